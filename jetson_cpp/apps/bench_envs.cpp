@@ -0,0 +1,338 @@
+/**
+ * @file bench_envs.cpp
+ * @brief Benchmark de throughput de los entornos simulados
+ *
+ * Compara CartPoleEnv (un entorno, un tensor nuevo por step) con
+ * VectorCartPoleEnv (N entornos en SoA, kernel SIMD y tensores
+ * preasignados). Las acciones se generan antes de medir para que solo se
+ * cuente la simulación.
+ *
+ * También mide SimEV3Env (robot EV3 simulado) frente al tiempo real y las
+ * consultas de contacto por lotes de Arena (rejilla espacial).
+ *
+ * Después mide el escalado de EnvPool con el número de hilos:
+ * - modo síncrono con CartPoleEnv
+ * - modo síncrono y asíncrono ("primeros K") con un robot simulado lento
+ *   cuyo step tarda entre 20 y 200 us (tiempos desiguales)
+ *
+ * USO:
+ *   ./bench_envs [num_envs] [steps] [max_threads]
+ *
+ * EJEMPLO:
+ *   ./bench_envs 4096 2000 8
+ */
+
+#include <iostream>
+#include <torch/torch.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "environment/cartpole_env.h"
+#include "environment/arena.h"
+#include "environment/env_pool.h"
+#include "environment/sim_ev3_env.h"
+#include "environment/vector_cartpole_env.h"
+
+/**
+ * @brief CartPole con un step lento y desigual (espera activa de 20-200 us)
+ *
+ * Simula el coste de un simulador de robot sin depender de ninguno.
+ */
+class SlowCartPoleEnv : public environment::EnvironmentInterface {
+public:
+    explicit SlowCartPoleEnv(uint64_t seed) : env_(500), rng_(seed), delay_us_(20, 200) {}
+
+    torch::Tensor reset() override { return env_.reset(); }
+    environment::StepResult step(int64_t action) override {
+        busy_wait();
+        return env_.step(action);
+    }
+    void reset_into(float* state) override { env_.reset_into(state); }
+    void step_into(int64_t action, float* next_state, float& reward, bool& done,
+                   environment::StepInfo* info = nullptr) override {
+        busy_wait();
+        env_.step_into(action, next_state, reward, done, info);
+    }
+    int64_t state_dim() const override { return env_.state_dim(); }
+    int64_t action_dim() const override { return env_.action_dim(); }
+    void close() override {}
+
+private:
+    void busy_wait() {
+        const auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(delay_us_(rng_));
+        while (std::chrono::steady_clock::now() < until) {
+        }
+    }
+
+    environment::CartPoleEnv env_;
+    std::mt19937 rng_;
+    std::uniform_int_distribution<int> delay_us_;
+};
+
+/**
+ * @brief Steps/s de EnvPool en modo síncrono (step_batch + reset_where)
+ */
+double bench_pool_sync(const environment::ScalarEnvAdapter::Factory& factory, int64_t num_envs,
+                       int threads, int64_t steps, uint64_t* steals) {
+    environment::EnvPool pool(factory, num_envs, threads);
+    torch::Tensor actions = torch::randint(0, 2, {num_envs}, torch::kInt64);
+    torch::Tensor obs = pool.make_observations();
+    torch::Tensor rewards = pool.make_scalars();
+    torch::Tensor dones = pool.make_scalars();
+    pool.reset_all(obs);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int64_t i = 0; i < steps; ++i) {
+        pool.step_batch(actions, obs, rewards, dones);
+        pool.reset_where(dones, obs);
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    *steals = pool.steals();
+    return static_cast<double>(num_envs * steps) / sec;
+}
+
+/**
+ * @brief Steps/s de EnvPool en modo asíncrono: se reenvían los K primeros listos
+ */
+double bench_pool_async(const environment::ScalarEnvAdapter::Factory& factory, int64_t num_envs,
+                        int threads, int64_t steps) {
+    environment::EnvPool pool(factory, num_envs, threads);
+    const int64_t k = std::max<int64_t>(1, num_envs / 4);
+    torch::Tensor ids = torch::arange(num_envs, torch::kInt64);
+    torch::Tensor actions = torch::randint(0, 2, {num_envs}, torch::kInt64);
+    torch::Tensor ready_ids = torch::empty({k}, torch::kInt64);
+    torch::Tensor obs = torch::empty({k, pool.state_dim()}, torch::kFloat32);
+    torch::Tensor rewards = torch::empty({k}, torch::kFloat32);
+    torch::Tensor dones = torch::empty({k}, torch::kFloat32);
+    torch::Tensor step_ids = torch::empty({k}, torch::kInt64);
+    torch::Tensor reset_ids = torch::empty({k}, torch::kInt64);
+
+    pool.async_reset(ids);
+    int64_t collected = 0;
+    const int64_t total = num_envs * steps;
+
+    auto start = std::chrono::steady_clock::now();
+    while (collected < total) {
+        pool.recv(k, ready_ids, obs, rewards, dones);
+        collected += k;
+
+        // Los terminados se reinician; el resto sigue con un step
+        const int64_t* id_ptr = ready_ids.data_ptr<int64_t>();
+        const float* done_ptr = dones.data_ptr<float>();
+        int64_t* step_ptr = step_ids.data_ptr<int64_t>();
+        int64_t* reset_ptr = reset_ids.data_ptr<int64_t>();
+        int64_t num_step = 0;
+        int64_t num_reset = 0;
+        for (int64_t j = 0; j < k; ++j) {
+            if (done_ptr[j] != 0.0f) {
+                reset_ptr[num_reset++] = id_ptr[j];
+            } else {
+                step_ptr[num_step++] = id_ptr[j];
+            }
+        }
+        if (num_reset > 0) {
+            pool.async_reset(reset_ids.narrow(0, 0, num_reset));
+        }
+        if (num_step > 0) {
+            pool.send(step_ids.narrow(0, 0, num_step), actions.narrow(0, 0, num_step));
+        }
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Vaciar lo que quede en vuelo antes de destruir el pool
+    while (pool.in_flight() > 0) {
+        const int64_t n = std::min(k, pool.in_flight());
+        torch::Tensor n_ids = ready_ids.narrow(0, 0, n);
+        torch::Tensor n_obs = obs.narrow(0, 0, n);
+        torch::Tensor n_rewards = rewards.narrow(0, 0, n);
+        torch::Tensor n_dones = dones.narrow(0, 0, n);
+        pool.recv(n, n_ids, n_obs, n_rewards, n_dones);
+    }
+    return static_cast<double>(collected) / sec;
+}
+
+void print_usage(const char* program) {
+    std::cout << "Uso: " << program << " [num_envs] [steps] [max_threads]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Argumentos:" << std::endl;
+    std::cout << "  num_envs        Entornos en paralelo del entorno vectorizado (default: 4096)" << std::endl;
+    std::cout << "  steps           Steps de cada entorno (default: 2000)" << std::endl;
+    std::cout << "  max_threads     Hilos máximos de EnvPool (default: núcleos disponibles)" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "=========================================================================" << std::endl;
+    std::cout << "  Environment Benchmark - CartPoleEnv / VectorCartPoleEnv / EnvPool" << std::endl;
+    std::cout << "=========================================================================" << std::endl;
+
+    if (argc > 1 && std::string(argv[1]) == "-h") {
+        print_usage(argv[0]);
+        return 0;
+    }
+
+    int64_t num_envs = (argc > 1) ? std::atoll(argv[1]) : 4096;
+    int64_t steps = (argc > 2) ? std::atoll(argv[2]) : 2000;
+    int max_threads = (argc > 3) ? std::atoi(argv[3])
+                                 : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    if (num_envs <= 0 || steps <= 0 || max_threads <= 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    // Acciones aleatorias pregeneradas (64 filas reutilizadas en ciclo)
+    const int64_t action_rows = 64;
+    torch::Tensor actions = torch::randint(0, 2, {action_rows, num_envs}, torch::kInt64);
+    const int64_t* action_ptr = actions.data_ptr<int64_t>();
+
+    // ------------------------------------------------------------------------
+    // CartPoleEnv escalar
+    // ------------------------------------------------------------------------
+    environment::CartPoleEnv scalar_env(500);
+    const int64_t scalar_steps = std::min<int64_t>(steps * 50, 200000);
+    scalar_env.reset();
+
+    auto start = std::chrono::steady_clock::now();
+    for (int64_t i = 0; i < scalar_steps; ++i) {
+        auto result = scalar_env.step(action_ptr[i % (action_rows * num_envs)]);
+        if (result.done) {
+            scalar_env.reset();
+        }
+    }
+    double scalar_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // ------------------------------------------------------------------------
+    // VectorCartPoleEnv
+    // ------------------------------------------------------------------------
+    environment::VectorCartPoleEnv vector_env(num_envs, 500, 42);
+    for (int64_t i = 0; i < 10; ++i) {
+        vector_env.step(action_ptr + (i % action_rows) * num_envs);  // warm-up
+    }
+    const uint64_t steps_before = vector_env.total_steps();
+
+    start = std::chrono::steady_clock::now();
+    for (int64_t i = 0; i < steps; ++i) {
+        vector_env.step(action_ptr + (i % action_rows) * num_envs);
+    }
+    double vector_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double vector_total = static_cast<double>(vector_env.total_steps() - steps_before);
+
+    const double scalar_rate = scalar_steps / scalar_sec;
+    const double vector_rate = vector_total / vector_sec;
+
+    std::cout << "Kernel:               " << environment::cartpole_kernel_isa() << std::endl;
+    std::cout << "CartPoleEnv:          " << scalar_rate / 1e6 << " M steps/s ("
+              << scalar_steps << " steps)" << std::endl;
+    std::cout << "VectorCartPoleEnv:    " << vector_rate / 1e6 << " M steps/s ("
+              << num_envs << " envs x " << steps << " steps)" << std::endl;
+    std::cout << "Speedup:              " << vector_rate / scalar_rate << "x" << std::endl;
+    std::cout << "Episodios terminados: " << vector_env.completed_episodes()
+              << " (longitud media " << vector_env.mean_episode_length() << ")" << std::endl;
+
+    // ------------------------------------------------------------------------
+    // SimEV3Env (acciones aleatorias 0-4)
+    // ------------------------------------------------------------------------
+    environment::SimEV3Env sim_env(environment::SimEV3Params(), 42);
+    float sim_state[4];
+    sim_env.reset_into(sim_state);
+    torch::Tensor sim_actions = torch::randint(0, 5, {action_rows * num_envs}, torch::kInt64);
+    const int64_t* sim_action_ptr = sim_actions.data_ptr<int64_t>();
+    const double sim_time_before = sim_env.simulated_seconds();
+
+    start = std::chrono::steady_clock::now();
+    for (int64_t i = 0; i < scalar_steps; ++i) {
+        float reward = 0.0f;
+        bool done = false;
+        sim_env.step_into(sim_action_ptr[i % (action_rows * num_envs)], sim_state, reward, done);
+        if (done) {
+            sim_env.reset_into(sim_state);
+        }
+    }
+    double sim_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "SimEV3Env:            " << scalar_steps / sim_sec / 1e6 << " M steps/s ("
+              << (sim_env.simulated_seconds() - sim_time_before) / sim_sec << "x tiempo real)" << std::endl;
+
+    // ------------------------------------------------------------------------
+    // Arena: parachoques de num_envs robots en una arena densa (10x10 m, 500 obstáculos)
+    // ------------------------------------------------------------------------
+    environment::ArenaParams arena_params;
+    arena_params.width = 10.0f;
+    arena_params.height = 10.0f;
+    arena_params.min_obstacles = 500;
+    arena_params.max_obstacles = 500;
+    environment::Arena arena(arena_params);
+    std::mt19937 arena_rng(42);
+    arena.generate(arena_rng);
+
+    torch::Tensor poses = torch::rand({3, num_envs}, torch::kFloat32);
+    poses[0].mul_(arena_params.width);
+    poses[1].mul_(arena_params.height);
+    poses[2].mul_(6.2831853f);
+    torch::Tensor touches = torch::empty({2, num_envs}, torch::kFloat32);
+    environment::PoseBatchView pose_view;
+    pose_view.x = poses.data_ptr<float>();
+    pose_view.y = pose_view.x + num_envs;
+    pose_view.heading = pose_view.y + num_envs;
+    pose_view.size = static_cast<size_t>(num_envs);
+
+    start = std::chrono::steady_clock::now();
+    for (int64_t i = 0; i < steps; ++i) {
+        arena.bumper_contacts(pose_view, environment::BumperGeometry(), touches.data_ptr<float>(),
+                              touches.data_ptr<float>() + num_envs);
+    }
+    double arena_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Arena (500 obst.):    " << num_envs * steps / arena_sec / 1e6
+              << " M robots/s (2 parachoques por robot, rejilla " << arena.grid_cols() << "x"
+              << arena.grid_rows() << ")" << std::endl;
+
+    // ------------------------------------------------------------------------
+    // EnvPool: escalado con el número de hilos
+    // ------------------------------------------------------------------------
+    std::vector<int> thread_counts;
+    for (int t = 1; t < max_threads; t *= 2) {
+        thread_counts.push_back(t);
+    }
+    thread_counts.push_back(max_threads);
+
+    const int64_t pool_envs = std::min<int64_t>(num_envs, 256);
+    const int64_t pool_steps = std::max<int64_t>(1, steps / 10);
+    const int64_t slow_envs = std::min<int64_t>(num_envs, 64);
+    const int64_t slow_steps = 20;
+
+    environment::ScalarEnvAdapter::Factory cartpole_factory = [] {
+        return std::make_unique<environment::CartPoleEnv>(500);
+    };
+    uint64_t seed = 0;
+    environment::ScalarEnvAdapter::Factory slow_factory = [&seed] {
+        return std::make_unique<SlowCartPoleEnv>(++seed);
+    };
+
+    std::cout << std::endl;
+    std::cout << "EnvPool (CartPoleEnv x" << pool_envs << ", " << pool_steps << " steps; robot lento x"
+              << slow_envs << ", " << slow_steps << " steps)" << std::endl;
+    std::cout << "  Hilos   CartPole sync (M/s)   Robot sync (k/s)   Robot async K=M/4 (k/s)   Robos" << std::endl;
+
+    double cartpole_base = 0.0;
+    double slow_base = 0.0;
+    for (int threads : thread_counts) {
+        uint64_t steals = 0;
+        uint64_t slow_steals = 0;
+        const double cartpole_rate = bench_pool_sync(cartpole_factory, pool_envs, threads, pool_steps, &steals);
+        const double slow_rate = bench_pool_sync(slow_factory, slow_envs, threads, slow_steps, &slow_steals);
+        const double async_rate = bench_pool_async(slow_factory, slow_envs, threads, slow_steps);
+        if (threads == 1) {
+            cartpole_base = cartpole_rate;
+            slow_base = slow_rate;
+        }
+        std::cout << "  " << threads << "\t  " << cartpole_rate / 1e6 << " (" << cartpole_rate / cartpole_base
+                  << "x)\t" << slow_rate / 1e3 << " (" << slow_rate / slow_base << "x)\t"
+                  << async_rate / 1e3 << "\t\t" << steals + slow_steals << std::endl;
+    }
+    std::cout << "=========================================================================" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file checkpoint_tool.cpp
+ * @brief Inspección y extracción del historial de checkpoints comprimido
+ *
+ * train_robot guarda cada 10 episodios una entrada en
+ * models/dqn_robot_history.bin: keyframes completos periódicos y, entre
+ * ellos, solo la diferencia de parámetros comprimida. Esta herramienta lista
+ * las entradas y reconstruye cualquiera de ellas como un .pt cargable por
+ * jetson_dqn (-m), distill_policy o compile_policy_table.
+ *
+ * USO:
+ *   ./checkpoint_tool list <history.bin>
+ *   ./checkpoint_tool extract <history.bin> <index> <salida.pt>
+ *
+ * EJEMPLO:
+ *   ./checkpoint_tool extract models/dqn_robot_history.bin 7 models/dqn_robot_ep80.pt
+ */
+
+#include <iostream>
+#include <torch/torch.h>
+#include <cstdlib>
+#include <iomanip>
+#include <string>
+
+#include "dqn/checkpoint_history.h"
+
+void print_usage(const char* program) {
+    std::cout << "Uso: " << program << " list <history.bin>" << std::endl;
+    std::cout << "     " << program << " extract <history.bin> <index> <salida.pt>" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Comandos:" << std::endl;
+    std::cout << "  list            Lista las entradas del historial y su tamaño" << std::endl;
+    std::cout << "  extract         Reconstruye la entrada <index> como checkpoint .pt" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::string command = argv[1];
+    std::string history_path = argv[2];
+
+    try {
+        // Solo lectura: no crea el archivo ni recorta el registro que
+        // train_robot pueda estar escribiendo
+        dqn::CheckpointHistory::Options options;
+        options.read_only = true;
+        dqn::CheckpointHistory history(history_path, options);
+
+        if (command == "list") {
+            std::cout << std::left << std::setw(7) << "Index" << std::setw(10) << "Tipo"
+                      << std::setw(10) << "Episodio" << std::setw(14) << "Train steps"
+                      << "Bytes" << std::endl;
+            for (const auto& entry : history.entries()) {
+                auto episode = entry.counters.find("episode");
+                std::cout << std::left << std::setw(7) << entry.index
+                          << std::setw(10) << (entry.keyframe ? "keyframe" : "delta")
+                          << std::setw(10) << (episode != entry.counters.end() ? std::to_string(static_cast<int>(episode->second)) : "-")
+                          << std::setw(14) << entry.training_steps
+                          << entry.bytes << std::endl;
+            }
+
+            uint64_t raw = history.raw_bytes();
+            uint64_t stored = history.file_bytes();
+            std::cout << "\nEntradas: " << history.size()
+                      << " | Archivo: " << stored / 1024 << " KB"
+                      << " | Sin comprimir: " << raw / 1024 << " KB";
+            if (stored > 0) {
+                std::cout << " | Ratio: " << std::fixed << std::setprecision(1)
+                          << static_cast<double>(raw) / static_cast<double>(stored) << "x";
+            }
+            std::cout << std::endl;
+            return 0;
+        }
+
+        if (command == "extract" && argc >= 5) {
+            size_t index = static_cast<size_t>(std::strtoull(argv[3], nullptr, 10));
+            std::string output_path = argv[4];
+
+            dqn::TrainingCheckpoint checkpoint = history.restore(index);
+            checkpoint.save(output_path);
+
+            std::cout << "[Checkpoint] Entrada " << index << " (train steps="
+                      << checkpoint.training_steps << ", epsilon=" << checkpoint.epsilon
+                      << ") guardada en: " << output_path << std::endl;
+            return 0;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] " << e.what() << std::endl;
+        return 1;
+    }
+
+    print_usage(argv[0]);
+    return 1;
+}
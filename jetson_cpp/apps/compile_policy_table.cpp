@@ -0,0 +1,105 @@
+/**
+ * @file compile_policy_table.cpp
+ * @brief Compila un QNetwork entrenado en una tabla Q con interpolación bilineal
+ *
+ * El estado del robot son dos canales de giroscopio acotados en [-1, 1]
+ * (tanh) y dos flags binarios de contacto. La tabla evalúa la red sobre una
+ * grilla densa de los canales del giroscopio para los 4 casos de contacto.
+ * jetson_dqn la carga con -l y decide en O(1) sin LibTorch.
+ *
+ * Acepta modelos completos (train_robot / DQNAgent::save) o students
+ * destilados (distill_policy).
+ *
+ * USO:
+ *   ./compile_policy_table <model.pt> <table.bin> [resolution]
+ *
+ * EJEMPLO:
+ *   ./compile_policy_table models/dqn_robot_best.pt models/dqn_table.bin 65
+ */
+
+#include <iostream>
+#include <torch/torch.h>
+#include <cstdlib>
+#include <string>
+
+#include "dqn/distillation.h"
+#include "dqn/inference_backend.h"
+#include "dqn/lookup_table_policy.h"
+#include "utils/timing.h"
+
+void print_usage(const char* program) {
+    std::cout << "Uso: " << program << " <model.pt> <table.bin> [resolution]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Argumentos:" << std::endl;
+    std::cout << "  model.pt        Modelo DQN o student destilado" << std::endl;
+    std::cout << "  table.bin       Ruta de salida de la tabla" << std::endl;
+    std::cout << "  resolution      Puntos de grilla por eje de giroscopio (default: 65)" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "=========================================================================" << std::endl;
+    std::cout << "  DQN Policy Compiler - QNetwork → Lookup Table" << std::endl;
+    std::cout << "=========================================================================" << std::endl;
+
+    if (argc < 3) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::string model_path = argv[1];
+    std::string table_path = argv[2];
+    int64_t resolution = (argc > 3) ? std::atoi(argv[3]) : 65;
+
+    const int64_t state_dim = 4;
+    const int64_t action_dim = 5;
+
+    // Cargar red: primero como student, si no como QNetwork completo
+    dqn::QLookupTable::ForwardFn forward;
+    try {
+        dqn::PolicyNetwork network = dqn::load_policy_network(model_path, state_dim, action_dim);
+        forward = network.forward_fn();
+        std::cout << "[Model] " << network.description() << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] No se pudo cargar el modelo: " << e.what() << std::endl;
+        return 1;
+    }
+
+    // Compilar y validar
+    dqn::QLookupTable table = dqn::QLookupTable::compile(forward, resolution);
+    dqn::LookupTableReport report = table.evaluate(forward);
+
+    // Latencia por decisión: red (LibTorch) vs tabla
+    dqn::EagerBackend network_backend("libtorch-eager", forward, state_dim, torch::kCPU);
+    torch::Tensor probes = dqn::sample_robot_states(512).contiguous();
+    const float* probe_ptr = probes.data_ptr<float>();
+    int64_t next = 0;
+    auto network_stats = utils::measure_latency([&]() {
+        (void)network_backend.select_action(probe_ptr + (next++ % 512) * state_dim);
+    }, 5000);
+    auto table_stats = utils::measure_latency([&]() {
+        (void)table.select_action(probe_ptr + (next++ % 512) * state_dim);
+    }, 5000);
+
+    std::cout << "\n=========================================================================" << std::endl;
+    std::cout << "  Resultado de la compilación" << std::endl;
+    std::cout << "=========================================================================" << std::endl;
+    std::cout << "Grilla:               4 x " << table.resolution() << " x " << table.resolution()
+              << " (" << table.size_bytes() / 1024 << " KB)" << std::endl;
+    std::cout << "Estados evaluados:    " << report.num_samples << std::endl;
+    std::cout << "Error de argmax:      " << (report.argmax_error * 100.0f) << "%" << std::endl;
+    std::cout << "Error Q (medio/máx):  " << report.mean_q_error << " / " << report.max_q_error << std::endl;
+    std::cout << "Latencia red:         " << network_stats.mean_us << " us (p99 "
+              << network_stats.p99_us << " us)" << std::endl;
+    std::cout << "Latencia tabla:       " << table_stats.mean_us << " us (p99 "
+              << table_stats.p99_us << " us)" << std::endl;
+
+    if (!table.save(table_path)) {
+        return 1;
+    }
+
+    std::cout << "\nUsar en jetson_dqn:" << std::endl;
+    std::cout << "  ./jetson_dqn <laptop_ip> -p dqn -l " << table_path << std::endl;
+    std::cout << "=========================================================================" << std::endl;
+
+    return 0;
+}
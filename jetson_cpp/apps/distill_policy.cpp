@@ -0,0 +1,117 @@
+/**
+ * @file distill_policy.cpp
+ * @brief Destilación de un QNetwork entrenado en un student pequeño
+ *
+ * Entrena una red 4 → hidden → 5 que imita los Q-values y la acción greedy
+ * del modelo completo (4 → 128 → 128 → 5). El student se carga en
+ * jetson_dqn con -s y reduce el costo de CPU por decisión.
+ *
+ * Estados de destilación:
+ * - Sesión grabada (CSV de sensores o log del bridge), si se especifica
+ * - Estados aleatorios cubriendo todo el espacio normalizado
+ *
+ * USO:
+ *   ./distill_policy <teacher.pt> <student.pt> [sensor_log] [hidden_dim]
+ *
+ * EJEMPLO:
+ *   ./distill_policy models/dqn_robot_best.pt models/dqn_student.pt bridge_log.txt 32
+ */
+
+#include <iostream>
+#include <torch/torch.h>
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+#include "dqn/distillation.h"
+#include "dqn/network.h"
+#include "dqn/types.h"
+
+void print_usage(const char* program) {
+    std::cout << "Uso: " << program << " <teacher.pt> <student.pt> [sensor_log] [hidden_dim]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Argumentos:" << std::endl;
+    std::cout << "  teacher.pt      Modelo DQN entrenado (4 -> 128 -> 128 -> 5)" << std::endl;
+    std::cout << "  student.pt      Ruta de salida del student destilado" << std::endl;
+    std::cout << "  sensor_log      CSV de sensores o log del bridge (opcional)" << std::endl;
+    std::cout << "  hidden_dim      Neuronas ocultas del student (default: 32)" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "=========================================================================" << std::endl;
+    std::cout << "  DQN Policy Distillation - Teacher → Student" << std::endl;
+    std::cout << "=========================================================================" << std::endl;
+
+    if (argc < 3) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::string teacher_path = argv[1];
+    std::string student_path = argv[2];
+    std::string sensor_log = (argc > 3) ? argv[3] : "";
+
+    const int64_t state_dim = 4;
+    const int64_t action_dim = 5;
+
+    dqn::DistillationConfig config;
+    if (argc > 4) {
+        config.hidden_dim = std::atoi(argv[4]);
+    }
+
+    torch::Device device(torch::cuda::is_available() ? torch::kCUDA : torch::kCPU);
+    std::cout << "[Device] " << device << std::endl;
+
+    // Cargar teacher (misma arquitectura que DQNAgent con hiperparámetros por defecto)
+    dqn::Hyperparameters params;
+    dqn::QNetwork teacher(state_dim, action_dim, params.hidden_dim1, params.hidden_dim2);
+    try {
+        torch::load(teacher, teacher_path);
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] No se pudo cargar el teacher: " << e.what() << std::endl;
+        return 1;
+    }
+    std::cout << "[Teacher] Cargado desde: " << teacher_path << std::endl;
+
+    // Estados de destilación: sesión grabada + cobertura aleatoria
+    torch::Tensor states = dqn::sample_robot_states(20000);
+    if (!sensor_log.empty()) {
+        torch::Tensor recorded = dqn::load_sensor_log_states(sensor_log);
+        if (recorded.defined()) {
+            states = torch::cat({recorded, states}, 0);
+        }
+    }
+
+    // Separar estados de evaluación (no vistos durante la destilación)
+    torch::Tensor perm = torch::randperm(states.size(0));
+    int64_t num_eval = std::max<int64_t>(1, states.size(0) / 10);
+    torch::Tensor eval_states = states.index_select(0, perm.slice(0, 0, num_eval));
+    torch::Tensor train_states = states.index_select(0, perm.slice(0, num_eval));
+
+    dqn::PolicyDistiller distiller(teacher, config, device);
+    dqn::StudentNetwork student = distiller.distill(train_states);
+
+    // Latencia medida en CPU: es donde corre el student en jetson_dqn
+    student->to(torch::kCPU);
+    dqn::PolicyDistiller cpu_distiller(teacher, config, torch::kCPU);
+    dqn::DistillationReport report = cpu_distiller.evaluate(student, eval_states);
+
+    std::cout << "\n=========================================================================" << std::endl;
+    std::cout << "  Resultado de la destilación" << std::endl;
+    std::cout << "=========================================================================" << std::endl;
+    std::cout << "Estados de evaluación: " << report.num_states << std::endl;
+    std::cout << "Acuerdo de acción:     " << (report.agreement_rate * 100.0f) << "%" << std::endl;
+    std::cout << "MSE de Q-values:       " << report.q_mse << std::endl;
+    std::cout << "Latencia teacher:      " << report.teacher_latency_us << " us (p99 "
+              << report.teacher_p99_us << " us)" << std::endl;
+    std::cout << "Latencia student:      " << report.student_latency_us << " us (p99 "
+              << report.student_p99_us << " us)" << std::endl;
+
+    dqn::save_student(student, student_path);
+
+    std::cout << "\nUsar en jetson_dqn:" << std::endl;
+    std::cout << "  ./jetson_dqn <laptop_ip> -p dqn -s " << student_path << std::endl;
+    std::cout << "=========================================================================" << std::endl;
+
+    return 0;
+}
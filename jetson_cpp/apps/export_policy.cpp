@@ -0,0 +1,113 @@
+/**
+ * @file export_policy.cpp
+ * @brief Exporta un QNetwork entrenado a pesos compactos para inferencia
+ *
+ * jetson_dqn con -m deserializa un archivo de LibTorch completo antes de la
+ * primera acción. Con -w mapea con mmap un archivo binario que contiene solo
+ * las capas Linear (pesos transpuestos y bias, alineados a 64 bytes) y arranca
+ * en milisegundos. Esta herramienta genera ese archivo y verifica que las
+ * decisiones coinciden con la red original.
+ *
+ * Acepta modelos completos (train_robot / DQNAgent::save) o students
+ * destilados (distill_policy).
+ *
+ * USO:
+ *   ./export_policy <model.pt> <weights.bin>
+ *
+ * EJEMPLO:
+ *   ./export_policy models/dqn_robot_best.pt models/dqn_weights.bin
+ */
+
+#include <iostream>
+#include <torch/torch.h>
+#include <memory>
+#include <string>
+
+#include "dqn/distillation.h"
+#include "dqn/inference_backend.h"
+#include "dqn/inference_policy.h"
+#include "utils/timing.h"
+
+void print_usage(const char* program) {
+    std::cout << "Uso: " << program << " <model.pt> <weights.bin>" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Argumentos:" << std::endl;
+    std::cout << "  model.pt        Modelo DQN o student destilado" << std::endl;
+    std::cout << "  weights.bin     Ruta de salida de los pesos compactos" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "=========================================================================" << std::endl;
+    std::cout << "  DQN Policy Export - QNetwork → Pesos compactos (mmap)" << std::endl;
+    std::cout << "=========================================================================" << std::endl;
+
+    if (argc < 3) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::string model_path = argv[1];
+    std::string weights_path = argv[2];
+
+    const int64_t state_dim = 4;
+    const int64_t action_dim = 5;
+
+    // Cargar red: primero como student, si no como QNetwork completo
+    dqn::PolicyNetwork network;
+    try {
+        network = dqn::load_policy_network(model_path, state_dim, action_dim);
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] No se pudo cargar el modelo: " << e.what() << std::endl;
+        return 1;
+    }
+    std::cout << "[Model] " << network.description() << std::endl;
+    std::vector<dqn::DenseLayer> layers = dqn::extract_dense_layers(network.module());
+
+    if (!dqn::InferencePolicy::export_weights(layers, weights_path)) {
+        return 1;
+    }
+
+    // Verificar: mapear el archivo y comparar decisiones con la red original
+    std::unique_ptr<dqn::InferencePolicy> mapped;
+    try {
+        mapped = std::make_unique<dqn::InferencePolicy>(weights_path);
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] No se pudo mapear " << weights_path << ": " << e.what() << std::endl;
+        return 1;
+    }
+    dqn::InferencePolicy& policy = *mapped;
+    dqn::EagerBackend reference("libtorch-eager", network.forward_fn(), state_dim, torch::kCPU);
+
+    torch::Tensor probes = dqn::sample_robot_states(512).contiguous();
+    const float* probe_ptr = probes.data_ptr<float>();
+    int64_t agree = 0;
+    for (int64_t i = 0; i < probes.size(0); ++i) {
+        const float* state = probe_ptr + i * state_dim;
+        agree += (policy.select_action(state) == reference.select_action(state)) ? 1 : 0;
+    }
+
+    int64_t next = 0;
+    auto stats = utils::measure_latency([&]() {
+        (void)policy.select_action(probe_ptr + (next++ % 512) * state_dim);
+    }, 5000);
+
+    std::cout << "\n=========================================================================" << std::endl;
+    std::cout << "  Resultado de la exportación" << std::endl;
+    std::cout << "=========================================================================" << std::endl;
+    std::cout << "Capas:                " << layers.size() << std::endl;
+    std::cout << "Tamaño:               " << policy.size_bytes() / 1024 << " KB" << std::endl;
+    std::cout << "Carga + warm-up:      " << policy.load_ms() << " ms" << std::endl;
+    std::cout << "Coincidencia argmax:  " << agree << "/" << probes.size(0) << std::endl;
+    std::cout << "Latencia:             " << stats.mean_us << " us (p99 " << stats.p99_us << " us)" << std::endl;
+
+    if (agree != probes.size(0)) {
+        // Solo puede diferir en empates casi exactos (orden distinto de sumas)
+        std::cerr << "[WARN] Algunas decisiones difieren de la red original" << std::endl;
+    }
+
+    std::cout << "\nUsar en jetson_dqn:" << std::endl;
+    std::cout << "  ./jetson_dqn <laptop_ip> -p dqn -w " << weights_path << std::endl;
+    std::cout << "=========================================================================" << std::endl;
+
+    return 0;
+}
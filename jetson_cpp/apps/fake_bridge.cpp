@@ -0,0 +1,485 @@
+/**
+ * @file fake_bridge.cpp
+ * @brief Bridge UDP falso: emula laptop/bridge.py con un robot simulado
+ *
+ * Habla el mismo protocolo que el bridge real:
+ *   1. El cliente (jetson_dqn / train_robot) envía la acción: "N" (0-4)
+ *   2. El bridge "ejecuta" la acción en un modelo de robot
+ *   3. Responde: "gyro_angle,gyro_rate,touch_front,touch_side" (ej: "12.50,-3.20,0,1")
+ *
+ * También acepta CSV con tag ("N,secuencia,timestamp_us") y el protocolo
+ * binario (communication/wire_protocol.h), y responde en el mismo formato
+ * que la petición, con el eco de su número de secuencia y hora de envío.
+ *
+ * Telemetría: un cliente que envía una suscripción ("S,hz" o el paquete
+ * binario equivalente) recibe frames de sensores empujados a ese ritmo
+ * (máx. 1000 Hz), sin esperar a sus acciones. La suscripción caduca si no
+ * se renueva en 3 s; "S,0" la cancela.
+ *
+ * Sirve a muchos clientes a la vez: cada dirección (ip:puerto) de origen
+ * tiene su propio robot. Se abren N sockets en el mismo puerto con
+ * SO_REUSEPORT, uno por hilo; el kernel reparte los datagramas por hash de
+ * la dirección de origen, así que cada cliente siempre cae en el mismo hilo
+ * y los robots no necesitan locks.
+ *
+ * Modelos de robot (pluggables, ver make_robot_model):
+ *   sim    = SimEV3Env (arena, giroscopio con ruido, bumpers). Cuando el
+ *            episodio termina por choque, el robot se recoloca en una arena
+ *            nueva (como el reposicionado manual en el robot real).
+ *   static = lecturas fijas a cero, para medir solo el camino de red.
+ *
+ * Acciones inválidas o lecturas perdidas (dropout del modelo) no se
+ * responden, igual que el bridge real: el cliente ve un timeout.
+ * Un cliente sin mensajes durante 30 s se olvida; si vuelve, recibe un
+ * robot nuevo.
+ *
+ * USO:
+ *   ./fake_bridge [port] [threads] [sim|static]
+ *
+ * EJEMPLO:
+ *   ./fake_bridge 5000 4 sim
+ *   ./train_robot 127.0.0.1 200 "" virtual
+ *   ./jetson_dqn 127.0.0.1 -p random -c virtual
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "communication/sensor_data.h"
+#include "communication/wire_protocol.h"
+#include "environment/sim_ev3_env.h"
+
+using communication::SensorData;
+
+// ============================================================================
+// CONFIGURACIÓN
+// ============================================================================
+
+// Puerto UDP del bridge (debe coincidir con config.py)
+const int DEFAULT_PORT = 5000;
+
+// Número de acciones válidas (STOP, FORWARD, TURN_LEFT, TURN_RIGHT, BACKWARD)
+const int NUM_ACTIONS = 5;
+
+// Un cliente sin mensajes durante este tiempo se olvida
+const auto CLIENT_IDLE_TIMEOUT = std::chrono::seconds(30);
+
+// Espera máxima de poll para revisar la señal de parada (como bridge.py)
+const int RECV_TIMEOUT_MS = 100;
+
+// Telemetría empujada: ritmo máximo y caducidad de una suscripción sin renovar
+const int MAX_TELEMETRY_HZ = 1000;
+const auto TELEMETRY_SUBSCRIPTION_TIMEOUT = std::chrono::seconds(3);
+
+volatile sig_atomic_t running = 1;
+
+void signalHandler(int signum) {
+    std::cout << "\n[INFO] Interrupción recibida (Ctrl+C), deteniendo..." << std::endl;
+    running = 0;
+}
+
+// ============================================================================
+// MODELOS DE ROBOT
+// ============================================================================
+
+/**
+ * @brief Robot detrás del bridge: recibe una acción y devuelve los sensores
+ */
+class RobotModel {
+public:
+    virtual ~RobotModel() = default;
+
+    /**
+     * @brief Ejecuta una acción (0-4) y lee los sensores
+     *
+     * @return false si la lectura se perdió (no se responde al cliente)
+     */
+    virtual bool act(int action, SensorData& sensors) = 0;
+
+    /**
+     * @brief Lee los sensores sin actuar (telemetría)
+     *
+     * @return false si la lectura se perdió
+     */
+    virtual bool sense(SensorData& sensors) = 0;
+};
+
+// Robot EV3 simulado; el episodio interno se reinicia al chocar
+class SimRobotModel : public RobotModel {
+public:
+    explicit SimRobotModel(uint64_t seed) : env_(make_params(), seed) {
+        env_.reset_into(state_);
+    }
+
+    bool act(int action, SensorData& sensors) override {
+        float reward = 0.0f;
+        bool done = false;
+        env_.step_into(action, state_, reward, done);
+        sense(sensors);
+
+        if (done) {
+            env_.reset_into(state_);  // Robot recolocado para el siguiente episodio
+        }
+        return sensors.valid;
+    }
+
+    // El simulador solo avanza con las acciones: la telemetría repite la
+    // última lectura hasta la siguiente
+    bool sense(SensorData& sensors) override {
+        const environment::SensorRecord& record = env_.last_sensor_record();
+        sensors.gyro_angle = record.gyro_angle;
+        sensors.gyro_rate = record.gyro_rate;
+        sensors.touch_front = static_cast<int>(record.touch_front);
+        sensors.touch_side = static_cast<int>(record.touch_side);
+        sensors.valid = record.valid > 0.0f;
+        return sensors.valid;
+    }
+
+private:
+    static environment::SimEV3Params make_params() {
+        environment::SimEV3Params params;
+        params.max_steps = 1 << 30;  // El cliente decide cuándo termina el episodio
+        return params;
+    }
+
+    environment::SimEV3Env env_;
+    float state_[4];
+};
+
+// Lecturas fijas: mide solo el coste de red y del bridge
+class StaticRobotModel : public RobotModel {
+public:
+    bool act(int action, SensorData& sensors) override {
+        return sense(sensors);
+    }
+
+    bool sense(SensorData& sensors) override {
+        sensors.gyro_angle = 0.0f;
+        sensors.gyro_rate = 0.0f;
+        sensors.touch_front = 0;
+        sensors.touch_side = 0;
+        sensors.valid = true;
+        return true;
+    }
+};
+
+std::unique_ptr<RobotModel> make_robot_model(const std::string& kind, uint64_t seed) {
+    if (kind == "sim") {
+        return std::make_unique<SimRobotModel>(seed);
+    }
+    if (kind == "static") {
+        return std::make_unique<StaticRobotModel>();
+    }
+    throw std::invalid_argument("Modelo de robot desconocido: " + kind + " (sim | static)");
+}
+
+// ============================================================================
+// WORKER - Un socket SO_REUSEPORT y sus clientes
+// ============================================================================
+
+struct WorkerStats {
+    std::atomic<uint64_t> received{0};
+    std::atomic<uint64_t> replied{0};
+    std::atomic<uint64_t> telemetry{0};
+    std::atomic<uint64_t> invalid{0};
+    std::atomic<uint64_t> clients{0};
+};
+
+int open_reuseport_socket(int port) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        throw std::runtime_error("No se pudo crear socket UDP");
+    }
+
+    int one = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) < 0) {
+        ::close(fd);
+        throw std::runtime_error(std::string("SO_REUSEPORT no disponible: ") + strerror(errno));
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        ::close(fd);
+        throw std::runtime_error("No se pudo abrir el puerto " + std::to_string(port) + ": " +
+                                 strerror(errno));
+    }
+    return fd;
+}
+
+void worker_loop(int fd, const std::string& model_kind, uint64_t seed, WorkerStats& stats) {
+    using clock = std::chrono::steady_clock;
+    struct Client {
+        std::unique_ptr<RobotModel> robot;
+        clock::time_point last_seen;
+        struct sockaddr_in addr;
+
+        // Telemetría (rate_hz 0 = sin suscripción)
+        int rate_hz = 0;
+        communication::WireFormat format = communication::WireFormat::kCsv;
+        clock::time_point next_frame;
+        clock::time_point subscribed_until;
+        uint32_t frame = 0;
+    };
+    std::unordered_map<uint64_t, Client> clients;
+    std::mt19937_64 seeds(seed);
+    auto last_sweep = clock::now();
+    auto next_telemetry = clock::time_point::max();   // Próximo frame pendiente de algún cliente
+
+    char buffer[256];
+    char reply[communication::kMaxWirePacketSize];
+    while (running) {
+        // Esperar datagramas hasta el próximo frame de telemetría (o 100 ms)
+        int wait_ms = RECV_TIMEOUT_MS;
+        if (next_telemetry != clock::time_point::max()) {
+            const auto until = std::chrono::duration_cast<std::chrono::milliseconds>(
+                next_telemetry - clock::now()).count();
+            wait_ms = static_cast<int>(std::max<int64_t>(0, std::min<int64_t>(wait_ms, until)));
+        }
+        struct pollfd pfd = {fd, POLLIN, 0};
+        ssize_t received = -1;
+        struct sockaddr_in from;
+        socklen_t from_len = sizeof(from);
+        if (poll(&pfd, 1, wait_ms) > 0) {
+            received = recvfrom(fd, buffer, sizeof(buffer), MSG_DONTWAIT,
+                                (struct sockaddr*)&from, &from_len);
+        }
+        const auto now = clock::now();
+
+        // Olvidar clientes inactivos (como mucho una vez por segundo)
+        if (now - last_sweep > std::chrono::seconds(1)) {
+            for (auto it = clients.begin(); it != clients.end();) {
+                it = now - it->second.last_seen > CLIENT_IDLE_TIMEOUT ? clients.erase(it) : std::next(it);
+            }
+            stats.clients.store(clients.size(), std::memory_order_relaxed);
+            last_sweep = now;
+        }
+
+        // Frames de telemetría vencidos
+        if (now >= next_telemetry) {
+            next_telemetry = clock::time_point::max();
+            for (auto& entry : clients) {
+                Client& client = entry.second;
+                if (client.rate_hz == 0) {
+                    continue;
+                }
+                if (now > client.subscribed_until) {
+                    client.rate_hz = 0;  // Suscripción sin renovar
+                    continue;
+                }
+                if (now >= client.next_frame) {
+                    SensorData sensors;
+                    if (client.robot->sense(sensors)) {
+                        communication::WireTag frame;
+                        frame.sequence = ++client.frame;
+                        frame.timestamp_us = static_cast<uint64_t>(
+                            std::chrono::duration_cast<std::chrono::microseconds>(
+                                now.time_since_epoch()).count());
+                        const size_t len = communication::encode_telemetry(
+                            sensors, client.format, reply, sizeof(reply), frame);
+                        if (sendto(fd, reply, len, 0, (struct sockaddr*)&client.addr,
+                                   sizeof(client.addr)) == static_cast<ssize_t>(len)) {
+                            stats.telemetry.fetch_add(1, std::memory_order_relaxed);
+                        }
+                    }
+                    // Ritmo fijo; si el hilo se retrasó, no se envían ráfagas
+                    client.next_frame += std::chrono::microseconds(1000000 / client.rate_hz);
+                    if (client.next_frame < now) {
+                        client.next_frame = now + std::chrono::microseconds(1000000 / client.rate_hz);
+                    }
+                }
+                next_telemetry = std::min(next_telemetry, client.next_frame);
+            }
+        }
+
+        if (received < 0) {
+            continue;  // Timeout: revisar running
+        }
+        stats.received.fetch_add(1, std::memory_order_relaxed);
+
+        int action = -1;
+        int rate_hz = -1;
+        communication::WireFormat format;
+        communication::WireTag tag;
+        const bool is_action =
+            communication::decode_action(buffer, static_cast<size_t>(received), action, &format, &tag) &&
+            action < NUM_ACTIONS;
+        if (!is_action &&
+            !communication::decode_subscribe(buffer, static_cast<size_t>(received), rate_hz, &format)) {
+            stats.invalid.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        const uint64_t key = (static_cast<uint64_t>(from.sin_addr.s_addr) << 16) | from.sin_port;
+        Client& client = clients[key];
+        if (!client.robot) {
+            client.robot = make_robot_model(model_kind, seeds());
+            stats.clients.store(clients.size(), std::memory_order_relaxed);
+        }
+        client.last_seen = now;
+        client.addr = from;
+
+        if (!is_action) {
+            // Suscripción nueva, renovación o cancelación
+            const int rate = std::min(rate_hz, MAX_TELEMETRY_HZ);
+            if (rate > 0 && client.rate_hz != rate) {
+                client.next_frame = now;
+            }
+            client.rate_hz = rate;
+            client.format = format;
+            client.subscribed_until = now + TELEMETRY_SUBSCRIPTION_TIMEOUT;
+            if (rate > 0) {
+                next_telemetry = std::min(next_telemetry, client.next_frame);
+            }
+            continue;
+        }
+
+        SensorData sensors;
+        if (!client.robot->act(action, sensors)) {
+            continue;  // Lectura perdida
+        }
+
+        // Mismo formato que la petición (CSV igual que bridge.py) y eco de su tag
+        const size_t len = communication::encode_sensors(sensors, format, reply, sizeof(reply), tag);
+        if (sendto(fd, reply, len, 0, (struct sockaddr*)&from, from_len) == static_cast<ssize_t>(len)) {
+            stats.replied.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+void print_usage(const char* program_name) {
+    std::cout << "Uso: " << program_name << " [port] [threads] [sim|static]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "  port     Puerto UDP (default: " << DEFAULT_PORT << ")" << std::endl;
+    std::cout << "  threads  Sockets SO_REUSEPORT / hilos (default: núcleos disponibles)" << std::endl;
+    std::cout << "  model    sim    = SimEV3Env por cliente (default)" << std::endl;
+    std::cout << "           static = lecturas fijas (solo red)" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && (std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help")) {
+        print_usage(argv[0]);
+        return 0;
+    }
+
+    int port = argc > 1 ? std::atoi(argv[1]) : DEFAULT_PORT;
+    int num_threads = argc > 2 ? std::atoi(argv[2]) : 0;
+    std::string model_kind = argc > 3 ? argv[3] : "sim";
+    if (num_threads <= 0) {
+        num_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    try {
+        make_robot_model(model_kind, 0);  // Validar el nombre antes de abrir sockets
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] " << e.what() << std::endl;
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::cout << "========================================" << std::endl;
+    std::cout << "  FAKE BRIDGE (robot " << model_kind << ")" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "[FakeBridge] Puerto UDP: " << port << std::endl;
+    std::cout << "[FakeBridge] Hilos (SO_REUSEPORT): " << num_threads << std::endl;
+
+    signal(SIGINT, signalHandler);
+
+    std::vector<int> sockets;
+    try {
+        for (int t = 0; t < num_threads; ++t) {
+            sockets.push_back(open_reuseport_socket(port));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] " << e.what() << std::endl;
+        for (int fd : sockets) ::close(fd);
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<WorkerStats>> stats;
+    std::vector<std::thread> workers;
+    std::random_device seed_source;
+    for (int t = 0; t < num_threads; ++t) {
+        stats.push_back(std::make_unique<WorkerStats>());
+        workers.emplace_back(worker_loop, sockets[t], model_kind, seed_source(), std::ref(*stats.back()));
+    }
+
+    std::cout << "[FakeBridge] Operativo. Presiona Ctrl+C para detener" << std::endl;
+
+    // Resumen cada 5 segundos
+    uint64_t last_replied = 0;
+    uint64_t last_telemetry = 0;
+    auto last_report = std::chrono::steady_clock::now();
+    while (running) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        const auto now = std::chrono::steady_clock::now();
+        const double seconds = std::chrono::duration<double>(now - last_report).count();
+        if (seconds < 5.0) {
+            continue;
+        }
+
+        uint64_t replied = 0;
+        uint64_t telemetry = 0;
+        uint64_t invalid = 0;
+        uint64_t clients = 0;
+        for (const auto& s : stats) {
+            replied += s->replied.load(std::memory_order_relaxed);
+            telemetry += s->telemetry.load(std::memory_order_relaxed);
+            invalid += s->invalid.load(std::memory_order_relaxed);
+            clients += s->clients.load(std::memory_order_relaxed);
+        }
+        if (replied != last_replied || telemetry != last_telemetry) {
+            std::cout << "[FakeBridge] " << static_cast<uint64_t>((replied - last_replied) / seconds)
+                      << " respuestas/s | "
+                      << static_cast<uint64_t>((telemetry - last_telemetry) / seconds)
+                      << " frames telemetría/s | clientes: " << clients
+                      << " | inválidos: " << invalid << std::endl;
+        }
+        last_replied = replied;
+        last_telemetry = telemetry;
+        last_report = now;
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (int fd : sockets) {
+        ::close(fd);
+    }
+
+    uint64_t received = 0;
+    uint64_t replied = 0;
+    for (const auto& s : stats) {
+        received += s->received.load();
+        replied += s->replied.load();
+    }
+    std::cout << "[FakeBridge] Cerrado. Recibidos: " << received << ", respondidos: " << replied
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,384 @@
+/**
+ * @file impair_proxy.cpp
+ * @brief Proxy UDP que degrada el enlace Jetson ↔ bridge (retardo, jitter, pérdidas...)
+ *
+ * Se coloca entre el cliente (jetson_dqn / train_robot) y un bridge (real
+ * o fake_bridge) y aplica a cada datagrama las degradaciones de
+ * communication::LinkImpairment, por separado en cada sentido:
+ *   subida (cliente → bridge): acciones
+ *   bajada (bridge → cliente): sensores
+ *
+ * Cada cliente tiene su propio socket hacia el bridge, así que las
+ * respuestas vuelven a quien corresponde. Con la misma semilla y la misma
+ * secuencia de datagramas las degradaciones se repiten.
+ *
+ * Los clientes usan el puerto 5000 fijo: el proxy escucha en 5000 y el
+ * bridge falso va en otro puerto.
+ *
+ * Formato de la degradación (claves opcionales, separadas por comas):
+ *   delay=<ms>,jitter=<ms>,dist=uniform|normal|pareto,loss=<0-1>,burst=<n>,
+ *   dup=<0-1>,reorder=<0-1>,reorder_ms=<ms>
+ *
+ * USO:
+ *   ./impair_proxy <listen_port> <bridge_ip> <bridge_port> [spec] [-u spec] [-d spec] [-s seed]
+ *
+ * EJEMPLO (Wi-Fi malo, por loopback):
+ *   ./fake_bridge 5001 2 sim
+ *   ./impair_proxy 5000 127.0.0.1 5001 delay=15,jitter=10,dist=pareto,loss=0.05,burst=3
+ *   ./train_robot 127.0.0.1 200 "" virtual
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "communication/link_impairment.h"
+
+using communication::LinkImpairment;
+using communication::LinkImpairmentParams;
+using Clock = std::chrono::steady_clock;
+
+// ============================================================================
+// CONFIGURACIÓN
+// ============================================================================
+
+// Una sesión sin tráfico durante este tiempo se cierra
+const auto SESSION_IDLE_TIMEOUT = std::chrono::seconds(30);
+
+// Espera máxima de poll sin datagramas pendientes (para revisar Ctrl+C)
+const int IDLE_POLL_MS = 100;
+
+volatile sig_atomic_t running = 1;
+
+void signalHandler(int signum) {
+    std::cout << "\n[INFO] Interrupción recibida (Ctrl+C), deteniendo..." << std::endl;
+    running = 0;
+}
+
+// ============================================================================
+// PROXY
+// ============================================================================
+
+// Datagrama retenido hasta su instante de entrega
+struct Pending {
+    Clock::time_point release;
+    uint64_t order;                // Desempate: mismo instante → orden de llegada
+    bool upstream;                 // true: hacia el bridge por el socket de la sesión
+    struct sockaddr_in client;     // Cliente de la sesión
+    std::string payload;
+
+    bool operator>(const Pending& other) const {
+        return release != other.release ? release > other.release : order > other.order;
+    }
+};
+
+struct Session {
+    int fd = -1;                   // Socket conectado al bridge
+    struct sockaddr_in client;
+    Clock::time_point last_seen;
+};
+
+class ImpairProxy {
+public:
+    ImpairProxy(int listen_port, const struct sockaddr_in& bridge,
+                const LinkImpairmentParams& up, const LinkImpairmentParams& down, uint64_t seed)
+        : bridge_(bridge), up_(up, seed), down_(down, seed ^ 0x9e3779b97f4a7c15ULL) {
+        listen_fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+        if (listen_fd_ < 0) {
+            throw std::runtime_error("No se pudo crear socket UDP");
+        }
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(listen_port);
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        if (bind(listen_fd_, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+            ::close(listen_fd_);
+            throw std::runtime_error("No se pudo abrir el puerto " + std::to_string(listen_port) +
+                                     ": " + strerror(errno));
+        }
+    }
+
+    ~ImpairProxy() {
+        for (auto& entry : sessions_) {
+            ::close(entry.second.fd);
+        }
+        ::close(listen_fd_);
+    }
+
+    void run() {
+        auto last_report = Clock::now();
+        auto last_sweep = last_report;
+        std::vector<struct pollfd> fds;
+        std::vector<uint64_t> keys;
+        char buffer[2048];
+
+        while (running) {
+            // Entregar lo que ya venció
+            auto now = Clock::now();
+            while (!pending_.empty() && pending_.top().release <= now) {
+                deliver(pending_.top());
+                pending_.pop();
+            }
+
+            // poll hasta el siguiente datagrama retenido (ppoll: resolución sub-ms)
+            struct timespec timeout;
+            auto wait = std::chrono::nanoseconds(std::chrono::milliseconds(IDLE_POLL_MS));
+            if (!pending_.empty()) {
+                wait = std::min(wait, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                          pending_.top().release - now));
+            }
+            timeout.tv_sec = wait.count() / 1000000000;
+            timeout.tv_nsec = wait.count() % 1000000000;
+
+            fds.clear();
+            keys.clear();
+            fds.push_back({listen_fd_, POLLIN, 0});
+            for (const auto& entry : sessions_) {
+                fds.push_back({entry.second.fd, POLLIN, 0});
+                keys.push_back(entry.first);
+            }
+            if (ppoll(fds.data(), fds.size(), &timeout, nullptr) <= 0) {
+                continue;
+            }
+            now = Clock::now();
+
+            // Subida: cliente → bridge
+            if (fds[0].revents & POLLIN) {
+                struct sockaddr_in from;
+                socklen_t from_len = sizeof(from);
+                ssize_t n = recvfrom(listen_fd_, buffer, sizeof(buffer), 0,
+                                     (struct sockaddr*)&from, &from_len);
+                if (n >= 0) {
+                    Session* session = find_or_open(from, now);
+                    if (session != nullptr) {
+                        enqueue(up_, now, true, from, buffer, n);
+                    }
+                }
+            }
+
+            // Bajada: bridge → cliente
+            for (size_t i = 1; i < fds.size(); ++i) {
+                if (!(fds[i].revents & POLLIN)) {
+                    continue;
+                }
+                Session& session = sessions_[keys[i - 1]];
+                ssize_t n = recv(session.fd, buffer, sizeof(buffer), 0);
+                if (n >= 0) {
+                    enqueue(down_, now, false, session.client, buffer, n);
+                }
+            }
+
+            if (now - last_sweep > std::chrono::seconds(1)) {
+                close_idle(now);
+                last_sweep = now;
+            }
+            if (now - last_report > std::chrono::seconds(5)) {
+                report();
+                last_report = now;
+            }
+        }
+    }
+
+    void report() const {
+        std::cout << "[ImpairProxy] sesiones: " << sessions_.size()
+                  << " | retenidos: " << pending_.size() << std::endl;
+        report_direction("subida", up_);
+        report_direction("bajada", down_);
+    }
+
+private:
+    static uint64_t key_of(const struct sockaddr_in& addr) {
+        return (static_cast<uint64_t>(addr.sin_addr.s_addr) << 16) | addr.sin_port;
+    }
+
+    static void report_direction(const char* name, const LinkImpairment& link) {
+        std::cout << "[ImpairProxy]   " << name << ": " << link.offered() << " datagramas, "
+                  << link.dropped() << " perdidos, " << link.duplicated() << " duplicados, "
+                  << link.reordered() << " reordenados, retardo medio " << link.mean_delay_ms()
+                  << " ms" << std::endl;
+    }
+
+    Session* find_or_open(const struct sockaddr_in& client, Clock::time_point now) {
+        const uint64_t key = key_of(client);
+        auto it = sessions_.find(key);
+        if (it == sessions_.end()) {
+            int fd = socket(AF_INET, SOCK_DGRAM, 0);
+            if (fd < 0 || connect(fd, (const struct sockaddr*)&bridge_, sizeof(bridge_)) < 0) {
+                std::cerr << "[ERROR] No se pudo abrir sesión hacia el bridge: " << strerror(errno)
+                          << std::endl;
+                if (fd >= 0) ::close(fd);
+                return nullptr;
+            }
+            Session session;
+            session.fd = fd;
+            session.client = client;
+            it = sessions_.emplace(key, session).first;
+
+            char ip[INET_ADDRSTRLEN];
+            inet_ntop(AF_INET, &client.sin_addr, ip, sizeof(ip));
+            std::cout << "[ImpairProxy] Nueva sesión: " << ip << ":" << ntohs(client.sin_port)
+                      << std::endl;
+        }
+        it->second.last_seen = now;
+        return &it->second;
+    }
+
+    void close_idle(Clock::time_point now) {
+        for (auto it = sessions_.begin(); it != sessions_.end();) {
+            if (now - it->second.last_seen > SESSION_IDLE_TIMEOUT) {
+                ::close(it->second.fd);  // Sus datagramas retenidos de subida se descartan
+                it = sessions_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void enqueue(LinkImpairment& link, Clock::time_point now, bool upstream,
+                 const struct sockaddr_in& client, const char* data, ssize_t size) {
+        Clock::time_point release[2];
+        const int copies = link.schedule(now, release);
+        for (int c = 0; c < copies; ++c) {
+            Pending pending;
+            pending.release = release[c];
+            pending.order = next_order_++;
+            pending.upstream = upstream;
+            pending.client = client;
+            pending.payload.assign(data, static_cast<size_t>(size));
+            pending_.push(std::move(pending));
+        }
+    }
+
+    void deliver(const Pending& pending) {
+        if (pending.upstream) {
+            auto it = sessions_.find(key_of(pending.client));
+            if (it != sessions_.end()) {
+                send(it->second.fd, pending.payload.data(), pending.payload.size(), 0);
+            }
+        } else {
+            sendto(listen_fd_, pending.payload.data(), pending.payload.size(), 0,
+                   (const struct sockaddr*)&pending.client, sizeof(pending.client));
+        }
+    }
+
+    int listen_fd_ = -1;
+    struct sockaddr_in bridge_;
+    LinkImpairment up_;
+    LinkImpairment down_;
+    std::unordered_map<uint64_t, Session> sessions_;
+    std::priority_queue<Pending, std::vector<Pending>, std::greater<Pending>> pending_;
+    uint64_t next_order_ = 0;
+};
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+void print_usage(const char* program_name) {
+    std::cout << "Uso: " << program_name
+              << " <listen_port> <bridge_ip> <bridge_port> [spec] [-u spec] [-d spec] [-s seed]"
+              << std::endl;
+    std::cout << std::endl;
+    std::cout << "  spec       Degradación en ambos sentidos (default: ninguna)" << std::endl;
+    std::cout << "  -u spec    Solo subida (acciones, cliente → bridge)" << std::endl;
+    std::cout << "  -d spec    Solo bajada (sensores, bridge → cliente)" << std::endl;
+    std::cout << "  -s seed    Semilla (default: 1)" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Formato de spec:" << std::endl;
+    std::cout << "  delay=<ms>,jitter=<ms>,dist=uniform|normal|pareto,loss=<0-1>,burst=<n>," << std::endl;
+    std::cout << "  dup=<0-1>,reorder=<0-1>,reorder_ms=<ms>" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Ejemplo:" << std::endl;
+    std::cout << "  " << program_name << " 5000 127.0.0.1 5001 delay=15,jitter=10,dist=pareto,loss=0.05"
+              << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    const int listen_port = std::atoi(argv[1]);
+    const std::string bridge_ip = argv[2];
+    const int bridge_port = std::atoi(argv[3]);
+    std::string both_spec = "";
+    std::string up_spec = "";
+    std::string down_spec = "";
+    bool has_up = false;
+    bool has_down = false;
+    uint64_t seed = 1;
+
+    // Parsear opciones
+    for (int i = 4; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-u" && i + 1 < argc) {
+            up_spec = argv[++i];
+            has_up = true;
+        } else if (arg == "-d" && i + 1 < argc) {
+            down_spec = argv[++i];
+            has_down = true;
+        } else if (arg == "-s" && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            both_spec = arg;
+        }
+    }
+
+    LinkImpairmentParams up;
+    LinkImpairmentParams down;
+    try {
+        up = communication::parse_link_impairment(has_up ? up_spec : both_spec);
+        down = communication::parse_link_impairment(has_down ? down_spec : both_spec);
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] " << e.what() << std::endl;
+        return 1;
+    }
+
+    struct sockaddr_in bridge;
+    memset(&bridge, 0, sizeof(bridge));
+    bridge.sin_family = AF_INET;
+    bridge.sin_port = htons(bridge_port);
+    if (inet_pton(AF_INET, bridge_ip.c_str(), &bridge.sin_addr) <= 0) {
+        std::cerr << "[ERROR] IP inválida: " << bridge_ip << std::endl;
+        return 1;
+    }
+
+    std::cout << "========================================" << std::endl;
+    std::cout << "  IMPAIR PROXY" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "[ImpairProxy] :" << listen_port << " → " << bridge_ip << ":" << bridge_port << std::endl;
+    std::cout << "[ImpairProxy] Subida: " << communication::describe_link_impairment(up) << std::endl;
+    std::cout << "[ImpairProxy] Bajada: " << communication::describe_link_impairment(down) << std::endl;
+    std::cout << "[ImpairProxy] Semilla: " << seed << std::endl;
+
+    signal(SIGINT, signalHandler);
+
+    try {
+        ImpairProxy proxy(listen_port, bridge, up, down, seed);
+        std::cout << "[ImpairProxy] Operativo. Presiona Ctrl+C para detener" << std::endl;
+        proxy.run();
+        std::cout << "[ImpairProxy] Resumen final:" << std::endl;
+        proxy.report();
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file relabel_rewards.cpp
+ * @brief Re-etiquetado de rewards de experiencia grabada sin volver a usar el robot
+ *
+ * train_robot guarda cada transición junto con los sensores crudos que
+ * produjeron su reward (models/dqn_robot_experience.pt). Esta herramienta
+ * recalcula rewards y dones de todo el dataset con otra función de reward
+ * en una sola pasada vectorizada, para experimentar con el reward en CPU
+ * en lugar de repetir horas de conducción.
+ *
+ * Funciones de reward disponibles:
+ *   udp   - UDPEnvironment (train_robot)
+ *   lego  - LegoRobotEnv
+ *
+ * USO:
+ *   ./relabel_rewards <experience.pt> <salida.pt> [reward]
+ *
+ * EJEMPLO:
+ *   ./relabel_rewards models/dqn_robot_experience.pt models/experience_relabeled.pt udp
+ */
+
+#include <iostream>
+#include <torch/torch.h>
+#include <chrono>
+#include <limits>
+#include <string>
+
+#include "dqn/replay_buffer.h"
+#include "environment/reward_functions.h"
+
+void print_usage(const char* program) {
+    std::cout << "Uso: " << program << " <experience.pt> <salida.pt> [reward]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Argumentos:" << std::endl;
+    std::cout << "  experience.pt   Experiencia grabada por train_robot" << std::endl;
+    std::cout << "  salida.pt       Ruta de salida de la experiencia re-etiquetada" << std::endl;
+    std::cout << "  reward          Función de reward: udp | lego (default: udp)" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "=========================================================================" << std::endl;
+    std::cout << "  DQN Reward Relabeling - Experiencia grabada → nuevos rewards" << std::endl;
+    std::cout << "=========================================================================" << std::endl;
+
+    if (argc < 3) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::string input_path = argv[1];
+    std::string output_path = argv[2];
+    std::string reward_name = (argc > 3) ? argv[3] : "udp";
+
+    std::unique_ptr<environment::RewardFunction> reward_fn;
+    try {
+        reward_fn = environment::make_reward_function(reward_name);
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] " << e.what() << std::endl;
+        return 1;
+    }
+
+    // Capacidad sin límite práctico: el dataset completo entra en el buffer
+    dqn::ReplayBuffer buffer(std::numeric_limits<size_t>::max());
+    try {
+        size_t loaded = buffer.load(input_path);
+        std::cout << "[Dataset] " << loaded << " transiciones cargadas desde: " << input_path << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] No se pudo cargar la experiencia: " << e.what() << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    dqn::RelabelStats stats = buffer.relabel(*reward_fn);
+    auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "\n=========================================================================" << std::endl;
+    std::cout << "  Resultado del re-etiquetado (" << reward_fn->name() << ")" << std::endl;
+    std::cout << "=========================================================================" << std::endl;
+    std::cout << "Re-etiquetadas:       " << stats.relabeled << std::endl;
+    std::cout << "Sin sensores crudos:  " << stats.skipped << std::endl;
+    std::cout << "Reward medio:         " << stats.old_mean_reward << " -> " << stats.new_mean_reward << std::endl;
+    std::cout << "Dones modificados:    " << stats.done_changes << std::endl;
+    std::cout << "Tiempo:               " << elapsed_us << " us" << std::endl;
+
+    try {
+        buffer.save(output_path);
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] No se pudo guardar: " << e.what() << std::endl;
+        return 1;
+    }
+    std::cout << "\nExperiencia guardada en: " << output_path << std::endl;
+    std::cout << "=========================================================================" << std::endl;
+
+    return 0;
+}
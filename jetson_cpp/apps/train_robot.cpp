@@ -11,91 +11,97 @@
  * - Giroscopio en Puerto 2 del EV3
  *
  * USO:
- *   ./train_robot <laptop_ip> [num_episodes]
+ *   ./train_robot <laptop_ip|sim> [num_episodes] [checkpoint] [real|virtual] [csv|csv-tagged|binary]
+ *                 [--dyna] [--symmetry]
+ *
+ *   sim = pre-entrenamiento con SimEV3Env (robot simulado, mismo estado,
+ *         acciones y reward que el robot real). Los modelos se guardan
+ *         como models/dqn_sim_*.
+ *
+ *   Reloj: todas las esperas (reset, pausa entre acciones, reposicionado,
+ *   timeouts de episodio y del bridge) usan utils::Clock. "virtual" las
+ *   resuelve al instante (default con sim; útil también con un bridge
+ *   falso), "real" espera de verdad (default con robot).
+ *
+ *   Protocolo: csv (default, compatible con el bridge.py original),
+ *   csv-tagged (CSV con secuencia y hora de envío) o binary (paquetes de
+ *   tamaño fijo con checksum, ver communication/wire_protocol.h). Los dos
+ *   últimos descartan respuestas tardías y requieren el bridge.py actual.
+ *
+ *   Opcionales (desactivados por defecto):
+ *   --dyna      Modelo de dinámica: la mitad de cada batch sale de
+ *               transiciones imaginadas y cada paso real hace actualizaciones
+ *               extra de planificación
+ *   --symmetry  Aumentación por simetría izquierda/derecha en el muestreo
  *
  * EJEMPLO:
  *   ./train_robot 192.168.1.100 200
+ *   ./train_robot 192.168.1.100 200 models/dqn_robot_latest.pt   (reanudar)
+ *   ./train_robot sim 5000                                         (pre-entrenar)
+ *   ./train_robot 192.168.1.100 5200 models/dqn_sim_latest.pt     (afinar en el robot)
+ *   ./train_robot 127.0.0.1 200 "" virtual                          (bridge falso local)
+ *
+ * CHECKPOINTS:
+ *   models/dqn_robot_history.bin  Historial comprimido (cada 10 episodios),
+ *                                 ver ./checkpoint_tool
+ *   models/dqn_robot_latest.pt    Checkpoint reanudable con replay buffer
+ *                                 (cada 50 episodios y al terminar)
  */
 
 #include <iostream>
 #include <torch/torch.h>
 #include <memory>
-#include <sys/socket.h>
-#include <arpa/inet.h>
-#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
-#include <sstream>
 #include <vector>
 #include <cmath>
 
 #include "dqn/agent.h"
+#include "dqn/augmentation.h"
+#include "dqn/checkpoint_writer.h"
+#include "dqn/distillation.h"
+#include "dqn/dynamics_model.h"
+#include "communication/network_client.h"
+#include "communication/sensor_data.h"
+#include "communication/wire_protocol.h"
 #include "environment/environment_interface.h"
+#include "environment/reward_functions.h"
+#include "environment/sim_ev3_env.h"
+#include "utils/clock.h"
 #include "utils/logger.h"
 #include "utils/metrics.h"
 
 // ============================================================================
-// SENSOR DATA (igual que en main.cpp)
+// SENSOR DATA (compartido con main.cpp)
 // ============================================================================
 
-struct SensorData {
-    float gyro_angle;
-    float gyro_rate;
-    int touch_front;
-    int touch_side;
-    bool valid;
-
-    SensorData() : gyro_angle(0.0f), gyro_rate(0.0f),
-                   touch_front(-1), touch_side(-1), valid(false) {}
-
-    torch::Tensor toState() const {
-        torch::Tensor state = torch::zeros({4}, torch::kFloat32);
-        state[0] = std::tanh(gyro_angle / 90.0f);   // Normalizar ángulo
-        state[1] = std::tanh(gyro_rate / 180.0f);   // Normalizar velocidad angular
-        state[2] = touch_front >= 0 ? static_cast<float>(touch_front) : 0.0f;
-        state[3] = touch_side >= 0 ? static_cast<float>(touch_side) : 0.0f;
-        return state;
-    }
-};
+using communication::SensorData;
 
 // ============================================================================
 // UDP ENVIRONMENT - Comunicación con robot real vía bridge
 // ============================================================================
 
+// La E/S de red la hace el hilo epoll de communication::NetworkClient:
+// step_async() solo encola la acción (sin syscalls en el camino de control) y
+// step_poll()/step_wait() recogen la respuesta de la cola del hilo, con el
+// mismo límite de 300 ms que tenía el recvfrom bloqueante.
+// Timeouts y esperas usan el reloj inyectado (real o virtual).
 class UDPEnvironment : public environment::EnvironmentInterface {
 public:
     UDPEnvironment(const std::string& bridge_ip, int bridge_port = 5000,
-                   int max_steps = 100, int timeout_sec = 30)
+                   int max_steps = 100, int timeout_sec = 30,
+                   utils::Clock& clock = utils::real_clock(),
+                   communication::WireFormat format = communication::WireFormat::kCsv)
         : bridge_ip_(bridge_ip), bridge_port_(bridge_port),
-          max_steps_(max_steps), timeout_sec_(timeout_sec),
-          sock_fd_(-1), current_step_(0) {
+          max_steps_(max_steps), timeout_sec_(timeout_sec), clock_(&clock),
+          current_step_(0) {
 
         std::cout << "[UDPEnvironment] Conectando a " << bridge_ip << ":" << bridge_port << std::endl;
 
-        // Crear socket UDP
-        sock_fd_ = socket(AF_INET, SOCK_DGRAM, 0);
-        if (sock_fd_ < 0) {
-            throw std::runtime_error("No se pudo crear socket UDP");
-        }
-
-        // Configurar timeouts
-        struct timeval tv;
-        tv.tv_sec = 1;
-        tv.tv_usec = 0;
-        setsockopt(sock_fd_, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
-
-        struct timeval tv_recv;
-        tv_recv.tv_sec = 0;
-        tv_recv.tv_usec = 300000;  // 300ms
-        setsockopt(sock_fd_, SOL_SOCKET, SO_RCVTIMEO, &tv_recv, sizeof(tv_recv));
-
-        // Configurar dirección del bridge
-        memset(&bridge_addr_, 0, sizeof(bridge_addr_));
-        bridge_addr_.sin_family = AF_INET;
-        bridge_addr_.sin_port = htons(bridge_port);
-        if (inet_pton(AF_INET, bridge_ip.c_str(), &bridge_addr_.sin_addr) <= 0) {
-            ::close(sock_fd_);
-            throw std::runtime_error("IP inválida: " + bridge_ip);
-        }
+        // Socket no bloqueante + hilo de E/S (lanza std::runtime_error si falla)
+        client_ = std::make_unique<communication::NetworkClient>(bridge_ip, bridge_port, format);
 
         std::cout << "[UDPEnvironment] Conectado exitosamente" << std::endl;
     }
@@ -105,157 +111,160 @@ public:
     }
 
     torch::Tensor reset() override {
+        torch::Tensor state = torch::empty({4}, torch::kFloat32);
+        reset_into(state.data_ptr<float>());
+        return state;
+    }
+
+    void reset_into(float* state) override {
         std::cout << "[UDPEnvironment] Reset - Iniciando nuevo episodio" << std::endl;
+        if (step_pending()) {
+            end_step();  // Se descarta el step pendiente
+        }
         current_step_ = 0;
-        episode_start_time_ = std::chrono::steady_clock::now();
+        episode_start_time_ = clock_->now();
 
         // Enviar STOP (acción 0) para detener robot
         sendAction(0);
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        clock_->sleep_for(std::chrono::milliseconds(500));
 
         // Obtener estado inicial
-        SensorData sensors = receiveSensors();
+        SensorData sensors;
+        if (!receiveSensors(sensors, kReceiveTimeoutMs)) {
+            client_->expire_reply();
+        }
 
         if (!sensors.valid) {
             std::cerr << "[WARNING] No se recibieron sensores válidos en reset, usando ceros" << std::endl;
-            return torch::zeros({4}, torch::kFloat32);
+            std::fill(state, state + 4, 0.0f);
+            return;
         }
 
         previous_sensors_ = sensors;
-        return sensors.toState();
+        sensors.toState(state);
     }
 
     environment::StepResult step(int64_t action) override {
-        current_step_++;
-
-        // Enviar acción al bridge
-        sendAction(static_cast<int>(action));
-
-        // Recibir sensores
-        SensorData sensors = receiveSensors();
-
-        // Calcular reward
-        float reward = computeReward(sensors, action);
-
-        // Determinar si el episodio terminó
-        bool done = isEpisodeDone(sensors);
-
-        // Crear resultado
         environment::StepResult result;
-        result.next_state = sensors.valid ? sensors.toState() : torch::zeros({4}, torch::kFloat32);
-        result.reward = reward;
-        result.done = done;
+        result.next_state = torch::empty({4}, torch::kFloat32);
+        step_into(action, result.next_state.data_ptr<float>(), result.reward, result.done);
         result.info = "step=" + std::to_string(current_step_);
-
-        previous_sensors_ = sensors;
-
         return result;
     }
 
-    int64_t state_dim() const override { return 4; }
-    int64_t action_dim() const override { return 5; }  // STOP, FORWARD, LEFT, RIGHT, BACKWARD
-
-    void close() override {
-        if (sock_fd_ >= 0) {
-            // Enviar STOP final
-            sendAction(0);
-            ::close(sock_fd_);
-            sock_fd_ = -1;
-        }
-    }
-
-private:
-    void sendAction(int action) {
-        std::string msg = std::to_string(action);
-        sendto(sock_fd_, msg.c_str(), msg.length(), 0,
-               (struct sockaddr*)&bridge_addr_, sizeof(bridge_addr_));
+    // Camino sin asignaciones: sin tensores, strings ni vectores por step
+    void step_into(int64_t action, float* next_state, float& reward, bool& done,
+                   environment::StepInfo* info = nullptr) override {
+        step_async(action);
+        step_wait(next_state, reward, done, info);
     }
 
-    SensorData receiveSensors() {
-        SensorData data;
-        char buffer[256];
-        memset(buffer, 0, sizeof(buffer));
-
-        struct sockaddr_in from_addr;
-        socklen_t from_len = sizeof(from_addr);
+    void step_async(int64_t action) override {
+        begin_step(action);
+        current_step_++;
 
-        ssize_t received = recvfrom(sock_fd_, buffer, sizeof(buffer) - 1, 0,
-                                    (struct sockaddr*)&from_addr, &from_len);
+        // Enviar acción al bridge; la respuesta se recoge en step_poll/step_wait
+        sendAction(static_cast<int>(action));
+        response_ = SensorData();
+        response_ready_ = false;
+        response_deadline_ = clock_->now() +
+                             std::chrono::milliseconds(kReceiveTimeoutMs);
+    }
 
-        if (received < 0) {
-            return data;  // valid = false
+    bool step_poll(int timeout_ms = 0) override {
+        if (!step_pending()) {
+            return false;
+        }
+        if (response_ready_) {
+            return true;
         }
 
-        buffer[received] = '\0';
-        std::string response(buffer);
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            response_deadline_ - clock_->now()).count();
+        int wait_ms = static_cast<int>(std::max<int64_t>(0, std::min<int64_t>(timeout_ms, remaining)));
 
-        if (parseSensorData(response, data)) {
-            data.valid = true;
+        if (receiveSensors(response_, wait_ms)) {
+            response_ready_ = true;
+        } else if (clock_->now() >= response_deadline_) {
+            client_->expire_reply();  // Timeout: sensores no válidos, respuesta perdida
+            response_ready_ = true;
         }
-
-        return data;
+        return response_ready_;
     }
 
-    bool parseSensorData(const std::string& csv, SensorData& data) {
-        std::istringstream ss(csv);
-        std::string token;
-        std::vector<std::string> tokens;
-
-        while (std::getline(ss, token, ',')) {
-            tokens.push_back(token);
+    void step_wait(float* next_state, float& reward, bool& done,
+                   environment::StepInfo* info = nullptr) override {
+        while (!step_poll(kReceiveTimeoutMs)) {
+        }
+        const int64_t action = end_step();
+        const SensorData& sensors = response_;
+
+        // Calcular reward y fin de episodio con la función de reward
+        // (los sensores crudos se guardan para poder re-etiquetar offline)
+        bool truncated = isEpisodeDone();
+        last_record_ = environment::make_sensor_record(sensors, truncated);
+        done = false;
+        reward = reward_fn_.compute_one(last_record_, action, done);
+        if (done && !truncated) {
+            logTerminal(sensors);
         }
 
-        if (tokens.size() != 4) return false;
+        if (sensors.valid) {
+            sensors.toState(next_state);
+        } else {
+            std::fill(next_state, next_state + 4, 0.0f);
+        }
 
-        try {
-            data.gyro_angle = std::stof(tokens[0]);
-            data.gyro_rate = std::stof(tokens[1]);
-            data.touch_front = std::stoi(tokens[2]);
-            data.touch_side = std::stoi(tokens[3]);
-            return true;
-        } catch (...) {
-            return false;
+        if (info != nullptr) {
+            info->step = current_step_;
+            info->truncated = truncated;
+            info->collision = sensors.valid && (sensors.touch_front == 1 || sensors.touch_side == 1);
+            info->reply_lost = !sensors.valid;
+            info->rtt_ms = sensors.valid ? client_->tracker().last_rtt_ms() : 0.0;
         }
-    }
 
-    float computeReward(const SensorData& sensors, int64_t action) {
-        if (!sensors.valid) return -1.0f;
+        previous_sensors_ = sensors;
+    }
 
-        float reward = 0.0f;
+    int64_t state_dim() const override { return 4; }
+    int64_t action_dim() const override { return 5; }  // STOP, FORWARD, LEFT, RIGHT, BACKWARD
 
-        // Penalización por colisión (máxima prioridad)
-        if (sensors.touch_front == 1 || sensors.touch_side == 1) {
-            return -10.0f;  // Terminal
-        }
+    // Sensores crudos del último step (para almacenar junto a la transición)
+    const environment::SensorRecord& lastSensorRecord() const { return last_record_; }
 
-        // Recompensa por mantener estabilidad (gyro cerca de 0)
-        float gyro_magnitude = std::abs(sensors.gyro_angle);
-        if (gyro_magnitude < 15.0f) {
-            reward += 1.0f;  // Recompensa por estar estable
-        } else if (gyro_magnitude > 45.0f) {
-            reward -= 0.5f;  // Penalización por inclinación excesiva
-        }
+    // Emparejamiento acción/respuesta: RTT, pérdidas y respuestas tardías descartadas
+    const communication::RequestTracker& tracker() const { return client_->tracker(); }
 
-        // Recompensa por acción FORWARD (movimiento proactivo)
-        if (action == 1) {  // FORWARD
-            reward += 0.5f;
+    void close() override {
+        if (client_) {
+            // Enviar STOP final (el destructor del cliente vacía la cola antes de cerrar)
+            sendAction(0);
+            client_.reset();
         }
+    }
 
-        // Penalización por STOP prolongado (evitar inactividad)
-        if (action == 0) {  // STOP
-            reward -= 0.1f;
+private:
+    void sendAction(int action) {
+        // Encola la acción con su secuencia; lo pendiente en la cola de
+        // respuestas (acciones ya vencidas) se descarta
+        if (!client_->send_action(action)) {
+            std::cerr << "[WARNING] Cola de acciones llena, acción descartada" << std::endl;
         }
-
-        return reward;
     }
 
-    bool isEpisodeDone(const SensorData& sensors) {
-        // Colisión detectada
-        if (sensors.valid && (sensors.touch_front == 1 || sensors.touch_side == 1)) {
-            std::cout << "[Episode Done] Colisión detectada" << std::endl;
+    // Espera hasta timeout_ms la respuesta a la acción en curso. Devuelve
+    // false si no llegó (data queda sin modificar).
+    bool receiveSensors(SensorData& data, int timeout_ms) {
+        if (client_->wait_reply(data, timeout_ms)) {
             return true;
         }
+        clock_->elapsed_outside(std::chrono::milliseconds(timeout_ms));
+        return false;
+    }
 
+    // Truncamiento (límite de pasos o de tiempo). Colisión e inclinación
+    // extrema son terminales y los decide la función de reward.
+    bool isEpisodeDone() {
         // Máximo de pasos alcanzado
         if (current_step_ >= max_steps_) {
             std::cout << "[Episode Done] Máximo de pasos alcanzado" << std::endl;
@@ -263,7 +272,7 @@ private:
         }
 
         // Timeout de tiempo real
-        auto now = std::chrono::steady_clock::now();
+        auto now = clock_->now();
         auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
             now - episode_start_time_).count();
         if (elapsed >= timeout_sec_) {
@@ -271,25 +280,40 @@ private:
             return true;
         }
 
-        // Inclinación extrema (robot cayó)
-        if (sensors.valid && std::abs(sensors.gyro_angle) > 60.0f) {
+        return false;
+    }
+
+    // Motivo de un fin de episodio terminal decidido por la función de reward
+    void logTerminal(const SensorData& sensors) const {
+        if (sensors.valid && (sensors.touch_front == 1 || sensors.touch_side == 1)) {
+            std::cout << "[Episode Done] Colisión detectada" << std::endl;
+        } else if (sensors.valid && std::abs(sensors.gyro_angle) > reward_fn_.params().fall_angle_deg) {
             std::cout << "[Episode Done] Inclinación extrema: " << sensors.gyro_angle << "°" << std::endl;
-            return true;
+        } else {
+            std::cout << "[Episode Done] Estado terminal" << std::endl;
         }
-
-        return false;
     }
 
+    static constexpr int kReceiveTimeoutMs = 300;
+
     std::string bridge_ip_;
     int bridge_port_;
     int max_steps_;
     int timeout_sec_;
-    int sock_fd_;
-    struct sockaddr_in bridge_addr_;
+    utils::Clock* clock_;
+    std::unique_ptr<communication::NetworkClient> client_;
 
     int current_step_;
-    std::chrono::steady_clock::time_point episode_start_time_;
+    utils::Clock::time_point episode_start_time_;
     SensorData previous_sensors_;
+
+    // Step en curso (step_async -> step_wait)
+    SensorData response_;
+    bool response_ready_ = false;
+    utils::Clock::time_point response_deadline_;
+
+    environment::UDPRobotReward reward_fn_;
+    environment::SensorRecord last_record_;
 };
 
 // ============================================================================
@@ -297,14 +321,24 @@ private:
 // ============================================================================
 
 void print_usage(const char* program) {
-    std::cout << "Uso: " << program << " <laptop_ip> [num_episodes]" << std::endl;
+    std::cout << "Uso: " << program << " <laptop_ip|sim> [num_episodes] [checkpoint] [real|virtual] [csv|csv-tagged|binary]" << std::endl;
     std::cout << std::endl;
     std::cout << "Argumentos:" << std::endl;
-    std::cout << "  laptop_ip       IP de la laptop con el bridge" << std::endl;
+    std::cout << "  laptop_ip       IP de la laptop con el bridge, o 'sim' para el robot simulado" << std::endl;
     std::cout << "  num_episodes    Número de episodios (default: 100)" << std::endl;
+    std::cout << "  checkpoint      Checkpoint de entrenamiento para reanudar (opcional, \"\" = ninguno)" << std::endl;
+    std::cout << "  reloj           real = esperas de verdad, virtual = instantáneas" << std::endl;
+    std::cout << "                  (default: virtual con sim, real con robot)" << std::endl;
+    std::cout << "  protocolo       csv (default) | csv-tagged | binary" << std::endl;
+    std::cout << "  --dyna          Activar Dyna (transiciones imaginadas con un modelo de dinámica)" << std::endl;
+    std::cout << "  --symmetry      Activar la aumentación por simetría izquierda/derecha" << std::endl;
     std::cout << std::endl;
     std::cout << "Ejemplo:" << std::endl;
     std::cout << "  " << program << " 192.168.1.100 200" << std::endl;
+    std::cout << "  " << program << " sim 5000" << std::endl;
+    std::cout << "  " << program << " 127.0.0.1 200 \"\" virtual" << std::endl;
+    std::cout << "  " << program << " 127.0.0.1 200 \"\" virtual binary" << std::endl;
+    std::cout << "  " << program << " sim 5000 --dyna --symmetry" << std::endl;
 }
 
 int main(int argc, char* argv[]) {
@@ -313,7 +347,26 @@ int main(int argc, char* argv[]) {
     std::cout << "  Entrenamiento con sensores y acciones reales" << std::endl;
     std::cout << "=========================================================================" << std::endl;
 
-    // Parsear argumentos
+    // Parsear argumentos (las opciones --x pueden ir en cualquier posición)
+    bool use_dyna = false;
+    bool use_symmetry = false;
+    int positional = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--dyna") {
+            use_dyna = true;
+        } else if (arg == "--symmetry") {
+            use_symmetry = true;
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "[ERROR] Opción desconocida: " << arg << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        } else {
+            argv[positional++] = argv[i];
+        }
+    }
+    argc = positional;
+
     if (argc < 2) {
         print_usage(argv[0]);
         return 1;
@@ -321,21 +374,59 @@ int main(int argc, char* argv[]) {
 
     std::string laptop_ip = argv[1];
     int num_episodes = (argc > 2) ? std::atoi(argv[2]) : 100;
+    std::string resume_path = (argc > 3) ? argv[3] : "";
     int max_steps_per_episode = 100;
+    const bool simulated = (laptop_ip == "sim");
+    const std::string model_prefix = simulated ? "models/dqn_sim" : "models/dqn_robot";
+
+    // Reloj para timeouts y esperas (virtual = sin esperas reales)
+    std::string clock_name = (argc > 4) ? argv[4] : (simulated ? "virtual" : "real");
+    std::unique_ptr<utils::Clock> clock;
+    communication::WireFormat wire_format;
+    try {
+        clock = utils::make_clock(clock_name);
+        wire_format = communication::parse_wire_format((argc > 5) ? argv[5] : "csv");
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] " << e.what() << std::endl;
+        print_usage(argv[0]);
+        return 1;
+    }
+    const bool virtual_time = (clock->name() == "virtual");
 
     std::cout << "Configuración:" << std::endl;
-    std::cout << "  Laptop IP: " << laptop_ip << std::endl;
+    std::cout << "  Laptop IP: " << (simulated ? "(robot simulado)" : laptop_ip) << std::endl;
     std::cout << "  Episodios: " << num_episodes << std::endl;
     std::cout << "  Max steps por episodio: " << max_steps_per_episode << std::endl;
+    std::cout << "  Reloj: " << clock->name() << std::endl;
+    std::cout << "  Dyna: " << (use_dyna ? "sí" : "no")
+              << ", simetría: " << (use_symmetry ? "sí" : "no") << std::endl;
+    if (!simulated) {
+        std::cout << "  Protocolo: " << communication::wire_format_name(wire_format) << std::endl;
+    }
     std::cout << "=========================================================================" << std::endl;
 
     // Device
     torch::Device device(torch::cuda::is_available() ? torch::kCUDA : torch::kCPU);
     std::cout << "[Device] " << device << std::endl;
 
-    // Crear entorno UDP (conecta con robot real)
-    std::cout << "\n[Environment] Creando entorno UDP para robot real..." << std::endl;
-    auto env = std::make_unique<UDPEnvironment>(laptop_ip, 5000, max_steps_per_episode, 30);
+    // Crear entorno: UDP (conecta con robot real) o robot simulado.
+    // sensor_record apunta a los sensores crudos del último step de cualquiera de los dos.
+    std::unique_ptr<environment::EnvironmentInterface> env;
+    const environment::SensorRecord* sensor_record = nullptr;
+    if (simulated) {
+        std::cout << "\n[Environment] Creando robot EV3 simulado (SimEV3Env)..." << std::endl;
+        environment::SimEV3Params sim_params;
+        sim_params.max_steps = max_steps_per_episode;
+        auto sim_env = std::make_unique<environment::SimEV3Env>(sim_params);
+        sensor_record = &sim_env->last_sensor_record();
+        env = std::move(sim_env);
+    } else {
+        std::cout << "\n[Environment] Creando entorno UDP para robot real..." << std::endl;
+        auto udp_env = std::make_unique<UDPEnvironment>(laptop_ip, 5000, max_steps_per_episode, 30, *clock,
+                                                        wire_format);
+        sensor_record = &udp_env->lastSensorRecord();
+        env = std::move(udp_env);
+    }
 
     // Crear agente DQN
     dqn::Hyperparameters params;
@@ -349,12 +440,56 @@ int main(int argc, char* argv[]) {
     params.target_update_freq = 5;
     params.hidden_dim1 = 128;
     params.hidden_dim2 = 128;
+    if (use_dyna) {
+        params.synthetic_ratio = 0.5f;   // Mitad del batch con transiciones imaginadas
+    }
 
     std::cout << "[Agent] Creando DQN agent..." << std::endl;
     dqn::DQNAgent agent(env->state_dim(), env->action_dim(), params, device);
 
+    // Aumentación por simetría izquierda/derecha (giroscopio con signo
+    // invertido, TURN_LEFT <-> TURN_RIGHT): duplica los datos útiles por paso
+    if (use_symmetry) {
+        agent.get_replay_buffer().set_augmentation(std::make_shared<dqn::SymmetryAugmentation>(
+            dqn::MirrorSymmetry::ev3_left_right(), env->state_dim(), 0.5f));
+    }
+
+    // Modelo de dinámica (Dyna): cada paso real alimenta varias actualizaciones.
+    // Se entrena con las transiciones reales tal cual (sin simetría)
+    std::unique_ptr<dqn::DynaPlanner> planner;
+    int64_t planning_steps = 0;
+    if (use_dyna) {
+        dqn::DynaConfig dyna_config;
+        dyna_config.project_state = [](const torch::Tensor& s) {
+            // Giroscopio acotado por tanh, contactos binarios
+            torch::Tensor gyro = s.slice(1, 0, 2).clamp(-1.0f, 1.0f);
+            torch::Tensor touch = (s.slice(1, 2, 4) > 0.5f).to(s.dtype());
+            return torch::cat({gyro, touch}, 1);
+        };
+        planning_steps = dyna_config.planning_steps_per_step;
+        planner = std::make_unique<dqn::DynaPlanner>(env->state_dim(), env->action_dim(),
+                                                     dyna_config, device);
+    }
+
+    // Historial de checkpoints (keyframes + deltas comprimidos en un archivo)
+    // Si el archivo existente no es legible se aparta y se empieza uno nuevo
+    const std::string history_path = model_prefix + "_history.bin";
+    std::unique_ptr<dqn::CheckpointHistory> history_file;
+    try {
+        history_file = std::make_unique<dqn::CheckpointHistory>(history_path);
+    } catch (const std::exception& e) {
+        const std::string aside_path = history_path + ".corrupt";
+        std::cerr << "[WARNING] " << e.what() << "; se mueve a " << aside_path << std::endl;
+        std::rename(history_path.c_str(), aside_path.c_str());
+        history_file = std::make_unique<dqn::CheckpointHistory>(history_path);
+    }
+    dqn::CheckpointHistory& history = *history_file;
+
+    // Checkpoints en segundo plano (el loop nunca espera al disco)
+    dqn::AsyncCheckpointWriter checkpoint_writer;
+
     // Logger y métricas
-    utils::Logger logger("robot_training.log");
+    utils::Logger logger(simulated ? "sim_training.log" : "robot_training.log");
     utils::MetricsTracker metrics;
 
     std::cout << "\n[Training] Iniciando entrenamiento con robot real..." << std::endl;
@@ -363,48 +498,123 @@ int main(int argc, char* argv[]) {
     std::cout << "=========================================================================" << std::endl;
 
     float best_reward = -1000.0f;
+    int first_episode = 1;
+    const std::string latest_path = model_prefix + "_latest.pt";
+
+    // Reanudar: redes, Adam, epsilon, contadores, RNG, replay buffers y modelo Dyna
+    if (!resume_path.empty()) {
+        try {
+            dqn::TrainingCheckpoint checkpoint = dqn::TrainingCheckpoint::load(resume_path);
+            agent.restore(checkpoint);
+            if (planner && !planner->restore(checkpoint)) {
+                std::cerr << "[WARNING] El checkpoint no incluye el modelo de dinámica: "
+                          << "Dyna se reentrena desde cero" << std::endl;
+            }
+            first_episode = static_cast<int>(checkpoint.counter("episode", 0.0)) + 1;
+            best_reward = static_cast<float>(checkpoint.counter("best_reward", best_reward));
+            std::cout << "[Resume] Reanudando desde episodio " << first_episode
+                      << " (epsilon=" << agent.get_epsilon()
+                      << ", buffer=" << agent.get_replay_buffer().size() << ")" << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] No se pudo cargar el checkpoint: " << e.what() << std::endl;
+            return 1;
+        }
+    }
 
     // Training loop
-    for (int episode = 1; episode <= num_episodes; ++episode) {
+    const utils::Clock::time_point clock_start = clock->now();
+    const auto wall_start = std::chrono::steady_clock::now();
+    for (int episode = first_episode; episode <= num_episodes; ++episode) {
         std::cout << "\n--- Episodio " << episode << "/" << num_episodes << " ---" << std::endl;
 
-        torch::Tensor state = env->reset();
+        // Estados preasignados: el entorno escribe en ellos sin crear tensores
+        torch::Tensor state = torch::empty({4}, torch::kFloat32);
+        torch::Tensor next_state = torch::empty({4}, torch::kFloat32);
+        env->reset_into(state.data_ptr<float>());
         float episode_reward = 0.0f;
         float episode_loss = 0.0f;
         int loss_count = 0;
         int step = 0;
+        double io_wait_ms = 0.0;  // Tiempo bloqueado esperando al robot
+        int replies_lost = 0;     // Steps sin respuesta emparejada (no se almacenan)
+        int replies_matched = 0;
+        double rtt_sum_ms = 0.0;
 
         for (step = 0; step < max_steps_per_episode; ++step) {
             // Seleccionar acción
             int64_t action = agent.select_action(state, true);
 
-            // Ejecutar en entorno real
-            auto result = env->step(action);
-
-            // Almacenar transición
-            agent.store_transition(state, action, result.reward, result.next_state, result.done);
+            // Enviar la acción al robot sin esperar la respuesta
+            env->step_async(action);
+
+            // Entrenar mientras el robot ejecuta la acción (1 actualización
+            // real + pasos de planificación con Dyna). La transición de
+            // este paso entra en el buffer al recoger el resultado.
+            for (int64_t k = 0; k <= planning_steps; ++k) {
+                float loss = agent.train_step();
+                if (loss >= 0.0f) {
+                    episode_loss += loss;
+                    loss_count++;
+                }
+            }
 
-            // Entrenar
-            float loss = agent.train_step();
-            if (loss >= 0.0f) {
-                episode_loss += loss;
-                loss_count++;
+            // Recoger el resultado (solo bloquea lo que el entrenamiento no cubrió)
+            auto wait_start = std::chrono::steady_clock::now();
+            float reward = 0.0f;
+            bool done = false;
+            environment::StepInfo info;
+            env->step_wait(next_state.data_ptr<float>(), reward, done, &info);
+            io_wait_ms += std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - wait_start).count();
+
+            // Sin respuesta emparejada no hay siguiente estado real: la
+            // transición no se almacena y se sigue desde el último estado
+            // conocido. El step cuenta igual para los límites del episodio.
+            if (info.reply_lost) {
+                replies_lost++;
+                if (!virtual_time) {
+                    std::cout << "  Step " << (step + 1) << ": sin respuesta del robot, transición descartada" << std::endl;
+                }
+                if (done || info.truncated) {
+                    std::cout << "  Episodio terminado después de " << (step + 1)
+                              << " pasos (límite alcanzado sin respuesta)" << std::endl;
+                    break;
+                }
+                clock->sleep_for(std::chrono::milliseconds(200));
+                continue;
             }
+            replies_matched++;
+            rtt_sum_ms += info.rtt_ms;
 
-            state = result.next_state;
-            episode_reward += result.reward;
+            // Almacenar transición (el replay buffer copia los estados)
+            agent.store_transition(state, action, reward, next_state, done,
+                                   *sensor_record);
 
-            std::cout << "  Step " << (step + 1) << ": action=" << action
-                      << ", reward=" << result.reward
-                      << ", total=" << episode_reward << std::endl;
+            std::swap(state, next_state);
+            episode_reward += reward;
 
-            if (result.done) {
+            if (!virtual_time) {
+                std::cout << "  Step " << (step + 1) << ": action=" << action
+                          << ", reward=" << reward
+                          << ", total=" << episode_reward << std::endl;
+            }
+
+            if (done) {
                 std::cout << "  Episodio terminado después de " << (step + 1) << " pasos" << std::endl;
                 break;
             }
 
             // Pequeña pausa entre acciones (seguridad)
-            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            clock->sleep_for(std::chrono::milliseconds(200));
+        }
+
+        // Dyna: reajustar el modelo y generar rollouts imaginados
+        float model_loss = planner ? planner->train_model(agent.get_replay_buffer()) : -1.0f;
+        if (model_loss >= 0.0f) {
+            size_t imagined = planner->generate_rollouts(agent.get_replay_buffer(), agent,
+                                                         agent.get_synthetic_buffer());
+            std::cout << "[Dyna] model_loss=" << model_loss
+                      << ", transiciones imaginadas=" << imagined << std::endl;
         }
 
         // Decay epsilon
@@ -425,41 +635,105 @@ int main(int argc, char* argv[]) {
 
         std::cout << "Resultado: reward=" << episode_reward
                   << ", epsilon=" << agent.get_epsilon()
-                  << ", avg_loss=" << avg_loss << std::endl;
+                  << ", avg_loss=" << avg_loss
+                  << ", espera_robot=" << io_wait_ms << " ms" << std::endl;
+        if (!simulated) {
+            std::cout << "Enlace: rtt_medio=" << (replies_matched > 0 ? rtt_sum_ms / replies_matched : 0.0)
+                      << " ms, respuestas_perdidas=" << replies_lost << std::endl;
+        }
 
         // Guardar mejor modelo
         if (episode_reward > best_reward) {
             best_reward = episode_reward;
-            std::string best_path = "models/dqn_robot_best.pt";
-            agent.save(best_path);
+            std::string best_path = model_prefix + "_best.pt";
+            checkpoint_writer.submit(agent.snapshot(), best_path);
             std::cout << "[CHECKPOINT] Nuevo mejor modelo guardado: " << best_path
                       << " (reward=" << best_reward << ")" << std::endl;
         }
 
-        // Guardar checkpoint cada 10 episodios
+        // Historial cada 10 episodios; checkpoint reanudable cada 50
         if (episode % 10 == 0) {
-            std::string checkpoint_path = "models/dqn_robot_checkpoint_" + std::to_string(episode) + ".pt";
-            agent.save(checkpoint_path);
+            dqn::TrainingCheckpoint snapshot = agent.snapshot(episode % 50 == 0);
+            snapshot.counters = {{"episode", episode}, {"best_reward", best_reward}};
+            if (snapshot.has_replay) {
+                if (planner) {
+                    planner->snapshot_into(snapshot);
+                }
+                checkpoint_writer.submit(snapshot, latest_path);
+            }
+            checkpoint_writer.submit(std::move(snapshot), history);
             float mean_reward = metrics.get_mean_reward(std::min(10, episode));
             std::cout << "[CHECKPOINT] Episodio " << episode
                       << " | Reward medio (10 eps): " << mean_reward << std::endl;
         }
 
         // Pausa entre episodios para reposicionar robot manualmente
-        std::cout << "\n[PAUSA] Reposiciona el robot si es necesario. Siguiente episodio en 5s..." << std::endl;
-        std::this_thread::sleep_for(std::chrono::seconds(5));
+        if (!virtual_time) {
+            std::cout << "\n[PAUSA] Reposiciona el robot si es necesario. Siguiente episodio en 5s..." << std::endl;
+        }
+        clock->sleep_for(std::chrono::seconds(5));
+    }
+
+    // Con reloj virtual: tiempo de robot cubierto frente al tiempo real empleado
+    if (virtual_time) {
+        double robot_sec = clock->seconds_since(clock_start);
+        double wall_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+        std::cout << "\n[Clock] Tiempo virtual: " << robot_sec << " s en " << wall_sec << " s reales ("
+                  << robot_sec / std::max(wall_sec, 1e-9) << "x)" << std::endl;
     }
 
-    // Guardar modelo final
-    std::string final_path = "models/dqn_robot_final.pt";
+    // Esperar checkpoints pendientes y guardar modelo final
+    std::string final_path = model_prefix + "_final.pt";
     agent.save(final_path);
+    dqn::TrainingCheckpoint final_snapshot = agent.snapshot(true);
+    final_snapshot.counters = {{"episode", num_episodes}, {"best_reward", best_reward}};
+    if (planner) {
+        planner->snapshot_into(final_snapshot);
+    }
+    checkpoint_writer.submit(std::move(final_snapshot), latest_path);
+    checkpoint_writer.flush();
+
+    // Guardar experiencia con sensores crudos (re-etiquetable con relabel_rewards)
+    std::string experience_path = model_prefix + "_experience.pt";
+    if (agent.get_replay_buffer().size() > 0) {
+        agent.get_replay_buffer().save(experience_path);
+    }
+
+    // Destilar student pequeño para inferencia en jetson_dqn (-s)
+    // Estados: experiencia real del replay buffer + cobertura aleatoria
+    std::string student_path = model_prefix + "_student.pt";
+    torch::Tensor distill_states = dqn::sample_robot_states(20000);
+    torch::Tensor buffer_states = agent.get_replay_buffer().all_states();
+    if (buffer_states.defined()) {
+        distill_states = torch::cat({buffer_states.cpu(), distill_states}, 0);
+    }
+
+    // Separar estados de evaluación (no vistos durante la destilación)
+    torch::Tensor perm = torch::randperm(distill_states.size(0));
+    int64_t num_eval = std::max<int64_t>(1, distill_states.size(0) / 10);
+    torch::Tensor eval_states = distill_states.index_select(0, perm.slice(0, 0, num_eval));
+    torch::Tensor train_states = distill_states.index_select(0, perm.slice(0, num_eval));
+
+    dqn::PolicyDistiller distiller(agent.get_q_network(), dqn::DistillationConfig(), device);
+    dqn::StudentNetwork student = distiller.distill(train_states);
+    dqn::DistillationReport report = distiller.evaluate(student, eval_states);
+    std::cout << "[Distillation] Acuerdo de acción (estados no vistos): " << (report.agreement_rate * 100.0f)
+              << "% | Latencia: " << report.teacher_latency_us << " us -> "
+              << report.student_latency_us << " us" << std::endl;
+    student->to(torch::kCPU);
+    dqn::save_student(student, student_path);
 
     std::cout << "\n=========================================================================" << std::endl;
     std::cout << "  Entrenamiento completado" << std::endl;
     std::cout << "=========================================================================" << std::endl;
     std::cout << "Modelos guardados:" << std::endl;
-    std::cout << "  - Mejor: models/dqn_robot_best.pt (reward=" << best_reward << ")" << std::endl;
+    std::cout << "  - Mejor: " << model_prefix << "_best.pt (reward=" << best_reward << ")" << std::endl;
     std::cout << "  - Final: " << final_path << std::endl;
+    std::cout << "  - Reanudable: " << latest_path << std::endl;
+    std::cout << "  - Historial: " << history_path << " (" << history.size() << " entradas, "
+              << history.file_bytes() / 1024 << " KB)" << std::endl;
+    std::cout << "  - Student: " << student_path << std::endl;
+    std::cout << "  - Experiencia: " << experience_path << std::endl;
     std::cout << "=========================================================================" << std::endl;
 
     return 0;
@@ -4,14 +4,33 @@
  *
  * Prueba el algoritmo DQN usando CartPole simulado.
  * NO requiere Bluetooth ni robot Lego.
+ *
+ * El loop está escrito una sola vez sobre BatchedEnvironmentInterface:
+ * con num_envs > 1 se simulan varios CartPole en paralelo y se hace un
+ * train_step por step del batch.
+ *
+ * USO:
+ *   ./train_simulation [num_episodes] [num_envs] [scalar|vector|pool]
+ *
+ *   scalar = N CartPoleEnv envueltos con ScalarEnvAdapter (default; con
+ *            num_envs = 1 es el CartPoleEnv de siempre)
+ *   vector = VectorCartPoleEnv (kernel SIMD)
+ *   pool   = N CartPoleEnv repartidos entre hilos con EnvPool
  */
 
 #include <iostream>
 #include <torch/torch.h>
+#include <algorithm>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "dqn/agent.h"
+#include "dqn/checkpoint_writer.h"
+#include "environment/batched_environment.h"
 #include "environment/cartpole_env.h"
+#include "environment/env_pool.h"
+#include "environment/vector_cartpole_env.h"
 #include "utils/logger.h"
 #include "utils/metrics.h"
 
@@ -23,15 +42,32 @@ int main(int argc, char* argv[]) {
 
     // Configuración
     int num_episodes = (argc > 1) ? std::atoi(argv[1]) : 500;
+    int64_t num_envs = (argc > 2) ? std::max(1, std::atoi(argv[2])) : 1;
+    std::string env_kind = (argc > 3) ? argv[3] : "scalar";
     int max_steps = 500;
 
     // Device
     torch::Device device(torch::cuda::is_available() ? torch::kCUDA : torch::kCPU);
     std::cout << "[Device] " << device << std::endl;
 
+    if (env_kind != "scalar" && env_kind != "vector" && env_kind != "pool") {
+        std::cerr << "[ERROR] Entorno desconocido: " << env_kind
+                  << " (usa scalar, vector o pool)" << std::endl;
+        return 1;
+    }
+
     // Crear entorno SIMULADO (sin Bluetooth)
-    std::cout << "[Environment] Creando entorno CartPole simulado..." << std::endl;
-    auto env = std::make_unique<environment::CartPoleEnv>(max_steps);
+    std::cout << "[Environment] Creando " << num_envs << " entorno(s) CartPole simulado(s) ("
+              << env_kind << ")..." << std::endl;
+    std::unique_ptr<environment::BatchedEnvironmentInterface> env;
+    auto cartpole_factory = [max_steps]() { return std::make_unique<environment::CartPoleEnv>(max_steps); };
+    if (env_kind == "vector") {
+        env = std::make_unique<environment::VectorCartPoleEnv>(num_envs, max_steps);
+    } else if (env_kind == "pool") {
+        env = std::make_unique<environment::EnvPool>(cartpole_factory, num_envs);
+    } else {
+        env = std::make_unique<environment::ScalarEnvAdapter>(cartpole_factory, num_envs);
+    }
 
     // Crear agente DQN
     dqn::Hyperparameters params;
@@ -49,6 +85,9 @@ int main(int argc, char* argv[]) {
     std::cout << "[Agent] Creando DQN agent..." << std::endl;
     dqn::DQNAgent agent(env->state_dim(), env->action_dim(), params, device);
 
+    // Checkpoints en segundo plano (el loop nunca espera al disco)
+    dqn::AsyncCheckpointWriter checkpoint_writer;
+
     // Logger y métricas
     utils::Logger logger("simulation_training.log");
     utils::MetricsTracker metrics;
@@ -58,31 +97,22 @@ int main(int argc, char* argv[]) {
     std::cout << "  Objetivo: Recompensa promedio >= 195" << std::endl;
     std::cout << "=========================================================================" << std::endl;
 
-    // Training loop
-    for (int episode = 1; episode <= num_episodes; ++episode) {
-        torch::Tensor state = env->reset();
-        float episode_reward = 0.0f;
-        float episode_loss = 0.0f;
-        int loss_count = 0;
-
-        for (int step = 0; step < max_steps; ++step) {
-            int64_t action = agent.select_action(state, true);
-            auto result = env->step(action);
-
-            agent.store_transition(state, action, result.reward, result.next_state, result.done);
-
-            float loss = agent.train_step();
-            if (loss >= 0.0f) {
-                episode_loss += loss;
-                loss_count++;
-            }
-
-            state = result.next_state;
-            episode_reward += result.reward;
-
-            if (result.done) break;
-        }
-
+    // Buffers del batch (se reutilizan en cada step)
+    torch::Tensor states = env->make_observations();
+    torch::Tensor next_states = env->make_observations();
+    torch::Tensor rewards = env->make_scalars();
+    torch::Tensor dones = env->make_scalars();
+    env->reset_all(states);
+
+    std::vector<float> episode_rewards(num_envs, 0.0f);
+    float episode_loss = 0.0f;
+    int loss_count = 0;
+    int episode = 0;
+    bool solved = false;
+
+    // Cierre de un episodio de cualquiera de los entornos
+    auto finish_episode = [&](float episode_reward) {
+        ++episode;
         agent.decay_epsilon();
 
         if (episode % params.target_update_freq == 0) {
@@ -90,6 +120,8 @@ int main(int argc, char* argv[]) {
         }
 
         float avg_loss = (loss_count > 0) ? (episode_loss / loss_count) : 0.0f;
+        episode_loss = 0.0f;
+        loss_count = 0;
         metrics.record_episode(episode_reward);
         if (avg_loss > 0.0f) metrics.record_loss(avg_loss);
 
@@ -101,7 +133,7 @@ int main(int argc, char* argv[]) {
 
             // Guardar mejor modelo
             if (metrics.is_best_reward(episode_reward)) {
-                agent.save("models/dqn_simulation_best.pt");
+                checkpoint_writer.submit(agent.snapshot(), "models/dqn_simulation_best.pt");
             }
         }
 
@@ -111,12 +143,49 @@ int main(int argc, char* argv[]) {
             if (mean_reward >= 195.0f) {
                 std::cout << "\n🎉 RESUELTO en episodio " << episode << "!" << std::endl;
                 std::cout << "   Recompensa promedio: " << mean_reward << std::endl;
-                break;
+                solved = true;
             }
         }
+    };
+
+    // Training loop
+    while (episode < num_episodes && !solved) {
+        torch::Tensor actions = agent.select_actions(states, true);
+        env->step_batch(actions, next_states, rewards, dones);
+
+        const int64_t* action_ptr = actions.data_ptr<int64_t>();
+        const float* reward_ptr = rewards.data_ptr<float>();
+        const float* done_ptr = dones.data_ptr<float>();
+        bool any_done = false;
+
+        for (int64_t i = 0; i < num_envs; ++i) {
+            agent.store_transition(states[i], action_ptr[i], reward_ptr[i], next_states[i], done_ptr[i] != 0.0f);
+            episode_rewards[i] += reward_ptr[i];
+        }
+
+        float loss = agent.train_step();
+        if (loss >= 0.0f) {
+            episode_loss += loss;
+            loss_count++;
+        }
+
+        for (int64_t i = 0; i < num_envs && episode < num_episodes && !solved; ++i) {
+            if (done_ptr[i] != 0.0f) {
+                any_done = true;
+                finish_episode(episode_rewards[i]);
+                episode_rewards[i] = 0.0f;
+            }
+        }
+
+        // Nuevos episodios en las filas terminadas; next_states pasa a ser el estado actual
+        if (any_done) {
+            env->reset_where(dones, next_states);
+        }
+        std::swap(states, next_states);
     }
 
-    // Guardar modelo final
+    // Esperar checkpoints pendientes y guardar modelo final
+    checkpoint_writer.flush();
     agent.save("models/dqn_simulation_final.pt");
     metrics.save_to_file("simulation_metrics.csv");
 
@@ -0,0 +1,114 @@
+#ifndef COMMUNICATION_LINK_IMPAIRMENT_H
+#define COMMUNICATION_LINK_IMPAIRMENT_H
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+
+namespace communication {
+
+enum class DelayDistribution { kUniform, kNormal, kPareto };
+
+/**
+ * @brief Impairments of one direction of a datagram link (netem-like)
+ *
+ * Times in milliseconds, probabilities in [0, 1].
+ */
+struct LinkImpairmentParams {
+    double delay_ms = 0.0;          // Base one-way delay
+    double jitter_ms = 0.0;         // Spread of the extra delay (see distribution)
+    DelayDistribution distribution = DelayDistribution::kUniform;
+    double loss = 0.0;              // Long-run fraction of lost datagrams
+    double burst_length = 1.0;      // Mean consecutive losses (1 = independent losses)
+    double duplicate = 0.0;         // Probability of delivering a second copy
+    double reorder = 0.0;           // Probability of holding a datagram back
+    double reorder_ms = 20.0;       // Extra delay of a held-back datagram
+};
+
+/**
+ * @brief Parse "delay=20,jitter=10,dist=pareto,loss=0.05,burst=3,dup=0.01,reorder=0.02,reorder_ms=30"
+ *
+ * Missing keys keep their defaults; an empty string means no impairment.
+ * Throws std::invalid_argument on unknown keys or out-of-range values.
+ */
+LinkImpairmentParams parse_link_impairment(const std::string& spec);
+
+/**
+ * @brief One-line description of the parameters (for logs)
+ */
+std::string describe_link_impairment(const LinkImpairmentParams& params);
+
+/**
+ * @brief Decides the fate of each datagram crossing one link direction
+ *
+ * Extra delay per datagram:
+ * - uniform: delay + U(-jitter, +jitter)
+ * - normal:  delay + N(0, jitter)
+ * - pareto:  delay + heavy tail with mean jitter (shape 2.5), the typical
+ *            shape of Wi-Fi retransmission stalls
+ * Delays are clamped at zero.
+ *
+ * Losses follow a two-state (Gilbert) chain whose long-run loss rate is
+ * `loss` and whose mean burst length is `burst_length`.
+ *
+ * Jitter alone never reorders: release times are kept monotone, as on a
+ * single FIFO link. Only datagrams picked for reordering are held back by
+ * reorder_ms and can be overtaken. A duplicate gets its own delay draw.
+ *
+ * Seeded, so a run is reproducible for a given arrival sequence.
+ */
+class LinkImpairment {
+public:
+    using time_point = std::chrono::steady_clock::time_point;
+
+    LinkImpairment(const LinkImpairmentParams& params, uint64_t seed);
+
+    /**
+     * @brief Schedule a datagram arriving at `now`
+     *
+     * @param release Output release times, at least 2 entries
+     * @return Number of copies to deliver: 0 (lost), 1, or 2 (duplicated)
+     */
+    int schedule(time_point now, time_point* release);
+
+    const LinkImpairmentParams& params() const { return params_; }
+
+    uint64_t offered() const { return offered_; }
+    uint64_t dropped() const { return dropped_; }
+    uint64_t duplicated() const { return duplicated_; }
+    uint64_t reordered() const { return reordered_; }
+
+    /**
+     * @brief Mean delay added to delivered copies (ms)
+     */
+    double mean_delay_ms() const { return delivered_ > 0 ? total_delay_ms_ / delivered_ : 0.0; }
+
+private:
+    bool lose();
+    double draw_delay_ms();
+    time_point release_time(time_point now);
+
+    LinkImpairmentParams params_;
+    std::mt19937_64 rng_;
+    std::uniform_real_distribution<double> uniform_{0.0, 1.0};
+    std::normal_distribution<double> normal_{0.0, 1.0};
+
+    // Gilbert chain: P(good -> bad) and P(bad -> good)
+    double enter_burst_ = 0.0;
+    double leave_burst_ = 1.0;
+    bool in_burst_ = false;
+
+    time_point last_release_{};
+
+    uint64_t offered_ = 0;
+    uint64_t dropped_ = 0;
+    uint64_t duplicated_ = 0;
+    uint64_t reordered_ = 0;
+    uint64_t delivered_ = 0;
+    double total_delay_ms_ = 0.0;
+};
+
+} // namespace communication
+
+#endif // COMMUNICATION_LINK_IMPAIRMENT_H
@@ -0,0 +1,179 @@
+#ifndef COMMUNICATION_NETWORK_CLIENT_H
+#define COMMUNICATION_NETWORK_CLIENT_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <netinet/in.h>
+#include "communication/request_tracker.h"
+#include "communication/sensor_data.h"
+#include "communication/spsc_queue.h"
+#include "communication/telemetry_mailbox.h"
+#include "communication/wire_protocol.h"
+
+namespace communication {
+
+/**
+ * @brief A decoded bridge reply with the tag it echoed
+ */
+struct SensorFrame {
+    SensorData sensors;
+    WireTag tag;
+    std::chrono::steady_clock::time_point received_at;
+};
+
+/**
+ * @brief Bridge client with a dedicated epoll I/O thread
+ *
+ * The control thread never touches the socket. send_action() tags the
+ * action and pushes it into a lock-free SPSC ring; the I/O thread encodes
+ * and sends it. The I/O thread reads every datagram from the non-blocking
+ * socket as soon as epoll reports it, decodes it and pushes the frame into
+ * a second SPSC ring, from which poll_reply() / wait_reply() pick the reply
+ * to the outstanding action (late replies are discarded by the tracker).
+ * With WireFormat::kCsv the tag is not sent, since the original bridge.py
+ * rejects tagged actions; late replies then cannot be told apart.
+ *
+ * Wakeups use eventfds and happen only when the other side is parked: a
+ * thread announces it is about to sleep, re-checks its ring, then sleeps,
+ * and the producer signals the eventfd only if it sees that announcement.
+ * While the I/O thread is awake (or spinning, see spin_us) send_action()
+ * makes no syscall at all; poll_reply() never makes one.
+ *
+ * Telemetry: after subscribe_telemetry(rate_hz) the bridge pushes sensor
+ * frames at that rate. The I/O thread publishes them into a
+ * TelemetryMailbox that any thread can read without waiting, and renews the
+ * subscription every second (the bridge drops it after a few seconds of
+ * silence, e.g. if this process dies).
+ *
+ * Threading: send_action(), subscribe_telemetry(), poll_reply(),
+ * wait_reply(), expire_reply() and tracker() belong to one control thread.
+ * telemetry() and the counters can be read from any thread.
+ */
+class NetworkClient {
+public:
+    /**
+     * @brief Open the socket and start the I/O thread
+     *
+     * @param queue_capacity Slots of each ring (actions and replies)
+     * @param spin_us After any activity the I/O thread keeps polling for this
+     *        long before parking (0 = park at once, lowest CPU use)
+     * @throws std::runtime_error if the address is invalid or the socket,
+     *         epoll or eventfds cannot be created
+     */
+    NetworkClient(const std::string& bridge_ip, int bridge_port,
+                  WireFormat format = WireFormat::kCsv,
+                  size_t queue_capacity = 64, int spin_us = 0);
+
+    /**
+     * @brief Send queued actions, unsubscribe, stop the I/O thread and close the socket
+     */
+    ~NetworkClient();
+
+    NetworkClient(const NetworkClient&) = delete;
+    NetworkClient& operator=(const NetworkClient&) = delete;
+
+    /**
+     * @brief Queue an action as the new outstanding request
+     *
+     * Replies still queued (to earlier, expired actions) are discarded first.
+     *
+     * @return false if the action ring is full (I/O thread stalled)
+     */
+    bool send_action(int action);
+
+    /**
+     * @brief Ask the bridge to push telemetry at rate_hz (0 = stop)
+     *
+     * @return false if the request ring is full
+     */
+    bool subscribe_telemetry(int rate_hz);
+
+    /**
+     * @brief Freshest pushed frame and a short history (any thread)
+     */
+    const TelemetryMailbox& telemetry() const { return telemetry_; }
+
+    /**
+     * @brief Non-blocking: the reply to the outstanding action, if it arrived
+     */
+    bool poll_reply(SensorData& data);
+
+    /**
+     * @brief Wait up to timeout_ms for the reply to the outstanding action
+     *
+     * Does not expire the request on timeout (see expire_reply()), so a
+     * caller can wait again until its own deadline.
+     *
+     * @return false on timeout (data unchanged)
+     */
+    bool wait_reply(SensorData& data, int timeout_ms);
+
+    /**
+     * @brief The outstanding action got no reply in time
+     */
+    void expire_reply() { tracker_.expire(); }
+
+    const RequestTracker& tracker() const { return tracker_; }
+
+    uint64_t datagrams_sent() const { return datagrams_sent_.load(std::memory_order_relaxed); }
+    uint64_t datagrams_received() const { return datagrams_received_.load(std::memory_order_relaxed); }
+    uint64_t send_errors() const { return send_errors_.load(std::memory_order_relaxed); }
+    uint64_t malformed() const { return malformed_.load(std::memory_order_relaxed); }
+    uint64_t dropped_replies() const { return dropped_replies_.load(std::memory_order_relaxed); }
+    uint64_t telemetry_frames() const { return telemetry_frames_.load(std::memory_order_relaxed); }
+
+private:
+    struct OutgoingMessage {
+        bool subscribe = false;   // value is a telemetry rate instead of an action
+        int value = 0;
+        WireTag tag;
+    };
+
+    void wake_io();
+    void io_loop();
+    void flush_actions();
+    void send_subscribe(int rate_hz);
+    void send_datagram(const char* data, size_t size);
+    void read_socket();
+    bool take_matching(SensorData& data);
+
+    static void signal(int fd);
+    static void clear(int fd);
+
+    WireFormat format_;
+    struct sockaddr_in bridge_addr_;
+    int sock_fd_ = -1;
+    int epoll_fd_ = -1;
+    int action_event_fd_ = -1;   // Wakes the I/O thread (actions queued, stop)
+    int reply_event_fd_ = -1;    // Wakes the control thread (reply queued)
+    int spin_us_;
+
+    SpscQueue<OutgoingMessage> actions_;  // Control -> I/O
+    SpscQueue<SensorFrame> replies_;      // I/O -> control
+    RequestTracker tracker_;              // Control thread only
+    TelemetryMailbox telemetry_;          // Written by the I/O thread
+
+    // I/O thread only
+    int telemetry_rate_hz_ = 0;
+    std::chrono::steady_clock::time_point next_renewal_;
+
+    std::atomic<bool> io_parked_{false};
+    std::atomic<bool> control_parked_{false};
+    std::atomic<bool> stop_{false};
+
+    std::atomic<uint64_t> datagrams_sent_{0};
+    std::atomic<uint64_t> datagrams_received_{0};
+    std::atomic<uint64_t> send_errors_{0};
+    std::atomic<uint64_t> malformed_{0};
+    std::atomic<uint64_t> dropped_replies_{0};
+    std::atomic<uint64_t> telemetry_frames_{0};
+
+    std::thread io_thread_;
+};
+
+} // namespace communication
+
+#endif // COMMUNICATION_NETWORK_CLIENT_H
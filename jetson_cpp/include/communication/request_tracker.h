@@ -0,0 +1,78 @@
+#ifndef COMMUNICATION_REQUEST_TRACKER_H
+#define COMMUNICATION_REQUEST_TRACKER_H
+
+#include <chrono>
+#include <cstdint>
+#include "communication/wire_protocol.h"
+
+namespace communication {
+
+/**
+ * @brief Pairs bridge replies with the action that caused them
+ *
+ * Each action gets a fresh tag (sequence, send timestamp) that the bridge
+ * echoes. A reply is accepted only if it echoes the outstanding sequence;
+ * anything else is a late reply to an action that already timed out and is
+ * discarded, so it can never be paired with the wrong action. Replies from
+ * peers that do not echo tags (sequence 0) are accepted while a request is
+ * outstanding, which is as good as the untagged protocol gets.
+ *
+ * RTT is measured on the local steady clock from the stored send time (the
+ * echoed timestamp is only used to reject a mismatched echo), so no clock
+ * synchronization with the bridge is needed.
+ */
+class RequestTracker {
+public:
+    using time_point = std::chrono::steady_clock::time_point;
+
+    enum class Match { kMatched, kUntagged, kStale };
+
+    /**
+     * @brief Tag for a new request, which becomes the outstanding one
+     *
+     * An earlier request still outstanding counts as lost.
+     */
+    WireTag next(time_point now = std::chrono::steady_clock::now());
+
+    /**
+     * @brief Classify a reply; kMatched / kUntagged close the outstanding request
+     */
+    Match accept(const WireTag& reply, time_point now = std::chrono::steady_clock::now());
+
+    /**
+     * @brief The outstanding request got no reply in time
+     */
+    void expire();
+
+    bool outstanding() const { return outstanding_; }
+
+    /**
+     * @brief Round trip of the last matched reply (ms)
+     */
+    double last_rtt_ms() const { return last_rtt_ms_; }
+
+    uint64_t sent() const { return sent_; }
+    uint64_t matched() const { return matched_; }
+    uint64_t stale() const { return stale_; }
+    uint64_t lost() const { return lost_; }
+    double mean_rtt_ms() const { return matched_ > 0 ? total_rtt_ms_ / matched_ : 0.0; }
+    double max_rtt_ms() const { return max_rtt_ms_; }
+
+private:
+    uint32_t sequence_ = 0;
+    WireTag pending_;
+    time_point sent_at_;
+    bool outstanding_ = false;
+
+    double last_rtt_ms_ = 0.0;
+    double total_rtt_ms_ = 0.0;
+    double max_rtt_ms_ = 0.0;
+    uint64_t sent_ = 0;
+    uint64_t matched_ = 0;
+    uint64_t stale_ = 0;
+    uint64_t lost_ = 0;
+};
+
+} // namespace communication
+
+#endif // COMMUNICATION_REQUEST_TRACKER_H
@@ -0,0 +1,89 @@
+#ifndef COMMUNICATION_SENSOR_DATA_H
+#define COMMUNICATION_SENSOR_DATA_H
+
+#include <torch/torch.h>
+#include <cmath>
+
+namespace communication {
+
+/**
+ * @brief Sensor reading received from the EV3 through the laptop bridge
+ *
+ * Shared by jetson_dqn, train_robot and the offline tools so that every
+ * component normalizes sensors into the same 4-D DQN state.
+ */
+struct SensorData {
+    float gyro_angle;      // Gyroscope angle (degrees)
+    float gyro_rate;       // Angular velocity (degrees/second)
+    int touch_front;       // Front touch sensor (0 or 1, -1 if unavailable)
+    int touch_side;        // Side touch sensor (0 or 1, -1 if unavailable)
+    bool valid;            // true if the reading is valid
+
+    SensorData() : gyro_angle(0.0f), gyro_rate(0.0f),
+                   touch_front(-1), touch_side(-1), valid(false) {}
+
+    /**
+     * @brief Convert sensors to the normalized DQN state
+     *
+     * Layout: [tanh(gyro_angle / 90), tanh(gyro_rate / 180), touch_front, touch_side]
+     *
+     * @return torch::Tensor State tensor [4]
+     */
+    torch::Tensor toState() const {
+        torch::Tensor state = torch::empty({4}, torch::kFloat32);
+        toState(state.data_ptr<float>());
+        return state;
+    }
+
+    /**
+     * @brief Write the normalized DQN state into a caller-owned buffer
+     *
+     * Same layout as toState(), without allocating a tensor.
+     *
+     * @param out Destination array of 4 floats
+     */
+    void toState(float* out) const {
+        out[0] = std::tanh(gyro_angle / 90.0f);
+        out[1] = std::tanh(gyro_rate / 180.0f);
+        out[2] = touch_front >= 0 ? static_cast<float>(touch_front) : 0.0f;
+        out[3] = touch_side >= 0 ? static_cast<float>(touch_side) : 0.0f;
+    }
+};
+
+/**
+ * @brief Raw sensor reading stored alongside each transition
+ *
+ * Keeps the un-normalized sensors that produced a reward so the reward can be
+ * recomputed later without driving the robot again. For the UDP bridge the
+ * gyro fields hold degrees and degrees/second; for LegoRobotEnv they hold the
+ * normalized gyro_x / gyro_y readings.
+ */
+struct SensorRecord {
+    float gyro_angle = 0.0f;    // Gyroscope angle
+    float gyro_rate = 0.0f;     // Angular velocity
+    float touch_front = 0.0f;   // Front touch sensor (0 or 1)
+    float touch_side = 0.0f;    // Side touch sensor (0 or 1)
+    float valid = 0.0f;         // 1 if the reading was received and parsed
+    float truncated = 0.0f;     // 1 if the episode was cut by step limit / timeout
+};
+
+/**
+ * @brief Build a SensorRecord from a bridge reading
+ *
+ * @param sensors Reading received from the bridge
+ * @param truncated Whether the episode hit its step or time limit on this step
+ */
+inline SensorRecord make_sensor_record(const SensorData& sensors, bool truncated) {
+    SensorRecord record;
+    record.gyro_angle = sensors.gyro_angle;
+    record.gyro_rate = sensors.gyro_rate;
+    record.touch_front = sensors.touch_front == 1 ? 1.0f : 0.0f;
+    record.touch_side = sensors.touch_side == 1 ? 1.0f : 0.0f;
+    record.valid = sensors.valid ? 1.0f : 0.0f;
+    record.truncated = truncated ? 1.0f : 0.0f;
+    return record;
+}
+
+} // namespace communication
+
+#endif // COMMUNICATION_SENSOR_DATA_H
@@ -0,0 +1,78 @@
+#ifndef COMMUNICATION_SEQLOCK_H
+#define COMMUNICATION_SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace communication {
+
+/**
+ * @brief Single-writer seqlock holding one trivially copyable value
+ *
+ * store() is wait-free: it never waits for readers. Readers never block the
+ * writer either; try_load() fails only if it overlapped a store, and load()
+ * retries until it gets a consistent copy.
+ *
+ * The value is kept as relaxed atomic words, so the racy copy a reader may
+ * see before the sequence check is not a data race in the C++ sense.
+ */
+template <typename T>
+class Seqlock {
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock needs a trivially copyable type");
+
+public:
+    /**
+     * @brief Writer side (one thread only)
+     */
+    void store(const T& value) {
+        uint64_t buffer[kWords] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+
+        const uint32_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);   // Odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Consistent copy, or false if a store was in progress
+     */
+    bool try_load(T& out) const {
+        const uint32_t before = seq_.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false;
+        }
+        uint64_t buffer[kWords];
+        for (size_t i = 0; i < kWords; ++i) {
+            buffer[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+        std::memcpy(&out, buffer, sizeof(T));
+        return true;
+    }
+
+    T load() const {
+        T value;
+        while (!try_load(value)) {
+        }
+        return value;
+    }
+
+private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint32_t> seq_{0};
+    std::atomic<uint64_t> words_[kWords] = {};
+};
+
+} // namespace communication
+
+#endif // COMMUNICATION_SEQLOCK_H
@@ -0,0 +1,87 @@
+#ifndef COMMUNICATION_SPSC_QUEUE_H
+#define COMMUNICATION_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace communication {
+
+/**
+ * @brief Bounded lock-free single-producer / single-consumer ring
+ *
+ * One thread calls try_push(), one other thread calls try_pop(); neither
+ * ever blocks or makes a syscall. Capacity is rounded up to a power of two.
+ *
+ * head_ (consumer) and tail_ (producer) live on separate cache lines, and
+ * each side caches the other's index so the shared line is only read again
+ * when the ring looks full (producer) or empty (consumer).
+ */
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * @brief Producer side; false if the ring is full
+     */
+    bool try_push(const T& item) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ > mask_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ > mask_) {
+                return false;
+            }
+        }
+        slots_[tail & mask_] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Consumer side; false if the ring is empty
+     */
+    bool try_pop(T& item) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return false;
+            }
+        }
+        item = slots_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Snapshot, exact only when called from the consumer thread
+     */
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    std::vector<T> slots_;
+    size_t mask_ = 0;
+
+    alignas(64) std::atomic<size_t> head_{0};   // Next slot to pop (written by consumer)
+    size_t cached_tail_ = 0;                    // Consumer's copy of tail_
+
+    alignas(64) std::atomic<size_t> tail_{0};   // Next slot to push (written by producer)
+    size_t cached_head_ = 0;                    // Producer's copy of head_
+};
+
+} // namespace communication
+
+#endif // COMMUNICATION_SPSC_QUEUE_H
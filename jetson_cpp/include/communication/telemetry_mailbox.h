@@ -0,0 +1,80 @@
+#ifndef COMMUNICATION_TELEMETRY_MAILBOX_H
+#define COMMUNICATION_TELEMETRY_MAILBOX_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "communication/seqlock.h"
+#include "communication/sensor_data.h"
+#include "communication/wire_protocol.h"
+
+namespace communication {
+
+/**
+ * @brief One pushed telemetry frame as seen by the client
+ */
+struct TelemetrySample {
+    SensorData sensors;
+    uint32_t frame = 0;             // Bridge frame counter
+    uint64_t bridge_time_us = 0;    // Bridge clock at send (not comparable with ours)
+    uint64_t index = 0;             // Local publish counter (1-based)
+    std::chrono::steady_clock::time_point received_at;
+};
+
+/**
+ * @brief Latest-value mailbox plus a short history of telemetry frames
+ *
+ * One writer (the network I/O thread) publishes every frame as it arrives;
+ * any number of readers (the control loop) read the freshest one at decision
+ * time without ever waiting for the writer, independent of the action
+ * cadence. The newest kHistory frames are also kept, each slot in its own
+ * seqlock, for readers that want a short window (filtering, finite
+ * differences).
+ *
+ * Frames that arrive out of order (a frame counter slightly behind the
+ * newest and an older bridge timestamp) are dropped, so latest() never goes
+ * back in time. A counter that goes back while the bridge clock moves on,
+ * or a large backwards jump, is taken as a bridge restart and accepted.
+ */
+class TelemetryMailbox {
+public:
+    static constexpr size_t kHistory = 32;
+
+    /**
+     * @brief Writer side (one thread only)
+     *
+     * @return false if the frame was dropped as out of order
+     */
+    bool publish(const SensorData& sensors, const WireTag& frame,
+                 std::chrono::steady_clock::time_point received_at);
+
+    /**
+     * @brief Newest frame; false if none has been published yet
+     */
+    bool latest(TelemetrySample& out) const;
+
+    /**
+     * @brief Up to max_samples newest frames, newest first
+     *
+     * Stops early at a slot the writer has already recycled.
+     *
+     * @return Number of samples written
+     */
+    size_t history(TelemetrySample* out, size_t max_samples) const;
+
+    uint64_t published() const { return published_.load(std::memory_order_acquire); }
+    uint64_t reordered() const { return reordered_.load(std::memory_order_relaxed); }
+
+private:
+    Seqlock<TelemetrySample> latest_;
+    Seqlock<TelemetrySample> ring_[kHistory];
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> reordered_{0};
+    uint32_t last_frame_ = 0;        // Writer only
+    uint64_t last_time_us_ = 0;      // Writer only
+};
+
+} // namespace communication
+
+#endif // COMMUNICATION_TELEMETRY_MAILBOX_H
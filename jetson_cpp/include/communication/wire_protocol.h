@@ -0,0 +1,180 @@
+#ifndef COMMUNICATION_WIRE_PROTOCOL_H
+#define COMMUNICATION_WIRE_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "communication/sensor_data.h"
+
+namespace communication {
+
+/**
+ * @brief Encoding of the datagrams exchanged with the bridge
+ *
+ * kCsv is the original text protocol ("N" for actions,
+ * "gyro_angle,gyro_rate,touch_front,touch_side" for sensors) and works with
+ * any bridge. kCsvTagged appends ",sequence,timestamp_us" to both; an
+ * original bridge.py rejects such actions, so it needs the updated bridge.
+ * kBinary is a fixed-layout little-endian packet:
+ *
+ *   Action (18 bytes)
+ *     0  magic    0xEB
+ *     1  version  2
+ *     2  type     1
+ *     3  action   uint8
+ *     4  sequence uint32
+ *     8  timestamp_us uint64 (sender clock)
+ *     16 checksum uint16 (Fletcher-16 of bytes 0-15)
+ *
+ *   Sensors (26 bytes)
+ *     0  magic    0xEB
+ *     1  version  2
+ *     2  type     2
+ *     3  flags    bit0 touch_front, bit1 touch_side,
+ *                 bit2 touch_front unavailable, bit3 touch_side unavailable
+ *     4  sequence uint32 (echo of the action)
+ *     8  timestamp_us uint64 (echo of the action)
+ *     16 gyro_angle float32 (IEEE 754)
+ *     20 gyro_rate  float32
+ *     24 checksum uint16 (Fletcher-16 of bytes 0-23)
+ *
+ *   Subscribe (18 bytes, action layout with type 3): byte 3 is 0, the
+ *   sequence field carries the telemetry rate in Hz (0 = unsubscribe).
+ *   CSV: "S,rate_hz".
+ *
+ *   Telemetry (26 bytes, sensors layout with type 4): pushed by the bridge
+ *   at the subscribed rate, not in reply to an action. The sequence field
+ *   is the bridge's frame counter and timestamp_us the bridge clock at send.
+ *   CSV: "T,gyro_angle,gyro_rate,touch_front,touch_side,frame,timestamp_us".
+ *
+ * The magic byte never starts a CSV datagram, so decoders detect the format
+ * from the first byte and accept all three (a CSV datagram with a tag is
+ * reported as kCsvTagged). Bridges answer in the format of the request and
+ * echo its tag, so a tagging client can pair every reply with its action
+ * (see RequestTracker). Version 1 packets (no tag) are rejected.
+ * Older bridges drop subscribe requests as malformed actions, so a client
+ * that subscribes simply gets no telemetry from them.
+ */
+enum class WireFormat : uint8_t { kCsv, kCsvTagged, kBinary };
+
+constexpr uint8_t kWireMagic = 0xEB;
+constexpr uint8_t kWireVersion = 2;
+constexpr uint8_t kWireTypeAction = 1;
+constexpr uint8_t kWireTypeSensors = 2;
+constexpr uint8_t kWireTypeSubscribe = 3;
+constexpr uint8_t kWireTypeTelemetry = 4;
+
+constexpr size_t kActionPacketSize = 18;
+constexpr size_t kSensorPacketSize = 26;
+constexpr size_t kMaxWirePacketSize = 96;   // Enough for either format
+
+/**
+ * @brief Request tag carried by an action and echoed by its reply
+ *
+ * Sequence 0 means "untagged" (a CSV peer that does not send or echo tags).
+ */
+struct WireTag {
+    uint32_t sequence = 0;
+    uint64_t timestamp_us = 0;
+};
+
+/**
+ * @brief Fletcher-16 checksum
+ */
+uint16_t wire_checksum(const uint8_t* data, size_t size);
+
+/**
+ * @brief Encode an action (0-255)
+ *
+ * @param tag Request tag; ignored by kCsv, which always sends the bare "N"
+ * @return Bytes written, 0 if the buffer is too small
+ */
+size_t encode_action(int action, WireFormat format, char* out, size_t capacity,
+                     const WireTag& tag = WireTag());
+
+/**
+ * @brief Encode a sensor reading (CSV with two decimals, like bridge.py)
+ *
+ * @param tag Tag of the action being answered (echoed as received; ignored by kCsv)
+ * @return Bytes written, 0 if the buffer is too small
+ */
+size_t encode_sensors(const SensorData& sensors, WireFormat format, char* out, size_t capacity,
+                      const WireTag& tag = WireTag());
+
+/**
+ * @brief Decode an action straight from a receive buffer (either format)
+ *
+ * No allocation and no exceptions. The range of the action is not checked.
+ *
+ * @param format If not null, receives the detected format
+ * @param tag If not null, receives the request tag (sequence 0 if untagged)
+ * @return false if the datagram is malformed (bad magic, version, type,
+ *         size or checksum, or not an integer)
+ */
+bool decode_action(const char* data, size_t size, int& action, WireFormat* format = nullptr,
+                   WireTag* tag = nullptr);
+
+/**
+ * @brief Decode a sensor reading straight from a receive buffer (either format)
+ *
+ * Fills gyro_angle, gyro_rate, touch_front and touch_side; sets
+ * sensors.valid to the return value.
+ *
+ * @param format If not null, receives the detected format
+ * @param tag If not null, receives the echoed tag (sequence 0 if untagged)
+ * @return false if the datagram is malformed (including non-finite gyro
+ *         values or touch values other than -1, 0 and 1)
+ */
+bool decode_sensors(const char* data, size_t size, SensorData& sensors, WireFormat* format = nullptr,
+                    WireTag* tag = nullptr);
+
+/**
+ * @brief Encode a telemetry subscription (rate_hz 0-65535, 0 = unsubscribe)
+ *
+ * @return Bytes written, 0 if the buffer is too small
+ */
+size_t encode_subscribe(int rate_hz, WireFormat format, char* out, size_t capacity);
+
+/**
+ * @brief Decode a telemetry subscription (either format)
+ *
+ * @return false if the datagram is not a well-formed subscription
+ */
+bool decode_subscribe(const char* data, size_t size, int& rate_hz, WireFormat* format = nullptr);
+
+/**
+ * @brief Encode a pushed telemetry frame
+ *
+ * @param frame Bridge frame counter and send time (not an action tag)
+ * @return Bytes written, 0 if the buffer is too small
+ */
+size_t encode_telemetry(const SensorData& sensors, WireFormat format, char* out, size_t capacity,
+                        const WireTag& frame);
+
+/**
+ * @brief Decode a pushed telemetry frame (either format)
+ *
+ * @param frame If not null, receives the frame counter and bridge send time
+ * @return false if the datagram is not a well-formed telemetry frame
+ */
+bool decode_telemetry(const char* data, size_t size, SensorData& sensors, WireFormat* format = nullptr,
+                      WireTag* frame = nullptr);
+
+/**
+ * @brief Cheap check of the first bytes: is this a telemetry frame?
+ *
+ * Lets a receiver route pushed frames away from action replies before
+ * decoding. The frame itself is validated by decode_telemetry().
+ */
+bool is_telemetry(const char* data, size_t size);
+
+/**
+ * @brief "csv" | "csv-tagged" | "binary" (throws std::invalid_argument otherwise)
+ */
+WireFormat parse_wire_format(const std::string& name);
+
+const char* wire_format_name(WireFormat format);
+
+} // namespace communication
+
+#endif // COMMUNICATION_WIRE_PROTOCOL_H
@@ -2,9 +2,11 @@
 #define DQN_AGENT_H
 
 #include <torch/torch.h>
+#include <map>
 #include <memory>
 #include <string>
 #include "dqn/network.h"
+#include "dqn/checkpoint.h"
 #include "dqn/replay_buffer.h"
 #include "dqn/types.h"
 
@@ -41,6 +43,15 @@ public:
      */
     int64_t select_action(const torch::Tensor& state, bool training = true);
 
+    /**
+     * @brief Select actions for a batch of states (epsilon-greedy per row)
+     *
+     * @param states State batch [batch_size, state_dim]
+     * @param training If true, use epsilon-greedy; if false, use greedy policy
+     * @return torch::Tensor Action indices [batch_size] (kLong, CPU)
+     */
+    torch::Tensor select_actions(const torch::Tensor& states, bool training = true);
+
     /**
      * @brief Store a transition in the replay buffer
      *
@@ -53,10 +64,21 @@ public:
     void store_transition(const torch::Tensor& state, int64_t action, float reward,
                          const torch::Tensor& next_state, bool done);
 
+    /**
+     * @brief Store a transition with the raw sensors behind its reward
+     *
+     * @param sensors Raw sensor record (enables offline reward relabeling)
+     */
+    void store_transition(const torch::Tensor& state, int64_t action, float reward,
+                         const torch::Tensor& next_state, bool done,
+                         const communication::SensorRecord& sensors);
+
     /**
      * @brief Perform one training step
      *
      * Samples a batch from replay buffer and performs gradient descent.
+     * With synthetic_ratio > 0, that fraction of the batch comes from the
+     * synthetic (imagined) buffer once it holds enough transitions.
      *
      * @return float Loss value (or -1.0 if not enough samples)
      */
@@ -64,6 +86,9 @@ public:
 
     /**
      * @brief Update target network by copying weights from Q-network
+     *
+     * Also bumps the target version, invalidating all cached target values
+     * in the replay buffer.
      */
     void update_target_network();
 
@@ -73,19 +98,45 @@ public:
     void decay_epsilon();
 
     /**
-     * @brief Save model to file
+     * @brief Save a resumable training checkpoint to file
+     *
+     * Writes both networks, optimizer state, epsilon, step counters and RNG
+     * states (see TrainingCheckpoint). The file still loads with
+     * torch::load(QNetwork, path) for inference-only consumers.
      *
      * @param filepath Path to save file (.pt extension)
+     * @param include_replay Also store the replay buffer (needed for an exact resume)
+     * @param counters Caller counters stored alongside (e.g. episode)
      */
-    void save(const std::string& filepath);
+    void save(const std::string& filepath, bool include_replay = false,
+              const std::map<std::string, double>& counters = {});
 
     /**
-     * @brief Load model from file
+     * @brief Load model or training checkpoint from file
+     *
+     * Training checkpoints restore the full training state; files holding
+     * only Q-network weights (older saves) restore the Q-network and sync
+     * the target network.
      *
      * @param filepath Path to model file
      */
     void load(const std::string& filepath);
 
+    /**
+     * @brief Capture the full training state
+     *
+     * @param include_replay Also copy the real and synthetic replay buffers
+     * @return TrainingCheckpoint CPU snapshot, independent of the agent
+     */
+    TrainingCheckpoint snapshot(bool include_replay = false) const;
+
+    /**
+     * @brief Restore the full training state captured by snapshot()
+     *
+     * @param checkpoint Checkpoint to restore
+     */
+    void restore(const TrainingCheckpoint& checkpoint);
+
     /**
      * @brief Get current epsilon value
      *
@@ -100,6 +151,28 @@ public:
      */
     int64_t get_training_steps() const { return training_steps_; }
 
+    /**
+     * @brief Get the policy Q-network (e.g. as a distillation teacher)
+     *
+     * @return QNetwork Module handle sharing the agent's parameters
+     */
+    QNetwork get_q_network() const { return q_network_; }
+
+    /**
+     * @brief Get the replay buffer
+     *
+     * @return const ReplayBuffer& Stored transitions
+     */
+    const ReplayBuffer& get_replay_buffer() const { return *replay_buffer_; }
+    ReplayBuffer& get_replay_buffer() { return *replay_buffer_; }
+
+    /**
+     * @brief Get the synthetic replay buffer filled by DynaPlanner
+     *
+     * @return ReplayBuffer& Imagined transitions
+     */
+    ReplayBuffer& get_synthetic_buffer() { return *synthetic_buffer_; }
+
     /**
      * @brief Set evaluation mode (disable epsilon-greedy)
      */
@@ -111,6 +184,18 @@ public:
     void train();
 
 private:
+    /**
+     * @brief max_a' Q_target(s', a') for a sampled batch
+     *
+     * Uses the replay buffer cache and runs the target network only on the
+     * stale rows, writing the fresh values back to the cache.
+     *
+     * @param buffer Buffer the batch was sampled from
+     * @param batch Sampled batch (CPU tensors)
+     * @return torch::Tensor Target values [batch_size, 1] on device_
+     */
+    torch::Tensor compute_max_next_q(ReplayBuffer& buffer, const TransitionBatch& batch);
+
     // Neural networks
     QNetwork q_network_{nullptr};                 // Policy network
     QNetwork target_network_{nullptr};            // Target network
@@ -118,8 +203,9 @@ private:
     // Optimizer
     std::unique_ptr<torch::optim::Adam> optimizer_;
 
-    // Replay buffer
+    // Replay buffers (real experience and model-generated experience)
     std::unique_ptr<ReplayBuffer> replay_buffer_;
+    std::unique_ptr<ReplayBuffer> synthetic_buffer_;
 
     // Hyperparameters
     Hyperparameters params_;
@@ -137,6 +223,11 @@ private:
     // Training progress
     int64_t training_steps_;
 
+    // Target network version (bumped on every sync) and cache statistics
+    int64_t target_version_ = 0;
+    int64_t target_cache_hits_ = 0;
+    int64_t target_cache_misses_ = 0;
+
     // Random number generator for epsilon-greedy
     std::mt19937 rng_;
     std::uniform_real_distribution<float> uniform_dist_;
@@ -0,0 +1,82 @@
+#ifndef DQN_AUGMENTATION_H
+#define DQN_AUGMENTATION_H
+
+#include <torch/torch.h>
+#include <utility>
+#include <vector>
+
+namespace dqn {
+
+/**
+ * @brief Declared mirror symmetry of an environment's state/action space
+ *
+ * Describes a transformation M such that the mirrored transition
+ * (M(s), M(a), r, M(s'), done) is as valid as the recorded one:
+ * - negate_dims: state channels whose sign flips (e.g. gyro angle/rate)
+ * - swap_dims: pairs of state channels that exchange values (e.g. left/right contact)
+ * - action_map: action permutation (e.g. TURN_LEFT <-> TURN_RIGHT)
+ * - asymmetric_dims: channels from sensors with no mirrored counterpart;
+ *   transitions where any of them is non-zero in s or s' are never mirrored
+ */
+struct MirrorSymmetry {
+    std::vector<int64_t> negate_dims;
+    std::vector<std::pair<int64_t, int64_t>> swap_dims;
+    std::vector<int64_t> action_map;
+    std::vector<int64_t> asymmetric_dims;
+
+    /**
+     * @brief Left/right mirror of the EV3 robot (UDP bridge)
+     *
+     * State [gyro_angle, gyro_rate, touch_front, touch_side]: both gyro
+     * channels flip sign, TURN_LEFT (2) and TURN_RIGHT (3) swap. The single
+     * side contact sensor has no mirrored twin, so side contacts are excluded.
+     */
+    static MirrorSymmetry ev3_left_right();
+};
+
+/**
+ * @brief Applies a MirrorSymmetry to sampled batches
+ *
+ * Used by ReplayBuffer::sample(): after the batch is gathered, each eligible
+ * row is mirrored with probability mirror_prob using a few vectorized tensor
+ * ops on the whole batch, so augmentation adds no per-transition work.
+ */
+class SymmetryAugmentation {
+public:
+    SymmetryAugmentation(const MirrorSymmetry& symmetry, int64_t state_dim, float mirror_prob = 0.5f);
+
+    /**
+     * @brief Choose the rows to mirror
+     *
+     * @param states State batch [batch_size, state_dim]
+     * @param next_states Next-state batch [batch_size, state_dim]
+     * @return torch::Tensor Boolean mask [batch_size]
+     */
+    torch::Tensor sample_mask(const torch::Tensor& states, const torch::Tensor& next_states) const;
+
+    /**
+     * @brief Mirror the masked rows in place
+     *
+     * @param states State batch [batch_size, state_dim]
+     * @param next_states Next-state batch [batch_size, state_dim]
+     * @param actions Action batch [batch_size, 1] (kLong)
+     * @param mask Rows to mirror [batch_size] (kBool)
+     */
+    void apply(torch::Tensor& states, torch::Tensor& next_states, torch::Tensor& actions,
+               const torch::Tensor& mask) const;
+
+    float mirror_prob() const { return mirror_prob_; }
+
+private:
+    torch::Tensor mirror_states(const torch::Tensor& states) const;
+
+    torch::Tensor column_index_;      // [state_dim] gather index implementing swap_dims
+    torch::Tensor sign_;              // [state_dim] +1 / -1 implementing negate_dims
+    torch::Tensor action_map_;        // [action_dim] action permutation
+    torch::Tensor asymmetric_index_;  // [k] channels that block mirroring
+    float mirror_prob_;
+};
+
+} // namespace dqn
+
+#endif // DQN_AUGMENTATION_H
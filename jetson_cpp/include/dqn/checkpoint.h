@@ -0,0 +1,142 @@
+#ifndef DQN_CHECKPOINT_H
+#define DQN_CHECKPOINT_H
+
+#include <torch/torch.h>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "dqn/replay_buffer.h"
+
+namespace dqn {
+
+using NamedTensors = std::vector<std::pair<std::string, torch::Tensor>>;
+
+/**
+ * @brief Adam moments of one parameter (CPU clones)
+ *
+ * Undefined exp_avg means the parameter has no optimizer state yet.
+ */
+struct AdamParamSnapshot {
+    int64_t step = 0;
+    torch::Tensor exp_avg;
+    torch::Tensor exp_avg_sq;
+    torch::Tensor max_exp_avg_sq;     // Only with amsgrad
+};
+
+/**
+ * @brief Thrown by TrainingCheckpoint::load() for a file that holds only
+ * model weights (legacy torch::save(QNetwork) format)
+ */
+class NotATrainingCheckpoint : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief Complete, self-contained snapshot of a training run
+ *
+ * Holds CPU copies of everything DQNAgent needs to continue training on the
+ * exact same trajectory: both networks, Adam moments, epsilon, step
+ * counters, the agent's and LibTorch's CPU RNG states and, optionally, the
+ * real and synthetic replay buffers with their sampling RNGs and the Dyna
+ * dynamics model with its optimizer. Caller-defined counters (episode,
+ * best reward, ...) travel in `counters`.
+ *
+ * File layout: the Q-network parameters sit at the top level exactly as
+ * torch::save(QNetwork) writes them, so torch::load(QNetwork, path) still
+ * works on checkpoint files; everything else lives in a "checkpoint"
+ * sub-archive.
+ */
+struct TrainingCheckpoint {
+    static constexpr int64_t kFormatVersion = 2;
+
+    NamedTensors q_network;               // Parameters and buffers, module naming ("fc1.weight")
+    NamedTensors target_network;
+    std::vector<AdamParamSnapshot> optimizer;   // One per parameter, in optimizer order
+
+    float epsilon = 0.0f;
+    int64_t training_steps = 0;
+    int64_t target_version = 0;
+
+    std::string rng_state;                // std::mt19937 of the agent (text form)
+    torch::Tensor torch_rng_state;        // Default CPU generator state
+
+    bool has_replay = false;
+    ReplayData replay;
+    std::string replay_rng_state;
+    ReplayData synthetic;                 // Dyna imagined transitions (with has_replay)
+    std::string synthetic_rng_state;
+
+    bool has_dynamics = false;            // Filled by DynaPlanner::snapshot_into()
+    NamedTensors dynamics_model;
+    std::vector<AdamParamSnapshot> dynamics_optimizer;
+
+    std::map<std::string, double> counters;
+
+    /**
+     * @brief Write the checkpoint to a file
+     *
+     * @param filepath Destination path
+     * @throws c10::Error on I/O failure
+     */
+    void save(const std::string& filepath) const;
+
+    /**
+     * @brief Read a checkpoint written by save()
+     *
+     * @param filepath Source path
+     * @throws NotATrainingCheckpoint if the file holds only model weights (legacy format)
+     * @throws std::runtime_error if the checkpoint is malformed or of an unknown version
+     */
+    static TrainingCheckpoint load(const std::string& filepath);
+
+    /**
+     * @brief Get a caller counter
+     *
+     * @param name Counter name
+     * @param fallback Value returned when the counter is missing
+     */
+    double counter(const std::string& name, double fallback = 0.0) const;
+};
+
+/**
+ * @brief Copy the parameters and buffers of a module to CPU
+ *
+ * @param module Source module
+ * @return NamedTensors Detached CPU clones in module naming
+ */
+NamedTensors snapshot_module(const torch::nn::Module& module);
+
+/**
+ * @brief Copy named tensors into the parameters and buffers of a module
+ *
+ * @param module Destination module (tensors are copied to its device)
+ * @param tensors Source tensors
+ * @throws std::runtime_error if a parameter or buffer is missing
+ */
+void restore_module(torch::nn::Module& module, const NamedTensors& tensors);
+
+/**
+ * @brief Copy the Adam moments of every parameter to CPU
+ *
+ * @param optimizer Source optimizer
+ * @return std::vector<AdamParamSnapshot> One entry per parameter, in optimizer order
+ */
+std::vector<AdamParamSnapshot> snapshot_adam(const torch::optim::Adam& optimizer);
+
+/**
+ * @brief Replace the Adam state with moments captured by snapshot_adam()
+ *
+ * An empty snapshot leaves the optimizer untouched.
+ *
+ * @param optimizer Destination optimizer (moments are copied to each parameter's device)
+ * @param snapshot Source moments
+ * @throws std::runtime_error if the parameter count does not match
+ */
+void restore_adam(torch::optim::Adam& optimizer, const std::vector<AdamParamSnapshot>& snapshot);
+
+} // namespace dqn
+
+#endif // DQN_CHECKPOINT_H
@@ -0,0 +1,158 @@
+#ifndef DQN_CHECKPOINT_HISTORY_H
+#define DQN_CHECKPOINT_HISTORY_H
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "dqn/checkpoint.h"
+
+namespace dqn {
+
+/**
+ * @brief Append-only history of network checkpoints with delta compression
+ *
+ * Every entry stores the Q and target networks as one flat float buffer
+ * plus epsilon, step counters and caller counters. Every keyframe_interval
+ * entries a full keyframe is written; the entries in between store only the
+ * difference to the previous entry:
+ * - kXor: lossless. Float bits XOR-ed with the previous entry and split into
+ *   byte planes; unchanged parameters and the stable sign/exponent bytes
+ *   become zero runs.
+ * - kQuantized: int8 diffs with one scale per 256-float block, taken against
+ *   the previously *reconstructed* entry so the error never accumulates
+ *   (at most half a quantization step per parameter).
+ * Delta payloads are zero-run-length encoded, so a target network that did
+ * not change since the last entry costs a few bytes.
+ *
+ * Optimizer state and the replay buffer are not part of the history: they
+ * only matter for resuming and live in the latest full TrainingCheckpoint.
+ * Restoring an entry yields a TrainingCheckpoint with networks, schedules
+ * and counters.
+ *
+ * File: "DQCH" header with the tensor layout, then records
+ * [kind, index, meta, payload, checksum]. A torn record at the tail (e.g.
+ * after power loss) is detected by its checksum and truncated on open; a
+ * torn header (crash during the first append) empties the file.
+ */
+class CheckpointHistory {
+public:
+    enum class DeltaMode : uint8_t { kXor = 1, kQuantized = 2 };
+
+    struct Options {
+        int64_t keyframe_interval = 10;         // Full entry every N entries
+        DeltaMode delta_mode = DeltaMode::kQuantized;
+        bool read_only = false;                 // Inspect only: no create, no repair, no append
+    };
+
+    /**
+     * @brief Summary of one stored entry
+     */
+    struct EntryInfo {
+        size_t index = 0;
+        bool keyframe = false;
+        uint64_t offset = 0;                    // Record offset in the file
+        uint64_t bytes = 0;                     // Record size in the file
+        int64_t training_steps = 0;
+        std::map<std::string, double> counters;
+    };
+
+    /**
+     * @brief Open (or create) a history file
+     *
+     * An existing file is scanned to rebuild the entry index; new entries
+     * are appended after it. With options.read_only the file must exist and
+     * is never modified: a torn tail (e.g. a record the trainer is still
+     * writing) is reported and skipped instead of truncated.
+     *
+     * @param filepath History file
+     * @param options Compression options for new entries
+     * @throws std::runtime_error if the file cannot be opened or is not a history file
+     */
+    explicit CheckpointHistory(const std::string& filepath, const Options& options);
+    explicit CheckpointHistory(const std::string& filepath);
+    ~CheckpointHistory();
+
+    CheckpointHistory(const CheckpointHistory&) = delete;
+    CheckpointHistory& operator=(const CheckpointHistory&) = delete;
+
+    /**
+     * @brief Append an entry (fsynced before returning)
+     *
+     * @param checkpoint Snapshot to store (networks, schedules, counters)
+     * @return size_t Index of the new entry
+     * @throws std::runtime_error if the network layout differs from the file's,
+     *         or the history was opened read-only
+     */
+    size_t append(const TrainingCheckpoint& checkpoint);
+
+    /**
+     * @brief Reconstruct an entry
+     *
+     * Decodes the nearest keyframe at or before index and applies the
+     * following deltas.
+     *
+     * @param index Entry index
+     * @return TrainingCheckpoint Networks, schedules and counters (no optimizer/replay)
+     * @throws std::out_of_range for an invalid index
+     */
+    TrainingCheckpoint restore(size_t index) const;
+
+    size_t size() const;
+    std::vector<EntryInfo> entries() const;
+
+    /**
+     * @brief Bytes used by the history file
+     */
+    uint64_t file_bytes() const;
+
+    /**
+     * @brief Bytes the same entries would take as uncompressed float buffers
+     */
+    uint64_t raw_bytes() const;
+
+private:
+    struct TensorLayout {
+        std::string name;
+        std::vector<int64_t> shape;
+        int64_t numel = 0;
+    };
+
+    struct Record {
+        EntryInfo info;
+        uint8_t kind = 0;
+        float epsilon = 0.0f;
+        int64_t target_version = 0;
+        uint64_t payload_offset = 0;
+        uint64_t payload_bytes = 0;
+    };
+
+    void open_or_create();
+    void scan();
+    void write_header(const std::vector<TensorLayout>& layout);
+
+    std::vector<float> flatten(const TrainingCheckpoint& checkpoint,
+                               std::vector<TensorLayout>* layout) const;
+    void unflatten(const std::vector<float>& flat, TrainingCheckpoint& checkpoint) const;
+
+    std::string read_payload(const Record& record) const;
+    void decode_into(const Record& record, std::vector<float>& frame) const;
+
+    std::string filepath_;
+    Options options_;
+    int fd_ = -1;
+
+    std::vector<TensorLayout> layout_;
+    int64_t num_floats_ = 0;
+    uint64_t file_bytes_ = 0;
+
+    std::vector<Record> records_;
+    std::vector<float> last_frame_;     // Reconstruction of the newest entry
+
+    mutable std::mutex mutex_;
+};
+
+} // namespace dqn
+
+#endif // DQN_CHECKPOINT_HISTORY_H
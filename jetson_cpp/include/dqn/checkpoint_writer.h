@@ -0,0 +1,103 @@
+#ifndef DQN_CHECKPOINT_WRITER_H
+#define DQN_CHECKPOINT_WRITER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "dqn/checkpoint.h"
+#include "dqn/checkpoint_history.h"
+
+namespace dqn {
+
+/**
+ * @brief Background checkpoint writer
+ *
+ * The training thread only takes a snapshot (DQNAgent::snapshot(), a plain
+ * tensor copy) and hands it to submit(), which never blocks on the
+ * filesystem. A worker thread serializes each snapshot to "<path>.tmp",
+ * fsyncs it and renames it over <path>, so a crash or power loss leaves
+ * either the previous or the new checkpoint, never a torn file.
+ *
+ * If the worker falls behind, a newer snapshot for a path that is still
+ * queued replaces the queued one; beyond max_pending the oldest queued
+ * file snapshot is dropped. History appends are never dropped.
+ */
+class AsyncCheckpointWriter {
+public:
+    /**
+     * @brief Start the worker thread
+     *
+     * @param max_pending Maximum number of queued snapshots
+     */
+    explicit AsyncCheckpointWriter(size_t max_pending = 4);
+
+    /**
+     * @brief Write all queued snapshots and stop the worker
+     */
+    ~AsyncCheckpointWriter();
+
+    AsyncCheckpointWriter(const AsyncCheckpointWriter&) = delete;
+    AsyncCheckpointWriter& operator=(const AsyncCheckpointWriter&) = delete;
+
+    /**
+     * @brief Queue a snapshot for writing (non-blocking)
+     *
+     * @param checkpoint Snapshot to write (moved into the queue)
+     * @param filepath Destination path
+     */
+    void submit(TrainingCheckpoint checkpoint, const std::string& filepath);
+
+    /**
+     * @brief Queue a snapshot for appending to a checkpoint history (non-blocking)
+     *
+     * History entries are never coalesced. The history must outlive the writer
+     * or a flush().
+     *
+     * @param checkpoint Snapshot to append (moved into the queue)
+     * @param history Destination history
+     */
+    void submit(TrainingCheckpoint checkpoint, CheckpointHistory& history);
+
+    /**
+     * @brief Block until every queued snapshot has been written
+     */
+    void flush();
+
+    uint64_t written() const;
+    uint64_t dropped() const;
+    uint64_t failed() const;
+
+private:
+    struct Job {
+        TrainingCheckpoint checkpoint;
+        std::string filepath;
+        CheckpointHistory* history = nullptr;   // Append to history instead of writing filepath
+    };
+
+    void worker_loop();
+    void enqueue(Job job);
+
+    // Serialize, fsync and atomically rename into place
+    static void write_atomic(const TrainingCheckpoint& checkpoint, const std::string& filepath);
+
+    size_t max_pending_;
+    std::deque<Job> queue_;
+    bool busy_ = false;             // Worker is writing a dequeued job
+    bool stop_ = false;
+
+    uint64_t written_ = 0;
+    uint64_t dropped_ = 0;
+    uint64_t failed_ = 0;
+
+    mutable std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable idle_cv_;
+    std::thread worker_;
+};
+
+} // namespace dqn
+
+#endif // DQN_CHECKPOINT_WRITER_H
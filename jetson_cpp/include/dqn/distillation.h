@@ -0,0 +1,200 @@
+#ifndef DQN_DISTILLATION_H
+#define DQN_DISTILLATION_H
+
+#include <torch/torch.h>
+#include <functional>
+#include <string>
+#include "dqn/network.h"
+
+namespace dqn {
+
+/**
+ * @brief Small student Q-network for on-robot inference
+ *
+ * Architecture: state_dim -> hidden_dim -> action_dim (single ReLU layer).
+ * Trained by PolicyDistiller to imitate a full QNetwork.
+ */
+class StudentNetworkImpl : public torch::nn::Module {
+public:
+    /**
+     * @brief Construct a new StudentNetwork object
+     *
+     * @param state_dim Dimension of the state space
+     * @param action_dim Number of discrete actions
+     * @param hidden_dim Size of the hidden layer (default: 32)
+     */
+    StudentNetworkImpl(int64_t state_dim, int64_t action_dim, int64_t hidden_dim = 32);
+
+    /**
+     * @brief Forward pass through the network
+     *
+     * @param x Input state tensor [batch_size, state_dim]
+     * @return Q-values for each action [batch_size, action_dim]
+     */
+    torch::Tensor forward(torch::Tensor x);
+
+    int64_t hidden_dim() const { return hidden_dim_; }
+
+private:
+    torch::nn::Linear fc1_{nullptr};    // Hidden layer
+    torch::nn::Linear fc2_{nullptr};    // Output layer
+
+    int64_t state_dim_;
+    int64_t action_dim_;
+    int64_t hidden_dim_;
+};
+
+TORCH_MODULE(StudentNetwork);
+
+/**
+ * @brief Parameters for policy distillation
+ */
+struct DistillationConfig {
+    int64_t hidden_dim = 32;            // Student hidden layer size
+    int64_t epochs = 200;               // Passes over the distillation states
+    size_t batch_size = 256;            // Minibatch size
+    float learning_rate = 0.005f;       // Adam learning rate
+    float q_loss_weight = 1.0f;         // Weight of the Q-value MSE term
+    float action_loss_weight = 1.0f;    // Weight of the argmax cross-entropy term
+    int latency_iterations = 1000;      // Single-state forwards timed per network
+};
+
+/**
+ * @brief Result of evaluating a student against its teacher
+ */
+struct DistillationReport {
+    int64_t num_states = 0;             // States used for evaluation
+    float agreement_rate = 0.0f;        // Fraction of states with equal argmax
+    float q_mse = 0.0f;                 // Mean squared Q-value error
+    double teacher_latency_us = 0.0;    // Mean single-state teacher latency
+    double student_latency_us = 0.0;    // Mean single-state student latency
+    double teacher_p99_us = 0.0;        // p99 single-state teacher latency
+    double student_p99_us = 0.0;        // p99 single-state student latency
+};
+
+/**
+ * @brief Distills a trained QNetwork into a StudentNetwork
+ *
+ * The student is trained on teacher-labelled states with a combined loss:
+ * MSE to the teacher Q-values plus cross-entropy to the teacher's greedy
+ * action, so both the value scale and the decision boundaries are kept.
+ */
+class PolicyDistiller {
+public:
+    /**
+     * @brief Construct a new Policy Distiller
+     *
+     * @param teacher Trained Q-network (left in eval mode)
+     * @param config Distillation parameters
+     * @param device Device to train the student on
+     */
+    PolicyDistiller(QNetwork teacher, const DistillationConfig& config, torch::Device device);
+
+    /**
+     * @brief Train a new student on the given states
+     *
+     * @param states Distillation states [num_states, state_dim]
+     * @return StudentNetwork Trained student (eval mode)
+     */
+    StudentNetwork distill(const torch::Tensor& states);
+
+    /**
+     * @brief Compare a student with the teacher on the given states
+     *
+     * @param student Student network to evaluate
+     * @param states Evaluation states [num_states, state_dim]
+     * @return DistillationReport Agreement rate, Q error and latency (all zero without states)
+     */
+    DistillationReport evaluate(StudentNetwork& student, const torch::Tensor& states);
+
+private:
+    QNetwork teacher_;
+    DistillationConfig config_;
+    torch::Device device_;
+};
+
+/**
+ * @brief Load normalized EV3 states from a recorded sensor session
+ *
+ * Accepts plain "gyro_angle,gyro_rate,touch_front,touch_side" lines as well
+ * as bridge log lines ("... Sensores enviados a ip:port: 12.50,-3.20,0,1").
+ * Lines that cannot be parsed are skipped.
+ *
+ * @param filepath Path to the CSV or bridge log
+ * @return torch::Tensor States [num_states, 4] (empty if none found)
+ */
+torch::Tensor load_sensor_log_states(const std::string& filepath);
+
+/**
+ * @brief Sample random EV3 states covering the whole normalized state space
+ *
+ * Gyro channels are uniform in [-1, 1], touch flags are uniform in {0, 1}.
+ *
+ * @param num_states Number of states to sample
+ * @return torch::Tensor States [num_states, 4]
+ */
+torch::Tensor sample_robot_states(int64_t num_states);
+
+/**
+ * @brief Save a student network together with its architecture
+ *
+ * @param student Student network
+ * @param filepath Path to save file (.pt extension)
+ */
+void save_student(StudentNetwork& student, const std::string& filepath);
+
+/**
+ * @brief Load a student network saved with save_student()
+ *
+ * @param filepath Path to model file
+ * @param state_dim Dimension of the state space
+ * @param action_dim Number of discrete actions
+ * @return StudentNetwork Loaded student (eval mode, CPU)
+ * @throws c10::Error if the file cannot be read
+ */
+StudentNetwork load_student(const std::string& filepath, int64_t state_dim, int64_t action_dim);
+
+/**
+ * @brief Network used for greedy inference: a distilled student or a full QNetwork
+ *
+ * Exactly one of student / q_network is set.
+ */
+struct PolicyNetwork {
+    using ForwardFn = std::function<torch::Tensor(const torch::Tensor&)>;
+
+    StudentNetwork student{nullptr};
+    QNetwork q_network{nullptr};
+
+    /**
+     * @brief Active module (e.g. for extract_dense_layers())
+     */
+    torch::nn::Module& module() const;
+
+    /**
+     * @brief Forward pass of the active network (shares its parameters)
+     */
+    ForwardFn forward_fn() const;
+
+    /**
+     * @brief Short description for logging ("student (hidden=32)", "QNetwork")
+     */
+    std::string description() const;
+};
+
+/**
+ * @brief Load a student saved with save_student(), or else a full QNetwork
+ *
+ * Full models may be torch::save(QNetwork) files or training checkpoints
+ * (DQNAgent::save); the QNetwork uses the default Hyperparameters sizes.
+ *
+ * @param filepath Path to model file
+ * @param state_dim Dimension of the state space
+ * @param action_dim Number of discrete actions
+ * @return PolicyNetwork Loaded network (eval mode, CPU)
+ * @throws c10::Error if the file holds neither a student nor a QNetwork
+ */
+PolicyNetwork load_policy_network(const std::string& filepath, int64_t state_dim, int64_t action_dim);
+
+} // namespace dqn
+
+#endif // DQN_DISTILLATION_H
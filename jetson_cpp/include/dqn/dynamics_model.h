@@ -0,0 +1,129 @@
+#ifndef DQN_DYNAMICS_MODEL_H
+#define DQN_DYNAMICS_MODEL_H
+
+#include <torch/torch.h>
+#include <functional>
+#include <memory>
+#include "dqn/checkpoint.h"
+#include "dqn/replay_buffer.h"
+
+namespace dqn {
+
+class DQNAgent;
+
+/**
+ * @brief Learned environment model p(s', r, done | s, a)
+ *
+ * Input: [state, one_hot(action)]. Outputs the state delta (s' - s), the
+ * reward and a done logit. Architecture: (state_dim + action_dim) ->
+ * hidden_dim -> hidden_dim -> (state_dim + 2), ReLU activations.
+ */
+class DynamicsModelImpl : public torch::nn::Module {
+public:
+    /**
+     * @brief Model prediction for a batch of (state, action) pairs
+     */
+    struct Prediction {
+        torch::Tensor next_states;   // [batch_size, state_dim]
+        torch::Tensor rewards;       // [batch_size, 1]
+        torch::Tensor done_logits;   // [batch_size, 1]
+    };
+
+    DynamicsModelImpl(int64_t state_dim, int64_t action_dim, int64_t hidden_dim = 128);
+
+    /**
+     * @brief Predict next state, reward and termination
+     *
+     * @param states State batch [batch_size, state_dim]
+     * @param actions Action indices [batch_size] or [batch_size, 1]
+     * @return Prediction Predicted transition
+     */
+    Prediction forward(const torch::Tensor& states, const torch::Tensor& actions);
+
+private:
+    torch::nn::Linear fc1_{nullptr};
+    torch::nn::Linear fc2_{nullptr};
+    torch::nn::Linear fc3_{nullptr};
+
+    int64_t state_dim_;
+    int64_t action_dim_;
+};
+
+TORCH_MODULE(DynamicsModel);
+
+/**
+ * @brief Parameters for Dyna-style model-based data generation
+ */
+struct DynaConfig {
+    int64_t hidden_dim = 128;               // Dynamics model hidden layer size
+    float learning_rate = 0.001f;           // Dynamics model Adam learning rate
+    size_t model_batch_size = 128;          // Real transitions per model update
+    int64_t model_train_steps = 50;         // Model updates per train_model() call
+    int64_t rollout_batch = 256;            // Imagined rollouts started per call
+    int64_t rollout_horizon = 3;            // Imagined steps per rollout
+    int64_t planning_steps_per_step = 2;    // Extra agent updates per real step
+
+    // Optional projection of predicted states back onto the valid state
+    // space (e.g. clamp gyro channels, binarize touch flags)
+    std::function<torch::Tensor(const torch::Tensor&)> project_state;
+};
+
+/**
+ * @brief Dyna planner: fits a dynamics model and fills a synthetic buffer
+ *
+ * The model is trained on the real replay buffer as observed (no symmetry
+ * augmentation; truncated episodes are not terminal). Imagined rollouts start
+ * from real states, follow the agent's epsilon-greedy policy and are pushed
+ * into the agent's synthetic replay buffer, from which train_step() draws
+ * Hyperparameters::synthetic_ratio of every minibatch.
+ */
+class DynaPlanner {
+public:
+    DynaPlanner(int64_t state_dim, int64_t action_dim, const DynaConfig& config, torch::Device device);
+
+    /**
+     * @brief Fit the dynamics model on real transitions
+     *
+     * @param real Real replay buffer
+     * @return float Mean model loss (or -1.0 if not enough samples)
+     */
+    float train_model(ReplayBuffer& real);
+
+    /**
+     * @brief Generate batched imagined rollouts into the synthetic buffer
+     *
+     * @param real Real replay buffer (rollout start states)
+     * @param agent Agent whose policy drives the rollouts
+     * @param synthetic Destination buffer
+     * @return size_t Number of synthetic transitions added
+     */
+    size_t generate_rollouts(ReplayBuffer& real, DQNAgent& agent, ReplayBuffer& synthetic);
+
+    /**
+     * @brief Add the dynamics model and its optimizer to a checkpoint
+     *
+     * @param checkpoint Checkpoint (usually from DQNAgent::snapshot())
+     */
+    void snapshot_into(TrainingCheckpoint& checkpoint) const;
+
+    /**
+     * @brief Restore the dynamics model and optimizer saved by snapshot_into()
+     *
+     * @param checkpoint Checkpoint to restore from
+     * @return bool False if the checkpoint holds no dynamics model
+     */
+    bool restore(const TrainingCheckpoint& checkpoint);
+
+    const DynaConfig& config() const { return config_; }
+
+private:
+    DynamicsModel model_{nullptr};
+    std::unique_ptr<torch::optim::Adam> optimizer_;
+    DynaConfig config_;
+    torch::Device device_;
+    int64_t action_dim_;
+};
+
+} // namespace dqn
+
+#endif // DQN_DYNAMICS_MODEL_H
@@ -0,0 +1,185 @@
+#ifndef DQN_INFERENCE_BACKEND_H
+#define DQN_INFERENCE_BACKEND_H
+
+#include <torch/torch.h>
+#include <torch/script.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace dqn {
+
+/**
+ * @brief Fully connected layer copied out of a LibTorch module
+ *
+ * The weight is stored transposed ([in_dim, out_dim], row-major) so that
+ * the forward pass is a sequence of contiguous axpy updates that the
+ * compiler vectorizes (AVX2 on x86, NEON on the Jetson).
+ */
+struct DenseLayer {
+    int64_t in_dim = 0;
+    int64_t out_dim = 0;
+    std::vector<float> weight_t;    // [in_dim, out_dim]
+    std::vector<float> bias;        // [out_dim]
+};
+
+/**
+ * @brief Copy the Linear layers of a module in registration order
+ *
+ * Works for any MLP made of Linear layers with ReLU between them
+ * (QNetwork, StudentNetwork).
+ *
+ * @param module Source module
+ * @return std::vector<DenseLayer> Layers, input to output
+ */
+std::vector<DenseLayer> extract_dense_layers(torch::nn::Module& module);
+
+/**
+ * @brief Greedy action evaluator for a single state
+ *
+ * Implementations must be deterministic and return argmax_a Q(s, a).
+ */
+class InferenceBackend {
+public:
+    virtual ~InferenceBackend() = default;
+
+    /**
+     * @brief Backend name for logging and selection
+     */
+    virtual std::string name() const = 0;
+
+    /**
+     * @brief Select the greedy action
+     *
+     * @param state Normalized state (state_dim floats)
+     * @return int64_t Action with maximum Q-value
+     */
+    virtual int64_t select_action(const float* state) = 0;
+};
+
+/**
+ * @brief LibTorch eager forward pass (reference backend)
+ *
+ * Copies the state into a preallocated [1, state_dim] tensor and calls the
+ * module's forward on the given device.
+ */
+class EagerBackend : public InferenceBackend {
+public:
+    using ForwardFn = std::function<torch::Tensor(const torch::Tensor&)>;
+
+    EagerBackend(std::string name, ForwardFn forward, int64_t state_dim, torch::Device device);
+
+    std::string name() const override { return name_; }
+    int64_t select_action(const float* state) override;
+
+private:
+    std::string name_;
+    ForwardFn forward_;
+    torch::Tensor input_;       // Preallocated CPU input [1, state_dim]
+    torch::Device device_;
+};
+
+/**
+ * @brief TorchScript module exported from Python (torch.jit.script/trace)
+ *
+ * Only available when the user provides an exported .ts file; the C++
+ * frontend modules used for training cannot be scripted from C++.
+ */
+class TorchScriptBackend : public InferenceBackend {
+public:
+    /**
+     * @param filepath Path to the TorchScript file
+     * @param state_dim Dimension of the state space
+     * @throws c10::Error if the module cannot be loaded
+     */
+    TorchScriptBackend(const std::string& filepath, int64_t state_dim);
+
+    std::string name() const override { return "torchscript"; }
+    int64_t select_action(const float* state) override;
+
+private:
+    torch::jit::script::Module module_;
+    torch::Tensor input_;                       // Preallocated input [1, state_dim]
+    std::vector<torch::jit::IValue> inputs_;    // Holds input_ (shares storage)
+};
+
+/**
+ * @brief Hand-written fp32 MLP kernel (no LibTorch dispatch)
+ */
+class DenseBackend : public InferenceBackend {
+public:
+    explicit DenseBackend(std::vector<DenseLayer> layers);
+
+    std::string name() const override { return "dense-fp32"; }
+    int64_t select_action(const float* state) override;
+
+private:
+    std::vector<DenseLayer> layers_;
+    std::vector<float> buffer_a_;   // Ping-pong activation buffers
+    std::vector<float> buffer_b_;
+};
+
+/**
+ * @brief MLP kernel with int8 weights and per-output-channel scales
+ *
+ * Weights are symmetric-quantized (scale = max|w| / 127 per output unit);
+ * activations stay in fp32. Cuts weight memory traffic by 4x.
+ */
+class QuantizedBackend : public InferenceBackend {
+public:
+    explicit QuantizedBackend(const std::vector<DenseLayer>& layers);
+
+    std::string name() const override { return "dense-int8"; }
+    int64_t select_action(const float* state) override;
+
+private:
+    struct QuantizedLayer {
+        int64_t in_dim = 0;
+        int64_t out_dim = 0;
+        std::vector<int8_t> weight_t;   // [in_dim, out_dim]
+        std::vector<float> scale;       // [out_dim]
+        std::vector<float> bias;        // [out_dim]
+    };
+
+    std::vector<QuantizedLayer> layers_;
+    std::vector<float> buffer_a_;
+    std::vector<float> buffer_b_;
+};
+
+/**
+ * @brief Outcome of benchmarking one backend
+ */
+struct BackendBenchmark {
+    std::string name;
+    float agreement = 0.0f;     // Argmax agreement with the reference backend
+    double mean_us = 0.0;       // Mean single-state latency
+    double p99_us = 0.0;        // p99 single-state latency
+    bool accepted = false;      // Agreement above threshold
+};
+
+/**
+ * @brief Pick the fastest backend that agrees with the reference
+ *
+ * The first backend is the reference. Every backend is run on all probe
+ * states; backends whose argmax agreement is below `min_agreement` are
+ * rejected. The accepted backend with the lowest p99 latency wins.
+ *
+ * @param backends Candidate backends (reference first)
+ * @param probes Probe states [num_probes, state_dim] (CPU, float32)
+ * @param iterations Timed calls per backend
+ * @param results Optional output with one entry per backend
+ * @param min_agreement Minimum argmax agreement to accept a backend
+ * @return size_t Index of the selected backend
+ * @throws std::runtime_error if backends is empty
+ * @throws std::invalid_argument if probes is empty or not 2-D
+ */
+size_t select_fastest_backend(std::vector<std::unique_ptr<InferenceBackend>>& backends,
+                              const torch::Tensor& probes,
+                              int iterations = 2000,
+                              std::vector<BackendBenchmark>* results = nullptr,
+                              float min_agreement = 1.0f);
+
+} // namespace dqn
+
+#endif // DQN_INFERENCE_BACKEND_H
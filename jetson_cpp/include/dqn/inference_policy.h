@@ -0,0 +1,106 @@
+#ifndef DQN_INFERENCE_POLICY_H
+#define DQN_INFERENCE_POLICY_H
+
+#include <torch/torch.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "dqn/inference_backend.h"
+
+namespace dqn {
+
+/**
+ * @brief Inference-only MLP policy backed by a memory-mapped weights file
+ *
+ * Running a trained network only needs its Linear layers. Loading a full
+ * DQNAgent for that also builds a target network, an Adam optimizer and a
+ * replay buffer, copies the weights into the target and deserializes a
+ * torch archive. InferencePolicy instead mmaps a compact weights file
+ * (written by export_weights()) and wraps the mapped floats with
+ * torch::from_blob, so loading is an open + mmap and pages are only
+ * faulted in when the first forward touches them.
+ *
+ * The forward pass runs on the CPU with preallocated input and activation
+ * tensors (addmm_out + relu_), so a decision does not allocate and never
+ * calls .to(device). Construction runs a few warm-up passes to fault in
+ * the weight pages and initialize the LibTorch kernels, which keeps the
+ * first real decision as fast as the following ones.
+ *
+ * File layout (little-endian):
+ *   "DQIW", uint32 version, uint32 num_layers, uint32 reserved,
+ *   num_layers x {uint32 in_dim, uint32 out_dim},
+ *   zero padding to 64 bytes,
+ *   per layer: weight_t [in_dim, out_dim] then bias [out_dim] (float32),
+ *   each array starting on a 64-byte boundary.
+ */
+class InferencePolicy : public InferenceBackend {
+public:
+    static constexpr uint32_t kVersion = 1;
+
+    /**
+     * @brief Map a weights file and warm up the forward pass
+     *
+     * @param filepath Weights file written by export_weights()
+     * @param warmup_iterations Forward passes run before returning
+     * @throws std::runtime_error if the file is missing or malformed
+     */
+    explicit InferencePolicy(const std::string& filepath, int warmup_iterations = 16);
+    ~InferencePolicy() override;
+
+    InferencePolicy(const InferencePolicy&) = delete;
+    InferencePolicy& operator=(const InferencePolicy&) = delete;
+
+    /**
+     * @brief Write the Linear layers of a network as a compact weights file
+     *
+     * @param layers Layers from extract_dense_layers() (QNetwork or StudentNetwork)
+     * @param filepath Destination path
+     * @return true on success
+     */
+    static bool export_weights(const std::vector<DenseLayer>& layers, const std::string& filepath);
+
+    // InferenceBackend
+    std::string name() const override { return "libtorch-mmap"; }
+    int64_t select_action(const float* state) override;
+
+    /**
+     * @brief Q-values for a state
+     *
+     * @param state Normalized state (state_dim floats)
+     * @return const float* action_dim Q-values, valid until the next call
+     */
+    const float* q_values(const float* state);
+
+    /**
+     * @brief Copy of the layers (for the fp32/int8 kernel backends)
+     */
+    std::vector<DenseLayer> dense_layers() const;
+
+    int64_t state_dim() const { return state_dim_; }
+    int64_t action_dim() const { return action_dim_; }
+    size_t size_bytes() const { return mapping_bytes_; }
+
+    /**
+     * @brief Time spent in the constructor (map + warm-up), in milliseconds
+     */
+    double load_ms() const { return load_ms_; }
+
+private:
+    void forward(const float* state);
+
+    void* mapping_ = nullptr;
+    size_t mapping_bytes_ = 0;
+
+    int64_t state_dim_ = 0;
+    int64_t action_dim_ = 0;
+    double load_ms_ = 0.0;
+
+    std::vector<torch::Tensor> weights_t_;      // Views on the mapping [in, out]
+    std::vector<torch::Tensor> biases_;         // Views on the mapping [out]
+    std::vector<torch::Tensor> activations_;    // Preallocated layer outputs [1, out]
+    torch::Tensor input_;                       // Preallocated input [1, state_dim]
+};
+
+} // namespace dqn
+
+#endif // DQN_INFERENCE_POLICY_H
@@ -0,0 +1,100 @@
+#ifndef DQN_LOOKUP_TABLE_POLICY_H
+#define DQN_LOOKUP_TABLE_POLICY_H
+
+#include <torch/torch.h>
+#include <string>
+#include <vector>
+#include "dqn/inference_backend.h"
+
+namespace dqn {
+
+/**
+ * @brief Accuracy of a lookup table against the network it was compiled from
+ */
+struct LookupTableReport {
+    int64_t num_samples = 0;        // Random states evaluated
+    float argmax_error = 0.0f;      // Fraction of states with a different greedy action
+    float max_q_error = 0.0f;       // Largest absolute Q-value error
+    float mean_q_error = 0.0f;      // Mean absolute Q-value error
+};
+
+/**
+ * @brief Precomputed Q-value table for the 4-D EV3 robot state
+ *
+ * The robot state is [tanh(gyro_angle/90), tanh(gyro_rate/180), touch_front,
+ * touch_side]: two continuous channels bounded in [-1, 1] and two binary
+ * flags. The table stores Q(s, a) on a resolution x resolution grid over the
+ * gyro channels for each of the 4 touch combinations and answers queries
+ * with bilinear interpolation, so a decision costs a constant number of
+ * float operations and no LibTorch calls.
+ *
+ * Layout: q[touch_case][i][j][action], touch_case = 2 * touch_front + touch_side.
+ */
+class QLookupTable : public InferenceBackend {
+public:
+    using ForwardFn = std::function<torch::Tensor(const torch::Tensor&)>;
+
+    static constexpr int64_t kStateDim = 4;
+    static constexpr int64_t kTouchCases = 4;
+
+    QLookupTable() = default;
+
+    /**
+     * @brief Evaluate a network over the full grid
+     *
+     * @param forward Network forward pass ([N, 4] -> [N, action_dim], CPU)
+     * @param resolution Grid points per gyro axis (>= 2)
+     * @return QLookupTable Compiled table
+     */
+    static QLookupTable compile(const ForwardFn& forward, int64_t resolution = 65);
+
+    /**
+     * @brief Compare table decisions with the network on random states
+     *
+     * @param forward Network forward pass used for compilation
+     * @param num_samples Number of random states (gyro uniform, touch uniform)
+     * @return LookupTableReport Argmax and Q-value error
+     */
+    LookupTableReport evaluate(const ForwardFn& forward, int64_t num_samples = 100000) const;
+
+    /**
+     * @brief Interpolated Q-values for a state
+     *
+     * @param state Normalized state (4 floats)
+     * @param q_out Output array of action_dim floats
+     */
+    void q_values(const float* state, float* q_out) const;
+
+    // InferenceBackend
+    std::string name() const override { return "lookup-table"; }
+    int64_t select_action(const float* state) override;
+
+    /**
+     * @brief Save table to a binary file
+     *
+     * @param filepath Destination path
+     * @return true on success
+     */
+    bool save(const std::string& filepath) const;
+
+    /**
+     * @brief Load table from a binary file written by save()
+     *
+     * @param filepath Source path
+     * @throws std::runtime_error if the file is missing or malformed
+     */
+    static QLookupTable load(const std::string& filepath);
+
+    int64_t resolution() const { return resolution_; }
+    int64_t action_dim() const { return action_dim_; }
+    size_t size_bytes() const { return q_.size() * sizeof(float); }
+
+private:
+    int64_t resolution_ = 0;
+    int64_t action_dim_ = 0;
+    std::vector<float> q_;      // [kTouchCases, resolution, resolution, action_dim]
+};
+
+} // namespace dqn
+
+#endif // DQN_LOOKUP_TABLE_POLICY_H
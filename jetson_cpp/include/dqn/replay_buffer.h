@@ -6,16 +6,52 @@
 #include <deque>
 #include <mutex>
 #include <random>
+#include <string>
+#include <memory>
+#include "dqn/augmentation.h"
 #include "dqn/types.h"
 
+namespace environment {
+class RewardFunction;
+}
+
 namespace dqn {
 
+/**
+ * @brief All transitions of a replay buffer as CPU tensors
+ *
+ * Row i of every tensor belongs to the same transition, oldest first.
+ * Used for dataset files and training checkpoints.
+ */
+struct ReplayData {
+    torch::Tensor states;        // [N, state_dim]
+    torch::Tensor actions;       // [N] (kLong)
+    torch::Tensor rewards;       // [N]
+    torch::Tensor next_states;   // [N, state_dim]
+    torch::Tensor dones;         // [N] (0/1)
+    torch::Tensor sensors;       // [N, 6] SensorRecord fields
+    torch::Tensor has_sensors;   // [N] (0/1)
+
+    bool defined() const { return states.defined() && states.size(0) > 0; }
+
+    void write(torch::serialize::OutputArchive& archive) const;
+    void read(torch::serialize::InputArchive& archive);
+};
+
 /**
  * @brief Experience Replay Buffer for DQN
  *
  * Stores transitions (s, a, r, s', done) in a circular buffer with fixed capacity.
  * Provides random sampling for breaking temporal correlations during training.
  * Thread-safe for potential asynchronous data collection.
+ *
+ * Each transition also caches max_a' Q_target(s', a') tagged with the target
+ * network version that produced it. Bumping the version on target sync
+ * invalidates every cached value in O(1); stale entries are recomputed lazily
+ * when they are sampled.
+ *
+ * With a SymmetryAugmentation attached, sample() mirrors a random subset of
+ * eligible rows on the fly; mirrored rows use a separate target cache slot.
  */
 class ReplayBuffer {
 public:
@@ -40,14 +76,63 @@ public:
     void push(const torch::Tensor& state, int64_t action, float reward,
               const torch::Tensor& next_state, bool done);
 
+    /**
+     * @brief Add a transition together with the raw sensors that produced it
+     *
+     * Transitions stored this way can be relabeled with a different reward
+     * function later (see relabel()).
+     *
+     * @param sensors Raw sensor record observed after the action
+     */
+    void push(const torch::Tensor& state, int64_t action, float reward,
+              const torch::Tensor& next_state, bool done,
+              const communication::SensorRecord& sensors);
+
     /**
      * @brief Sample a random batch of transitions
      *
+     * When target_version >= 0 the batch also carries the cached target
+     * values (max_next_q) and the rows whose cache is stale for that version.
+     * With a negative version every row is reported as stale.
+     *
      * @param batch_size Number of transitions to sample
+     * @param target_version Current target network version (-1: no caching)
      * @return TransitionBatch Batch of transitions as tensors
      * @throws std::runtime_error if buffer has fewer than batch_size transitions
      */
-    TransitionBatch sample(size_t batch_size);
+    TransitionBatch sample(size_t batch_size, int64_t target_version = -1);
+
+    /**
+     * @brief Sample stored transitions as observed, for model fitting
+     *
+     * Unlike sample(), no augmentation is applied, no target cache is
+     * filled, and dones mark terminal states only: transitions whose raw
+     * sensors record a truncation (step or time limit) get done = 0.
+     *
+     * @param batch_size Number of transitions to sample
+     * @return TransitionBatch Batch of transitions as tensors
+     * @throws std::runtime_error if buffer has fewer than batch_size transitions
+     */
+    TransitionBatch sample_real(size_t batch_size);
+
+    /**
+     * @brief Attach a symmetry augmentation applied by sample()
+     *
+     * @param augmentation Augmentation to apply (nullptr disables it)
+     */
+    void set_augmentation(std::shared_ptr<const SymmetryAugmentation> augmentation);
+
+    /**
+     * @brief Store freshly computed target values for the stale rows of a batch
+     *
+     * Transitions evicted since the batch was sampled are skipped.
+     *
+     * @param batch Batch returned by sample()
+     * @param values Target values for batch.stale_rows, in the same order [num_stale] or [num_stale, 1]
+     * @param target_version Target network version that produced the values
+     */
+    void update_target_cache(const TransitionBatch& batch, const torch::Tensor& values,
+                             int64_t target_version);
 
     /**
      * @brief Get current number of transitions in buffer
@@ -64,16 +149,85 @@ public:
      */
     bool can_sample(size_t batch_size) const;
 
+    /**
+     * @brief Stack the states of all stored transitions
+     *
+     * Used as the state source for offline tools such as policy distillation.
+     *
+     * @return torch::Tensor States [size, state_dim] (undefined if empty)
+     */
+    torch::Tensor all_states() const;
+
+    /**
+     * @brief Recompute rewards and dones of every stored transition
+     *
+     * Gathers the raw sensors of all transitions into one SoA batch, runs the
+     * reward function over it in a single sweep and writes the results back.
+     * Transitions without raw sensors are left untouched. Cached target
+     * values stay valid: they depend only on next_state.
+     *
+     * @param reward_fn Reward function to apply
+     * @return RelabelStats Summary of the pass
+     */
+    RelabelStats relabel(const environment::RewardFunction& reward_fn);
+
+    /**
+     * @brief Copy all transitions into tensors
+     *
+     * @return ReplayData Transitions, oldest first (undefined tensors if empty)
+     */
+    ReplayData export_data() const;
+
+    /**
+     * @brief Append transitions from tensors (see export_data())
+     *
+     * @param data Transitions to append
+     * @return size_t Number of transitions appended
+     */
+    size_t import_data(const ReplayData& data);
+
+    /**
+     * @brief Serialized state of the sampling RNG
+     */
+    std::string rng_state() const;
+
+    /**
+     * @brief Restore the sampling RNG from rng_state()
+     */
+    void set_rng_state(const std::string& state);
+
+    /**
+     * @brief Save all transitions (including raw sensors) to a file
+     *
+     * @param filepath Destination path
+     */
+    void save(const std::string& filepath) const;
+
+    /**
+     * @brief Append transitions saved with save()
+     *
+     * Oldest transitions are evicted if the file exceeds the capacity.
+     *
+     * @param filepath Source path
+     * @return size_t Number of transitions loaded
+     */
+    size_t load(const std::string& filepath);
+
     /**
      * @brief Clear all transitions from buffer
      */
     void clear();
 
 private:
+    // Append a transition and evict the oldest one if over capacity (lock held)
+    void push_locked(Transition transition);
+
     size_t capacity_;                           // Maximum buffer capacity
     std::deque<Transition> buffer_;             // Circular buffer using deque
+    uint64_t evicted_ = 0;                      // Transitions popped so far (id of buffer_[0])
     mutable std::mutex mutex_;                  // Thread safety
     std::mt19937 rng_;                          // Random number generator
+    std::shared_ptr<const SymmetryAugmentation> augmentation_;  // Optional mirroring in sample()
 };
 
 } // namespace dqn
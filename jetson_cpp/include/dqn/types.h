@@ -4,6 +4,7 @@
 #include <torch/torch.h>
 #include <vector>
 #include <string>
+#include "communication/sensor_data.h"
 
 namespace dqn {
 
@@ -29,6 +30,10 @@ struct Hyperparameters {
     size_t batch_size = 64;                 // Minibatch size for training
     size_t buffer_capacity = 10000;         // Maximum replay buffer capacity
 
+    // Model-based (Dyna) data
+    float synthetic_ratio = 0.0f;           // Fraction of each minibatch drawn from imagined transitions
+    size_t synthetic_buffer_capacity = 20000;  // Maximum synthetic replay buffer capacity
+
     // Network architecture
     int64_t hidden_dim1 = 128;              // First hidden layer dimension
     int64_t hidden_dim2 = 128;              // Second hidden layer dimension
@@ -45,6 +50,19 @@ struct Transition {
     float reward;                // Reward received
     torch::Tensor next_state;    // Resulting next state
     bool done;                   // Whether episode ended
+
+    // Cached max_a' Q_target(next_state, a'), valid while target_version
+    // matches the agent's current target network version
+    float target_max_q = 0.0f;
+    int64_t target_version = -1;
+
+    // Same cache for the mirrored next_state (symmetry augmentation)
+    float target_max_q_mirror = 0.0f;
+    int64_t target_version_mirror = -1;
+
+    // Raw sensors behind reward/done, kept for offline reward relabeling
+    communication::SensorRecord sensors;
+    bool has_sensors = false;
 };
 
 /**
@@ -58,6 +76,23 @@ struct TransitionBatch {
     torch::Tensor rewards;       // [batch_size, 1]
     torch::Tensor next_states;   // [batch_size, state_dim]
     torch::Tensor dones;         // [batch_size, 1]
+
+    // Target Q-value cache (filled when sampling with a target version)
+    torch::Tensor max_next_q;           // [batch_size, 1] cached values (stale rows undefined)
+    std::vector<int64_t> stale_rows;    // Rows whose cached value must be recomputed
+    std::vector<uint64_t> ids;          // Stable transition ids, one per row
+    std::vector<uint8_t> mirrored;      // 1 if the row was mirrored by augmentation
+};
+
+/**
+ * @brief Summary of a reward relabeling pass
+ */
+struct RelabelStats {
+    size_t relabeled = 0;           // Transitions with raw sensors (recomputed)
+    size_t skipped = 0;             // Transitions without raw sensors (left untouched)
+    size_t done_changes = 0;        // Transitions whose done flag flipped
+    double old_mean_reward = 0.0;   // Mean reward before relabeling (relabeled rows)
+    double new_mean_reward = 0.0;   // Mean reward after relabeling (relabeled rows)
 };
 
 } // namespace dqn
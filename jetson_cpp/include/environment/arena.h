@@ -0,0 +1,158 @@
+#ifndef ENVIRONMENT_ARENA_H
+#define ENVIRONMENT_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace environment {
+
+/**
+ * @brief Parameters of a procedurally generated arena
+ *
+ * Distances in meters. The arena is the rectangle [0, width] x [0, height]
+ * surrounded by walls.
+ */
+struct ArenaParams {
+    float width = 2.0f;
+    float height = 2.0f;
+    int min_obstacles = 2;
+    int max_obstacles = 6;
+    float box_fraction = 0.5f;      // Fraction of obstacles that are boxes (the rest are discs)
+    float min_size = 0.05f;         // Disc radius / box half-extent range
+    float max_size = 0.15f;
+    float cell_size = 0.25f;        // Spatial grid cell (>= typical obstacle size)
+};
+
+enum class ObstacleShape : uint8_t { kDisc, kBox };
+
+/**
+ * @brief Disc (radius) or axis-aligned box (half extents) centred at (x, y)
+ */
+struct ArenaObstacle {
+    ObstacleShape shape = ObstacleShape::kDisc;
+    float x = 0.0f;
+    float y = 0.0f;
+    float radius = 0.0f;            // Disc only
+    float half_width = 0.0f;        // Box only
+    float half_height = 0.0f;       // Box only
+};
+
+/**
+ * @brief Touch-sensor bumpers as segments in the robot frame
+ *
+ * The front bumper is perpendicular to the heading, front_offset ahead of
+ * the robot centre. The side bumper runs along the heading on the right
+ * side, side_offset from the centre.
+ */
+struct BumperGeometry {
+    float front_offset = 0.09f;
+    float front_half_width = 0.06f;
+    float side_offset = 0.09f;
+    float side_half_length = 0.05f;
+};
+
+/**
+ * @brief Non-owning structure-of-arrays view over robot poses (heading in radians)
+ */
+struct PoseBatchView {
+    const float* x = nullptr;
+    const float* y = nullptr;
+    const float* heading = nullptr;
+    size_t size = 0;
+};
+
+/**
+ * @brief Obstacle layout indexed by a uniform grid for collision queries
+ *
+ * Every obstacle is registered in each grid cell its bounding box overlaps
+ * (compressed rows: per-cell offsets into one index array). A query only
+ * visits the cells under its own bounding box, so a bumper segment or robot
+ * body shorter than a cell tests the obstacles of at most four cells,
+ * independent of the total obstacle count. Walls are tested analytically.
+ *
+ * Rebuilding the index (generate / set_obstacles) reuses the arrays, so
+ * resetting an environment does not allocate once the arena has grown to
+ * its largest layout.
+ */
+class Arena {
+public:
+    explicit Arena(const ArenaParams& params = ArenaParams());
+
+    /**
+     * @brief Replace the layout with a random one and rebuild the index
+     */
+    void generate(std::mt19937& rng);
+
+    /**
+     * @brief Use a fixed layout and rebuild the index
+     */
+    void set_obstacles(const std::vector<ArenaObstacle>& obstacles);
+
+    /**
+     * @brief Whether the segment (x0, y0)-(x1, y1) touches a wall or an obstacle
+     */
+    bool segment_hits(float x0, float y0, float x1, float y1) const;
+
+    /**
+     * @brief Whether a disc of the given radius overlaps a wall or an obstacle
+     */
+    bool circle_hits(float x, float y, float radius) const;
+
+    /**
+     * @brief Sample a position where a disc of radius clearance fits
+     *
+     * @return false if no free position was found within the attempts
+     */
+    bool sample_free_position(std::mt19937& rng, float clearance, float& x, float& y,
+                              int attempts = 64) const;
+
+    /**
+     * @brief Touch sensors of one robot pose
+     */
+    void bumper_contacts(float x, float y, float heading, const BumperGeometry& bumpers,
+                         bool& touch_front, bool& touch_side) const;
+
+    /**
+     * @brief Touch sensors of a batch of robot poses
+     *
+     * @param poses Poses [n]
+     * @param bumpers Bumper geometry shared by all robots
+     * @param touch_front Output 0/1 flags [n]
+     * @param touch_side Output 0/1 flags [n]
+     */
+    void bumper_contacts(const PoseBatchView& poses, const BumperGeometry& bumpers,
+                         float* touch_front, float* touch_side) const;
+
+    /**
+     * @brief Segment queries for a batch, hits[i] = 0/1
+     */
+    void segments_hit(const float* x0, const float* y0, const float* x1, const float* y1,
+                      size_t n, uint8_t* hits) const;
+
+    const ArenaParams& params() const { return params_; }
+    const std::vector<ArenaObstacle>& obstacles() const { return obstacles_; }
+    int grid_cols() const { return cols_; }
+    int grid_rows() const { return rows_; }
+
+private:
+    void build_index();
+
+    // Inclusive cell range under an axis-aligned box (clamped to the grid)
+    void cell_range(float min_x, float min_y, float max_x, float max_y,
+                    int& c0, int& r0, int& c1, int& r1) const;
+
+    ArenaParams params_;
+    float inv_cell_ = 1.0f;
+    int cols_ = 1;
+    int rows_ = 1;
+
+    std::vector<ArenaObstacle> obstacles_;
+    std::vector<uint32_t> cell_start_;      // [cols * rows + 1] offsets into cell_items_
+    std::vector<uint32_t> cell_items_;      // Obstacle indices, grouped by cell
+};
+
+} // namespace environment
+
+#endif // ENVIRONMENT_ARENA_H
@@ -0,0 +1,137 @@
+#ifndef ENVIRONMENT_BATCHED_ENVIRONMENT_H
+#define ENVIRONMENT_BATCHED_ENVIRONMENT_H
+
+#include <torch/torch.h>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "environment/environment_interface.h"
+
+namespace environment {
+
+/**
+ * @brief Interface for N environments stepped as one batch
+ *
+ * All buffers are owned by the caller and written in place:
+ * - observations: [N, state_dim] float32, CPU, contiguous
+ * - rewards, dones: [N] float32, CPU, contiguous (dones are 0/1)
+ * - actions: [N] int64, CPU, contiguous
+ * - mask: [N] bool or float32 (nonzero = selected), e.g. the dones buffer
+ *
+ * step_batch() does not reset finished environments: after the step the
+ * observation rows of finished environments hold their terminal state (the
+ * next_state for the replay buffer). The caller then calls
+ * reset_where(dones, observations) to start new episodes in those rows.
+ * Stepping a finished environment without resetting it is undefined.
+ */
+class BatchedEnvironmentInterface {
+public:
+    virtual ~BatchedEnvironmentInterface() = default;
+
+    /**
+     * @brief Reset the environments selected by mask
+     *
+     * @param mask Environments to reset [N]
+     * @param observations Initial states are written to the selected rows
+     */
+    virtual void reset_where(const torch::Tensor& mask, torch::Tensor& observations) = 0;
+
+    /**
+     * @brief Reset every environment
+     *
+     * @param observations Initial states [N, state_dim]
+     */
+    void reset_all(torch::Tensor& observations);
+
+    /**
+     * @brief Step every environment with its action
+     *
+     * @param actions Actions [N]
+     * @param observations Resulting states [N, state_dim]
+     * @param rewards Rewards [N]
+     * @param dones Episode-ended flags [N]
+     */
+    virtual void step_batch(const torch::Tensor& actions, torch::Tensor& observations,
+                            torch::Tensor& rewards, torch::Tensor& dones) = 0;
+
+    virtual int64_t num_envs() const = 0;
+    virtual int64_t state_dim() const = 0;
+    virtual int64_t action_dim() const = 0;
+    virtual void close() = 0;
+
+    /**
+     * @brief Allocate buffers with the shapes expected by step_batch()
+     */
+    torch::Tensor make_observations() const;
+    torch::Tensor make_scalars() const;
+};
+
+/**
+ * @brief Batched view of N independent scalar environments
+ *
+ * Steps each wrapped EnvironmentInterface in turn through step_into() /
+ * reset_into(), which write straight into the caller's buffer rows, so any
+ * existing environment can be driven by a batched training loop.
+ */
+class ScalarEnvAdapter : public BatchedEnvironmentInterface {
+public:
+    using Factory = std::function<std::unique_ptr<EnvironmentInterface>()>;
+
+    /**
+     * @param factory Creates one environment instance
+     * @param num_envs Number of instances
+     */
+    ScalarEnvAdapter(const Factory& factory, int64_t num_envs);
+
+    /**
+     * @param envs Environment instances (at least one, same dimensions)
+     */
+    explicit ScalarEnvAdapter(std::vector<std::unique_ptr<EnvironmentInterface>> envs);
+
+    void reset_where(const torch::Tensor& mask, torch::Tensor& observations) override;
+    void step_batch(const torch::Tensor& actions, torch::Tensor& observations,
+                    torch::Tensor& rewards, torch::Tensor& dones) override;
+
+    int64_t num_envs() const override { return static_cast<int64_t>(envs_.size()); }
+    int64_t state_dim() const override { return envs_.front()->state_dim(); }
+    int64_t action_dim() const override { return envs_.front()->action_dim(); }
+    void close() override;
+
+    EnvironmentInterface& env(int64_t i) { return *envs_[i]; }
+
+private:
+    std::vector<std::unique_ptr<EnvironmentInterface>> envs_;
+};
+
+/**
+ * @brief Check buffer shapes/dtypes against an environment batch
+ *
+ * @throws std::invalid_argument on a mismatch
+ */
+void check_batch_buffers(const BatchedEnvironmentInterface& env, const torch::Tensor& actions,
+                         const torch::Tensor& observations, const torch::Tensor& rewards,
+                         const torch::Tensor& dones);
+
+/**
+ * @brief Read-only view of a reset mask (bool or float32, CPU, contiguous)
+ */
+class MaskView {
+public:
+    /**
+     * @param mask Reset mask
+     * @param num_envs Expected number of elements
+     * @throws std::invalid_argument for other dtypes, non-CPU masks or a size
+     *         other than num_envs
+     */
+    MaskView(const torch::Tensor& mask, int64_t num_envs);
+
+    bool operator[](int64_t i) const { return bools_ ? bools_[i] : floats_[i] != 0.0f; }
+
+private:
+    const bool* bools_ = nullptr;
+    const float* floats_ = nullptr;
+};
+
+} // namespace environment
+
+#endif // ENVIRONMENT_BATCHED_ENVIRONMENT_H
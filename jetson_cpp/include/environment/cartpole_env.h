@@ -22,6 +22,11 @@ public:
 
     torch::Tensor reset() override;
     StepResult step(int64_t action) override;
+
+    // Camino sin asignaciones: escribe el estado en el buffer del llamador
+    void reset_into(float* state) override;
+    void step_into(int64_t action, float* next_state, float& reward, bool& done,
+                   StepInfo* info = nullptr) override;
     int64_t state_dim() const override { return 4; }
     int64_t action_dim() const override { return 2; }
     void close() override {}
@@ -43,7 +48,7 @@ private:
 
     void update_physics(float force);
     bool is_terminal() const;
-    torch::Tensor get_state() const;
+    void write_state(float* out) const;
 };
 
 } // namespace environment
@@ -0,0 +1,56 @@
+#ifndef ENVIRONMENT_CARTPOLE_KERNELS_H
+#define ENVIRONMENT_CARTPOLE_KERNELS_H
+
+#include <cstdint>
+
+namespace environment {
+
+/**
+ * @brief CartPole physical constants (same values as CartPoleEnv)
+ */
+struct CartPoleConstants {
+    static constexpr float kGravity = 9.8f;
+    static constexpr float kCartMass = 1.0f;
+    static constexpr float kPoleMass = 0.1f;
+    static constexpr float kPoleLength = 0.5f;
+    static constexpr float kForceMag = 10.0f;
+    static constexpr float kTau = 0.02f;
+    static constexpr float kXThreshold = 2.4f;
+    static constexpr float kThetaThreshold = 0.2095f;  // ~12 degrees
+};
+
+/**
+ * @brief Structure-of-arrays view of N CartPole states
+ *
+ * Each array holds `size` floats. Arrays should be 32-byte aligned for the
+ * vector loads, but unaligned pointers are accepted.
+ */
+struct CartPoleSoA {
+    float* x = nullptr;
+    float* x_dot = nullptr;
+    float* theta = nullptr;
+    float* theta_dot = nullptr;
+    int64_t size = 0;
+};
+
+/**
+ * @brief Advance every CartPole by one Euler step
+ *
+ * Same equations as CartPoleEnv::update_physics. sin/cos are evaluated with
+ * a vectorized Cephes-style polynomial (8 lanes with AVX2+FMA, 4 with NEON);
+ * the scalar fallback and the remainder lanes use std::sin/std::cos.
+ *
+ * @param state States, updated in place
+ * @param force Force applied to each cart (+/- kForceMag)
+ * @param terminal Output, 1.0f where the cart or the pole left its bounds
+ */
+void cartpole_step_kernel(const CartPoleSoA& state, const float* force, float* terminal);
+
+/**
+ * @brief Instruction set the kernel was compiled for ("avx2", "neon" or "scalar")
+ */
+const char* cartpole_kernel_isa();
+
+} // namespace environment
+
+#endif // ENVIRONMENT_CARTPOLE_KERNELS_H
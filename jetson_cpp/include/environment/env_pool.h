@@ -0,0 +1,172 @@
+#ifndef ENVIRONMENT_ENV_POOL_H
+#define ENVIRONMENT_ENV_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "environment/batched_environment.h"
+
+namespace environment {
+
+/**
+ * @brief M scalar environments stepped by a work-stealing thread pool
+ *
+ * Every worker thread owns a task deque. A task steps (or resets) a range of
+ * environments through step_into()/reset_into(). Environment i is normally
+ * queued on worker i % num_threads. A worker whose deque is empty steals
+ * from the back of the others, so a few slow steps (a robot simulator with
+ * uneven step times) do not stall the whole batch.
+ *
+ * Synchronous mode (BatchedEnvironmentInterface): step_batch() splits the M
+ * environments into chunks, writes results straight into the caller's
+ * buffers and returns when every chunk is done.
+ *
+ * Asynchronous mode ("first K ready"): send() queues one step per listed
+ * environment and returns immediately. recv(k) blocks until k environments
+ * have finished and returns their ids and results in completion order.
+ * async_reset() queues resets the same way (reward 0, done 0). Finished
+ * episodes are not reset automatically. An environment can have at most
+ * one step or reset in flight, and sync calls need an idle pool.
+ *
+ * send/async_reset/recv/step_batch/reset_where must be called from a single
+ * thread.
+ */
+class EnvPool : public BatchedEnvironmentInterface {
+public:
+    /**
+     * @param factory Creates one environment instance
+     * @param num_envs Number of environments (M)
+     * @param num_threads Worker threads (0 = hardware concurrency)
+     */
+    EnvPool(const ScalarEnvAdapter::Factory& factory, int64_t num_envs, int num_threads = 0);
+
+    /**
+     * @brief Stop the workers (waits for in-flight tasks)
+     */
+    ~EnvPool() override;
+
+    EnvPool(const EnvPool&) = delete;
+    EnvPool& operator=(const EnvPool&) = delete;
+
+    // BatchedEnvironmentInterface (synchronous)
+    void reset_where(const torch::Tensor& mask, torch::Tensor& observations) override;
+    void step_batch(const torch::Tensor& actions, torch::Tensor& observations,
+                    torch::Tensor& rewards, torch::Tensor& dones) override;
+    int64_t num_envs() const override { return static_cast<int64_t>(envs_.size()); }
+    int64_t state_dim() const override { return state_dim_; }
+    int64_t action_dim() const override { return action_dim_; }
+    void close() override;
+
+    /**
+     * @brief Queue one step for each listed environment (non-blocking)
+     *
+     * @param env_ids Environment ids [k] (int64)
+     * @param actions Actions [k] (int64)
+     * @throws std::invalid_argument if an id repeats or already has a task in flight
+     */
+    void send(const torch::Tensor& env_ids, const torch::Tensor& actions);
+
+    /**
+     * @brief Queue a reset for each listed environment (non-blocking)
+     *
+     * @param env_ids Environment ids [k] (int64)
+     * @throws std::invalid_argument if an id repeats or already has a task in flight
+     */
+    void async_reset(const torch::Tensor& env_ids);
+
+    /**
+     * @brief Wait for the first k finished environments
+     *
+     * @param k Results to collect (<= tasks in flight)
+     * @param env_ids Output ids [k] (int64)
+     * @param observations Output states [k, state_dim]
+     * @param rewards Output rewards [k]
+     * @param dones Output episode-ended flags [k]
+     * @return int64_t Number of results written (k)
+     * @throws std::runtime_error if an environment threw while stepping
+     */
+    int64_t recv(int64_t k, torch::Tensor& env_ids, torch::Tensor& observations,
+                 torch::Tensor& rewards, torch::Tensor& dones);
+
+    /**
+     * @brief Tasks sent asynchronously and not yet returned by recv()
+     */
+    int64_t in_flight() const { return in_flight_count_; }
+
+    int num_threads() const { return static_cast<int>(workers_.size()); }
+
+    /**
+     * @brief Tasks executed by a worker other than the one they were queued on
+     */
+    uint64_t steals() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    enum class TaskKind : uint8_t { kStep, kReset };
+
+    struct Task {
+        TaskKind kind = TaskKind::kStep;
+        bool async = false;
+        int64_t begin = 0;                  // Environment range [begin, end)
+        int64_t end = 0;
+        const int64_t* actions = nullptr;   // Indexed by environment id
+        const MaskView* mask = nullptr;     // Resets only: selected environments (null = all)
+        float* observations = nullptr;     // Row i = environment i
+        float* rewards = nullptr;
+        float* dones = nullptr;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void worker_loop(size_t index);
+    bool pop_local(size_t index, Task& task);
+    bool steal(size_t index, Task& task);
+    void run(const Task& task);
+    void push(size_t worker, const Task& task);
+    void run_sync(TaskKind kind, const int64_t* actions, const MaskView* mask,
+                  float* observations, float* rewards, float* dones);
+    void queue_async(const torch::Tensor& env_ids, const int64_t* actions, TaskKind kind);
+    void rethrow_error();
+
+    std::vector<std::unique_ptr<EnvironmentInterface>> envs_;
+    int64_t state_dim_ = 0;
+    int64_t action_dim_ = 0;
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+
+    // Idle workers sleep here until tasks are queued
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    std::atomic<int64_t> queued_{0};
+    bool stop_ = false;
+
+    // Completions: sync chunk counter and async ready queue
+    std::mutex done_mutex_;
+    std::condition_variable done_cv_;
+    int64_t sync_remaining_ = 0;
+    std::deque<int64_t> ready_;
+    std::exception_ptr error_;
+
+    // Async per-environment slots (results land here until recv)
+    std::vector<int64_t> action_slots_;
+    std::vector<float> observation_slots_;
+    std::vector<float> reward_slots_;
+    std::vector<float> done_slots_;
+    std::vector<uint8_t> busy_;             // Caller-thread view of in-flight environments
+    int64_t in_flight_count_ = 0;
+
+    std::atomic<uint64_t> steals_{0};
+};
+
+} // namespace environment
+
+#endif // ENVIRONMENT_ENV_POOL_H
@@ -6,6 +6,24 @@
 
 namespace environment {
 
+/**
+ * @brief Structured per-step information (opt-in, see step_into)
+ *
+ * Replaces parsing StepResult::info; filling it never allocates.
+ */
+struct StepInfo {
+    int64_t step = 0;            // Step index within the episode (1-based)
+    bool truncated = false;      // Ended by a step/time limit rather than a terminal state
+    bool collision = false;      // Touch sensor triggered (robot environments)
+    bool reply_lost = false;     // No matching reply from the robot (networked environments)
+    double rtt_ms = 0.0;         // Round trip of the matched reply (networked environments)
+
+    /**
+     * @brief Human-readable form ("step=N[, truncated][, collision][, reply lost | rtt=X ms]"), for logging only
+     */
+    std::string to_string() const;
+};
+
 /**
  * @brief Result of an environment step
  */
@@ -40,6 +58,68 @@ public:
      */
     virtual StepResult step(int64_t action) = 0;
 
+    /**
+     * @brief Reset, writing the initial state into a caller-owned buffer
+     *
+     * The default implementation calls reset() and copies the tensor;
+     * environments override it with an allocation-free version.
+     *
+     * @param state Destination array of state_dim() floats
+     */
+    virtual void reset_into(float* state);
+
+    /**
+     * @brief Execute an action, writing the next state into a caller-owned buffer
+     *
+     * Allocation-free counterpart of step() for environments that override
+     * it (no state tensor, no info string). The default implementation calls
+     * step() and copies the result.
+     *
+     * @param action Action to execute
+     * @param next_state Destination array of state_dim() floats
+     * @param reward Reward received
+     * @param done Whether the episode ended
+     * @param info Optional structured step information (nullptr to skip)
+     */
+    virtual void step_into(int64_t action, float* next_state, float& reward, bool& done,
+                           StepInfo* info = nullptr);
+
+    /**
+     * @brief Start a step without waiting for its result (split-phase step)
+     *
+     * Returns as soon as the action has been issued; collect the result with
+     * step_wait(). At most one step can be pending. The default
+     * implementation only records the action and runs step_into() inside
+     * step_wait(); I/O-bound environments (robots, network bridges) override
+     * the three calls so the caller can train or log while the robot moves.
+     *
+     * @param action Action to execute
+     * @throws std::logic_error if a step is already pending
+     */
+    virtual void step_async(int64_t action);
+
+    /**
+     * @brief Check whether the pending step has a result
+     *
+     * @param timeout_ms Maximum time to wait for it (0 = just check)
+     * @return true if step_wait() will not block (false if no step is pending)
+     */
+    virtual bool step_poll(int timeout_ms = 0);
+
+    /**
+     * @brief Finish the pending step, blocking until its result is available
+     *
+     * Same outputs as step_into().
+     *
+     * @throws std::logic_error if no step is pending
+     */
+    virtual void step_wait(float* next_state, float& reward, bool& done, StepInfo* info = nullptr);
+
+    /**
+     * @brief Whether a step_async() has not been collected by step_wait() yet
+     */
+    bool step_pending() const { return step_pending_; }
+
     /**
      * @brief Get dimension of state space
      *
@@ -58,6 +138,26 @@ public:
      * @brief Close the environment and clean up resources
      */
     virtual void close() = 0;
+
+protected:
+    /**
+     * @brief Split-phase bookkeeping for step_async() overrides
+     *
+     * @throws std::logic_error if a step is already pending
+     */
+    void begin_step(int64_t action);
+
+    /**
+     * @brief Split-phase bookkeeping for step_wait() overrides
+     *
+     * @return int64_t Action of the pending step
+     * @throws std::logic_error if no step is pending
+     */
+    int64_t end_step();
+
+private:
+    bool step_pending_ = false;
+    int64_t pending_action_ = 0;
 };
 
 } // namespace environment
@@ -2,23 +2,15 @@
 #define ENVIRONMENT_LEGO_ROBOT_ENV_H
 
 #include "environment/environment_interface.h"
+#include "environment/reward_functions.h"
 #include "communication/bluetooth_manager.h"
+#include "utils/clock.h"
+#include <array>
 #include <memory>
 #include <chrono>
 
 namespace environment {
 
-/**
- * @brief Reward function parameters
- */
-struct RewardParams {
-    float forward_success = 1.0f;       // Reward for successful forward movement
-    float collision_penalty = -1.0f;    // Penalty for collision
-    float backward_penalty = -0.1f;     // Penalty for moving backward
-    float turn_reward = 0.0f;           // Reward for turning
-    float orientation_bonus = 0.5f;     // Bonus for stable orientation
-};
-
 /**
  * @brief Lego Robot Environment for DQN Training
  *
@@ -43,47 +35,58 @@ public:
      * @param max_steps_per_episode Maximum steps before episode ends (default: 200)
      * @param episode_timeout_sec Maximum time per episode in seconds (default: 60)
      * @param reward_params Custom reward parameters (optional)
+     * @param clock Time source for the timeout and action waits (default: wall time)
      */
     LegoRobotEnv(const std::string& robot_address,
                  int max_steps_per_episode = 200,
                  int episode_timeout_sec = 60,
-                 const RewardParams& reward_params = RewardParams());
+                 const RewardParams& reward_params = RewardParams(),
+                 utils::Clock& clock = utils::real_clock());
 
     ~LegoRobotEnv() override;
 
     // EnvironmentInterface implementation
     torch::Tensor reset() override;
     StepResult step(int64_t action) override;
+    void reset_into(float* state) override;
+    void step_into(int64_t action, float* next_state, float& reward, bool& done,
+                   StepInfo* info = nullptr) override;
+    void step_async(int64_t action) override;
+    bool step_poll(int timeout_ms = 0) override;
+    void step_wait(float* next_state, float& reward, bool& done, StepInfo* info = nullptr) override;
     int64_t state_dim() const override { return 4; }
     int64_t action_dim() const override { return 4; }
     void close() override;
 
 private:
     /**
-     * @brief Get current state from robot sensors
+     * @brief Read the current state from the robot sensors
      *
-     * @return torch::Tensor State tensor [orientation_x, orientation_y, contact_front, contact_side]
+     * @param state Destination [orientation_x, orientation_y, contact_front, contact_side]
      */
-    torch::Tensor get_current_state();
+    void read_state(float* state);
 
     /**
      * @brief Compute reward based on state and action
      *
-     * @param state Current state
+     * Delegates to LegoRobotReward so the same function can relabel stored
+     * experience offline.
+     *
+     * @param state Current state (4 floats)
      * @param action Action taken
      * @param collision Whether collision occurred
      * @return float Reward value
      */
-    float compute_reward(const torch::Tensor& state, int64_t action, bool collision);
+    float compute_reward(const float* state, int64_t action, bool collision);
 
     /**
      * @brief Check if episode should end
      *
-     * @param state Current state
+     * @param state Current state (4 floats)
      * @param step_count Current step count
      * @return true if episode done
      */
-    bool is_episode_done(const torch::Tensor& state, int step_count);
+    bool is_episode_done(const float* state, int step_count);
 
     // Bluetooth communication
     std::unique_ptr<communication::BluetoothManager> bt_manager_;
@@ -92,13 +95,19 @@ private:
     int max_steps_per_episode_;
     int episode_timeout_sec_;
     RewardParams reward_params_;
+    LegoRobotReward reward_fn_;
+
+    utils::Clock* clock_;
 
     // Episode tracking
     int current_step_;
-    std::chrono::steady_clock::time_point episode_start_time_;
+    utils::Clock::time_point episode_start_time_;
+
+    // When the command of the pending step has finished executing
+    utils::Clock::time_point action_done_time_;
 
     // Previous state for orientation stability tracking
-    torch::Tensor previous_state_;
+    std::array<float, 4> previous_state_{};
 };
 
 } // namespace environment
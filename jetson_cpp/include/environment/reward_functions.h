@@ -0,0 +1,162 @@
+#ifndef ENVIRONMENT_REWARD_FUNCTIONS_H
+#define ENVIRONMENT_REWARD_FUNCTIONS_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "communication/sensor_data.h"
+
+namespace environment {
+
+// Defined next to SensorData so the dqn module can store them without
+// depending on environment
+using communication::SensorRecord;
+using communication::make_sensor_record;
+
+/**
+ * @brief Non-owning structure-of-arrays view over a batch of sensor records
+ *
+ * One contiguous array per channel so reward kernels run as straight loops
+ * the compiler can vectorize. Flags are stored as 0/1 floats and actions as
+ * int32 to keep every lane 32 bits wide.
+ */
+struct SensorBatchView {
+    const float* gyro_angle = nullptr;
+    const float* gyro_rate = nullptr;
+    const float* touch_front = nullptr;
+    const float* touch_side = nullptr;
+    const float* valid = nullptr;
+    const float* truncated = nullptr;
+    const int32_t* actions = nullptr;   // Action taken on the step that produced the reading
+    size_t size = 0;
+};
+
+/**
+ * @brief Owning structure-of-arrays batch of sensor records
+ */
+class SensorBatch {
+public:
+    void reserve(size_t n);
+    void clear();
+    void push_back(const SensorRecord& record, int64_t action);
+
+    size_t size() const { return actions_.size(); }
+    SensorBatchView view() const;
+
+private:
+    std::vector<float> gyro_angle_;
+    std::vector<float> gyro_rate_;
+    std::vector<float> touch_front_;
+    std::vector<float> touch_side_;
+    std::vector<float> valid_;
+    std::vector<float> truncated_;
+    std::vector<int32_t> actions_;
+};
+
+/**
+ * @brief Vectorized reward and termination function over raw sensors
+ *
+ * Implementations compute rewards and dones for a whole batch in one sweep.
+ * The same object is used online (one record per step) and offline when
+ * relabeling a replay buffer or a recorded dataset.
+ */
+class RewardFunction {
+public:
+    virtual ~RewardFunction() = default;
+
+    virtual std::string name() const = 0;
+
+    /**
+     * @brief Compute rewards and dones for a batch
+     *
+     * dones include truncation: done = terminal(sensors) || truncated.
+     *
+     * @param batch Sensor batch
+     * @param rewards Output array [batch.size]
+     * @param dones Output array [batch.size] of 0/1 floats
+     */
+    virtual void compute(const SensorBatchView& batch, float* rewards, float* dones) const = 0;
+
+    /**
+     * @brief Convenience wrapper for a single step
+     *
+     * @param record Sensor reading after the action
+     * @param action Action taken
+     * @param done Output: whether the episode ends
+     * @return float Reward
+     */
+    float compute_one(const SensorRecord& record, int64_t action, bool& done) const;
+};
+
+/**
+ * @brief Reward parameters for the UDP bridge robot (train_robot)
+ */
+struct UDPRewardParams {
+    float invalid_penalty = -1.0f;      // Reward when no valid reading arrived
+    float collision_penalty = -10.0f;   // Reward on any touch sensor (terminal)
+    float stable_angle_deg = 15.0f;     // |angle| below this is stable
+    float stable_bonus = 1.0f;          // Bonus for stable orientation
+    float tilt_angle_deg = 45.0f;       // |angle| above this is penalized
+    float tilt_penalty = -0.5f;         // Penalty for excessive tilt
+    float fall_angle_deg = 60.0f;       // |angle| above this ends the episode
+    float forward_bonus = 0.5f;         // Bonus for FORWARD (action 1)
+    float stop_penalty = -0.1f;         // Penalty for STOP (action 0)
+};
+
+/**
+ * @brief Reward of UDPEnvironment: stability bonus, collision/fall termination
+ */
+class UDPRobotReward : public RewardFunction {
+public:
+    explicit UDPRobotReward(const UDPRewardParams& params = UDPRewardParams()) : params_(params) {}
+
+    std::string name() const override { return "udp"; }
+    void compute(const SensorBatchView& batch, float* rewards, float* dones) const override;
+
+    const UDPRewardParams& params() const { return params_; }
+
+private:
+    UDPRewardParams params_;
+};
+
+/**
+ * @brief Reward function parameters (LegoRobotEnv)
+ */
+struct RewardParams {
+    float forward_success = 1.0f;       // Reward for successful forward movement
+    float collision_penalty = -1.0f;    // Penalty for collision
+    float backward_penalty = -0.1f;     // Penalty for moving backward
+    float turn_reward = 0.0f;           // Reward for turning
+    float orientation_bonus = 0.5f;     // Bonus for stable orientation
+    float stable_orientation = 0.3f;    // Normalized orientation magnitude considered stable
+};
+
+/**
+ * @brief Reward of LegoRobotEnv: action shaping plus orientation bonus
+ *
+ * Actions: 0 forward, 1 backward, 2 left, 3 right.
+ */
+class LegoRobotReward : public RewardFunction {
+public:
+    explicit LegoRobotReward(const RewardParams& params = RewardParams()) : params_(params) {}
+
+    std::string name() const override { return "lego"; }
+    void compute(const SensorBatchView& batch, float* rewards, float* dones) const override;
+
+    const RewardParams& params() const { return params_; }
+
+private:
+    RewardParams params_;
+};
+
+/**
+ * @brief Create a reward function by name ("udp" or "lego")
+ *
+ * @throws std::invalid_argument for unknown names
+ */
+std::unique_ptr<RewardFunction> make_reward_function(const std::string& name);
+
+} // namespace environment
+
+#endif // ENVIRONMENT_REWARD_FUNCTIONS_H
@@ -0,0 +1,126 @@
+#ifndef ENVIRONMENT_SIM_EV3_ENV_H
+#define ENVIRONMENT_SIM_EV3_ENV_H
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "communication/sensor_data.h"
+#include "environment/arena.h"
+#include "environment/environment_interface.h"
+#include "environment/reward_functions.h"
+
+namespace environment {
+
+/**
+ * @brief Parameters of the simulated EV3 robot and its arena
+ *
+ * Distances in meters, angles in degrees, times in seconds.
+ */
+struct SimEV3Params {
+    // Walled arena with a new random layout on every reset
+    ArenaParams arena;
+
+    // Robot (disc) kinematics
+    float robot_radius = 0.08f;
+    float linear_speed = 0.15f;         // FORWARD / BACKWARD
+    float turn_rate_deg = 60.0f;        // LEFT / RIGHT (turn in place)
+    float action_duration = 0.25f;      // Motor time per step
+    float step_period = 0.5f;           // Real-robot wall time per step (action + bridge + pause)
+    int substeps = 5;                   // Integration/contact substeps per action
+
+    // Gyroscope model: white noise, random-walk bias, integer output like the EV3
+    float gyro_angle_noise_deg = 0.5f;
+    float gyro_rate_noise_deg = 2.0f;
+    float gyro_bias_walk_deg = 0.05f;   // Bias std added per step (deg/s)
+    bool gyro_quantize = true;
+
+    // Touch sensors: bumper segments just outside the body (rear bumps are not sensed)
+    BumperGeometry bumpers;
+
+    float dropout_prob = 0.0f;          // Probability of a lost reading (valid = false)
+    int max_steps = 100;                // Truncation, as in train_robot
+};
+
+/**
+ * @brief Simulated EV3 robot with the interface of train_robot's UDPEnvironment
+ *
+ * Same 4-D state (normalized gyro angle, gyro rate, touch_front, touch_side,
+ * see SensorData::toState) and the same 5 actions (STOP, FORWARD, LEFT,
+ * RIGHT, BACKWARD). The robot is a disc driven by a unicycle model inside a
+ * procedurally generated Arena; the touch sensors are bumper segments
+ * queried against the arena's spatial grid. The gyro reports the heading
+ * change since reset, clockwise positive like the EV3 sensor.
+ *
+ * Reward and termination come from UDPRobotReward applied to the simulated
+ * readings, so a policy pre-trained here sees the same rewards as on the
+ * hardware. A step costs well under a microsecond against step_period
+ * seconds on the real robot.
+ */
+class SimEV3Env : public EnvironmentInterface {
+public:
+    /**
+     * @param params Robot, arena and sensor parameters
+     * @param seed Seed for layouts and sensor noise
+     * @param reward_params Reward shared with the real robot
+     */
+    explicit SimEV3Env(const SimEV3Params& params = SimEV3Params(),
+                       uint64_t seed = std::random_device{}(),
+                       const UDPRewardParams& reward_params = UDPRewardParams());
+
+    // Resets throw std::runtime_error if no layout leaves room for the robot
+    torch::Tensor reset() override;
+    StepResult step(int64_t action) override;
+    void reset_into(float* state) override;
+    void step_into(int64_t action, float* next_state, float& reward, bool& done,
+                   StepInfo* info = nullptr) override;
+    int64_t state_dim() const override { return 4; }
+    int64_t action_dim() const override { return 5; }  // STOP, FORWARD, LEFT, RIGHT, BACKWARD
+    void close() override {}
+
+    /**
+     * @brief Raw readings of the last step (stored with the transition for relabeling)
+     */
+    const SensorRecord& last_sensor_record() const { return last_record_; }
+
+    const Arena& arena() const { return arena_; }
+    const SimEV3Params& params() const { return params_; }
+
+    /**
+     * @brief Simulated robot time since construction (steps x step_period)
+     */
+    double simulated_seconds() const { return simulated_seconds_; }
+
+private:
+    void generate_layout();
+
+    // Integrate one action; the body stops at the last collision-free position
+    void move(int64_t action);
+
+    communication::SensorData read_sensors(float rate_deg);
+
+    SimEV3Params params_;
+    UDPRobotReward reward_fn_;
+    std::mt19937 rng_;
+    std::normal_distribution<float> normal_{0.0f, 1.0f};
+    std::uniform_real_distribution<float> uniform_{0.0f, 1.0f};
+
+    Arena arena_;
+
+    // Pose (radians, counter-clockwise positive)
+    float x_ = 0.0f;
+    float y_ = 0.0f;
+    float heading_ = 0.0f;
+    float start_heading_ = 0.0f;
+
+    // Gyro error state: bias (deg/s) and the angle it has integrated (deg)
+    float gyro_bias_ = 0.0f;
+    float gyro_drift_ = 0.0f;
+
+    int step_count_ = 0;
+    double simulated_seconds_ = 0.0;
+    SensorRecord last_record_;
+};
+
+} // namespace environment
+
+#endif // ENVIRONMENT_SIM_EV3_ENV_H
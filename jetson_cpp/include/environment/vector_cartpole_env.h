@@ -0,0 +1,117 @@
+#ifndef ENVIRONMENT_VECTOR_CARTPOLE_ENV_H
+#define ENVIRONMENT_VECTOR_CARTPOLE_ENV_H
+
+#include <torch/torch.h>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "environment/batched_environment.h"
+#include "environment/cartpole_kernels.h"
+
+namespace environment {
+
+/**
+ * @brief N CartPole environments stepped together
+ *
+ * States are kept in structure-of-arrays layout and advanced by
+ * cartpole_step_kernel (AVX2/NEON). Episodes that end are reset in place
+ * (auto-reset), so step() always leaves N live environments behind.
+ *
+ * Through BatchedEnvironmentInterface (step_batch / reset_where) the results
+ * go to caller buffers instead and there is no auto-reset: the caller resets
+ * finished environments with reset_where(dones, observations).
+ *
+ * Outputs are preallocated CPU tensors that every step() overwrites:
+ * - observations() [N, 4]: state after the step (after the reset for
+ *   finished environments, i.e. the first state of the next episode)
+ * - final_observations() [N, 4]: terminal state of finished environments,
+ *   the next_state to store in the replay buffer where dones() is 1
+ * - rewards() [N], dones() [N]: float32, same semantics as CartPoleEnv
+ *   (reward 1 while alive, 0 on the terminal step; truncation counts as done)
+ */
+class VectorCartPoleEnv : public BatchedEnvironmentInterface {
+public:
+    /**
+     * @param num_envs Number of environments (N)
+     * @param max_steps Steps before an episode is truncated
+     * @param seed Seed for the reset distribution
+     */
+    explicit VectorCartPoleEnv(int64_t num_envs, int max_steps = 500,
+                               uint64_t seed = std::random_device{}());
+
+    /**
+     * @brief Reset every environment
+     *
+     * @return const torch::Tensor& Observations [N, 4]
+     */
+    const torch::Tensor& reset();
+
+    /**
+     * @brief Step every environment
+     *
+     * @param actions Actions [N] (int64, CPU), 0 = left, 1 = right
+     */
+    void step(const torch::Tensor& actions);
+    void step(const int64_t* actions);
+
+    // BatchedEnvironmentInterface
+    void reset_where(const torch::Tensor& mask, torch::Tensor& observations) override;
+    void step_batch(const torch::Tensor& actions, torch::Tensor& observations,
+                    torch::Tensor& rewards, torch::Tensor& dones) override;
+    void close() override {}
+
+    const torch::Tensor& observations() const { return observations_; }
+    const torch::Tensor& final_observations() const { return final_observations_; }
+    const torch::Tensor& rewards() const { return rewards_; }
+    const torch::Tensor& dones() const { return dones_; }
+
+    int64_t num_envs() const override { return num_envs_; }
+    int64_t state_dim() const override { return 4; }
+    int64_t action_dim() const override { return 2; }
+
+    /**
+     * @brief Environment steps taken since construction (N per step())
+     */
+    uint64_t total_steps() const { return total_steps_; }
+
+    /**
+     * @brief Episodes finished since construction
+     */
+    uint64_t completed_episodes() const { return completed_episodes_; }
+
+    /**
+     * @brief Mean length of the finished episodes (0 if none)
+     */
+    double mean_episode_length() const;
+
+private:
+    void reset_env(int64_t i);
+
+    // Physics + bookkeeping; final_obs may be null when auto_reset is false
+    void advance(const int64_t* actions, float* obs, float* final_obs,
+                 float* rewards, float* dones, bool auto_reset);
+
+    int64_t num_envs_;
+    int max_steps_;
+    std::mt19937 rng_;
+    std::uniform_real_distribution<float> reset_dist_;
+
+    // SoA state, advanced by the SIMD kernel
+    std::vector<float> x_, x_dot_, theta_, theta_dot_;
+    std::vector<float> force_;
+    std::vector<float> terminal_;
+    std::vector<int32_t> step_count_;
+
+    torch::Tensor observations_;        // [N, 4]
+    torch::Tensor final_observations_;  // [N, 4]
+    torch::Tensor rewards_;             // [N]
+    torch::Tensor dones_;               // [N]
+
+    uint64_t total_steps_ = 0;
+    uint64_t completed_episodes_ = 0;
+    uint64_t completed_episode_steps_ = 0;
+};
+
+} // namespace environment
+
+#endif // ENVIRONMENT_VECTOR_CARTPOLE_ENV_H
@@ -0,0 +1,113 @@
+#ifndef UTILS_CLOCK_H
+#define UTILS_CLOCK_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace utils {
+
+/**
+ * @brief Injectable time source and sleep
+ *
+ * Environments and control loops read time and wait only through a Clock,
+ * so the same code (episode timeouts, reset delays, inter-step pauses,
+ * action pacing) runs on wall time against the robot or on virtual time
+ * against a simulator or fake bridge.
+ */
+class Clock {
+public:
+    using duration = std::chrono::steady_clock::duration;
+    using time_point = std::chrono::steady_clock::time_point;
+
+    virtual ~Clock() = default;
+
+    virtual time_point now() const = 0;
+
+    /**
+     * @brief Wait for d (returns at once for d <= 0)
+     */
+    virtual void sleep_for(duration d) = 0;
+
+    /**
+     * @brief Account for time spent blocked outside the clock
+     *
+     * Call after waiting in the kernel (poll(), a socket timeout) with the
+     * time that was waited. Wall time has already passed; a virtual clock
+     * advances by it so deadlines measured on it still expire.
+     */
+    virtual void elapsed_outside(duration d) = 0;
+
+    /**
+     * @brief Wait until t (returns at once if t has passed)
+     */
+    void sleep_until(time_point t);
+
+    /**
+     * @brief Seconds from t to now()
+     */
+    double seconds_since(time_point t) const;
+
+    virtual std::string name() const = 0;
+};
+
+/**
+ * @brief Wall time: std::chrono::steady_clock and std::this_thread::sleep_for
+ */
+class RealClock : public Clock {
+public:
+    time_point now() const override { return std::chrono::steady_clock::now(); }
+    void sleep_for(duration d) override;
+    void elapsed_outside(duration) override {}
+    std::string name() const override { return "real"; }
+};
+
+/**
+ * @brief Simulated time that only moves when someone sleeps on it
+ *
+ * sleep_for() advances the clock instantly instead of blocking, so a loop
+ * that paces itself with sleeps runs as fast as its computation allows.
+ * Time starts at the steady_clock reading taken at construction. Safe to
+ * share between threads (the offset is atomic).
+ */
+class VirtualClock : public Clock {
+public:
+    VirtualClock();
+
+    time_point now() const override;
+    void sleep_for(duration d) override { advance(d); }
+    void elapsed_outside(duration d) override { advance(d); }
+    std::string name() const override { return "virtual"; }
+
+    /**
+     * @brief Move time forward by d (ignored for d <= 0)
+     */
+    void advance(duration d);
+
+    /**
+     * @brief Virtual time elapsed since construction
+     */
+    duration elapsed() const { return duration(offset_.load(std::memory_order_relaxed)); }
+
+private:
+    time_point origin_;
+    std::atomic<int64_t> offset_{0};   // duration ticks
+};
+
+/**
+ * @brief Process-wide wall clock (default for environments)
+ */
+Clock& real_clock();
+
+/**
+ * @brief Create a clock by name ("real" or "virtual")
+ *
+ * @throws std::invalid_argument for unknown names
+ */
+std::unique_ptr<Clock> make_clock(const std::string& name);
+
+} // namespace utils
+
+#endif // UTILS_CLOCK_H
@@ -0,0 +1,65 @@
+#ifndef UTILS_TIMING_H
+#define UTILS_TIMING_H
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace utils {
+
+/**
+ * @brief Latency statistics of a repeated operation (microseconds)
+ */
+struct LatencyStats {
+    double mean_us = 0.0;
+    double p50_us = 0.0;
+    double p99_us = 0.0;
+    double max_us = 0.0;
+};
+
+/**
+ * @brief Measure per-call latency of a callable
+ *
+ * Runs the callable `warmup` times untimed, then times each of the
+ * following `iterations` calls individually.
+ *
+ * @param fn Callable to benchmark
+ * @param iterations Number of timed calls
+ * @param warmup Number of untimed calls before measuring
+ * @return LatencyStats Mean, median, p99 and max latency
+ */
+template <typename Fn>
+LatencyStats measure_latency(Fn&& fn, int iterations, int warmup = 10) {
+    for (int i = 0; i < warmup; ++i) {
+        fn();
+    }
+
+    std::vector<double> samples;
+    samples.reserve(std::max(iterations, 1));
+    for (int i = 0; i < iterations; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+
+    LatencyStats stats;
+    if (samples.empty()) {
+        return stats;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (double s : samples) {
+        sum += s;
+    }
+    stats.mean_us = sum / samples.size();
+    stats.p50_us = samples[samples.size() / 2];
+    stats.p99_us = samples[std::min(samples.size() - 1, (samples.size() * 99) / 100)];
+    stats.max_us = samples.back();
+    return stats;
+}
+
+} // namespace utils
+
+#endif // UTILS_TIMING_H
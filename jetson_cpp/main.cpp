@@ -17,6 +17,13 @@
  *   ./jetson_dqn <laptop_ip> -p random                    # Modo random
  *   ./jetson_dqn <laptop_ip> -p dqn                       # Modo DQN (sin modelo)
  *   ./jetson_dqn <laptop_ip> -p dqn -m models/dqn.pt     # Modo DQN con modelo
+ *   ./jetson_dqn <laptop_ip> -p dqn -s models/dqn_student.pt  # Student destilado
+ *   ./jetson_dqn <laptop_ip> -p dqn -l models/dqn_table.bin   # Tabla Q (sin LibTorch)
+ *   ./jetson_dqn <laptop_ip> -p dqn -w models/dqn_weights.bin # Pesos mmap (arranque rápido)
+ *   ./jetson_dqn 127.0.0.1 -p random -c virtual            # Bridge falso, sin esperas
+ *   ./jetson_dqn <laptop_ip> -p dqn -f binary             # Protocolo binario (ver wire_protocol.h)
+ *   ./jetson_dqn <laptop_ip> -p dqn -f csv-tagged         # CSV con secuencia (bridge.py actualizado)
+ *   ./jetson_dqn <laptop_ip> -p dqn -t 100                # Telemetría empujada a 100 Hz
  */
 
 #include <iostream>
@@ -24,19 +31,24 @@
 #include <chrono>
 #include <thread>
 #include <csignal>
-#include <sys/socket.h>
-#include <arpa/inet.h>
-#include <unistd.h>
 #include <cstring>
 #include <random>
 #include <memory>
-#include <sstream>
+#include <stdexcept>
 #include <vector>
 
 // DQN includes (código probado de jetson_test)
 #include <torch/torch.h>
-#include "dqn/agent.h"
+#include "dqn/network.h"
 #include "dqn/types.h"
+#include "dqn/distillation.h"
+#include "dqn/inference_backend.h"
+#include "dqn/inference_policy.h"
+#include "dqn/lookup_table_policy.h"
+#include "communication/network_client.h"
+#include "communication/sensor_data.h"
+#include "communication/wire_protocol.h"
+#include "utils/clock.h"
 
 // ============================================================================
 // CONFIGURACIÓN
@@ -48,8 +60,11 @@ const int UDP_PORT = 5000;
 // Frecuencia de acciones (Hz)
 const int ACTION_FREQUENCY = 5;
 
-// Timeout para conexión UDP (segundos)
-const int UDP_TIMEOUT = 5;
+// Espera máxima de la respuesta de sensores (milisegundos)
+const int RECEIVE_TIMEOUT_MS = 300;
+
+// Un frame de telemetría más viejo que esto no se usa para decidir (milisegundos)
+const int TELEMETRY_MAX_AGE_MS = 100;
 
 // Nombres de acciones (para logging)
 const char* ACTION_NAMES[] = {
@@ -78,98 +93,42 @@ void signalHandler(int signum) {
 // SENSOR DATA
 // ============================================================================
 
-/**
- * Datos de sensores recibidos del EV3 vía bridge
- */
-struct SensorData {
-    float gyro_angle;      // Ángulo del giroscopio (grados)
-    float gyro_rate;       // Velocidad angular (grados/segundo)
-    int touch_front;       // Sensor táctil frontal (0 o 1, -1 si no disponible)
-    int touch_side;        // Sensor táctil lateral (0 o 1, -1 si no disponible)
-    bool valid;            // true si los datos son válidos
-
-    SensorData() : gyro_angle(0.0f), gyro_rate(0.0f),
-                   touch_front(-1), touch_side(-1), valid(false) {}
-
-    // Convierte sensores a estado normalizado para DQN
-    // [gyro_angle_norm, gyro_rate_norm, touch_front, touch_side]
-    torch::Tensor toState() const {
-        torch::Tensor state = torch::zeros({4}, torch::kFloat32);
-
-        // Normalizar ángulo de giroscopio a rango [-1, 1]
-        // Asumiendo que ±90 grados es el rango típico
-        state[0] = std::tanh(gyro_angle / 90.0f);
-
-        // Normalizar velocidad angular a rango [-1, 1]
-        // Asumiendo que ±180 grados/segundo es el rango típico
-        state[1] = std::tanh(gyro_rate / 180.0f);
-
-        // Sensores táctiles (binarios: 0 o 1)
-        state[2] = touch_front >= 0 ? static_cast<float>(touch_front) : 0.0f;
-        state[3] = touch_side >= 0 ? static_cast<float>(touch_side) : 0.0f;
-
-        return state;
-    }
-};
+// Datos de sensores recibidos del EV3 vía bridge (ver communication/sensor_data.h)
+using communication::SensorData;
 
 // ============================================================================
 // CLASE UDP SENDER BIDIRECCIONAL
 // ============================================================================
 
 /**
- * Envía acciones y recibe sensores por UDP al/del bridge de la laptop
+ * Envía acciones y recibe sensores por UDP al/del bridge de la laptop.
+ * El socket lo atiende el hilo epoll de communication::NetworkClient: el loop
+ * de control solo encola acciones y recoge respuestas de colas sin bloqueo.
  */
 class UDPSender {
 public:
-    UDPSender(const std::string& ip, int port)
-        : laptop_ip_(ip), port_(port), sock_fd_(-1), connected_(false) {
-
-        // Crear socket UDP
-        sock_fd_ = socket(AF_INET, SOCK_DGRAM, 0);
-        if (sock_fd_ < 0) {
-            std::cerr << "[ERROR] No se pudo crear socket UDP: "
-                      << strerror(errno) << std::endl;
-            return;
-        }
-
-        // Configurar timeout para send
-        struct timeval tv;
-        tv.tv_sec = UDP_TIMEOUT;
-        tv.tv_usec = 0;
-        setsockopt(sock_fd_, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
-
-        // Configurar timeout para receive (300ms para esperar sensores)
-        struct timeval tv_recv;
-        tv_recv.tv_sec = 0;
-        tv_recv.tv_usec = 300000;  // 300ms
-        setsockopt(sock_fd_, SOL_SOCKET, SO_RCVTIMEO, &tv_recv, sizeof(tv_recv));
-
-        // Configurar dirección del servidor
-        memset(&server_addr_, 0, sizeof(server_addr_));
-        server_addr_.sin_family = AF_INET;
-        server_addr_.sin_port = htons(port);
-
-        if (inet_pton(AF_INET, ip.c_str(), &server_addr_.sin_addr) <= 0) {
-            std::cerr << "[ERROR] Dirección IP inválida: " << ip << std::endl;
-            close(sock_fd_);
-            sock_fd_ = -1;
+    UDPSender(const std::string& ip, int port,
+              communication::WireFormat format = communication::WireFormat::kCsv)
+        : laptop_ip_(ip), port_(port) {
+        try {
+            client_ = std::make_unique<communication::NetworkClient>(ip, port, format);
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] " << e.what() << std::endl;
             return;
         }
-
-        connected_ = true;
-        std::cout << "[UDP] Listo para enviar a " << ip << ":" << port << std::endl;
+        std::cout << "[UDP] Listo para enviar a " << ip << ":" << port
+                  << " (hilo de E/S epoll)" << std::endl;
     }
 
     ~UDPSender() {
-        if (sock_fd_ >= 0) {
-            // Enviar STOP final antes de cerrar
+        if (client_) {
+            // Enviar STOP final; el cliente vacía su cola antes de cerrar
             send(0);
-            close(sock_fd_);
         }
     }
 
     bool send(int action, SensorData* sensors_out = nullptr) {
-        if (!connected_ || sock_fd_ < 0) {
+        if (!client_) {
             std::cerr << "[ERROR] Socket UDP no inicializado" << std::endl;
             return false;
         }
@@ -179,15 +138,10 @@ public:
             return false;
         }
 
-        // Convertir acción a string
-        std::string msg = std::to_string(action);
-
-        // Enviar por UDP
-        ssize_t sent = sendto(sock_fd_, msg.c_str(), msg.length(), 0,
-                              (struct sockaddr*)&server_addr_, sizeof(server_addr_));
-
-        if (sent < 0) {
-            std::cerr << "[ERROR] Error al enviar: " << strerror(errno) << std::endl;
+        // Encolar la acción con su secuencia y hora de envío (el hilo de E/S la
+        // codifica y envía; respuestas tardías pendientes se descartan)
+        if (!client_->send_action(action)) {
+            std::cerr << "[ERROR] Cola de acciones llena" << std::endl;
             return false;
         }
 
@@ -213,7 +167,10 @@ public:
                 std::cout << " | Sensors: gyro=" << sensors.gyro_angle
                           << "°, rate=" << sensors.gyro_rate << "°/s"
                           << ", touch=[" << sensors.touch_front << ","
-                          << sensors.touch_side << "]";
+                          << sensors.touch_side << "]"
+                          << " | rtt=" << client_->tracker().last_rtt_ms() << " ms";
+            } else {
+                std::cout << " | Sin respuesta (perdida)";
             }
         }
 
@@ -222,74 +179,47 @@ public:
         return true;
     }
 
+    // Espera hasta 300ms la respuesta a la última acción. Las respuestas
+    // tardías (otra secuencia) se descartan y se sigue esperando.
     SensorData receiveSensors() {
-        SensorData data;
-
-        char recv_buffer[256];
-        memset(recv_buffer, 0, sizeof(recv_buffer));
-
-        struct sockaddr_in from_addr;
-        socklen_t from_len = sizeof(from_addr);
-
-        // Intentar recibir respuesta del bridge (con timeout)
-        ssize_t received = recvfrom(sock_fd_, recv_buffer, sizeof(recv_buffer) - 1, 0,
-                                    (struct sockaddr*)&from_addr, &from_len);
-
-        if (received < 0) {
-            // Timeout o error (normal si no hay sensores)
-            return data;  // data.valid = false
+        SensorData data;  // data.valid = false si no llega a tiempo
+        if (!client_->wait_reply(data, RECEIVE_TIMEOUT_MS)) {
+            client_->expire_reply();
         }
-
-        recv_buffer[received] = '\0';
-        std::string response(recv_buffer);
-
-        // Parsear formato CSV: "gyro_angle,gyro_rate,touch_front,touch_side"
-        // Ejemplo: "12.50,-3.20,0,1"
-        if (parseSensorData(response, data)) {
-            data.valid = true;
-        }
-
         return data;
     }
 
-    bool isConnected() const { return connected_; }
-
-private:
-    bool parseSensorData(const std::string& csv, SensorData& data) {
-        // Formato esperado: "gyro_angle,gyro_rate,touch_front,touch_side"
-        // Ejemplo: "12.50,-3.20,0,1"
-
-        std::istringstream ss(csv);
-        std::string token;
-        std::vector<std::string> tokens;
-
-        // Dividir por comas
-        while (std::getline(ss, token, ',')) {
-            tokens.push_back(token);
-        }
+    // Pide al bridge frames de sensores empujados a rate_hz (0 = cancelar)
+    bool subscribeTelemetry(int rate_hz) {
+        return client_->subscribe_telemetry(rate_hz);
+    }
 
-        if (tokens.size() != 4) {
-            std::cerr << "[WARNING] Formato de sensores inválido: " << csv << std::endl;
+    // Frame de telemetría más reciente si tiene menos de TELEMETRY_MAX_AGE_MS
+    // (lectura sin esperas del buzón que escribe el hilo de E/S)
+    bool freshTelemetry(SensorData& out, double& age_ms) const {
+        communication::TelemetrySample sample;
+        if (!client_->telemetry().latest(sample) || !sample.sensors.valid) {
             return false;
         }
-
-        try {
-            data.gyro_angle = std::stof(tokens[0]);
-            data.gyro_rate = std::stof(tokens[1]);
-            data.touch_front = std::stoi(tokens[2]);
-            data.touch_side = std::stoi(tokens[3]);
-            return true;
-        } catch (const std::exception& e) {
-            std::cerr << "[WARNING] Error parseando sensores: " << e.what() << std::endl;
+        age_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - sample.received_at).count();
+        if (age_ms > TELEMETRY_MAX_AGE_MS) {
             return false;
         }
+        out = sample.sensors;
+        return true;
     }
 
-    int sock_fd_;
-    struct sockaddr_in server_addr_;
+    const communication::RequestTracker& tracker() const { return client_->tracker(); }
+
+    const communication::NetworkClient& client() const { return *client_; }
+
+    bool isConnected() const { return client_ != nullptr; }
+
+private:
     std::string laptop_ip_;
     int port_;
-    bool connected_;
+    std::unique_ptr<communication::NetworkClient> client_;
 };
 
 // ============================================================================
@@ -333,15 +263,44 @@ private:
 /**
  * Política DQN (usa red neuronal entrenada)
  * Código DQN probado y verificado de jetson_test
+ *
+ * Para inferencia solo hace falta la Q-network: no se construye un DQNAgent
+ * (red target, optimizador Adam y replay buffer no se usan al ejecutar).
+ *
+ * Con pesos compactos (-w, ver export_policy) la red se mapea con mmap y se
+ * ejecuta con InferencePolicy: tensores preasignados, sin .to(device) y con
+ * warm-up en el constructor. Es el arranque más rápido y no hace el
+ * micro-benchmark de backends (salvo que se fuerce uno con -b).
+ *
+ * Si se pasa un student destilado (-s), se usa solo esa red pequeña en CPU.
+ *
+ * Con un modelo .pt (-m) o sin modelo, al arrancar mide todos los backends
+ * de inferencia disponibles (LibTorch eager, kernel fp32, kernel int8,
+ * TorchScript si se pasa -j), descarta los que no coinciden en argmax con
+ * LibTorch y usa el de menor latencia p99.
+ *
+ * Con una tabla compilada (-l, ver compile_policy_table) cada decisión es una
+ * interpolación bilineal O(1) y no se usa LibTorch en absoluto.
  */
 class DQNPolicy : public Policy {
 public:
-    DQNPolicy(const std::string& model_path = "")
-        : device_(torch::cuda::is_available() ? torch::kCUDA : torch::kCPU),
-          model_loaded_(false) {
+    DQNPolicy(const std::string& model_path = "", const std::string& student_path = "",
+              const std::string& torchscript_path = "", const std::string& backend_name = "auto",
+              const std::string& table_path = "", const std::string& weights_path = "")
+        : device_(torch::kCPU),
+          model_loaded_(false),
+          q_network_(nullptr),
+          student_(nullptr) {
+
+        // Tabla Q precompilada: no necesita red ni LibTorch
+        if (!table_path.empty() && loadTable(table_path)) {
+            return;
+        }
 
-        // Configurar device (CUDA si está disponible)
-        std::cout << "[DQNPolicy] Using device: " << device_ << std::endl;
+        // Pesos compactos mapeados en memoria: sin deserializar ni benchmark
+        if (!weights_path.empty() && loadWeights(weights_path, backend_name)) {
+            return;
+        }
 
         // Parámetros del entorno EV3
         // state_dim = 4: [gyro_x, gyro_y, contact_front, contact_side]
@@ -349,26 +308,37 @@ public:
         const int64_t state_dim = 4;
         const int64_t action_dim = NUM_ACTIONS;
 
-        // Inicializar hiperparámetros (usar defaults)
-        dqn::Hyperparameters params;
-
-        // Crear agente DQN (código probado de jetson_test)
-        agent_ = std::make_unique<dqn::DQNAgent>(state_dim, action_dim, params, device_);
-        agent_->eval();  // Modo evaluación (no entrenamiento)
+        // Student destilado: red pequeña, siempre en CPU (menos overhead que CUDA)
+        if (student_path.empty() || !loadStudent(student_path, state_dim, action_dim)) {
+            // Configurar device (CUDA si está disponible)
+            device_ = torch::cuda::is_available() ? torch::kCUDA : torch::kCPU;
+            std::cout << "[DQNPolicy] Using device: " << device_ << std::endl;
+
+            // Solo la Q-network (mismas dimensiones ocultas que el entrenamiento)
+            dqn::Hyperparameters params;
+            q_network_ = dqn::QNetwork(state_dim, action_dim, params.hidden_dim1, params.hidden_dim2);
+
+            // Cargar modelo si se especificó
+            if (!model_path.empty()) {
+                loadModel(model_path);
+            } else {
+                std::cout << "[DQNPolicy] No model specified, using random initialization" << std::endl;
+                std::cout << "[DQNPolicy] To use trained model: ./jetson_dqn <ip> -p dqn -m models/dqn_best.pt" << std::endl;
+            }
 
-        // Cargar modelo si se especificó
-        if (!model_path.empty()) {
-            loadModel(model_path);
-        } else {
-            std::cout << "[DQNPolicy] No model specified, using random initialization" << std::endl;
-            std::cout << "[DQNPolicy] To use trained model: ./jetson_dqn <ip> -p dqn -m models/dqn_best.pt" << std::endl;
+            q_network_->to_device(device_);
+            q_network_->eval();  // Modo evaluación (no entrenamiento)
         }
+
+        selectBackend(state_dim, torchscript_path, backend_name);
     }
 
     bool loadModel(const std::string& model_path) {
         try {
+            // Acepta checkpoints completos (DQNAgent::save): la Q-network está
+            // en el nivel superior del archivo
             std::cout << "[DQNPolicy] Loading model from: " << model_path << std::endl;
-            agent_->load(model_path);
+            torch::load(q_network_, model_path);
             model_loaded_ = true;
             std::cout << "[DQNPolicy] ✓ Model loaded successfully" << std::endl;
             return true;
@@ -380,33 +350,92 @@ public:
         }
     }
 
-    int selectAction(const SensorData* sensors = nullptr) override {
-        torch::Tensor state;
+    bool loadWeights(const std::string& weights_path, const std::string& backend_name) {
+        try {
+            std::cout << "[DQNPolicy] Mapping weights from: " << weights_path << std::endl;
+            auto weights = std::make_unique<dqn::InferencePolicy>(weights_path);
+            std::cout << "[DQNPolicy] ✓ Weights mapped (" << weights->size_bytes() / 1024
+                      << " KB, " << weights->load_ms() << " ms incl. warm-up)" << std::endl;
+            model_loaded_ = true;
+            mapped_ = true;
+
+            // Los kernels propios se construyen a partir de los mismos pesos
+            if (backend_name == "dense-fp32") {
+                backend_ = std::make_unique<dqn::DenseBackend>(weights->dense_layers());
+            } else if (backend_name == "dense-int8") {
+                backend_ = std::make_unique<dqn::QuantizedBackend>(weights->dense_layers());
+            } else if (backend_name == "auto" || backend_name == weights->name()) {
+                backend_ = std::move(weights);
+            } else {
+                throw std::runtime_error("backend " + backend_name + " no disponible con -w");
+            }
+            return true;
+        } catch (const std::exception& e) {
+            std::cerr << "[DQNPolicy] ✗ Failed to map weights: " << e.what() << std::endl;
+            std::cerr << "[DQNPolicy] Falling back to network loading" << std::endl;
+            return false;
+        }
+    }
 
-        if (sensors != nullptr && sensors->valid) {
-            // Usar sensores reales del EV3
-            state = sensors->toState();
-        } else {
-            // Fallback: estado dummy (todos ceros) si no hay sensores
-            state = torch::zeros({4}, torch::kFloat32);
+    bool loadStudent(const std::string& student_path, int64_t state_dim, int64_t action_dim) {
+        try {
+            std::cout << "[DQNPolicy] Loading distilled student from: " << student_path << std::endl;
+            student_ = dqn::load_student(student_path, state_dim, action_dim);
+            device_ = torch::kCPU;
+            model_loaded_ = true;
+            std::cout << "[DQNPolicy] ✓ Student loaded (hidden=" << student_->hidden_dim()
+                      << ", device=cpu)" << std::endl;
+            return true;
+        } catch (const std::exception& e) {
+            std::cerr << "[DQNPolicy] ✗ Failed to load student: " << e.what() << std::endl;
+            std::cerr << "[DQNPolicy] Falling back to full DQN" << std::endl;
+            student_ = nullptr;
+            return false;
         }
+    }
 
-        // Mover estado al device correcto
-        state = state.to(device_);
+    bool loadTable(const std::string& table_path) {
+        try {
+            std::cout << "[DQNPolicy] Loading Q lookup table from: " << table_path << std::endl;
+            auto table = std::make_unique<dqn::QLookupTable>(dqn::QLookupTable::load(table_path));
+            std::cout << "[DQNPolicy] ✓ Table loaded (" << table->resolution() << "x"
+                      << table->resolution() << " grid, " << table->size_bytes() / 1024
+                      << " KB)" << std::endl;
+            backend_ = std::move(table);
+            model_loaded_ = true;
+            return true;
+        } catch (const std::exception& e) {
+            std::cerr << "[DQNPolicy] ✗ Failed to load table: " << e.what() << std::endl;
+            std::cerr << "[DQNPolicy] Falling back to network inference" << std::endl;
+            return false;
+        }
+    }
+
+    int selectAction(const SensorData* sensors = nullptr) override {
+        float state[4] = {0.0f, 0.0f, 0.0f, 0.0f};
 
-        // Seleccionar acción usando el agente DQN (código probado)
-        // false = no training mode (greedy, sin epsilon exploration)
-        int64_t action;
-        {
-            torch::NoGradGuard no_grad;  // Deshabilitar gradientes para inferencia
-            action = agent_->select_action(state, false);
+        if (sensors != nullptr && sensors->valid) {
+            // Usar sensores reales del EV3
+            sensors->toState(state);
         }
+        // Si no hay sensores: estado dummy (todos ceros)
 
-        return static_cast<int>(action);
+        // Greedy (sin epsilon exploration) con el backend seleccionado
+        return static_cast<int>(backend_->select_action(state));
     }
 
     std::string getName() const override {
-        return model_loaded_ ? "DQN (trained)" : "DQN (random init)";
+        std::string name;
+        if (mapped_) {
+            name = "DQN (mapped weights)";
+        } else if (!q_network_ && !student_) {
+            name = "DQN (lookup table)";
+        } else if (student_) {
+            name = "DQN (distilled student)";
+        } else {
+            name = model_loaded_ ? "DQN (trained)" : "DQN (random init)";
+        }
+        return name + " [" + backend_->name() + "]";
     }
 
     bool isModelLoaded() const {
@@ -414,9 +443,58 @@ public:
     }
 
 private:
-    std::unique_ptr<dqn::DQNAgent> agent_;
+    void selectBackend(int64_t state_dim, const std::string& torchscript_path,
+                       const std::string& backend_name) {
+        // Red activa: student destilado o Q-network del agente
+        dqn::PolicyNetwork network;
+        if (student_) {
+            network.student = student_;
+        } else {
+            network.q_network = q_network_;
+        }
+
+        // El primer backend es la referencia (LibTorch eager)
+        std::vector<std::unique_ptr<dqn::InferenceBackend>> backends;
+        backends.push_back(std::make_unique<dqn::EagerBackend>(
+            "libtorch-eager", network.forward_fn(), state_dim, device_));
+
+        std::vector<dqn::DenseLayer> layers = dqn::extract_dense_layers(network.module());
+        backends.push_back(std::make_unique<dqn::DenseBackend>(layers));
+        backends.push_back(std::make_unique<dqn::QuantizedBackend>(layers));
+
+        if (!torchscript_path.empty()) {
+            try {
+                backends.push_back(std::make_unique<dqn::TorchScriptBackend>(torchscript_path, state_dim));
+            } catch (const std::exception& e) {
+                std::cerr << "[DQNPolicy] TorchScript no disponible: " << e.what() << std::endl;
+            }
+        }
+
+        // Backend forzado por el usuario (-b)
+        if (backend_name != "auto") {
+            for (auto& backend : backends) {
+                if (backend->name() == backend_name) {
+                    backend_ = std::move(backend);
+                    std::cout << "[DQNPolicy] Backend forzado: " << backend_name << std::endl;
+                    return;
+                }
+            }
+            std::cerr << "[DQNPolicy] Backend desconocido: " << backend_name
+                      << ", usando selección automática" << std::endl;
+        }
+
+        // Micro-benchmark sobre estados de prueba que cubren el espacio de estados
+        torch::Tensor probes = dqn::sample_robot_states(512);
+        size_t best = dqn::select_fastest_backend(backends, probes);
+        backend_ = std::move(backends[best]);
+    }
+
     torch::Device device_;
     bool model_loaded_;
+    bool mapped_ = false;
+    dqn::QNetwork q_network_;
+    dqn::StudentNetwork student_;
+    std::unique_ptr<dqn::InferenceBackend> backend_;
 };
 
 // ============================================================================
@@ -434,12 +512,27 @@ void print_usage(const char* program_name) {
     std::cout << "                   random  = Acciones aleatorias (testing)" << std::endl;
     std::cout << "                   dqn     = DQN con red neuronal" << std::endl;
     std::cout << "  -m <model>       Ruta del modelo .pt (solo con -p dqn)" << std::endl;
+    std::cout << "  -s <student>     Student destilado .pt (solo con -p dqn, ver distill_policy)" << std::endl;
+    std::cout << "  -j <model.ts>    Modelo TorchScript exportado (backend opcional)" << std::endl;
+    std::cout << "  -l <table.bin>   Tabla Q precompilada (sin LibTorch, ver compile_policy_table)" << std::endl;
+    std::cout << "  -w <weights.bin> Pesos compactos mapeados con mmap (ver export_policy)" << std::endl;
+    std::cout << "  -b <backend>     auto | libtorch-eager | dense-fp32 | dense-int8 | torchscript" << std::endl;
+    std::cout << "                   (default: auto = el más rápido que coincide con LibTorch)" << std::endl;
+    std::cout << "                   (con -w: auto | libtorch-mmap | dense-fp32 | dense-int8;" << std::endl;
+    std::cout << "                    auto = libtorch-mmap, sin benchmark)" << std::endl;
+    std::cout << "  -c <clock>       real | virtual (default: real; virtual = sin esperas de ritmo)" << std::endl;
+    std::cout << "  -f <format>      csv | csv-tagged | binary (default: csv; el bridge responde en el mismo formato)" << std::endl;
+    std::cout << "                   (csv-tagged y binary descartan respuestas tardías; requieren el bridge.py actual)" << std::endl;
+    std::cout << "  -t <hz>          Telemetría empujada por el bridge a <hz>; la política decide con el" << std::endl;
+    std::cout << "                   frame más reciente (default: 0 = solo la respuesta a cada acción)" << std::endl;
     std::cout << std::endl;
     std::cout << "Ejemplos:" << std::endl;
     std::cout << "  " << program_name << " 192.168.1.100" << std::endl;
     std::cout << "  " << program_name << " 192.168.1.100 -p random" << std::endl;
     std::cout << "  " << program_name << " 192.168.1.100 -p dqn" << std::endl;
     std::cout << "  " << program_name << " 192.168.1.100 -p dqn -m models/dqn_best.pt" << std::endl;
+    std::cout << "  " << program_name << " 192.168.1.100 -p dqn -s models/dqn_student.pt" << std::endl;
+    std::cout << "  " << program_name << " 192.168.1.100 -p dqn -w models/dqn_weights.bin" << std::endl;
 }
 
 int main(int argc, char* argv[]) {
@@ -454,6 +547,14 @@ int main(int argc, char* argv[]) {
     std::string laptop_ip = argv[1];
     std::string policy_name = "random";
     std::string model_path = "";
+    std::string student_path = "";
+    std::string torchscript_path = "";
+    std::string backend_name = "auto";
+    std::string table_path = "";
+    std::string weights_path = "";
+    std::string clock_name = "real";
+    std::string format_name = "csv";
+    int telemetry_hz = 0;
 
     // Parsear opciones
     for (int i = 2; i < argc; i++) {
@@ -462,6 +563,22 @@ int main(int argc, char* argv[]) {
             policy_name = argv[++i];
         } else if (arg == "-m" && i + 1 < argc) {
             model_path = argv[++i];
+        } else if (arg == "-s" && i + 1 < argc) {
+            student_path = argv[++i];
+        } else if (arg == "-j" && i + 1 < argc) {
+            torchscript_path = argv[++i];
+        } else if (arg == "-b" && i + 1 < argc) {
+            backend_name = argv[++i];
+        } else if (arg == "-l" && i + 1 < argc) {
+            table_path = argv[++i];
+        } else if (arg == "-w" && i + 1 < argc) {
+            weights_path = argv[++i];
+        } else if (arg == "-c" && i + 1 < argc) {
+            clock_name = argv[++i];
+        } else if (arg == "-f" && i + 1 < argc) {
+            format_name = argv[++i];
+        } else if (arg == "-t" && i + 1 < argc) {
+            telemetry_hz = std::atoi(argv[++i]);
         }
     }
 
@@ -474,6 +591,10 @@ int main(int argc, char* argv[]) {
     std::cout << "Laptop Bridge:    " << laptop_ip << ":" << UDP_PORT << std::endl;
     std::cout << "Frecuencia:       " << ACTION_FREQUENCY << " Hz" << std::endl;
     std::cout << "Política:         " << policy_name << std::endl;
+    std::cout << "Reloj:            " << clock_name << std::endl;
+    std::cout << "Protocolo:        " << format_name << std::endl;
+    std::cout << "Telemetría:       " << (telemetry_hz > 0 ? std::to_string(telemetry_hz) + " Hz" : "no")
+              << std::endl;
     std::cout << "Presiona Ctrl+C para detener" << std::endl;
     std::cout << "=========================================================================" << std::endl;
     std::cout << std::endl;
@@ -483,6 +604,18 @@ int main(int argc, char* argv[]) {
     // ========================================================================
     signal(SIGINT, signalHandler);
 
+    // Reloj del loop de control (ritmo de acciones y esperas)
+    std::unique_ptr<utils::Clock> clock;
+    communication::WireFormat wire_format;
+    try {
+        clock = utils::make_clock(clock_name);
+        wire_format = communication::parse_wire_format(format_name);
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] " << e.what() << std::endl;
+        print_usage(argv[0]);
+        return 1;
+    }
+
     // ========================================================================
     // 4. Crear política de selección
     // ========================================================================
@@ -492,8 +625,18 @@ int main(int argc, char* argv[]) {
         policy = std::make_unique<RandomPolicy>();
         std::cout << "[Policy] Usando política aleatoria (testing mode)" << std::endl;
     } else if (policy_name == "dqn") {
+        // Los pesos mapeados solo alimentan estos backends (no hay red ni TorchScript)
+        if (!weights_path.empty() && backend_name != "auto" && backend_name != "libtorch-mmap" &&
+            backend_name != "dense-fp32" && backend_name != "dense-int8") {
+            std::cerr << "[ERROR] Backend " << backend_name << " no disponible con -w "
+                      << "(usa auto, libtorch-mmap, dense-fp32 o dense-int8)" << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
         std::cout << "[Policy] Usando política DQN (código probado de jetson_test)" << std::endl;
-        policy = std::make_unique<DQNPolicy>(model_path);
+        policy = std::make_unique<DQNPolicy>(model_path, student_path,
+                                             torchscript_path, backend_name,
+                                             table_path, weights_path);
     } else {
         std::cerr << "[ERROR] Política desconocida: " << policy_name << std::endl;
         print_usage(argv[0]);
@@ -503,7 +646,7 @@ int main(int argc, char* argv[]) {
     // ========================================================================
     // 5. Inicializar UDP sender
     // ========================================================================
-    UDPSender udp(laptop_ip, UDP_PORT);
+    UDPSender udp(laptop_ip, UDP_PORT, wire_format);
     if (!udp.isConnected()) {
         std::cerr << "[ERROR] No se pudo inicializar UDP sender" << std::endl;
         return 1;
@@ -512,7 +655,11 @@ int main(int argc, char* argv[]) {
     // Enviar STOP inicial para asegurar que el robot está detenido
     std::cout << "[Init] Enviando STOP inicial..." << std::endl;
     udp.send(0);
-    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    if (telemetry_hz > 0) {
+        std::cout << "[Init] Suscribiendo telemetría a " << telemetry_hz << " Hz..." << std::endl;
+        udp.subscribeTelemetry(telemetry_hz);
+    }
+    clock->sleep_for(std::chrono::milliseconds(500));
 
     // ========================================================================
     // 6. Loop principal CON SENSORES
@@ -524,12 +671,21 @@ int main(int argc, char* argv[]) {
     auto delay = std::chrono::milliseconds(1000 / ACTION_FREQUENCY);
     int step = 0;
     SensorData sensors;  // Datos de sensores del EV3
+    int telemetry_decisions = 0;     // Decisiones tomadas con un frame de telemetría
+    double telemetry_age_sum_ms = 0.0;
 
     while (running) {
-        auto start_time = std::chrono::steady_clock::now();
-
-        // Seleccionar acción usando la política (con sensores de la iteración anterior)
-        int action = policy->selectAction(&sensors);
+        auto start_time = clock->now();
+
+        // Seleccionar acción usando la política: con el frame de telemetría más
+        // reciente si hay uno fresco, si no con los sensores de la iteración anterior
+        SensorData decision_sensors = sensors;
+        double telemetry_age_ms = 0.0;
+        if (telemetry_hz > 0 && udp.freshTelemetry(decision_sensors, telemetry_age_ms)) {
+            telemetry_decisions++;
+            telemetry_age_sum_ms += telemetry_age_ms;
+        }
+        int action = policy->selectAction(&decision_sensors);
 
         // Enviar acción por UDP Y recibir sensores actualizados
         if (!udp.send(action, &sensors)) {
@@ -544,17 +700,24 @@ int main(int argc, char* argv[]) {
             if (sensors.valid) {
                 std::cout << " | Gyro: " << sensors.gyro_angle << "°";
             }
+            std::cout << " | RTT medio: " << udp.tracker().mean_rtt_ms() << " ms"
+                      << " | perdidas: " << udp.tracker().lost()
+                      << " | tardías: " << udp.tracker().stale();
+            if (telemetry_hz > 0) {
+                std::cout << " | Telemetría: " << udp.client().telemetry_frames() << " frames, "
+                          << telemetry_decisions << "/" << step << " decisiones";
+            }
             std::cout << std::endl;
             std::cout << "=========================================================================" << std::endl;
         }
 
         // Mantener frecuencia de acciones
-        auto end_time = std::chrono::steady_clock::now();
+        auto end_time = clock->now();
         auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
             end_time - start_time);
 
         if (elapsed < delay) {
-            std::this_thread::sleep_for(delay - elapsed);
+            clock->sleep_for(delay - elapsed);
         }
     }
 
@@ -563,6 +726,24 @@ int main(int argc, char* argv[]) {
     // ========================================================================
     std::cout << "\n\n[Shutdown] Limpiando recursos..." << std::endl;
     std::cout << "  Total steps ejecutados: " << step << std::endl;
+    std::cout << "  Respuestas: " << udp.tracker().matched() << "/" << udp.tracker().sent()
+              << " (perdidas: " << udp.tracker().lost() << ", tardías descartadas: "
+              << udp.tracker().stale() << ")" << std::endl;
+    std::cout << "  RTT medio: " << udp.tracker().mean_rtt_ms() << " ms, máximo: "
+              << udp.tracker().max_rtt_ms() << " ms" << std::endl;
+    std::cout << "  Datagramas: " << udp.client().datagrams_sent() << " enviados, "
+              << udp.client().datagrams_received() << " recibidos ("
+              << udp.client().malformed() << " inválidos, "
+              << udp.client().send_errors() << " errores de envío)" << std::endl;
+    if (telemetry_hz > 0) {
+        std::cout << "  Telemetría: " << udp.client().telemetry_frames() << " frames ("
+                  << udp.client().telemetry().reordered() << " fuera de orden), "
+                  << telemetry_decisions << "/" << step << " decisiones con frame fresco";
+        if (telemetry_decisions > 0) {
+            std::cout << ", antigüedad media " << telemetry_age_sum_ms / telemetry_decisions << " ms";
+        }
+        std::cout << std::endl;
+    }
 
     // El destructor de UDPSender enviará STOP automáticamente
 
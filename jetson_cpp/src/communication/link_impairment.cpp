@@ -0,0 +1,173 @@
+#include "communication/link_impairment.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
+namespace communication {
+
+namespace {
+
+double parse_number(const std::string& key, const std::string& value) {
+    char* end = nullptr;
+    const double x = std::strtod(value.c_str(), &end);
+    if (value.empty() || *end != '\0' || !std::isfinite(x)) {
+        throw std::invalid_argument("LinkImpairment: bad value for '" + key + "': " + value);
+    }
+    return x;
+}
+
+void check_range(const std::string& key, double x, double lo, double hi) {
+    if (x < lo || x > hi) {
+        throw std::invalid_argument("LinkImpairment: '" + key + "' out of range");
+    }
+}
+
+} // namespace
+
+LinkImpairmentParams parse_link_impairment(const std::string& spec) {
+    LinkImpairmentParams params;
+    std::stringstream stream(spec);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (item.empty()) {
+            continue;
+        }
+        const size_t eq = item.find('=');
+        if (eq == std::string::npos) {
+            throw std::invalid_argument("LinkImpairment: expected key=value, got '" + item + "'");
+        }
+        const std::string key = item.substr(0, eq);
+        const std::string value = item.substr(eq + 1);
+
+        if (key == "dist") {
+            if (value == "uniform") {
+                params.distribution = DelayDistribution::kUniform;
+            } else if (value == "normal") {
+                params.distribution = DelayDistribution::kNormal;
+            } else if (value == "pareto") {
+                params.distribution = DelayDistribution::kPareto;
+            } else {
+                throw std::invalid_argument("LinkImpairment: unknown distribution " + value +
+                                            " (uniform | normal | pareto)");
+            }
+            continue;
+        }
+
+        const double x = parse_number(key, value);
+        if (key == "delay") {
+            check_range(key, x, 0.0, 60000.0);
+            params.delay_ms = x;
+        } else if (key == "jitter") {
+            check_range(key, x, 0.0, 60000.0);
+            params.jitter_ms = x;
+        } else if (key == "loss") {
+            check_range(key, x, 0.0, 1.0);
+            params.loss = x;
+        } else if (key == "burst") {
+            check_range(key, x, 1.0, 1e6);
+            params.burst_length = x;
+        } else if (key == "dup") {
+            check_range(key, x, 0.0, 1.0);
+            params.duplicate = x;
+        } else if (key == "reorder") {
+            check_range(key, x, 0.0, 1.0);
+            params.reorder = x;
+        } else if (key == "reorder_ms") {
+            check_range(key, x, 0.0, 60000.0);
+            params.reorder_ms = x;
+        } else {
+            throw std::invalid_argument("LinkImpairment: unknown key '" + key + "'");
+        }
+    }
+    return params;
+}
+
+std::string describe_link_impairment(const LinkImpairmentParams& params) {
+    static const char* kDistributions[] = {"uniform", "normal", "pareto"};
+    std::ostringstream out;
+    out << "delay=" << params.delay_ms << "ms jitter=" << params.jitter_ms << "ms ("
+        << kDistributions[static_cast<int>(params.distribution)] << ") loss=" << params.loss * 100.0
+        << "% burst=" << params.burst_length << " dup=" << params.duplicate * 100.0
+        << "% reorder=" << params.reorder * 100.0 << "% (+" << params.reorder_ms << "ms)";
+    return out.str();
+}
+
+LinkImpairment::LinkImpairment(const LinkImpairmentParams& params, uint64_t seed)
+    : params_(params), rng_(seed) {
+    // Stationary loss of the chain: enter / (enter + leave) = loss
+    const double loss = std::min(params_.loss, 0.999);
+    leave_burst_ = 1.0 / std::max(1.0, params_.burst_length);
+    enter_burst_ = loss > 0.0 ? std::min(1.0, leave_burst_ * loss / (1.0 - loss)) : 0.0;
+}
+
+bool LinkImpairment::lose() {
+    if (params_.loss <= 0.0) {
+        return false;
+    }
+    in_burst_ = in_burst_ ? uniform_(rng_) >= leave_burst_ : uniform_(rng_) < enter_burst_;
+    return in_burst_;
+}
+
+double LinkImpairment::draw_delay_ms() {
+    double extra = 0.0;
+    if (params_.jitter_ms > 0.0) {
+        switch (params_.distribution) {
+        case DelayDistribution::kUniform:
+            extra = params_.jitter_ms * (2.0 * uniform_(rng_) - 1.0);
+            break;
+        case DelayDistribution::kNormal:
+            extra = params_.jitter_ms * normal_(rng_);
+            break;
+        case DelayDistribution::kPareto: {
+            // Pareto with shape a and mean jitter: scale = jitter * (a - 1) / a
+            const double shape = 2.5;
+            const double scale = params_.jitter_ms * (shape - 1.0) / shape;
+            extra = scale / std::pow(1.0 - uniform_(rng_), 1.0 / shape);
+            break;
+        }
+        }
+    }
+    return std::max(0.0, params_.delay_ms + extra);
+}
+
+LinkImpairment::time_point LinkImpairment::release_time(time_point now) {
+    double delay_ms = draw_delay_ms();
+    const bool held_back = params_.reorder > 0.0 && uniform_(rng_) < params_.reorder;
+    if (held_back) {
+        delay_ms += params_.reorder_ms;
+        reordered_++;
+    }
+
+    time_point release = now + std::chrono::duration_cast<time_point::duration>(
+                                   std::chrono::duration<double, std::milli>(delay_ms));
+    if (!held_back) {
+        // FIFO link: jitter does not let a datagram overtake the previous one
+        release = std::max(release, last_release_);
+        last_release_ = release;
+    }
+
+    delivered_++;
+    total_delay_ms_ += std::chrono::duration<double, std::milli>(release - now).count();
+    return release;
+}
+
+int LinkImpairment::schedule(time_point now, time_point* release) {
+    offered_++;
+    if (lose()) {
+        dropped_++;
+        return 0;
+    }
+
+    int copies = 1;
+    release[0] = release_time(now);
+    if (params_.duplicate > 0.0 && uniform_(rng_) < params_.duplicate) {
+        release[1] = release_time(now);
+        duplicated_++;
+        copies = 2;
+    }
+    return copies;
+}
+
+} // namespace communication
@@ -0,0 +1,299 @@
+#include "communication/network_client.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace communication {
+
+namespace {
+
+// Subscriptions are renewed this often; bridges expire them after a few seconds
+constexpr auto kSubscriptionRenewal = std::chrono::seconds(1);
+
+inline void close_fd(int& fd) {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+} // namespace
+
+NetworkClient::NetworkClient(const std::string& bridge_ip, int bridge_port, WireFormat format,
+                             size_t queue_capacity, int spin_us)
+    : format_(format), spin_us_(spin_us), actions_(queue_capacity), replies_(queue_capacity) {
+    std::memset(&bridge_addr_, 0, sizeof(bridge_addr_));
+    bridge_addr_.sin_family = AF_INET;
+    bridge_addr_.sin_port = htons(static_cast<uint16_t>(bridge_port));
+    if (inet_pton(AF_INET, bridge_ip.c_str(), &bridge_addr_.sin_addr) <= 0) {
+        throw std::runtime_error("Invalid bridge address: " + bridge_ip);
+    }
+
+    sock_fd_ = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    action_event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    reply_event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    bool ok = sock_fd_ >= 0 && epoll_fd_ >= 0 && action_event_fd_ >= 0 && reply_event_fd_ >= 0;
+    if (ok) {
+        struct epoll_event ev;
+        std::memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.fd = sock_fd_;
+        ok = epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, sock_fd_, &ev) == 0;
+        ev.data.fd = action_event_fd_;
+        ok = ok && epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, action_event_fd_, &ev) == 0;
+    }
+    if (!ok) {
+        const std::string reason = std::strerror(errno);
+        close_fd(sock_fd_);
+        close_fd(epoll_fd_);
+        close_fd(action_event_fd_);
+        close_fd(reply_event_fd_);
+        throw std::runtime_error("Cannot set up bridge socket: " + reason);
+    }
+
+    io_thread_ = std::thread(&NetworkClient::io_loop, this);
+}
+
+NetworkClient::~NetworkClient() {
+    stop_.store(true);
+    signal(action_event_fd_);
+    if (io_thread_.joinable()) {
+        io_thread_.join();
+    }
+    close_fd(sock_fd_);
+    close_fd(epoll_fd_);
+    close_fd(action_event_fd_);
+    close_fd(reply_event_fd_);
+}
+
+bool NetworkClient::send_action(int action) {
+    // Whatever is still queued answers actions that already expired
+    SensorData stale;
+    take_matching(stale);
+
+    OutgoingMessage out;
+    out.value = action;
+    out.tag = tracker_.next();   // An earlier outstanding action counts as lost
+    if (!actions_.try_push(out)) {
+        tracker_.expire();
+        return false;
+    }
+
+    wake_io();
+    return true;
+}
+
+bool NetworkClient::subscribe_telemetry(int rate_hz) {
+    OutgoingMessage out;
+    out.subscribe = true;
+    out.value = rate_hz;
+    if (!actions_.try_push(out)) {
+        return false;
+    }
+    wake_io();
+    return true;
+}
+
+void NetworkClient::wake_io() {
+    // Pairs with the fence in io_loop: either the I/O thread sees the message
+    // before parking, or we see it parked and wake it
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (io_parked_.load(std::memory_order_relaxed) && io_parked_.exchange(false)) {
+        signal(action_event_fd_);
+    }
+}
+
+bool NetworkClient::poll_reply(SensorData& data) {
+    return take_matching(data);
+}
+
+bool NetworkClient::wait_reply(SensorData& data, int timeout_ms) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (true) {
+        if (take_matching(data)) {
+            return true;
+        }
+
+        const auto remaining = deadline - std::chrono::steady_clock::now();
+        if (remaining <= std::chrono::steady_clock::duration::zero()) {
+            return false;
+        }
+
+        control_parked_.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!replies_.empty()) {
+            control_parked_.store(false);
+            continue;
+        }
+
+        struct timespec ts;
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+        ts.tv_sec = static_cast<time_t>(ns / 1000000000);
+        ts.tv_nsec = static_cast<long>(ns % 1000000000);
+        struct pollfd pfd = {reply_event_fd_, POLLIN, 0};
+        ppoll(&pfd, 1, &ts, nullptr);
+        control_parked_.store(false);
+        clear(reply_event_fd_);
+    }
+}
+
+bool NetworkClient::take_matching(SensorData& data) {
+    SensorFrame frame;
+    while (replies_.try_pop(frame)) {
+        // RTT up to when the I/O thread read the datagram, not when we looked
+        if (tracker_.accept(frame.tag, frame.received_at) != RequestTracker::Match::kStale) {
+            data = frame.sensors;
+            return true;
+        }
+    }
+    return false;
+}
+
+void NetworkClient::io_loop() {
+    struct epoll_event events[4];
+    auto last_activity = std::chrono::steady_clock::now();
+
+    while (true) {
+        flush_actions();
+        if (stop_.load()) {
+            break;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (telemetry_rate_hz_ > 0 && now >= next_renewal_) {
+            send_subscribe(telemetry_rate_hz_);
+        }
+
+        // Spin: poll without sleeping so send_action() needs no wakeup
+        int timeout_ms = 0;
+        if (now - last_activity >= std::chrono::microseconds(spin_us_)) {
+            io_parked_.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!actions_.empty() || stop_.load()) {
+                io_parked_.store(false);
+                continue;
+            }
+            timeout_ms = -1;
+            if (telemetry_rate_hz_ > 0) {
+                timeout_ms = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                    next_renewal_ - now).count()) + 1;
+            }
+        }
+
+        const int n = epoll_wait(epoll_fd_, events, 4, timeout_ms);
+        io_parked_.store(false);
+        if (n < 0 && errno != EINTR) {
+            break;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            if (events[i].data.fd == sock_fd_) {
+                read_socket();
+            } else {
+                clear(action_event_fd_);
+            }
+        }
+        if (n > 0 || !actions_.empty()) {
+            last_activity = std::chrono::steady_clock::now();
+        }
+    }
+
+    if (telemetry_rate_hz_ > 0) {
+        send_subscribe(0);
+    }
+}
+
+void NetworkClient::flush_actions() {
+    OutgoingMessage out;
+    char msg[kMaxWirePacketSize];
+    while (actions_.try_pop(out)) {
+        if (out.subscribe) {
+            send_subscribe(out.value);
+            continue;
+        }
+        send_datagram(msg, encode_action(out.value, format_, msg, sizeof(msg), out.tag));
+    }
+}
+
+void NetworkClient::send_subscribe(int rate_hz) {
+    char msg[kMaxWirePacketSize];
+    send_datagram(msg, encode_subscribe(rate_hz, format_, msg, sizeof(msg)));
+    telemetry_rate_hz_ = rate_hz;
+    next_renewal_ = std::chrono::steady_clock::now() + kSubscriptionRenewal;
+}
+
+void NetworkClient::send_datagram(const char* data, size_t size) {
+    const ssize_t sent = sendto(sock_fd_, data, size, 0,
+                                reinterpret_cast<const struct sockaddr*>(&bridge_addr_),
+                                sizeof(bridge_addr_));
+    if (sent < 0) {
+        send_errors_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        datagrams_sent_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void NetworkClient::read_socket() {
+    char buffer[256];
+    bool pushed = false;
+    while (true) {
+        const ssize_t received = recvfrom(sock_fd_, buffer, sizeof(buffer), 0, nullptr, nullptr);
+        if (received < 0) {
+            if (errno == EINTR) continue;
+            break;  // EAGAIN: drained (or a transient error; epoll will report again)
+        }
+        datagrams_received_.fetch_add(1, std::memory_order_relaxed);
+
+        SensorFrame frame;
+        frame.received_at = std::chrono::steady_clock::now();
+        if (is_telemetry(buffer, static_cast<size_t>(received))) {
+            // Pushed frame: straight into the mailbox, never into the reply ring
+            if (decode_telemetry(buffer, static_cast<size_t>(received), frame.sensors, nullptr,
+                                 &frame.tag)) {
+                telemetry_frames_.fetch_add(1, std::memory_order_relaxed);
+                telemetry_.publish(frame.sensors, frame.tag, frame.received_at);
+            } else {
+                malformed_.fetch_add(1, std::memory_order_relaxed);
+            }
+            continue;
+        }
+        if (!decode_sensors(buffer, static_cast<size_t>(received), frame.sensors, nullptr, &frame.tag)) {
+            malformed_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (replies_.try_push(frame)) {
+            pushed = true;
+        } else {
+            dropped_replies_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    if (pushed) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (control_parked_.load(std::memory_order_relaxed) && control_parked_.exchange(false)) {
+            signal(reply_event_fd_);
+        }
+    }
+}
+
+void NetworkClient::signal(int fd) {
+    const uint64_t one = 1;
+    ssize_t ignored = ::write(fd, &one, sizeof(one));
+    (void)ignored;
+}
+
+void NetworkClient::clear(int fd) {
+    uint64_t value;
+    ssize_t ignored = ::read(fd, &value, sizeof(value));
+    (void)ignored;
+}
+
+} // namespace communication
@@ -0,0 +1,48 @@
+#include "communication/request_tracker.h"
+#include <algorithm>
+
+namespace communication {
+
+WireTag RequestTracker::next(time_point now) {
+    if (outstanding_) {
+        expire();
+    }
+
+    // Sequence 0 is reserved for untagged peers
+    if (++sequence_ == 0) {
+        sequence_ = 1;
+    }
+    pending_.sequence = sequence_;
+    pending_.timestamp_us = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count());
+    sent_at_ = now;
+    outstanding_ = true;
+    sent_++;
+    return pending_;
+}
+
+RequestTracker::Match RequestTracker::accept(const WireTag& reply, time_point now) {
+    const bool untagged = reply.sequence == 0;
+    if (!outstanding_ ||
+        (!untagged && (reply.sequence != pending_.sequence ||
+                       reply.timestamp_us != pending_.timestamp_us))) {
+        stale_++;
+        return Match::kStale;
+    }
+
+    outstanding_ = false;
+    last_rtt_ms_ = std::chrono::duration<double, std::milli>(now - sent_at_).count();
+    total_rtt_ms_ += last_rtt_ms_;
+    max_rtt_ms_ = std::max(max_rtt_ms_, last_rtt_ms_);
+    matched_++;
+    return untagged ? Match::kUntagged : Match::kMatched;
+}
+
+void RequestTracker::expire() {
+    if (outstanding_) {
+        outstanding_ = false;
+        lost_++;
+    }
+}
+
+} // namespace communication
@@ -0,0 +1,61 @@
+#include "communication/telemetry_mailbox.h"
+
+namespace communication {
+
+namespace {
+
+// Backward jumps up to this many frames may be reordering, larger ones are a restart
+constexpr uint32_t kReorderWindow = 1024;
+
+} // namespace
+
+bool TelemetryMailbox::publish(const SensorData& sensors, const WireTag& frame,
+                               std::chrono::steady_clock::time_point received_at) {
+    const uint64_t count = published_.load(std::memory_order_relaxed);
+    // A frame behind the newest is a late one only if it was also sent
+    // earlier; a newer bridge clock with a lower counter means the bridge
+    // restarted and its counter began again
+    if (count > 0 && last_frame_ - frame.sequence < kReorderWindow &&
+        frame.timestamp_us <= last_time_us_) {
+        reordered_.fetch_add(1, std::memory_order_relaxed);   // Older or duplicate
+        return false;
+    }
+    last_frame_ = frame.sequence;
+    last_time_us_ = frame.timestamp_us;
+
+    TelemetrySample sample;
+    sample.sensors = sensors;
+    sample.frame = frame.sequence;
+    sample.bridge_time_us = frame.timestamp_us;
+    sample.index = count + 1;
+    sample.received_at = received_at;
+
+    ring_[count % kHistory].store(sample);
+    latest_.store(sample);
+    published_.store(count + 1, std::memory_order_release);
+    return true;
+}
+
+bool TelemetryMailbox::latest(TelemetrySample& out) const {
+    if (published() == 0) {
+        return false;
+    }
+    out = latest_.load();
+    return true;
+}
+
+size_t TelemetryMailbox::history(TelemetrySample* out, size_t max_samples) const {
+    const uint64_t count = published();
+    size_t n = 0;
+    while (n < max_samples && n < kHistory && n < count) {
+        const uint64_t index = count - n;   // 1-based index of the wanted sample
+        const TelemetrySample sample = ring_[(index - 1) % kHistory].load();
+        if (sample.index != index) {
+            break;   // Overwritten by a newer frame while we were reading
+        }
+        out[n++] = sample;
+    }
+    return n;
+}
+
+} // namespace communication
@@ -0,0 +1,454 @@
+#include "communication/wire_protocol.h"
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace communication {
+
+namespace {
+
+constexpr uint8_t kFlagTouchFront = 1 << 0;
+constexpr uint8_t kFlagTouchSide = 1 << 1;
+constexpr uint8_t kFlagFrontUnavailable = 1 << 2;
+constexpr uint8_t kFlagSideUnavailable = 1 << 3;
+
+inline bool is_csv(WireFormat format) {
+    return format != WireFormat::kBinary;
+}
+
+// Explicit little-endian stores/loads (independent of the host byte order)
+inline void store_u16(uint8_t* p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+inline uint16_t load_u16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline void store_u32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+    p[2] = static_cast<uint8_t>(v >> 16);
+    p[3] = static_cast<uint8_t>(v >> 24);
+}
+
+inline uint32_t load_u32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline void store_u64(uint8_t* p, uint64_t v) {
+    store_u32(p, static_cast<uint32_t>(v));
+    store_u32(p + 4, static_cast<uint32_t>(v >> 32));
+}
+
+inline uint64_t load_u64(const uint8_t* p) {
+    return static_cast<uint64_t>(load_u32(p)) | (static_cast<uint64_t>(load_u32(p + 4)) << 32);
+}
+
+inline void store_f32(uint8_t* p, float f) {
+    uint32_t v;
+    std::memcpy(&v, &f, sizeof(v));
+    store_u32(p, v);
+}
+
+inline float load_f32(const uint8_t* p) {
+    const uint32_t v = load_u32(p);
+    float f;
+    std::memcpy(&f, &v, sizeof(f));
+    return f;
+}
+
+inline void store_header(uint8_t* p, uint8_t type, uint8_t payload, const WireTag& tag) {
+    p[0] = kWireMagic;
+    p[1] = kWireVersion;
+    p[2] = type;
+    p[3] = payload;
+    store_u32(p + 4, tag.sequence);
+    store_u64(p + 8, tag.timestamp_us);
+}
+
+// Header and trailing checksum of a binary packet of the given type and size
+inline bool check_packet(const uint8_t* p, size_t size, uint8_t type, size_t expected) {
+    return size == expected && p[0] == kWireMagic && p[1] == kWireVersion && p[2] == type &&
+           load_u16(p + expected - 2) == wire_checksum(p, expected - 2);
+}
+
+// CSV datagrams are short; terminate a stack copy for strtof/strtol
+inline bool terminated_copy(const char* data, size_t size, char* out, size_t capacity) {
+    if (size >= capacity) {
+        return false;
+    }
+    std::memcpy(out, data, size);
+    out[size] = '\0';
+    return true;
+}
+
+inline const char* skip_trailing(const char* p) {
+    while (*p == ' ' || *p == '\r' || *p == '\n') ++p;
+    return p;
+}
+
+// Optional ",sequence,timestamp_us" suffix of a CSV datagram; advances cursor
+inline bool parse_csv_tag(const char*& cursor, WireTag& tag) {
+    tag = WireTag();
+    if (*cursor != ',') {
+        return true;  // Untagged
+    }
+    char* end = nullptr;
+    const unsigned long long sequence = std::strtoull(cursor + 1, &end, 10);
+    if (end == cursor + 1 || *end != ',' || sequence > UINT32_MAX) {
+        return false;
+    }
+    cursor = end + 1;
+    const unsigned long long timestamp = std::strtoull(cursor, &end, 10);
+    if (end == cursor) {
+        return false;
+    }
+    cursor = end;
+    tag.sequence = static_cast<uint32_t>(sequence);
+    tag.timestamp_us = timestamp;
+    return true;
+}
+
+inline size_t finish_csv(int len, size_t capacity) {
+    return len > 0 && static_cast<size_t>(len) < capacity ? static_cast<size_t>(len) : 0;
+}
+
+// Sensors and telemetry share the 26-byte layout; only the type differs
+size_t encode_sensor_packet(const SensorData& sensors, uint8_t type, const WireTag& tag, char* out,
+                            size_t capacity) {
+    if (capacity < kSensorPacketSize) {
+        return 0;
+    }
+    uint8_t flags = 0;
+    if (sensors.touch_front < 0) {
+        flags |= kFlagFrontUnavailable;
+    } else if (sensors.touch_front != 0) {
+        flags |= kFlagTouchFront;
+    }
+    if (sensors.touch_side < 0) {
+        flags |= kFlagSideUnavailable;
+    } else if (sensors.touch_side != 0) {
+        flags |= kFlagTouchSide;
+    }
+
+    uint8_t* p = reinterpret_cast<uint8_t*>(out);
+    store_header(p, type, flags, tag);
+    store_f32(p + 16, sensors.gyro_angle);
+    store_f32(p + 20, sensors.gyro_rate);
+    store_u16(p + 24, wire_checksum(p, 24));
+    return kSensorPacketSize;
+}
+
+bool decode_sensor_packet(const uint8_t* p, size_t size, uint8_t type, SensorData& sensors,
+                          WireTag* tag) {
+    if (!check_packet(p, size, type, kSensorPacketSize)) {
+        return false;
+    }
+    const float gyro_angle = load_f32(p + 16);
+    const float gyro_rate = load_f32(p + 20);
+    if (!std::isfinite(gyro_angle) || !std::isfinite(gyro_rate)) {
+        return false;
+    }
+    const uint8_t flags = p[3];
+    if (tag != nullptr) {
+        tag->sequence = load_u32(p + 4);
+        tag->timestamp_us = load_u64(p + 8);
+    }
+    sensors.gyro_angle = gyro_angle;
+    sensors.gyro_rate = gyro_rate;
+    sensors.touch_front = (flags & kFlagFrontUnavailable) ? -1 : ((flags & kFlagTouchFront) ? 1 : 0);
+    sensors.touch_side = (flags & kFlagSideUnavailable) ? -1 : ((flags & kFlagTouchSide) ? 1 : 0);
+    sensors.valid = true;
+    return true;
+}
+
+// Touch sensors report -1 (unavailable), 0 or 1
+inline bool is_touch_value(float value) {
+    return value == -1.0f || value == 0.0f || value == 1.0f;
+}
+
+// "gyro_angle,gyro_rate,touch_front,touch_side"; advances cursor, leaves valid alone
+bool parse_csv_sensors(const char*& cursor, SensorData& sensors) {
+    float values[4];
+    for (int i = 0; i < 4; ++i) {
+        char* end = nullptr;
+        values[i] = std::strtof(cursor, &end);
+        if (end == cursor || !std::isfinite(values[i])) return false;
+        cursor = end;
+        if (i < 3) {
+            if (*cursor != ',') return false;
+            ++cursor;
+        }
+    }
+    if (!is_touch_value(values[2]) || !is_touch_value(values[3])) {
+        return false;
+    }
+    sensors.gyro_angle = values[0];
+    sensors.gyro_rate = values[1];
+    sensors.touch_front = static_cast<int>(values[2]);
+    sensors.touch_side = static_cast<int>(values[3]);
+    return true;
+}
+
+} // namespace
+
+uint16_t wire_checksum(const uint8_t* data, size_t size) {
+    // Reduce once per block instead of per byte (360 bytes cannot overflow 32 bits)
+    uint32_t a = 0;
+    uint32_t b = 0;
+    while (size > 0) {
+        const size_t block = size < 360 ? size : 360;
+        for (size_t i = 0; i < block; ++i) {
+            a += data[i];
+            b += a;
+        }
+        a %= 255;
+        b %= 255;
+        data += block;
+        size -= block;
+    }
+    return static_cast<uint16_t>((b << 8) | a);
+}
+
+size_t encode_action(int action, WireFormat format, char* out, size_t capacity,
+                     const WireTag& tag) {
+    if (is_csv(format)) {
+        if (format == WireFormat::kCsv || tag.sequence == 0) {
+            return finish_csv(std::snprintf(out, capacity, "%d", action), capacity);
+        }
+        return finish_csv(std::snprintf(out, capacity, "%d,%" PRIu32 ",%" PRIu64, action,
+                                        tag.sequence, tag.timestamp_us),
+                          capacity);
+    }
+
+    if (capacity < kActionPacketSize) {
+        return 0;
+    }
+    uint8_t* p = reinterpret_cast<uint8_t*>(out);
+    store_header(p, kWireTypeAction, static_cast<uint8_t>(action), tag);
+    store_u16(p + 16, wire_checksum(p, 16));
+    return kActionPacketSize;
+}
+
+size_t encode_sensors(const SensorData& sensors, WireFormat format, char* out, size_t capacity,
+                      const WireTag& tag) {
+    if (is_csv(format)) {
+        if (format == WireFormat::kCsv || tag.sequence == 0) {
+            return finish_csv(std::snprintf(out, capacity, "%.2f,%.2f,%d,%d", sensors.gyro_angle,
+                                            sensors.gyro_rate, sensors.touch_front,
+                                            sensors.touch_side),
+                              capacity);
+        }
+        return finish_csv(std::snprintf(out, capacity, "%.2f,%.2f,%d,%d,%" PRIu32 ",%" PRIu64,
+                                        sensors.gyro_angle, sensors.gyro_rate, sensors.touch_front,
+                                        sensors.touch_side, tag.sequence, tag.timestamp_us),
+                          capacity);
+    }
+
+    return encode_sensor_packet(sensors, kWireTypeSensors, tag, out, capacity);
+}
+
+bool decode_action(const char* data, size_t size, int& action, WireFormat* format, WireTag* tag) {
+    if (size == 0) {
+        return false;
+    }
+
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+    if (p[0] == kWireMagic) {
+        if (format != nullptr) *format = WireFormat::kBinary;
+        if (!check_packet(p, size, kWireTypeAction, kActionPacketSize)) {
+            return false;
+        }
+        action = p[3];
+        if (tag != nullptr) {
+            tag->sequence = load_u32(p + 4);
+            tag->timestamp_us = load_u64(p + 8);
+        }
+        return true;
+    }
+
+    // CSV: "N" or "N,sequence,timestamp_us"
+    if (format != nullptr) *format = WireFormat::kCsv;
+    char text[kMaxWirePacketSize];
+    if (!terminated_copy(data, size, text, sizeof(text))) {
+        return false;
+    }
+    char* end = nullptr;
+    const long value = std::strtol(text, &end, 10);
+    if (end == text || value < 0 || value > 255) {
+        return false;
+    }
+    const char* cursor = end;
+    WireTag parsed;
+    if (!parse_csv_tag(cursor, parsed) || *skip_trailing(cursor) != '\0') {
+        return false;
+    }
+    action = static_cast<int>(value);
+    if (format != nullptr && parsed.sequence != 0) *format = WireFormat::kCsvTagged;
+    if (tag != nullptr) *tag = parsed;
+    return true;
+}
+
+bool decode_sensors(const char* data, size_t size, SensorData& sensors, WireFormat* format,
+                    WireTag* tag) {
+    sensors.valid = false;
+    if (size == 0) {
+        return false;
+    }
+
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+    if (p[0] == kWireMagic) {
+        if (format != nullptr) *format = WireFormat::kBinary;
+        return decode_sensor_packet(p, size, kWireTypeSensors, sensors, tag);
+    }
+
+    // CSV: "gyro_angle,gyro_rate,touch_front,touch_side[,sequence,timestamp_us]"
+    if (format != nullptr) *format = WireFormat::kCsv;
+    char text[kMaxWirePacketSize];
+    if (!terminated_copy(data, size, text, sizeof(text))) {
+        return false;
+    }
+    SensorData parsed;
+    WireTag parsed_tag;
+    const char* cursor = text;
+    if (!parse_csv_sensors(cursor, parsed) || !parse_csv_tag(cursor, parsed_tag) ||
+        *skip_trailing(cursor) != '\0') {
+        return false;
+    }
+
+    sensors = parsed;
+    sensors.valid = true;
+    if (format != nullptr && parsed_tag.sequence != 0) *format = WireFormat::kCsvTagged;
+    if (tag != nullptr) *tag = parsed_tag;
+    return true;
+}
+
+size_t encode_subscribe(int rate_hz, WireFormat format, char* out, size_t capacity) {
+    if (is_csv(format)) {
+        return finish_csv(std::snprintf(out, capacity, "S,%d", rate_hz), capacity);
+    }
+
+    if (capacity < kActionPacketSize) {
+        return 0;
+    }
+    WireTag rate;
+    rate.sequence = static_cast<uint32_t>(rate_hz);
+    uint8_t* p = reinterpret_cast<uint8_t*>(out);
+    store_header(p, kWireTypeSubscribe, 0, rate);
+    store_u16(p + 16, wire_checksum(p, 16));
+    return kActionPacketSize;
+}
+
+bool decode_subscribe(const char* data, size_t size, int& rate_hz, WireFormat* format) {
+    if (size == 0) {
+        return false;
+    }
+
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+    if (p[0] == kWireMagic) {
+        if (format != nullptr) *format = WireFormat::kBinary;
+        if (!check_packet(p, size, kWireTypeSubscribe, kActionPacketSize) ||
+            load_u32(p + 4) > 65535) {
+            return false;
+        }
+        rate_hz = static_cast<int>(load_u32(p + 4));
+        return true;
+    }
+
+    // CSV: "S,rate_hz"
+    if (format != nullptr) *format = WireFormat::kCsv;
+    char text[kMaxWirePacketSize];
+    if (!terminated_copy(data, size, text, sizeof(text)) || text[0] != 'S' || text[1] != ',') {
+        return false;
+    }
+    char* end = nullptr;
+    const long value = std::strtol(text + 2, &end, 10);
+    if (end == text + 2 || value < 0 || value > 65535 || *skip_trailing(end) != '\0') {
+        return false;
+    }
+    rate_hz = static_cast<int>(value);
+    return true;
+}
+
+size_t encode_telemetry(const SensorData& sensors, WireFormat format, char* out, size_t capacity,
+                        const WireTag& frame) {
+    if (is_csv(format)) {
+        return finish_csv(std::snprintf(out, capacity, "T,%.2f,%.2f,%d,%d,%" PRIu32 ",%" PRIu64,
+                                        sensors.gyro_angle, sensors.gyro_rate, sensors.touch_front,
+                                        sensors.touch_side, frame.sequence, frame.timestamp_us),
+                          capacity);
+    }
+    return encode_sensor_packet(sensors, kWireTypeTelemetry, frame, out, capacity);
+}
+
+bool decode_telemetry(const char* data, size_t size, SensorData& sensors, WireFormat* format,
+                      WireTag* frame) {
+    sensors.valid = false;
+    if (size == 0) {
+        return false;
+    }
+
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+    if (p[0] == kWireMagic) {
+        if (format != nullptr) *format = WireFormat::kBinary;
+        return decode_sensor_packet(p, size, kWireTypeTelemetry, sensors, frame);
+    }
+
+    // CSV: "T,gyro_angle,gyro_rate,touch_front,touch_side,frame,timestamp_us"
+    if (format != nullptr) *format = WireFormat::kCsv;
+    char text[kMaxWirePacketSize];
+    if (!terminated_copy(data, size, text, sizeof(text)) || text[0] != 'T' || text[1] != ',') {
+        return false;
+    }
+    SensorData parsed;
+    WireTag parsed_frame;
+    const char* cursor = text + 2;
+    if (!parse_csv_sensors(cursor, parsed) || *cursor != ',' ||
+        !parse_csv_tag(cursor, parsed_frame) || *skip_trailing(cursor) != '\0') {
+        return false;
+    }
+
+    sensors = parsed;
+    sensors.valid = true;
+    if (frame != nullptr) *frame = parsed_frame;
+    return true;
+}
+
+bool is_telemetry(const char* data, size_t size) {
+    if (size == 0) {
+        return false;
+    }
+    if (static_cast<uint8_t>(data[0]) == kWireMagic) {
+        return size > 2 && static_cast<uint8_t>(data[2]) == kWireTypeTelemetry;
+    }
+    return data[0] == 'T';
+}
+
+WireFormat parse_wire_format(const std::string& name) {
+    if (name == "csv") {
+        return WireFormat::kCsv;
+    }
+    if (name == "csv-tagged") {
+        return WireFormat::kCsvTagged;
+    }
+    if (name == "binary") {
+        return WireFormat::kBinary;
+    }
+    throw std::invalid_argument("Unknown wire format: " + name + " (expected csv, csv-tagged or binary)");
+}
+
+const char* wire_format_name(WireFormat format) {
+    switch (format) {
+        case WireFormat::kCsvTagged: return "csv-tagged";
+        case WireFormat::kBinary: return "binary";
+        default: return "csv";
+    }
+}
+
+} // namespace communication
@@ -1,6 +1,9 @@
 #include "dqn/agent.h"
+#include <algorithm>
 #include <iostream>
 #include <random>
+#include <sstream>
+#include <ATen/CPUGeneratorImpl.h>
 
 namespace dqn {
 
@@ -37,8 +40,9 @@ DQNAgent::DQNAgent(int64_t state_dim, int64_t action_dim,
         torch::optim::AdamOptions(params.learning_rate)
     );
 
-    // Create replay buffer
+    // Create replay buffers
     replay_buffer_ = std::make_unique<ReplayBuffer>(params.buffer_capacity);
+    synthetic_buffer_ = std::make_unique<ReplayBuffer>(params.synthetic_buffer_capacity);
 
     std::cout << "[DQNAgent] Initialized with:" << std::endl;
     std::cout << "  State dim: " << state_dim << std::endl;
@@ -76,45 +80,90 @@ int64_t DQNAgent::select_action(const torch::Tensor& state, bool training) {
     return action;
 }
 
+torch::Tensor DQNAgent::select_actions(const torch::Tensor& states, bool training) {
+    torch::NoGradGuard no_grad;
+
+    // Greedy actions for the whole batch
+    torch::Tensor state_tensor = states.to(device_);
+    if (state_tensor.dim() == 1) {
+        state_tensor = state_tensor.unsqueeze(0);
+    }
+    torch::Tensor actions = q_network_->forward(state_tensor).argmax(1).to(torch::kCPU);
+
+    // Epsilon-greedy: replace a random subset with random actions
+    if (training && epsilon_ > 0.0f) {
+        auto actions_a = actions.accessor<int64_t, 1>();
+        std::uniform_int_distribution<int64_t> action_dist(0, action_dim_ - 1);
+        for (int64_t i = 0; i < actions.size(0); ++i) {
+            if (uniform_dist_(rng_) < epsilon_) {
+                actions_a[i] = action_dist(rng_);
+            }
+        }
+    }
+
+    return actions;
+}
+
 void DQNAgent::store_transition(const torch::Tensor& state, int64_t action, float reward,
                                 const torch::Tensor& next_state, bool done) {
     replay_buffer_->push(state, action, reward, next_state, done);
 }
 
+void DQNAgent::store_transition(const torch::Tensor& state, int64_t action, float reward,
+                                const torch::Tensor& next_state, bool done,
+                                const communication::SensorRecord& sensors) {
+    replay_buffer_->push(state, action, reward, next_state, done, sensors);
+}
+
 float DQNAgent::train_step() {
+    // Split the minibatch between real and synthetic (Dyna) experience
+    size_t synthetic_size = std::min(
+        static_cast<size_t>(params_.synthetic_ratio * params_.batch_size + 0.5f),
+        params_.batch_size - 1);  // Always keep at least one real transition
+    if (synthetic_size > 0 && !synthetic_buffer_->can_sample(synthetic_size)) {
+        synthetic_size = 0;  // Not enough imagined transitions yet
+    }
+    size_t real_size = params_.batch_size - synthetic_size;
+
     // Check if we have enough samples in the buffer
-    if (!replay_buffer_->can_sample(params_.batch_size)) {
+    if (!replay_buffer_->can_sample(real_size)) {
         return -1.0f;  // Not enough samples yet
     }
 
-    // Sample a batch from replay buffer
-    TransitionBatch batch = replay_buffer_->sample(params_.batch_size);
+    // Sample a batch from replay buffer (with cached target values for this version)
+    TransitionBatch batch = replay_buffer_->sample(real_size, target_version_);
+
+    // ========== Compute Target Q-values ==========
+    // Target: r + gamma * max_a' Q_target(s', a') * (1 - done)
+    // max_a' Q_target(s', a') comes from the cache; only stale rows are recomputed
+    torch::Tensor max_next_q_values = compute_max_next_q(*replay_buffer_, batch);  // [batch_size, 1]
+
+    if (synthetic_size > 0) {
+        TransitionBatch synthetic = synthetic_buffer_->sample(synthetic_size, target_version_);
+        torch::Tensor synthetic_max_next_q = compute_max_next_q(*synthetic_buffer_, synthetic);
+
+        batch.states = torch::cat({batch.states, synthetic.states}, 0);
+        batch.actions = torch::cat({batch.actions, synthetic.actions}, 0);
+        batch.rewards = torch::cat({batch.rewards, synthetic.rewards}, 0);
+        batch.dones = torch::cat({batch.dones, synthetic.dones}, 0);
+        max_next_q_values = torch::cat({max_next_q_values, synthetic_max_next_q}, 0);
+    }
 
     // Move batch tensors to device
     batch.states = batch.states.to(device_);
     batch.actions = batch.actions.to(device_);
     batch.rewards = batch.rewards.to(device_);
-    batch.next_states = batch.next_states.to(device_);
     batch.dones = batch.dones.to(device_);
 
+    // Apply Bellman equation (constant w.r.t. the Q-network parameters)
+    torch::Tensor target_q_values = batch.rewards +
+                                    params_.gamma * max_next_q_values * (1.0f - batch.dones);
+
     // ========== Compute Current Q-values ==========
     // Q(s, a) for the actions that were taken
     torch::Tensor q_values = q_network_->forward(batch.states);  // [batch_size, action_dim]
     torch::Tensor current_q_values = q_values.gather(1, batch.actions);  // [batch_size, 1]
 
-    // ========== Compute Target Q-values ==========
-    torch::NoGradGuard no_grad;  // No gradients for target network
-
-    // Target: r + gamma * max_a' Q_target(s', a') * (1 - done)
-    torch::Tensor next_q_values = target_network_->forward(batch.next_states);  // [batch_size, action_dim]
-    torch::Tensor max_next_q_values = std::get<0>(next_q_values.max(1, true));  // [batch_size, 1]
-
-    // Apply Bellman equation
-    torch::Tensor target_q_values = batch.rewards +
-                                    params_.gamma * max_next_q_values * (1.0f - batch.dones);
-
-    no_grad.~NoGradGuard();  // Re-enable gradients
-
     // ========== Compute Loss ==========
     // Mean Squared Error between current Q-values and target Q-values
     torch::Tensor loss = torch::mse_loss(current_q_values, target_q_values);
@@ -129,6 +178,29 @@ float DQNAgent::train_step() {
     return loss.item<float>();
 }
 
+torch::Tensor DQNAgent::compute_max_next_q(ReplayBuffer& buffer, const TransitionBatch& batch) {
+    torch::NoGradGuard no_grad;  // No gradients for target network
+
+    torch::Tensor max_next_q = batch.max_next_q.clone();  // [batch_size, 1], CPU
+    const int64_t num_stale = static_cast<int64_t>(batch.stale_rows.size());
+
+    target_cache_hits_ += max_next_q.size(0) - num_stale;
+    target_cache_misses_ += num_stale;
+
+    if (num_stale > 0) {
+        torch::Tensor rows = torch::tensor(batch.stale_rows, torch::kLong);
+        torch::Tensor next_states = batch.next_states.index_select(0, rows.to(batch.next_states.device())).to(device_);
+
+        torch::Tensor next_q_values = target_network_->forward(next_states);  // [num_stale, action_dim]
+        torch::Tensor fresh = std::get<0>(next_q_values.max(1, true)).to(torch::kCPU);  // [num_stale, 1]
+
+        max_next_q.index_copy_(0, rows, fresh);
+        buffer.update_target_cache(batch, fresh, target_version_);
+    }
+
+    return max_next_q.to(device_);
+}
+
 void DQNAgent::update_target_network() {
     // Copy weights from Q-network to target network
     torch::NoGradGuard no_grad;
@@ -145,33 +217,103 @@ void DQNAgent::update_target_network() {
         }
     }
 
-    std::cout << "[DQNAgent] Target network updated at step " << training_steps_ << std::endl;
+    // Invalidate every cached target value in O(1)
+    target_version_++;
+
+    int64_t lookups = target_cache_hits_ + target_cache_misses_;
+    std::cout << "[DQNAgent] Target network updated at step " << training_steps_;
+    if (lookups > 0) {
+        std::cout << " (target cache hit rate: "
+                  << (100.0 * target_cache_hits_ / lookups) << "%)";
+    }
+    std::cout << std::endl;
+    target_cache_hits_ = 0;
+    target_cache_misses_ = 0;
 }
 
 void DQNAgent::decay_epsilon() {
     epsilon_ = std::max(params_.epsilon_end, epsilon_ * params_.epsilon_decay);
 }
 
-void DQNAgent::save(const std::string& filepath) {
-    try {
-        torch::serialize::OutputArchive archive;
+TrainingCheckpoint DQNAgent::snapshot(bool include_replay) const {
+    TrainingCheckpoint checkpoint;
+
+    // Networks
+    checkpoint.q_network = snapshot_module(*q_network_);
+    checkpoint.target_network = snapshot_module(*target_network_);
+
+    // Optimizer state (Adam moments and step counts): tensor copies only, the
+    // archive is built by whoever writes the checkpoint
+    checkpoint.optimizer = snapshot_adam(*optimizer_);
+
+    // Schedules and counters
+    checkpoint.epsilon = epsilon_;
+    checkpoint.training_steps = training_steps_;
+    checkpoint.target_version = target_version_;
+
+    // RNG states (epsilon-greedy and torch::rand used by augmentation)
+    std::ostringstream rng_stream;
+    rng_stream << rng_;
+    checkpoint.rng_state = rng_stream.str();
+    {
+        auto generator = at::detail::getDefaultCPUGenerator();
+        std::lock_guard<std::mutex> lock(generator.mutex());
+        checkpoint.torch_rng_state = generator.get_state();
+    }
 
-        // Save Q-network parameters
-        q_network_->save(archive);
+    // Replay buffers (real and Dyna synthetic)
+    if (include_replay) {
+        checkpoint.has_replay = true;
+        checkpoint.replay = replay_buffer_->export_data();
+        checkpoint.replay_rng_state = replay_buffer_->rng_state();
+        checkpoint.synthetic = synthetic_buffer_->export_data();
+        checkpoint.synthetic_rng_state = synthetic_buffer_->rng_state();
+    }
 
-        // Save optimizer state
-        torch::serialize::OutputArchive optimizer_archive;
-        optimizer_->save(optimizer_archive);
+    return checkpoint;
+}
 
-        // Create a dictionary to save everything
-        torch::Dict<std::string, torch::Tensor> state_dict;
+void DQNAgent::restore(const TrainingCheckpoint& checkpoint) {
+    restore_module(*q_network_, checkpoint.q_network);
+    restore_module(*target_network_, checkpoint.target_network);
+
+    restore_adam(*optimizer_, checkpoint.optimizer);
+
+    epsilon_ = checkpoint.epsilon;
+    training_steps_ = checkpoint.training_steps;
+    // Target values cached by the current networks (synthetic buffer, or the
+    // replay buffer when it is not replaced) belong to the old target network:
+    // move past every version either side has used so none of them is reused
+    target_version_ = std::max(target_version_, checkpoint.target_version) + 1;
+
+    std::istringstream rng_stream(checkpoint.rng_state);
+    rng_stream >> rng_;
+    if (checkpoint.torch_rng_state.defined()) {
+        auto generator = at::detail::getDefaultCPUGenerator();
+        std::lock_guard<std::mutex> lock(generator.mutex());
+        generator.set_state(checkpoint.torch_rng_state);
+    }
 
-        // Save epsilon and training steps as tensors
-        state_dict.insert("epsilon", torch::tensor(epsilon_));
-        state_dict.insert("training_steps", torch::tensor(static_cast<int64_t>(training_steps_)));
+    if (checkpoint.has_replay) {
+        // Imported transitions start with a stale target cache and are
+        // recomputed on first use with the restored target network
+        replay_buffer_->clear();
+        replay_buffer_->import_data(checkpoint.replay);
+        replay_buffer_->set_rng_state(checkpoint.replay_rng_state);
+        synthetic_buffer_->clear();
+        if (checkpoint.synthetic.defined()) {
+            synthetic_buffer_->import_data(checkpoint.synthetic);
+            synthetic_buffer_->set_rng_state(checkpoint.synthetic_rng_state);
+        }
+    }
+}
 
-        // Save to file
-        torch::save(q_network_, filepath);
+void DQNAgent::save(const std::string& filepath, bool include_replay,
+                    const std::map<std::string, double>& counters) {
+    try {
+        TrainingCheckpoint checkpoint = snapshot(include_replay);
+        checkpoint.counters = counters;
+        checkpoint.save(filepath);
 
         std::cout << "[DQNAgent] Model saved to: " << filepath << std::endl;
     } catch (const std::exception& e) {
@@ -180,6 +322,19 @@ void DQNAgent::save(const std::string& filepath) {
 }
 
 void DQNAgent::load(const std::string& filepath) {
+    try {
+        restore(TrainingCheckpoint::load(filepath));
+        std::cout << "[DQNAgent] Checkpoint loaded from: " << filepath
+                  << " (training_steps=" << training_steps_
+                  << ", epsilon=" << epsilon_ << ")" << std::endl;
+        return;
+    } catch (const NotATrainingCheckpoint&) {
+        // Weights-only file: fall back to the legacy format below
+    } catch (const std::exception& e) {
+        std::cerr << "[DQNAgent] Error loading model: " << e.what() << std::endl;
+        return;
+    }
+
     try {
         // Load model
         torch::load(q_network_, filepath);
@@ -0,0 +1,69 @@
+#include "dqn/augmentation.h"
+#include <numeric>
+#include <stdexcept>
+
+namespace dqn {
+
+MirrorSymmetry MirrorSymmetry::ev3_left_right() {
+    MirrorSymmetry symmetry;
+    symmetry.negate_dims = {0, 1};           // gyro_angle, gyro_rate
+    symmetry.action_map = {0, 1, 3, 2, 4};   // STOP, FORWARD, RIGHT, LEFT, BACKWARD
+    symmetry.asymmetric_dims = {3};          // touch_side
+    return symmetry;
+}
+
+SymmetryAugmentation::SymmetryAugmentation(const MirrorSymmetry& symmetry, int64_t state_dim,
+                                           float mirror_prob)
+    : mirror_prob_(mirror_prob) {
+
+    if (symmetry.action_map.empty()) {
+        throw std::invalid_argument("SymmetryAugmentation: action_map must not be empty");
+    }
+
+    std::vector<int64_t> columns(state_dim);
+    std::iota(columns.begin(), columns.end(), 0);
+    std::vector<float> sign(state_dim, 1.0f);
+
+    for (const auto& swap : symmetry.swap_dims) {
+        std::swap(columns[swap.first], columns[swap.second]);
+    }
+    for (int64_t dim : symmetry.negate_dims) {
+        sign[dim] = -1.0f;
+    }
+
+    column_index_ = torch::tensor(columns, torch::kLong);
+    sign_ = torch::tensor(sign, torch::kFloat32);
+    action_map_ = torch::tensor(symmetry.action_map, torch::kLong);
+    asymmetric_index_ = torch::tensor(symmetry.asymmetric_dims, torch::kLong);
+}
+
+torch::Tensor SymmetryAugmentation::sample_mask(const torch::Tensor& states,
+                                                const torch::Tensor& next_states) const {
+    const int64_t batch_size = states.size(0);
+    torch::Tensor mask = torch::rand({batch_size}) < mirror_prob_;
+
+    if (asymmetric_index_.numel() > 0) {
+        torch::Tensor blocked =
+            states.index_select(1, asymmetric_index_).ne(0).any(1) |
+            next_states.index_select(1, asymmetric_index_).ne(0).any(1);
+        mask = mask & blocked.logical_not();
+    }
+    return mask;
+}
+
+torch::Tensor SymmetryAugmentation::mirror_states(const torch::Tensor& states) const {
+    return states.index_select(1, column_index_) * sign_;
+}
+
+void SymmetryAugmentation::apply(torch::Tensor& states, torch::Tensor& next_states,
+                                 torch::Tensor& actions, const torch::Tensor& mask) const {
+    torch::Tensor row_mask = mask.unsqueeze(1);
+
+    states = torch::where(row_mask, mirror_states(states), states);
+    next_states = torch::where(row_mask, mirror_states(next_states), next_states);
+
+    torch::Tensor mirrored_actions = action_map_.index_select(0, actions.view({-1})).view_as(actions);
+    actions = torch::where(row_mask, mirrored_actions, actions);
+}
+
+} // namespace dqn
@@ -0,0 +1,393 @@
+#include "dqn/checkpoint.h"
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+
+namespace dqn {
+
+namespace {
+
+// Key of a parameter in optimizer state(): a string in LibTorch 1.x, the
+// TensorImpl pointer in 2.x
+template <typename StateMap>
+typename StateMap::key_type optimizer_state_key(const torch::Tensor& param) {
+    if constexpr (std::is_same<typename StateMap::key_type, std::string>::value) {
+        std::ostringstream key;   // Same text as c10::guts::to_string
+        key << param.unsafeGetTensorImpl();
+        return key.str();
+    } else {
+        return param.unsafeGetTensorImpl();
+    }
+}
+
+torch::Tensor clone_to_cpu(const torch::Tensor& t) {
+    return t.detach().to(torch::kCPU).clone();
+}
+
+torch::Tensor string_to_tensor(const std::string& s) {
+    if (s.empty()) {
+        return torch::empty({0}, torch::kUInt8);
+    }
+    return torch::from_blob(const_cast<char*>(s.data()), {static_cast<int64_t>(s.size())},
+                            torch::kUInt8).clone();
+}
+
+std::string tensor_to_string(const torch::Tensor& t) {
+    torch::Tensor bytes = t.to(torch::kCPU, torch::kUInt8).contiguous();
+    const char* data = reinterpret_cast<const char*>(bytes.data_ptr<uint8_t>());
+    return std::string(data, data + bytes.numel());
+}
+
+std::string join_names(const NamedTensors& tensors) {
+    std::string joined;
+    for (const auto& entry : tensors) {
+        joined += entry.first;
+        joined += '\n';
+    }
+    return joined;
+}
+
+std::vector<std::string> split_names(const std::string& joined) {
+    std::vector<std::string> names;
+    std::istringstream in(joined);
+    std::string name;
+    while (std::getline(in, name)) {
+        if (!name.empty()) {
+            names.push_back(name);
+        }
+    }
+    return names;
+}
+
+// Write tensors with dotted names as nested archives, the same layout
+// torch::nn::Module::save() produces ("fc1.weight" -> archive fc1, key weight)
+void write_nested(torch::serialize::OutputArchive& archive, const NamedTensors& tensors) {
+    std::map<std::string, NamedTensors> children;
+    for (const auto& entry : tensors) {
+        size_t dot = entry.first.find('.');
+        if (dot == std::string::npos) {
+            archive.write(entry.first, entry.second);
+        } else {
+            children[entry.first.substr(0, dot)].emplace_back(entry.first.substr(dot + 1), entry.second);
+        }
+    }
+    for (const auto& child : children) {
+        torch::serialize::OutputArchive child_archive;
+        write_nested(child_archive, child.second);
+        archive.write(child.first, child_archive);
+    }
+}
+
+torch::Tensor read_nested(torch::serialize::InputArchive& archive, const std::string& name) {
+    size_t dot = name.find('.');
+    if (dot == std::string::npos) {
+        torch::Tensor tensor;
+        archive.read(name, tensor);
+        return tensor;
+    }
+    torch::serialize::InputArchive child;
+    archive.read(name.substr(0, dot), child);
+    return read_nested(child, name.substr(dot + 1));
+}
+
+void write_module_tensors(torch::serialize::OutputArchive& archive, const std::string& key,
+                          const NamedTensors& tensors) {
+    archive.write(key + "_names", string_to_tensor(join_names(tensors)));
+}
+
+NamedTensors read_module_tensors(torch::serialize::InputArchive& names_archive, const std::string& key,
+                                 torch::serialize::InputArchive& tensor_archive) {
+    torch::Tensor names;
+    names_archive.read(key + "_names", names);
+
+    NamedTensors tensors;
+    for (const std::string& name : split_names(tensor_to_string(names))) {
+        tensors.emplace_back(name, read_nested(tensor_archive, name));
+    }
+    return tensors;
+}
+
+torch::Tensor scalar_tensor(double value) {
+    return torch::tensor(value, torch::kFloat64);
+}
+
+// Adam moments as plain tensors: steps[i] = -1 marks a parameter without state
+void write_optimizer(torch::serialize::OutputArchive& ckpt, const std::string& key,
+                     const std::vector<AdamParamSnapshot>& optimizer) {
+    torch::Tensor steps = torch::full({static_cast<int64_t>(optimizer.size())}, -1, torch::kInt64);
+    torch::serialize::OutputArchive moments;
+    for (size_t i = 0; i < optimizer.size(); ++i) {
+        const AdamParamSnapshot& param = optimizer[i];
+        if (!param.exp_avg.defined()) {
+            continue;
+        }
+        const std::string index = std::to_string(i);
+        steps[static_cast<int64_t>(i)] = param.step;
+        moments.write("exp_avg_" + index, param.exp_avg);
+        moments.write("exp_avg_sq_" + index, param.exp_avg_sq);
+        if (param.max_exp_avg_sq.defined()) {
+            moments.write("max_exp_avg_sq_" + index, param.max_exp_avg_sq);
+        }
+    }
+    ckpt.write(key + "_steps", steps);
+    ckpt.write(key + "_moments", moments);
+}
+
+std::vector<AdamParamSnapshot> read_optimizer(torch::serialize::InputArchive& ckpt, const std::string& key) {
+    torch::Tensor steps;
+    ckpt.read(key + "_steps", steps);
+    torch::serialize::InputArchive moments;
+    ckpt.read(key + "_moments", moments);
+
+    std::vector<AdamParamSnapshot> optimizer(static_cast<size_t>(steps.numel()));
+    for (size_t i = 0; i < optimizer.size(); ++i) {
+        const int64_t step = steps[static_cast<int64_t>(i)].item<int64_t>();
+        if (step < 0) {
+            continue;
+        }
+        const std::string index = std::to_string(i);
+        AdamParamSnapshot& param = optimizer[i];
+        param.step = step;
+        moments.read("exp_avg_" + index, param.exp_avg);
+        moments.read("exp_avg_sq_" + index, param.exp_avg_sq);
+        torch::Tensor max_exp_avg_sq;
+        if (moments.try_read("max_exp_avg_sq_" + index, max_exp_avg_sq)) {
+            param.max_exp_avg_sq = max_exp_avg_sq;
+        }
+    }
+    return optimizer;
+}
+
+} // namespace
+
+void TrainingCheckpoint::save(const std::string& filepath) const {
+    // Q-network at the top level (torch::load(QNetwork) compatible)
+    torch::serialize::OutputArchive archive;
+    write_nested(archive, q_network);
+
+    torch::serialize::OutputArchive ckpt;
+    ckpt.write("format_version", torch::tensor(kFormatVersion));
+    write_module_tensors(ckpt, "q_network", q_network);
+    write_module_tensors(ckpt, "target_network", target_network);
+
+    torch::serialize::OutputArchive target_archive;
+    write_nested(target_archive, target_network);
+    ckpt.write("target_network", target_archive);
+
+    write_optimizer(ckpt, "optimizer", optimizer);
+    ckpt.write("epsilon", torch::tensor(epsilon));
+    ckpt.write("training_steps", torch::tensor(training_steps));
+    ckpt.write("target_version", torch::tensor(target_version));
+    ckpt.write("rng_state", string_to_tensor(rng_state));
+    if (torch_rng_state.defined()) {
+        ckpt.write("torch_rng_state", torch_rng_state);
+    }
+
+    ckpt.write("has_replay", torch::tensor(has_replay ? 1 : 0));
+    if (has_replay && replay.defined()) {
+        torch::serialize::OutputArchive replay_archive;
+        replay.write(replay_archive);
+        ckpt.write("replay", replay_archive);
+        ckpt.write("replay_rng_state", string_to_tensor(replay_rng_state));
+    }
+    if (has_replay && synthetic.defined()) {
+        torch::serialize::OutputArchive synthetic_archive;
+        synthetic.write(synthetic_archive);
+        ckpt.write("synthetic", synthetic_archive);
+        ckpt.write("synthetic_rng_state", string_to_tensor(synthetic_rng_state));
+    }
+
+    ckpt.write("has_dynamics", torch::tensor(has_dynamics ? 1 : 0));
+    if (has_dynamics) {
+        torch::serialize::OutputArchive dynamics_archive;
+        write_nested(dynamics_archive, dynamics_model);
+        write_module_tensors(ckpt, "dynamics_model", dynamics_model);
+        ckpt.write("dynamics_model", dynamics_archive);
+        write_optimizer(ckpt, "dynamics_optimizer", dynamics_optimizer);
+    }
+
+    NamedTensors counter_tensors;
+    for (const auto& c : counters) {
+        counter_tensors.emplace_back(c.first, scalar_tensor(c.second));
+    }
+    torch::serialize::OutputArchive counters_archive;
+    for (const auto& c : counter_tensors) {
+        counters_archive.write(c.first, c.second);
+    }
+    write_module_tensors(ckpt, "counters", counter_tensors);
+    ckpt.write("counters", counters_archive);
+
+    archive.write("checkpoint", ckpt);
+    archive.save_to(filepath);
+}
+
+TrainingCheckpoint TrainingCheckpoint::load(const std::string& filepath) {
+    torch::serialize::InputArchive archive;
+    archive.load_from(filepath);
+
+    torch::serialize::InputArchive ckpt;
+    if (!archive.try_read("checkpoint", ckpt)) {
+        throw NotATrainingCheckpoint("TrainingCheckpoint: " + filepath + " holds model weights only");
+    }
+
+    torch::Tensor version;
+    ckpt.read("format_version", version);
+    if (version.item<int64_t>() != kFormatVersion) {
+        throw std::runtime_error("TrainingCheckpoint: unsupported format version " +
+                                 std::to_string(version.item<int64_t>()));
+    }
+
+    TrainingCheckpoint checkpoint;
+    checkpoint.q_network = read_module_tensors(ckpt, "q_network", archive);
+
+    torch::serialize::InputArchive target_archive;
+    ckpt.read("target_network", target_archive);
+    checkpoint.target_network = read_module_tensors(ckpt, "target_network", target_archive);
+
+    checkpoint.optimizer = read_optimizer(ckpt, "optimizer");
+
+    torch::Tensor t;
+    ckpt.read("epsilon", t);
+    checkpoint.epsilon = t.item<float>();
+    ckpt.read("training_steps", t);
+    checkpoint.training_steps = t.item<int64_t>();
+    ckpt.read("target_version", t);
+    checkpoint.target_version = t.item<int64_t>();
+    ckpt.read("rng_state", t);
+    checkpoint.rng_state = tensor_to_string(t);
+    torch::Tensor torch_rng_state;
+    if (ckpt.try_read("torch_rng_state", torch_rng_state)) {
+        checkpoint.torch_rng_state = torch_rng_state;
+    }
+
+    ckpt.read("has_replay", t);
+    checkpoint.has_replay = t.item<int64_t>() != 0;
+    if (checkpoint.has_replay) {
+        torch::serialize::InputArchive replay_archive;
+        if (ckpt.try_read("replay", replay_archive)) {
+            checkpoint.replay.read(replay_archive);
+            ckpt.read("replay_rng_state", t);
+            checkpoint.replay_rng_state = tensor_to_string(t);
+        }
+        torch::serialize::InputArchive synthetic_archive;
+        if (ckpt.try_read("synthetic", synthetic_archive)) {
+            checkpoint.synthetic.read(synthetic_archive);
+            ckpt.read("synthetic_rng_state", t);
+            checkpoint.synthetic_rng_state = tensor_to_string(t);
+        }
+    }
+
+    checkpoint.has_dynamics = ckpt.try_read("has_dynamics", t) && t.item<int64_t>() != 0;
+    if (checkpoint.has_dynamics) {
+        torch::serialize::InputArchive dynamics_archive;
+        ckpt.read("dynamics_model", dynamics_archive);
+        checkpoint.dynamics_model = read_module_tensors(ckpt, "dynamics_model", dynamics_archive);
+        checkpoint.dynamics_optimizer = read_optimizer(ckpt, "dynamics_optimizer");
+    }
+
+    torch::serialize::InputArchive counters_archive;
+    ckpt.read("counters", counters_archive);
+    for (const auto& c : read_module_tensors(ckpt, "counters", counters_archive)) {
+        checkpoint.counters[c.first] = c.second.item<double>();
+    }
+
+    return checkpoint;
+}
+
+double TrainingCheckpoint::counter(const std::string& name, double fallback) const {
+    auto it = counters.find(name);
+    return it != counters.end() ? it->second : fallback;
+}
+
+NamedTensors snapshot_module(const torch::nn::Module& module) {
+    NamedTensors tensors;
+    for (const auto& p : module.named_parameters(true)) {
+        tensors.emplace_back(p.key(), p.value().detach().to(torch::kCPU).clone());
+    }
+    for (const auto& b : module.named_buffers(true)) {
+        tensors.emplace_back(b.key(), b.value().detach().to(torch::kCPU).clone());
+    }
+    return tensors;
+}
+
+void restore_module(torch::nn::Module& module, const NamedTensors& tensors) {
+    std::unordered_map<std::string, const torch::Tensor*> by_name;
+    for (const auto& entry : tensors) {
+        by_name[entry.first] = &entry.second;
+    }
+
+    torch::NoGradGuard no_grad;
+    auto copy_into = [&](const std::string& name, torch::Tensor& dst) {
+        auto it = by_name.find(name);
+        if (it == by_name.end()) {
+            throw std::runtime_error("restore_module: missing tensor " + name);
+        }
+        dst.copy_(*it->second);
+    };
+
+    for (auto& p : module.named_parameters(true)) {
+        copy_into(p.key(), p.value());
+    }
+    for (auto& b : module.named_buffers(true)) {
+        copy_into(b.key(), b.value());
+    }
+}
+
+std::vector<AdamParamSnapshot> snapshot_adam(const torch::optim::Adam& optimizer) {
+    using StateMap = std::decay_t<decltype(optimizer.state())>;
+    const auto& state = optimizer.state();
+    std::vector<AdamParamSnapshot> snapshot;
+    for (const auto& group : optimizer.param_groups()) {
+        for (const auto& param : group.params()) {
+            AdamParamSnapshot entry;
+            auto it = state.find(optimizer_state_key<StateMap>(param));
+            if (it != state.end()) {
+                const auto& adam = static_cast<const torch::optim::AdamParamState&>(*it->second);
+                entry.step = adam.step();
+                entry.exp_avg = clone_to_cpu(adam.exp_avg());
+                entry.exp_avg_sq = clone_to_cpu(adam.exp_avg_sq());
+                if (adam.max_exp_avg_sq().defined()) {
+                    entry.max_exp_avg_sq = clone_to_cpu(adam.max_exp_avg_sq());
+                }
+            }
+            snapshot.push_back(std::move(entry));
+        }
+    }
+    return snapshot;
+}
+
+void restore_adam(torch::optim::Adam& optimizer, const std::vector<AdamParamSnapshot>& snapshot) {
+    if (snapshot.empty()) {
+        return;
+    }
+
+    using StateMap = std::decay_t<decltype(optimizer.state())>;
+    auto& state = optimizer.state();
+    state.clear();
+    size_t index = 0;
+    for (const auto& group : optimizer.param_groups()) {
+        for (const auto& param : group.params()) {
+            if (index >= snapshot.size()) {
+                throw std::runtime_error("Checkpoint optimizer state has too few parameters");
+            }
+            const AdamParamSnapshot& entry = snapshot[index++];
+            if (!entry.exp_avg.defined()) {
+                continue;
+            }
+            auto adam = std::make_unique<torch::optim::AdamParamState>();
+            adam->step(entry.step);
+            adam->exp_avg(entry.exp_avg.to(param.device()).clone());
+            adam->exp_avg_sq(entry.exp_avg_sq.to(param.device()).clone());
+            if (entry.max_exp_avg_sq.defined()) {
+                adam->max_exp_avg_sq(entry.max_exp_avg_sq.to(param.device()).clone());
+            }
+            state[optimizer_state_key<StateMap>(param)] = std::move(adam);
+        }
+    }
+    if (index != snapshot.size()) {
+        throw std::runtime_error("Checkpoint optimizer state has too many parameters");
+    }
+}
+
+} // namespace dqn
@@ -0,0 +1,593 @@
+#include "dqn/checkpoint_history.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace dqn {
+
+namespace {
+
+const char kFileMagic[4] = {'D', 'Q', 'C', 'H'};
+const uint32_t kFileVersion = 1;
+const uint32_t kRecordMagic = 0x43455244;   // "DREC"
+
+const uint8_t kKindKeyframe = 0;
+const int64_t kQuantBlock = 256;
+
+const std::string kQPrefix = "q_network/";
+const std::string kTargetPrefix = "target_network/";
+
+// ---------------------------------------------------------------------------
+// Byte helpers (host byte order; Jetson and x86 are both little-endian)
+// ---------------------------------------------------------------------------
+
+class ByteWriter {
+public:
+    template <typename T>
+    void put(T value) {
+        buf_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    void put_bytes(const std::string& bytes) { buf_.append(bytes); }
+    void put_string(const std::string& s) {
+        put<uint16_t>(static_cast<uint16_t>(s.size()));
+        buf_.append(s);
+    }
+    std::string& str() { return buf_; }
+
+private:
+    std::string buf_;
+};
+
+class ByteReader {
+public:
+    ByteReader(const char* data, size_t size) : p_(data), end_(data + size) {}
+
+    template <typename T>
+    bool get(T& value) {
+        if (static_cast<size_t>(end_ - p_) < sizeof(T)) return false;
+        std::memcpy(&value, p_, sizeof(T));
+        p_ += sizeof(T);
+        return true;
+    }
+    bool get_bytes(size_t n, std::string& out) {
+        if (static_cast<size_t>(end_ - p_) < n) return false;
+        out.assign(p_, n);
+        p_ += n;
+        return true;
+    }
+    bool get_string(std::string& out) {
+        uint16_t len = 0;
+        return get(len) && get_bytes(len, out);
+    }
+    const char* position() const { return p_; }
+
+private:
+    const char* p_;
+    const char* end_;
+};
+
+uint32_t fnv1a(const char* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// ---------------------------------------------------------------------------
+// Zero-run-length coding: a zero byte is followed by a LEB128 run length,
+// any other byte is a literal
+// ---------------------------------------------------------------------------
+
+std::string rle_zero_encode(const std::string& in) {
+    std::string out;
+    out.reserve(in.size() / 2);
+    size_t i = 0;
+    while (i < in.size()) {
+        if (in[i] != 0) {
+            out.push_back(in[i++]);
+            continue;
+        }
+        uint64_t run = 0;
+        while (i < in.size() && in[i] == 0) {
+            ++run;
+            ++i;
+        }
+        out.push_back(0);
+        while (run >= 0x80) {
+            out.push_back(static_cast<char>((run & 0x7f) | 0x80));
+            run >>= 7;
+        }
+        out.push_back(static_cast<char>(run));
+    }
+    return out;
+}
+
+std::string rle_zero_decode(const std::string& in, size_t expected_size) {
+    std::string out;
+    out.reserve(expected_size);
+    size_t i = 0;
+    while (i < in.size()) {
+        if (in[i] != 0) {
+            out.push_back(in[i++]);
+            continue;
+        }
+        ++i;
+        uint64_t run = 0;
+        int shift = 0;
+        while (i < in.size()) {
+            uint8_t byte = static_cast<uint8_t>(in[i++]);
+            run |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            shift += 7;
+            if ((byte & 0x80) == 0) break;
+        }
+        out.append(run, '\0');
+    }
+    if (out.size() != expected_size) {
+        throw std::runtime_error("CheckpointHistory: corrupt delta payload");
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// Delta codecs
+// ---------------------------------------------------------------------------
+
+// XOR with the previous frame, split into 4 byte planes
+std::string xor_encode(const std::vector<float>& cur, const std::vector<float>& prev) {
+    const size_t n = cur.size();
+    std::string planes(4 * n, '\0');
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t a, b;
+        std::memcpy(&a, &cur[i], 4);
+        std::memcpy(&b, &prev[i], 4);
+        uint32_t x = a ^ b;
+        for (size_t k = 0; k < 4; ++k) {
+            planes[k * n + i] = static_cast<char>((x >> (8 * k)) & 0xff);
+        }
+    }
+    return rle_zero_encode(planes);
+}
+
+void xor_decode(const std::string& payload, std::vector<float>& frame) {
+    const size_t n = frame.size();
+    std::string planes = rle_zero_decode(payload, 4 * n);
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t x = 0;
+        for (size_t k = 0; k < 4; ++k) {
+            x |= static_cast<uint32_t>(static_cast<uint8_t>(planes[k * n + i])) << (8 * k);
+        }
+        uint32_t bits;
+        std::memcpy(&bits, &frame[i], 4);
+        bits ^= x;
+        std::memcpy(&frame[i], &bits, 4);
+    }
+}
+
+// int8 diffs with one scale per block; prev is updated to the reconstruction
+std::string quantized_encode(const std::vector<float>& cur, std::vector<float>& prev) {
+    const int64_t n = static_cast<int64_t>(cur.size());
+    const int64_t num_blocks = (n + kQuantBlock - 1) / kQuantBlock;
+
+    std::vector<float> scales(num_blocks, 0.0f);
+    std::string values(n, '\0');
+
+    for (int64_t b = 0; b < num_blocks; ++b) {
+        const int64_t begin = b * kQuantBlock;
+        const int64_t end = std::min(n, begin + kQuantBlock);
+
+        float max_abs = 0.0f;
+        for (int64_t i = begin; i < end; ++i) {
+            max_abs = std::max(max_abs, std::fabs(cur[i] - prev[i]));
+        }
+        if (max_abs == 0.0f) continue;
+
+        const float scale = max_abs / 127.0f;
+        scales[b] = scale;
+        for (int64_t i = begin; i < end; ++i) {
+            float q = std::round((cur[i] - prev[i]) / scale);
+            q = std::min(127.0f, std::max(-127.0f, q));
+            values[i] = static_cast<char>(static_cast<int8_t>(q));
+            prev[i] += q * scale;
+        }
+    }
+
+    std::string raw(reinterpret_cast<const char*>(scales.data()), scales.size() * sizeof(float));
+    raw += values;
+    return rle_zero_encode(raw);
+}
+
+void quantized_decode(const std::string& payload, std::vector<float>& frame) {
+    const int64_t n = static_cast<int64_t>(frame.size());
+    const int64_t num_blocks = (n + kQuantBlock - 1) / kQuantBlock;
+
+    std::string raw = rle_zero_decode(payload, num_blocks * sizeof(float) + n);
+    const float* scales = reinterpret_cast<const float*>(raw.data());
+    const int8_t* values = reinterpret_cast<const int8_t*>(raw.data() + num_blocks * sizeof(float));
+
+    for (int64_t i = 0; i < n; ++i) {
+        frame[i] += static_cast<float>(values[i]) * scales[i / kQuantBlock];
+    }
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// CheckpointHistory
+// ---------------------------------------------------------------------------
+
+CheckpointHistory::CheckpointHistory(const std::string& filepath, const Options& options)
+    : filepath_(filepath), options_(options) {
+    if (options_.keyframe_interval < 1) {
+        options_.keyframe_interval = 1;
+    }
+    open_or_create();
+}
+
+CheckpointHistory::CheckpointHistory(const std::string& filepath)
+    : CheckpointHistory(filepath, Options()) {}
+
+CheckpointHistory::~CheckpointHistory() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+void CheckpointHistory::open_or_create() {
+    fd_ = options_.read_only ? ::open(filepath_.c_str(), O_RDONLY)
+                             : ::open(filepath_.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) {
+        throw std::runtime_error("CheckpointHistory: cannot open " + filepath_ + ": " + std::strerror(errno));
+    }
+    scan();
+}
+
+void CheckpointHistory::scan() {
+    struct stat st;
+    if (::fstat(fd_, &st) != 0) {
+        throw std::runtime_error("CheckpointHistory: fstat failed on " + filepath_);
+    }
+    if (st.st_size == 0) {
+        return;  // New file: header written on first append
+    }
+
+    std::string data(static_cast<size_t>(st.st_size), '\0');
+    if (::pread(fd_, &data[0], data.size(), 0) != static_cast<ssize_t>(data.size())) {
+        throw std::runtime_error("CheckpointHistory: cannot read " + filepath_);
+    }
+
+    // Header and tensor layout
+    ByteReader header(data.data(), data.size());
+    std::string magic;
+    uint32_t version = 0;
+    uint32_t num_tensors = 0;
+    const size_t magic_bytes = std::min(data.size(), sizeof(kFileMagic));
+    bool complete = header.get_bytes(4, magic) && header.get(version);
+    if (std::memcmp(data.data(), kFileMagic, magic_bytes) != 0 || (complete && version != kFileVersion)) {
+        throw std::runtime_error("CheckpointHistory: " + filepath_ + " is not a checkpoint history");
+    }
+    complete = complete && header.get(num_tensors);
+    for (uint32_t t = 0; complete && t < num_tensors; ++t) {
+        TensorLayout entry;
+        uint32_t ndim = 0;
+        complete = header.get_string(entry.name) && header.get(ndim);
+        entry.numel = 1;
+        for (uint32_t d = 0; complete && d < ndim; ++d) {
+            int64_t dim = 0;
+            complete = header.get(dim);
+            entry.shape.push_back(dim);
+            entry.numel *= dim;
+        }
+        num_floats_ += entry.numel;
+        layout_.push_back(std::move(entry));
+    }
+
+    // A header cut short (crash during the first append) has no record after
+    // it: start over as a new file
+    if (!complete) {
+        std::cerr << "[CheckpointHistory] " << (options_.read_only ? "Ignoring" : "Discarding")
+                  << " torn header in " << filepath_ << std::endl;
+        if (!options_.read_only && ::ftruncate(fd_, 0) != 0) {
+            throw std::runtime_error("CheckpointHistory: cannot truncate " + filepath_);
+        }
+        layout_.clear();
+        num_floats_ = 0;
+        return;
+    }
+
+    // Records; stop at the first incomplete or corrupt one
+    uint64_t offset = static_cast<uint64_t>(header.position() - data.data());
+    while (offset < data.size()) {
+        ByteReader reader(data.data() + offset, data.size() - offset);
+        Record record;
+        uint32_t magic_value = 0;
+        uint64_t index = 0;
+        uint32_t num_counters = 0;
+        bool ok = reader.get(magic_value) && magic_value == kRecordMagic &&
+                  reader.get(record.kind) && reader.get(index) && index == records_.size() &&
+                  reader.get(record.epsilon) && reader.get(record.info.training_steps) &&
+                  reader.get(record.target_version) && reader.get(num_counters);
+        for (uint32_t c = 0; ok && c < num_counters; ++c) {
+            std::string name;
+            double value = 0.0;
+            ok = reader.get_string(name) && reader.get(value);
+            record.info.counters[name] = value;
+        }
+        std::string payload;
+        uint32_t checksum = 0;
+        ok = ok && reader.get(record.payload_bytes);
+        const char* checked_begin = data.data() + offset + sizeof(uint32_t);
+        ok = ok && reader.get_bytes(record.payload_bytes, payload);
+        const char* checked_end = reader.position();
+        ok = ok && reader.get(checksum) &&
+             checksum == fnv1a(checked_begin, static_cast<size_t>(checked_end - checked_begin));
+
+        if (!ok) {
+            std::cerr << "[CheckpointHistory] " << (options_.read_only ? "Ignoring" : "Truncating")
+                      << " torn record at offset " << offset << " in " << filepath_ << std::endl;
+            if (!options_.read_only && ::ftruncate(fd_, static_cast<off_t>(offset)) != 0) {
+                throw std::runtime_error("CheckpointHistory: cannot truncate " + filepath_);
+            }
+            data.resize(offset);
+            break;
+        }
+
+        record.info.index = static_cast<size_t>(index);
+        record.info.keyframe = record.kind == kKindKeyframe;
+        record.info.offset = offset;
+        record.info.bytes = static_cast<uint64_t>(reader.position() - (data.data() + offset));
+        record.payload_offset = static_cast<uint64_t>(checked_end - data.data()) - record.payload_bytes;
+        records_.push_back(std::move(record));
+        offset += records_.back().info.bytes;
+    }
+
+    file_bytes_ = data.size();
+
+    // Rebuild the newest reconstruction for the next delta
+    if (!records_.empty()) {
+        size_t key = records_.size() - 1;
+        while (records_[key].kind != kKindKeyframe) --key;
+        last_frame_.assign(num_floats_, 0.0f);
+        for (size_t i = key; i < records_.size(); ++i) {
+            decode_into(records_[i], last_frame_);
+        }
+    }
+}
+
+void CheckpointHistory::write_header(const std::vector<TensorLayout>& layout) {
+    ByteWriter writer;
+    writer.str().append(kFileMagic, 4);
+    writer.put<uint32_t>(kFileVersion);
+    writer.put<uint32_t>(static_cast<uint32_t>(layout.size()));
+    for (const TensorLayout& entry : layout) {
+        writer.put_string(entry.name);
+        writer.put<uint32_t>(static_cast<uint32_t>(entry.shape.size()));
+        for (int64_t dim : entry.shape) {
+            writer.put<int64_t>(dim);
+        }
+    }
+
+    const std::string& bytes = writer.str();
+    if (::pwrite(fd_, bytes.data(), bytes.size(), 0) != static_cast<ssize_t>(bytes.size())) {
+        throw std::runtime_error("CheckpointHistory: cannot write header to " + filepath_);
+    }
+    file_bytes_ = bytes.size();
+}
+
+std::vector<float> CheckpointHistory::flatten(const TrainingCheckpoint& checkpoint,
+                                              std::vector<TensorLayout>* layout) const {
+    std::vector<float> flat;
+    auto add = [&](const std::string& prefix, const NamedTensors& tensors) {
+        for (const auto& entry : tensors) {
+            torch::Tensor t = entry.second.to(torch::kCPU, torch::kFloat32).contiguous();
+            const float* data = t.data_ptr<float>();
+            flat.insert(flat.end(), data, data + t.numel());
+            if (layout) {
+                TensorLayout l;
+                l.name = prefix + entry.first;
+                l.shape = t.sizes().vec();
+                l.numel = t.numel();
+                layout->push_back(std::move(l));
+            }
+        }
+    };
+    add(kQPrefix, checkpoint.q_network);
+    add(kTargetPrefix, checkpoint.target_network);
+    return flat;
+}
+
+void CheckpointHistory::unflatten(const std::vector<float>& flat, TrainingCheckpoint& checkpoint) const {
+    int64_t offset = 0;
+    for (const TensorLayout& entry : layout_) {
+        torch::Tensor t = torch::from_blob(const_cast<float*>(flat.data() + offset), entry.shape,
+                                           torch::kFloat32).clone();
+        offset += entry.numel;
+
+        if (entry.name.compare(0, kQPrefix.size(), kQPrefix) == 0) {
+            checkpoint.q_network.emplace_back(entry.name.substr(kQPrefix.size()), t);
+        } else {
+            checkpoint.target_network.emplace_back(entry.name.substr(kTargetPrefix.size()), t);
+        }
+    }
+}
+
+size_t CheckpointHistory::append(const TrainingCheckpoint& checkpoint) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (options_.read_only) {
+        throw std::runtime_error("CheckpointHistory: " + filepath_ + " was opened read-only");
+    }
+
+    std::vector<TensorLayout> layout;
+    std::vector<float> frame = flatten(checkpoint, &layout);
+
+    if (layout_.empty()) {
+        write_header(layout);
+        layout_ = layout;
+        num_floats_ = static_cast<int64_t>(frame.size());
+    } else {
+        bool same = layout.size() == layout_.size();
+        for (size_t i = 0; same && i < layout.size(); ++i) {
+            same = layout[i].name == layout_[i].name && layout[i].numel == layout_[i].numel;
+        }
+        if (!same) {
+            throw std::runtime_error("CheckpointHistory: network layout differs from " + filepath_);
+        }
+    }
+
+    // Keyframe or delta against the previous reconstruction
+    size_t since_keyframe = 0;
+    for (size_t i = records_.size(); i > 0 && records_[i - 1].kind != kKindKeyframe; --i) {
+        ++since_keyframe;
+    }
+    bool keyframe = records_.empty() ||
+                    since_keyframe + 1 >= static_cast<size_t>(options_.keyframe_interval);
+
+    // The next delta reference is committed to last_frame_ only once the
+    // record is on disk, so a failed write leaves it matching the file
+    Record record;
+    std::string payload;
+    std::vector<float> next_frame;
+    if (keyframe) {
+        record.kind = kKindKeyframe;
+        payload.assign(reinterpret_cast<const char*>(frame.data()), frame.size() * sizeof(float));
+        next_frame = std::move(frame);
+    } else if (options_.delta_mode == DeltaMode::kXor) {
+        record.kind = static_cast<uint8_t>(DeltaMode::kXor);
+        payload = xor_encode(frame, last_frame_);
+        next_frame = std::move(frame);
+    } else {
+        record.kind = static_cast<uint8_t>(DeltaMode::kQuantized);
+        next_frame = last_frame_;
+        payload = quantized_encode(frame, next_frame);   // updates next_frame
+    }
+
+    record.epsilon = checkpoint.epsilon;
+    record.target_version = checkpoint.target_version;
+    record.info.index = records_.size();
+    record.info.keyframe = keyframe;
+    record.info.training_steps = checkpoint.training_steps;
+    record.info.counters = checkpoint.counters;
+
+    // Serialize record; checksum covers everything after the magic
+    ByteWriter writer;
+    writer.put<uint32_t>(kRecordMagic);
+    writer.put<uint8_t>(record.kind);
+    writer.put<uint64_t>(record.info.index);
+    writer.put<float>(record.epsilon);
+    writer.put<int64_t>(record.info.training_steps);
+    writer.put<int64_t>(record.target_version);
+    writer.put<uint32_t>(static_cast<uint32_t>(record.info.counters.size()));
+    for (const auto& c : record.info.counters) {
+        writer.put_string(c.first);
+        writer.put<double>(c.second);
+    }
+    writer.put<uint64_t>(payload.size());
+    size_t payload_pos = writer.str().size();
+    writer.put_bytes(payload);
+    const std::string& body = writer.str();
+    writer.put<uint32_t>(fnv1a(body.data() + sizeof(uint32_t), body.size() - sizeof(uint32_t)));
+
+    const std::string& bytes = writer.str();
+    if (::pwrite(fd_, bytes.data(), bytes.size(), static_cast<off_t>(file_bytes_)) !=
+            static_cast<ssize_t>(bytes.size()) ||
+        ::fsync(fd_) != 0) {
+        throw std::runtime_error("CheckpointHistory: write failed on " + filepath_ + ": " + std::strerror(errno));
+    }
+
+    record.info.offset = file_bytes_;
+    record.info.bytes = bytes.size();
+    record.payload_offset = file_bytes_ + payload_pos;
+    record.payload_bytes = payload.size();
+    file_bytes_ += bytes.size();
+    records_.push_back(std::move(record));
+    last_frame_ = std::move(next_frame);
+
+    return records_.size() - 1;
+}
+
+std::string CheckpointHistory::read_payload(const Record& record) const {
+    std::string payload(record.payload_bytes, '\0');
+    if (record.payload_bytes > 0 &&
+        ::pread(fd_, &payload[0], payload.size(), static_cast<off_t>(record.payload_offset)) !=
+            static_cast<ssize_t>(payload.size())) {
+        throw std::runtime_error("CheckpointHistory: cannot read record from " + filepath_);
+    }
+    return payload;
+}
+
+void CheckpointHistory::decode_into(const Record& record, std::vector<float>& frame) const {
+    std::string payload = read_payload(record);
+
+    if (record.kind == kKindKeyframe) {
+        if (payload.size() != static_cast<size_t>(num_floats_) * sizeof(float)) {
+            throw std::runtime_error("CheckpointHistory: corrupt keyframe in " + filepath_);
+        }
+        frame.resize(num_floats_);
+        std::memcpy(frame.data(), payload.data(), payload.size());
+    } else if (record.kind == static_cast<uint8_t>(DeltaMode::kXor)) {
+        xor_decode(payload, frame);
+    } else if (record.kind == static_cast<uint8_t>(DeltaMode::kQuantized)) {
+        quantized_decode(payload, frame);
+    } else {
+        throw std::runtime_error("CheckpointHistory: unknown record kind in " + filepath_);
+    }
+}
+
+TrainingCheckpoint CheckpointHistory::restore(size_t index) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (index >= records_.size()) {
+        throw std::out_of_range("CheckpointHistory: no entry " + std::to_string(index));
+    }
+
+    size_t key = index;
+    while (records_[key].kind != kKindKeyframe) --key;
+
+    std::vector<float> frame(num_floats_, 0.0f);
+    for (size_t i = key; i <= index; ++i) {
+        decode_into(records_[i], frame);
+    }
+
+    const Record& record = records_[index];
+    TrainingCheckpoint checkpoint;
+    unflatten(frame, checkpoint);
+    checkpoint.epsilon = record.epsilon;
+    checkpoint.training_steps = record.info.training_steps;
+    checkpoint.target_version = record.target_version;
+    checkpoint.counters = record.info.counters;
+    return checkpoint;
+}
+
+size_t CheckpointHistory::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return records_.size();
+}
+
+std::vector<CheckpointHistory::EntryInfo> CheckpointHistory::entries() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<EntryInfo> infos;
+    infos.reserve(records_.size());
+    for (const Record& record : records_) {
+        infos.push_back(record.info);
+    }
+    return infos;
+}
+
+uint64_t CheckpointHistory::file_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_bytes_;
+}
+
+uint64_t CheckpointHistory::raw_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return records_.size() * static_cast<uint64_t>(num_floats_) * sizeof(float);
+}
+
+} // namespace dqn
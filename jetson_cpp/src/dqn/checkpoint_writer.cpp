@@ -0,0 +1,181 @@
+#include "dqn/checkpoint_writer.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace dqn {
+
+namespace {
+
+void fsync_path(const std::string& path, int flags) {
+    int fd = ::open(path.c_str(), flags);
+    if (fd < 0) {
+        throw std::runtime_error("open(" + path + "): " + std::strerror(errno));
+    }
+    int rc = ::fsync(fd);
+    ::close(fd);
+    if (rc != 0) {
+        throw std::runtime_error("fsync(" + path + "): " + std::strerror(errno));
+    }
+}
+
+std::string parent_directory(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    if (slash == std::string::npos) {
+        return ".";
+    }
+    return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+} // namespace
+
+AsyncCheckpointWriter::AsyncCheckpointWriter(size_t max_pending)
+    : max_pending_(max_pending > 0 ? max_pending : 1) {
+    worker_ = std::thread(&AsyncCheckpointWriter::worker_loop, this);
+}
+
+AsyncCheckpointWriter::~AsyncCheckpointWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_one();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void AsyncCheckpointWriter::submit(TrainingCheckpoint checkpoint, const std::string& filepath) {
+    Job job;
+    job.checkpoint = std::move(checkpoint);
+    job.filepath = filepath;
+    enqueue(std::move(job));
+}
+
+void AsyncCheckpointWriter::submit(TrainingCheckpoint checkpoint, CheckpointHistory& history) {
+    Job job;
+    job.checkpoint = std::move(checkpoint);
+    job.history = &history;
+    enqueue(std::move(job));
+}
+
+void AsyncCheckpointWriter::enqueue(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // Coalesce: a newer snapshot supersedes a queued one for the same file
+        bool replaced = false;
+        if (!job.history) {
+            for (Job& queued : queue_) {
+                if (!queued.history && queued.filepath == job.filepath) {
+                    queued.checkpoint = std::move(job.checkpoint);
+                    replaced = true;
+                    dropped_++;
+                    break;
+                }
+            }
+        }
+
+        if (!replaced) {
+            if (queue_.size() >= max_pending_) {
+                // Only file snapshots may be dropped (a newer one follows);
+                // history appends are kept even beyond max_pending
+                auto oldest_file = std::find_if(queue_.begin(), queue_.end(),
+                                                [](const Job& queued) { return !queued.history; });
+                if (oldest_file != queue_.end()) {
+                    std::cerr << "[CheckpointWriter] Queue full, dropping oldest snapshot" << std::endl;
+                    queue_.erase(oldest_file);
+                    dropped_++;
+                }
+            }
+            queue_.push_back(std::move(job));
+        }
+    }
+    work_cv_.notify_one();
+}
+
+void AsyncCheckpointWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this] { return queue_.empty() && !busy_; });
+}
+
+uint64_t AsyncCheckpointWriter::written() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return written_;
+}
+
+uint64_t AsyncCheckpointWriter::dropped() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+}
+
+uint64_t AsyncCheckpointWriter::failed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return failed_;
+}
+
+void AsyncCheckpointWriter::worker_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+        work_cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+        if (queue_.empty()) {
+            break;  // stop_ requested and nothing left to write
+        }
+
+        Job job = std::move(queue_.front());
+        queue_.pop_front();
+        busy_ = true;
+        lock.unlock();
+
+        bool ok = true;
+        try {
+            if (job.history) {
+                size_t index = job.history->append(job.checkpoint);
+                std::cout << "[CheckpointWriter] History entry " << index << " appended ("
+                          << job.history->file_bytes() / 1024 << " KB total)" << std::endl;
+            } else {
+                write_atomic(job.checkpoint, job.filepath);
+                std::cout << "[CheckpointWriter] Saved: " << job.filepath << std::endl;
+            }
+        } catch (const std::exception& e) {
+            ok = false;
+            std::cerr << "[CheckpointWriter] Error writing "
+                      << (job.history ? "history entry" : job.filepath) << ": " << e.what() << std::endl;
+        }
+
+        lock.lock();
+        busy_ = false;
+        if (ok) {
+            written_++;
+        } else {
+            failed_++;
+        }
+        if (queue_.empty()) {
+            idle_cv_.notify_all();
+        }
+    }
+
+    idle_cv_.notify_all();
+}
+
+void AsyncCheckpointWriter::write_atomic(const TrainingCheckpoint& checkpoint, const std::string& filepath) {
+    const std::string tmp_path = filepath + ".tmp";
+
+    checkpoint.save(tmp_path);
+    fsync_path(tmp_path, O_RDONLY);
+
+    if (std::rename(tmp_path.c_str(), filepath.c_str()) != 0) {
+        throw std::runtime_error("rename(" + tmp_path + "): " + std::strerror(errno));
+    }
+
+    // Persist the directory entry of the rename
+    fsync_path(parent_directory(filepath), O_RDONLY | O_DIRECTORY);
+}
+
+} // namespace dqn
@@ -0,0 +1,248 @@
+#include "dqn/distillation.h"
+#include "dqn/types.h"
+#include "communication/sensor_data.h"
+#include "utils/timing.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace dqn {
+
+StudentNetworkImpl::StudentNetworkImpl(int64_t state_dim, int64_t action_dim, int64_t hidden_dim)
+    : state_dim_(state_dim),
+      action_dim_(action_dim),
+      hidden_dim_(hidden_dim) {
+
+    fc1_ = register_module("fc1", torch::nn::Linear(state_dim, hidden_dim));
+    fc2_ = register_module("fc2", torch::nn::Linear(hidden_dim, action_dim));
+
+    torch::nn::init::xavier_uniform_(fc1_->weight);
+    torch::nn::init::constant_(fc1_->bias, 0.0);
+
+    torch::nn::init::xavier_uniform_(fc2_->weight);
+    torch::nn::init::constant_(fc2_->bias, 0.0);
+}
+
+torch::Tensor StudentNetworkImpl::forward(torch::Tensor x) {
+    if (x.dim() == 1) {
+        x = x.unsqueeze(0);
+    }
+    return fc2_->forward(torch::relu(fc1_->forward(x)));
+}
+
+PolicyDistiller::PolicyDistiller(QNetwork teacher, const DistillationConfig& config,
+                                 torch::Device device)
+    : teacher_(std::move(teacher)), config_(config), device_(device) {
+    teacher_->to(device_);
+    teacher_->eval();
+}
+
+StudentNetwork PolicyDistiller::distill(const torch::Tensor& states) {
+    torch::Tensor inputs = states.to(device_);
+    const int64_t num_states = inputs.size(0);
+
+    // Label every state once with the teacher
+    torch::Tensor teacher_q;
+    {
+        torch::NoGradGuard no_grad;
+        teacher_q = teacher_->forward(inputs);
+    }
+    torch::Tensor teacher_actions = teacher_q.argmax(1);
+
+    StudentNetwork student(inputs.size(1), teacher_q.size(1), config_.hidden_dim);
+    student->to(device_);
+    student->train();
+
+    torch::optim::Adam optimizer(student->parameters(),
+                                 torch::optim::AdamOptions(config_.learning_rate));
+
+    const int64_t batch_size = std::min<int64_t>(static_cast<int64_t>(config_.batch_size), num_states);
+
+    std::cout << "[PolicyDistiller] Distilling " << num_states << " states into "
+              << inputs.size(1) << " -> " << config_.hidden_dim << " -> " << teacher_q.size(1)
+              << " student" << std::endl;
+
+    for (int64_t epoch = 1; epoch <= config_.epochs; ++epoch) {
+        torch::Tensor perm = torch::randperm(num_states,
+            torch::TensorOptions().dtype(torch::kLong).device(device_));
+
+        float epoch_loss = 0.0f;
+        int64_t num_batches = 0;
+
+        for (int64_t start = 0; start < num_states; start += batch_size) {
+            torch::Tensor idx = perm.slice(0, start, std::min(start + batch_size, num_states));
+
+            torch::Tensor q = student->forward(inputs.index_select(0, idx));
+            torch::Tensor loss =
+                config_.q_loss_weight * torch::mse_loss(q, teacher_q.index_select(0, idx)) +
+                config_.action_loss_weight *
+                    torch::nn::functional::cross_entropy(q, teacher_actions.index_select(0, idx));
+
+            optimizer.zero_grad();
+            loss.backward();
+            optimizer.step();
+
+            epoch_loss += loss.item<float>();
+            num_batches++;
+        }
+
+        if (epoch % 50 == 0 || epoch == config_.epochs) {
+            std::cout << "[PolicyDistiller] Epoch " << epoch << "/" << config_.epochs
+                      << " | Loss: " << (epoch_loss / std::max<int64_t>(num_batches, 1)) << std::endl;
+        }
+    }
+
+    student->eval();
+    return student;
+}
+
+DistillationReport PolicyDistiller::evaluate(StudentNetwork& student, const torch::Tensor& states) {
+    torch::NoGradGuard no_grad;
+    student->to(device_);
+    student->eval();
+
+    DistillationReport report;
+    if (states.dim() != 2 || states.size(0) == 0) {
+        std::cerr << "[Distillation] No evaluation states" << std::endl;
+        return report;
+    }
+
+    torch::Tensor inputs = states.to(device_);
+    torch::Tensor teacher_q = teacher_->forward(inputs);
+    torch::Tensor student_q = student->forward(inputs);
+
+    report.num_states = inputs.size(0);
+    report.agreement_rate = teacher_q.argmax(1).eq(student_q.argmax(1))
+                                .to(torch::kFloat32).mean().item<float>();
+    report.q_mse = torch::mse_loss(student_q, teacher_q).item<float>();
+
+    // Single-state latency, as seen by the control loop
+    torch::Tensor single = inputs[0].unsqueeze(0);
+    auto teacher_stats = utils::measure_latency([&]() {
+        (void)teacher_->forward(single).argmax(1).item<int64_t>();
+    }, config_.latency_iterations);
+    auto student_stats = utils::measure_latency([&]() {
+        (void)student->forward(single).argmax(1).item<int64_t>();
+    }, config_.latency_iterations);
+
+    report.teacher_latency_us = teacher_stats.mean_us;
+    report.student_latency_us = student_stats.mean_us;
+    report.teacher_p99_us = teacher_stats.p99_us;
+    report.student_p99_us = student_stats.p99_us;
+    return report;
+}
+
+torch::Tensor load_sensor_log_states(const std::string& filepath) {
+    std::ifstream file(filepath);
+    if (!file.is_open()) {
+        std::cerr << "[Distillation] Could not open sensor log: " << filepath << std::endl;
+        return torch::Tensor();
+    }
+
+    std::vector<torch::Tensor> states;
+    std::string line;
+    while (std::getline(file, line)) {
+        // Bridge log lines carry the CSV after the last ':'
+        size_t colon = line.rfind(':');
+        const char* p = line.c_str() + (colon == std::string::npos ? 0 : colon + 1);
+
+        float values[4];
+        int count = 0;
+        char* end = nullptr;
+        for (; count < 4; ++count) {
+            values[count] = std::strtof(p, &end);
+            if (end == p) break;
+            p = end;
+            if (count < 3) {
+                if (*p != ',') break;
+                ++p;
+            }
+        }
+        if (count != 4) continue;
+
+        communication::SensorData sensors;
+        sensors.gyro_angle = values[0];
+        sensors.gyro_rate = values[1];
+        sensors.touch_front = static_cast<int>(values[2]);
+        sensors.touch_side = static_cast<int>(values[3]);
+        sensors.valid = true;
+        states.push_back(sensors.toState());
+    }
+
+    if (states.empty()) {
+        return torch::Tensor();
+    }
+
+    std::cout << "[Distillation] Loaded " << states.size() << " states from " << filepath << std::endl;
+    return torch::stack(states);
+}
+
+torch::Tensor sample_robot_states(int64_t num_states) {
+    torch::Tensor gyro = torch::rand({num_states, 2}) * 2.0f - 1.0f;
+    torch::Tensor touch = torch::randint(0, 2, {num_states, 2}, torch::kFloat32);
+    return torch::cat({gyro, touch}, 1);
+}
+
+void save_student(StudentNetwork& student, const std::string& filepath) {
+    torch::serialize::OutputArchive archive;
+    student->save(archive);
+    archive.write("hidden_dim", torch::tensor(student->hidden_dim()));
+    archive.save_to(filepath);
+    std::cout << "[Distillation] Student saved to: " << filepath << std::endl;
+}
+
+StudentNetwork load_student(const std::string& filepath, int64_t state_dim, int64_t action_dim) {
+    torch::serialize::InputArchive archive;
+    archive.load_from(filepath);
+
+    torch::Tensor hidden_dim;
+    archive.read("hidden_dim", hidden_dim);
+
+    StudentNetwork student(state_dim, action_dim, hidden_dim.item<int64_t>());
+    student->load(archive);
+    student->eval();
+    return student;
+}
+
+torch::nn::Module& PolicyNetwork::module() const {
+    if (student) {
+        return *student;
+    }
+    return *q_network;
+}
+
+PolicyNetwork::ForwardFn PolicyNetwork::forward_fn() const {
+    if (student) {
+        StudentNetwork network = student;
+        return [network](const torch::Tensor& x) { return network->forward(x); };
+    }
+    QNetwork network = q_network;
+    return [network](const torch::Tensor& x) { return network->forward(x); };
+}
+
+std::string PolicyNetwork::description() const {
+    if (student) {
+        return "student (hidden=" + std::to_string(student->hidden_dim()) + ")";
+    }
+    return "QNetwork";
+}
+
+PolicyNetwork load_policy_network(const std::string& filepath, int64_t state_dim, int64_t action_dim) {
+    PolicyNetwork network;
+    try {
+        network.student = load_student(filepath, state_dim, action_dim);
+        return network;
+    } catch (const std::exception&) {
+        // Not a student: full QNetwork (top level of model and checkpoint files)
+    }
+
+    Hyperparameters params;
+    network.q_network = QNetwork(state_dim, action_dim, params.hidden_dim1, params.hidden_dim2);
+    torch::load(network.q_network, filepath);
+    network.q_network->eval();
+    return network;
+}
+
+} // namespace dqn
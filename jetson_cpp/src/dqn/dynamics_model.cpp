@@ -0,0 +1,136 @@
+#include "dqn/dynamics_model.h"
+#include "dqn/agent.h"
+#include <algorithm>
+#include <iostream>
+
+namespace dqn {
+
+DynamicsModelImpl::DynamicsModelImpl(int64_t state_dim, int64_t action_dim, int64_t hidden_dim)
+    : state_dim_(state_dim), action_dim_(action_dim) {
+
+    fc1_ = register_module("fc1", torch::nn::Linear(state_dim + action_dim, hidden_dim));
+    fc2_ = register_module("fc2", torch::nn::Linear(hidden_dim, hidden_dim));
+    fc3_ = register_module("fc3", torch::nn::Linear(hidden_dim, state_dim + 2));
+}
+
+DynamicsModelImpl::Prediction DynamicsModelImpl::forward(const torch::Tensor& states,
+                                                         const torch::Tensor& actions) {
+    torch::Tensor one_hot = torch::one_hot(actions.view({-1}), action_dim_).to(states.dtype());
+    torch::Tensor x = torch::cat({states, one_hot}, 1);
+
+    x = torch::relu(fc1_->forward(x));
+    x = torch::relu(fc2_->forward(x));
+    x = fc3_->forward(x);
+
+    Prediction prediction;
+    prediction.next_states = states + x.slice(1, 0, state_dim_);
+    prediction.rewards = x.slice(1, state_dim_, state_dim_ + 1);
+    prediction.done_logits = x.slice(1, state_dim_ + 1, state_dim_ + 2);
+    return prediction;
+}
+
+DynaPlanner::DynaPlanner(int64_t state_dim, int64_t action_dim, const DynaConfig& config,
+                         torch::Device device)
+    : config_(config), device_(device), action_dim_(action_dim) {
+    model_ = DynamicsModel(state_dim, action_dim, config.hidden_dim);
+    model_->to(device_);
+
+    optimizer_ = std::make_unique<torch::optim::Adam>(
+        model_->parameters(),
+        torch::optim::AdamOptions(config.learning_rate)
+    );
+}
+
+float DynaPlanner::train_model(ReplayBuffer& real) {
+    if (!real.can_sample(config_.model_batch_size)) {
+        return -1.0f;
+    }
+
+    model_->train();
+    float total_loss = 0.0f;
+
+    for (int64_t step = 0; step < config_.model_train_steps; ++step) {
+        TransitionBatch batch = real.sample_real(config_.model_batch_size);
+        torch::Tensor states = batch.states.to(device_);
+        torch::Tensor next_states = batch.next_states.to(device_);
+
+        auto prediction = model_->forward(states, batch.actions.to(device_));
+
+        torch::Tensor loss =
+            torch::mse_loss(prediction.next_states, next_states) +
+            torch::mse_loss(prediction.rewards, batch.rewards.to(device_)) +
+            torch::binary_cross_entropy_with_logits(prediction.done_logits, batch.dones.to(device_));
+
+        optimizer_->zero_grad();
+        loss.backward();
+        optimizer_->step();
+
+        total_loss += loss.item<float>();
+    }
+
+    return total_loss / std::max<int64_t>(config_.model_train_steps, 1);
+}
+
+void DynaPlanner::snapshot_into(TrainingCheckpoint& checkpoint) const {
+    checkpoint.has_dynamics = true;
+    checkpoint.dynamics_model = snapshot_module(*model_);
+    checkpoint.dynamics_optimizer = snapshot_adam(*optimizer_);
+}
+
+bool DynaPlanner::restore(const TrainingCheckpoint& checkpoint) {
+    if (!checkpoint.has_dynamics) {
+        return false;
+    }
+    restore_module(*model_, checkpoint.dynamics_model);
+    restore_adam(*optimizer_, checkpoint.dynamics_optimizer);
+    return true;
+}
+
+size_t DynaPlanner::generate_rollouts(ReplayBuffer& real, DQNAgent& agent, ReplayBuffer& synthetic) {
+    size_t start_count = std::min(real.size(), static_cast<size_t>(config_.rollout_batch));
+    if (start_count == 0) {
+        return 0;
+    }
+
+    torch::NoGradGuard no_grad;
+    model_->eval();
+
+    // Start from real (un-mirrored) states
+    torch::Tensor states = real.sample_real(start_count).states.to(device_);
+    size_t added = 0;
+
+    for (int64_t h = 0; h < config_.rollout_horizon && states.size(0) > 0; ++h) {
+        torch::Tensor actions = agent.select_actions(states, true).to(device_);
+        auto prediction = model_->forward(states, actions);
+
+        torch::Tensor next_states = prediction.next_states;
+        if (config_.project_state) {
+            next_states = config_.project_state(next_states);
+        }
+        torch::Tensor dones = prediction.done_logits.view({-1}) > 0.0f;
+
+        // Batched transfer to CPU, then one push per imagined transition
+        torch::Tensor cpu_states = states.cpu();
+        torch::Tensor cpu_next = next_states.cpu();
+        torch::Tensor cpu_actions = actions.view({-1}).cpu();
+        torch::Tensor cpu_rewards = prediction.rewards.view({-1}).cpu();
+        torch::Tensor cpu_dones = dones.cpu();
+
+        auto actions_a = cpu_actions.accessor<int64_t, 1>();
+        auto rewards_a = cpu_rewards.accessor<float, 1>();
+        auto dones_a = cpu_dones.accessor<bool, 1>();
+
+        for (int64_t i = 0; i < cpu_states.size(0); ++i) {
+            synthetic.push(cpu_states[i], actions_a[i], rewards_a[i], cpu_next[i], dones_a[i]);
+        }
+        added += static_cast<size_t>(cpu_states.size(0));
+
+        // Continue only the rollouts that did not terminate
+        torch::Tensor alive = dones.logical_not().nonzero().view({-1});
+        states = next_states.index_select(0, alive);
+    }
+
+    return added;
+}
+
+} // namespace dqn
@@ -0,0 +1,274 @@
+#include "dqn/inference_backend.h"
+#include "utils/timing.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace dqn {
+
+namespace {
+
+// y = W^T x + b with W stored [in, out]; inner loop is a contiguous axpy
+void dense_forward(const float* weight_t, const float* bias, int64_t in_dim, int64_t out_dim,
+                   const float* x, float* y, bool relu) {
+    std::memcpy(y, bias, sizeof(float) * out_dim);
+    for (int64_t i = 0; i < in_dim; ++i) {
+        const float xi = x[i];
+        const float* w = weight_t + i * out_dim;
+        for (int64_t o = 0; o < out_dim; ++o) {
+            y[o] += xi * w[o];
+        }
+    }
+    if (relu) {
+        for (int64_t o = 0; o < out_dim; ++o) {
+            y[o] = std::max(y[o], 0.0f);
+        }
+    }
+}
+
+int64_t argmax(const float* values, int64_t count) {
+    int64_t best = 0;
+    for (int64_t i = 1; i < count; ++i) {
+        if (values[i] > values[best]) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+std::vector<DenseLayer> extract_dense_layers(torch::nn::Module& module) {
+    torch::NoGradGuard no_grad;
+    std::vector<DenseLayer> layers;
+
+    for (const auto& child : module.modules(/*include_self=*/false)) {
+        auto* linear = child->as<torch::nn::Linear>();
+        if (linear == nullptr) {
+            continue;
+        }
+
+        torch::Tensor weight_t = linear->weight.detach().to(torch::kCPU, torch::kFloat32).t().contiguous();
+        torch::Tensor bias = linear->bias.detach().to(torch::kCPU, torch::kFloat32).contiguous();
+
+        DenseLayer layer;
+        layer.in_dim = weight_t.size(0);
+        layer.out_dim = weight_t.size(1);
+        layer.weight_t.assign(weight_t.data_ptr<float>(), weight_t.data_ptr<float>() + weight_t.numel());
+        layer.bias.assign(bias.data_ptr<float>(), bias.data_ptr<float>() + bias.numel());
+        layers.push_back(std::move(layer));
+    }
+
+    return layers;
+}
+
+// ============================================================================
+// EagerBackend
+// ============================================================================
+
+EagerBackend::EagerBackend(std::string name, ForwardFn forward, int64_t state_dim, torch::Device device)
+    : name_(std::move(name)),
+      forward_(std::move(forward)),
+      input_(torch::zeros({1, state_dim}, torch::kFloat32)),
+      device_(device) {
+}
+
+int64_t EagerBackend::select_action(const float* state) {
+    torch::NoGradGuard no_grad;
+    std::memcpy(input_.data_ptr<float>(), state, sizeof(float) * input_.size(1));
+
+    torch::Tensor q_values = device_.is_cpu() ? forward_(input_) : forward_(input_.to(device_));
+    return q_values.argmax(1).item<int64_t>();
+}
+
+// ============================================================================
+// TorchScriptBackend
+// ============================================================================
+
+TorchScriptBackend::TorchScriptBackend(const std::string& filepath, int64_t state_dim)
+    : module_(torch::jit::load(filepath, torch::kCPU)),
+      input_(torch::zeros({1, state_dim}, torch::kFloat32)) {
+    module_.eval();
+    inputs_.emplace_back(input_);
+}
+
+int64_t TorchScriptBackend::select_action(const float* state) {
+    torch::NoGradGuard no_grad;
+    std::memcpy(input_.data_ptr<float>(), state, sizeof(float) * input_.size(1));
+    return module_.forward(inputs_).toTensor().argmax(1).item<int64_t>();
+}
+
+// ============================================================================
+// DenseBackend
+// ============================================================================
+
+DenseBackend::DenseBackend(std::vector<DenseLayer> layers)
+    : layers_(std::move(layers)) {
+    int64_t widest = 0;
+    for (const auto& layer : layers_) {
+        widest = std::max(widest, layer.out_dim);
+    }
+    buffer_a_.resize(widest);
+    buffer_b_.resize(widest);
+}
+
+int64_t DenseBackend::select_action(const float* state) {
+    const float* x = state;
+    float* y = buffer_a_.data();
+
+    for (size_t l = 0; l < layers_.size(); ++l) {
+        const DenseLayer& layer = layers_[l];
+        const bool is_output = (l + 1 == layers_.size());
+        dense_forward(layer.weight_t.data(), layer.bias.data(), layer.in_dim, layer.out_dim,
+                      x, y, !is_output);
+        x = y;
+        y = (y == buffer_a_.data()) ? buffer_b_.data() : buffer_a_.data();
+    }
+
+    return argmax(x, layers_.back().out_dim);
+}
+
+// ============================================================================
+// QuantizedBackend
+// ============================================================================
+
+QuantizedBackend::QuantizedBackend(const std::vector<DenseLayer>& layers) {
+    int64_t widest = 0;
+
+    for (const auto& layer : layers) {
+        QuantizedLayer q;
+        q.in_dim = layer.in_dim;
+        q.out_dim = layer.out_dim;
+        q.bias = layer.bias;
+        q.scale.assign(layer.out_dim, 0.0f);
+        q.weight_t.resize(layer.weight_t.size());
+
+        // Per output unit: scale = max|w| / 127
+        for (int64_t i = 0; i < layer.in_dim; ++i) {
+            for (int64_t o = 0; o < layer.out_dim; ++o) {
+                q.scale[o] = std::max(q.scale[o], std::abs(layer.weight_t[i * layer.out_dim + o]));
+            }
+        }
+        for (int64_t o = 0; o < layer.out_dim; ++o) {
+            q.scale[o] = q.scale[o] > 0.0f ? q.scale[o] / 127.0f : 1.0f;
+        }
+        for (int64_t i = 0; i < layer.in_dim; ++i) {
+            for (int64_t o = 0; o < layer.out_dim; ++o) {
+                float w = layer.weight_t[i * layer.out_dim + o] / q.scale[o];
+                q.weight_t[i * layer.out_dim + o] = static_cast<int8_t>(std::lround(std::clamp(w, -127.0f, 127.0f)));
+            }
+        }
+
+        widest = std::max(widest, layer.out_dim);
+        layers_.push_back(std::move(q));
+    }
+
+    buffer_a_.resize(widest);
+    buffer_b_.resize(widest);
+}
+
+int64_t QuantizedBackend::select_action(const float* state) {
+    const float* x = state;
+    float* y = buffer_a_.data();
+
+    for (size_t l = 0; l < layers_.size(); ++l) {
+        const QuantizedLayer& layer = layers_[l];
+        const bool is_output = (l + 1 == layers_.size());
+
+        std::fill(y, y + layer.out_dim, 0.0f);
+        for (int64_t i = 0; i < layer.in_dim; ++i) {
+            const float xi = x[i];
+            const int8_t* w = layer.weight_t.data() + i * layer.out_dim;
+            for (int64_t o = 0; o < layer.out_dim; ++o) {
+                y[o] += xi * static_cast<float>(w[o]);
+            }
+        }
+        for (int64_t o = 0; o < layer.out_dim; ++o) {
+            float v = y[o] * layer.scale[o] + layer.bias[o];
+            y[o] = is_output ? v : std::max(v, 0.0f);
+        }
+
+        x = y;
+        y = (y == buffer_a_.data()) ? buffer_b_.data() : buffer_a_.data();
+    }
+
+    return argmax(x, layers_.back().out_dim);
+}
+
+// ============================================================================
+// Selection
+// ============================================================================
+
+size_t select_fastest_backend(std::vector<std::unique_ptr<InferenceBackend>>& backends,
+                              const torch::Tensor& probes,
+                              int iterations,
+                              std::vector<BackendBenchmark>* results,
+                              float min_agreement) {
+    if (backends.empty()) {
+        throw std::runtime_error("select_fastest_backend: no backends to select from");
+    }
+    if (probes.dim() != 2 || probes.size(0) == 0) {
+        throw std::invalid_argument("select_fastest_backend: probes must be a non-empty [N, state_dim] tensor");
+    }
+
+    torch::Tensor probe_data = probes.to(torch::kCPU, torch::kFloat32).contiguous();
+    const int64_t num_probes = probe_data.size(0);
+    const int64_t state_dim = probe_data.size(1);
+    const float* probe_ptr = probe_data.data_ptr<float>();
+
+    // Reference actions from the first backend
+    std::vector<int64_t> reference(num_probes);
+    for (int64_t p = 0; p < num_probes; ++p) {
+        reference[p] = backends[0]->select_action(probe_ptr + p * state_dim);
+    }
+
+    size_t best = 0;
+    double best_p99 = -1.0;
+    std::vector<BackendBenchmark> benchmarks;
+
+    for (size_t b = 0; b < backends.size(); ++b) {
+        InferenceBackend& backend = *backends[b];
+
+        BackendBenchmark bench;
+        bench.name = backend.name();
+
+        int64_t matches = 0;
+        for (int64_t p = 0; p < num_probes; ++p) {
+            matches += (backend.select_action(probe_ptr + p * state_dim) == reference[p]) ? 1 : 0;
+        }
+        bench.agreement = static_cast<float>(matches) / num_probes;
+        bench.accepted = bench.agreement >= min_agreement;
+
+        int64_t next_probe = 0;
+        utils::LatencyStats stats = utils::measure_latency([&]() {
+            (void)backend.select_action(probe_ptr + next_probe * state_dim);
+            next_probe = (next_probe + 1) % num_probes;
+        }, iterations, iterations / 10);
+        bench.mean_us = stats.mean_us;
+        bench.p99_us = stats.p99_us;
+
+        std::cout << "[BackendSelector] " << bench.name
+                  << " | agreement: " << (bench.agreement * 100.0f) << "%"
+                  << " | mean: " << bench.mean_us << " us"
+                  << " | p99: " << bench.p99_us << " us"
+                  << (bench.accepted ? "" : " | REJECTED") << std::endl;
+
+        if (bench.accepted && (best_p99 < 0.0 || bench.p99_us < best_p99)) {
+            best = b;
+            best_p99 = bench.p99_us;
+        }
+        benchmarks.push_back(bench);
+    }
+
+    std::cout << "[BackendSelector] Selected backend: " << backends[best]->name()
+              << " (p99 " << best_p99 << " us)" << std::endl;
+
+    if (results != nullptr) {
+        *results = std::move(benchmarks);
+    }
+    return best;
+}
+
+} // namespace dqn
@@ -0,0 +1,212 @@
+#include "dqn/inference_policy.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace dqn {
+
+namespace {
+
+const char kMagic[4] = {'D', 'Q', 'I', 'W'};
+constexpr size_t kAlignment = 64;
+
+size_t align_up(size_t offset) {
+    return (offset + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+size_t header_bytes(size_t num_layers) {
+    return align_up(sizeof(kMagic) + 3 * sizeof(uint32_t) + num_layers * 2 * sizeof(uint32_t));
+}
+
+} // namespace
+
+InferencePolicy::InferencePolicy(const std::string& filepath, int warmup_iterations) {
+    auto start = std::chrono::steady_clock::now();
+
+    int fd = ::open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("InferencePolicy: could not open " + filepath + ": " + std::strerror(errno));
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(header_bytes(0))) {
+        ::close(fd);
+        throw std::runtime_error("InferencePolicy: invalid weights file " + filepath);
+    }
+
+    mapping_bytes_ = static_cast<size_t>(st.st_size);
+    mapping_ = ::mmap(nullptr, mapping_bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);    // The mapping keeps the file referenced
+    if (mapping_ == MAP_FAILED) {
+        mapping_ = nullptr;
+        throw std::runtime_error("InferencePolicy: mmap failed for " + filepath + ": " + std::strerror(errno));
+    }
+
+    try {
+        const char* base = static_cast<const char*>(mapping_);
+        uint32_t header[3];
+        std::memcpy(header, base + sizeof(kMagic), sizeof(header));
+        const uint32_t version = header[0];
+        const uint32_t num_layers = header[1];
+
+        if (std::memcmp(base, kMagic, sizeof(kMagic)) != 0 || version != kVersion ||
+            num_layers == 0 || header_bytes(num_layers) > mapping_bytes_) {
+            throw std::runtime_error("InferencePolicy: invalid weights file " + filepath);
+        }
+
+        std::vector<uint32_t> dims(2 * num_layers);
+        std::memcpy(dims.data(), base + sizeof(kMagic) + sizeof(header), dims.size() * sizeof(uint32_t));
+
+        // The mapping is read-only; the forward pass only reads weights and biases
+        auto options = torch::TensorOptions().dtype(torch::kFloat32);
+        size_t offset = header_bytes(num_layers);
+        int64_t previous_out = dims[0];
+
+        for (uint32_t l = 0; l < num_layers; ++l) {
+            const int64_t in_dim = dims[2 * l];
+            const int64_t out_dim = dims[2 * l + 1];
+            if (in_dim <= 0 || out_dim <= 0 || in_dim != previous_out) {
+                throw std::runtime_error("InferencePolicy: inconsistent layer shapes in " + filepath);
+            }
+
+            // Sizes are checked against the remaining bytes by division, so
+            // dimensions read from the file cannot overflow the offsets
+            const size_t weight_offset = offset;
+            const size_t weight_count = static_cast<size_t>(in_dim);
+            const size_t out_count = static_cast<size_t>(out_dim);
+            if (weight_offset > mapping_bytes_ ||
+                weight_count > (mapping_bytes_ - weight_offset) / sizeof(float) / out_count) {
+                throw std::runtime_error("InferencePolicy: truncated weights file " + filepath);
+            }
+            const size_t bias_offset = align_up(weight_offset + weight_count * out_count * sizeof(float));
+            if (bias_offset > mapping_bytes_ || out_count > (mapping_bytes_ - bias_offset) / sizeof(float)) {
+                throw std::runtime_error("InferencePolicy: truncated weights file " + filepath);
+            }
+            offset = align_up(bias_offset + out_count * sizeof(float));
+
+            float* weight = reinterpret_cast<float*>(const_cast<char*>(base) + weight_offset);
+            float* bias = reinterpret_cast<float*>(const_cast<char*>(base) + bias_offset);
+            weights_t_.push_back(torch::from_blob(weight, {in_dim, out_dim}, options));
+            biases_.push_back(torch::from_blob(bias, {out_dim}, options));
+            activations_.push_back(torch::empty({1, out_dim}, options));
+            previous_out = out_dim;
+        }
+
+        state_dim_ = dims[0];
+        action_dim_ = dims[2 * num_layers - 1];
+        input_ = torch::zeros({1, state_dim_}, options);
+    } catch (...) {
+        ::munmap(mapping_, mapping_bytes_);
+        mapping_ = nullptr;
+        throw;
+    }
+
+    // Warm-up: fault in the weight pages and initialize the CPU kernels
+    std::vector<float> state(state_dim_, 0.0f);
+    for (int i = 0; i < warmup_iterations; ++i) {
+        forward(state.data());
+    }
+
+    load_ms_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+InferencePolicy::~InferencePolicy() {
+    // Drop the views before unmapping their storage
+    weights_t_.clear();
+    biases_.clear();
+    if (mapping_ != nullptr) {
+        ::munmap(mapping_, mapping_bytes_);
+    }
+}
+
+bool InferencePolicy::export_weights(const std::vector<DenseLayer>& layers, const std::string& filepath) {
+    if (layers.empty()) {
+        std::cerr << "[InferencePolicy] Error: network has no Linear layers" << std::endl;
+        return false;
+    }
+
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "[InferencePolicy] Error: Could not open file for writing: " << filepath << std::endl;
+        return false;
+    }
+
+    const uint32_t header[3] = {kVersion, static_cast<uint32_t>(layers.size()), 0};
+    file.write(kMagic, sizeof(kMagic));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    for (const auto& layer : layers) {
+        const uint32_t dims[2] = {static_cast<uint32_t>(layer.in_dim), static_cast<uint32_t>(layer.out_dim)};
+        file.write(reinterpret_cast<const char*>(dims), sizeof(dims));
+    }
+
+    const char padding[kAlignment] = {};
+    auto pad = [&]() {
+        size_t position = static_cast<size_t>(file.tellp());
+        file.write(padding, align_up(position) - position);
+    };
+    pad();
+
+    for (const auto& layer : layers) {
+        file.write(reinterpret_cast<const char*>(layer.weight_t.data()), layer.weight_t.size() * sizeof(float));
+        pad();
+        file.write(reinterpret_cast<const char*>(layer.bias.data()), layer.bias.size() * sizeof(float));
+        pad();
+    }
+
+    file.close();
+    if (!file.good()) {
+        std::cerr << "[InferencePolicy] Error: write failed for " << filepath << std::endl;
+        return false;
+    }
+
+    std::cout << "[InferencePolicy] Weights exported to: " << filepath << std::endl;
+    return true;
+}
+
+void InferencePolicy::forward(const float* state) {
+    torch::NoGradGuard no_grad;
+    std::memcpy(input_.data_ptr<float>(), state, sizeof(float) * state_dim_);
+
+    const torch::Tensor* x = &input_;
+    for (size_t l = 0; l < weights_t_.size(); ++l) {
+        torch::addmm_out(activations_[l], biases_[l], *x, weights_t_[l]);
+        if (l + 1 < weights_t_.size()) {
+            activations_[l].relu_();
+        }
+        x = &activations_[l];
+    }
+}
+
+const float* InferencePolicy::q_values(const float* state) {
+    forward(state);
+    return activations_.back().data_ptr<float>();
+}
+
+int64_t InferencePolicy::select_action(const float* state) {
+    const float* q = q_values(state);
+    return std::max_element(q, q + action_dim_) - q;
+}
+
+std::vector<DenseLayer> InferencePolicy::dense_layers() const {
+    std::vector<DenseLayer> layers;
+    for (size_t l = 0; l < weights_t_.size(); ++l) {
+        DenseLayer layer;
+        layer.in_dim = weights_t_[l].size(0);
+        layer.out_dim = weights_t_[l].size(1);
+        const float* weight = weights_t_[l].data_ptr<float>();
+        const float* bias = biases_[l].data_ptr<float>();
+        layer.weight_t.assign(weight, weight + weights_t_[l].numel());
+        layer.bias.assign(bias, bias + biases_[l].numel());
+        layers.push_back(std::move(layer));
+    }
+    return layers;
+}
+
+} // namespace dqn
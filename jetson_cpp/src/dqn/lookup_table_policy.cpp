@@ -0,0 +1,220 @@
+#include "dqn/lookup_table_policy.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace dqn {
+
+namespace {
+
+const char kMagic[4] = {'D', 'Q', 'L', 'T'};
+const uint32_t kVersion = 1;
+
+// Sanity limits for tables read from disk (compile() output is far smaller)
+const int64_t kMaxResolution = 4096;
+const int64_t kMaxActions = 1024;
+const int64_t kHeaderSize = sizeof(kMagic) + sizeof(kVersion) + 2 * sizeof(int64_t);
+
+// Grid cell and interpolation weight for a gyro channel in [-1, 1] (NaN maps to 0)
+inline void grid_cell(float x, int64_t resolution, int64_t& index, float& weight) {
+    if (!(x == x)) {
+        x = 0.0f;
+    }
+    float u = (std::min(std::max(x, -1.0f), 1.0f) + 1.0f) * 0.5f * static_cast<float>(resolution - 1);
+    index = std::min<int64_t>(static_cast<int64_t>(u), resolution - 2);
+    weight = u - static_cast<float>(index);
+}
+
+inline int64_t touch_case(const float* state) {
+    return (state[2] > 0.5f ? 2 : 0) + (state[3] > 0.5f ? 1 : 0);
+}
+
+// Bilinear interpolation of every action's Q-value; calls emit(a, q) in action order
+template <typename Emit>
+inline void interpolate(const std::vector<float>& table, int64_t resolution, int64_t action_dim,
+                        const float* state, Emit&& emit) {
+    int64_t i0, j0;
+    float ti, tj;
+    grid_cell(state[0], resolution, i0, ti);
+    grid_cell(state[1], resolution, j0, tj);
+
+    const int64_t row = resolution * action_dim;
+    const float* p00 = table.data() + ((touch_case(state) * resolution + i0) * resolution + j0) * action_dim;
+    const float* p01 = p00 + action_dim;
+    const float* p10 = p00 + row;
+    const float* p11 = p10 + action_dim;
+
+    for (int64_t a = 0; a < action_dim; ++a) {
+        emit(a, (1.0f - ti) * ((1.0f - tj) * p00[a] + tj * p01[a]) +
+                    ti * ((1.0f - tj) * p10[a] + tj * p11[a]));
+    }
+}
+
+} // namespace
+
+QLookupTable QLookupTable::compile(const ForwardFn& forward, int64_t resolution) {
+    if (resolution < 2) {
+        throw std::invalid_argument("QLookupTable: resolution must be >= 2");
+    }
+
+    // Grid states in table order: [touch_case][i][j]
+    const int64_t num_points = kTouchCases * resolution * resolution;
+    torch::Tensor grid = torch::empty({num_points, kStateDim}, torch::kFloat32);
+    float* g = grid.data_ptr<float>();
+    for (int64_t tc = 0; tc < kTouchCases; ++tc) {
+        for (int64_t i = 0; i < resolution; ++i) {
+            for (int64_t j = 0; j < resolution; ++j) {
+                float* row = g + ((tc * resolution + i) * resolution + j) * kStateDim;
+                row[0] = -1.0f + 2.0f * static_cast<float>(i) / static_cast<float>(resolution - 1);
+                row[1] = -1.0f + 2.0f * static_cast<float>(j) / static_cast<float>(resolution - 1);
+                row[2] = static_cast<float>(tc / 2);
+                row[3] = static_cast<float>(tc % 2);
+            }
+        }
+    }
+
+    torch::Tensor q;
+    {
+        torch::NoGradGuard no_grad;
+        q = forward(grid).to(torch::kCPU, torch::kFloat32).contiguous();
+    }
+
+    QLookupTable table;
+    table.resolution_ = resolution;
+    table.action_dim_ = q.size(1);
+    table.q_.assign(q.data_ptr<float>(), q.data_ptr<float>() + q.numel());
+
+    std::cout << "[QLookupTable] Compiled " << kTouchCases << "x" << resolution << "x" << resolution
+              << " grid, " << table.action_dim_ << " actions (" << table.size_bytes() / 1024
+              << " KB)" << std::endl;
+    return table;
+}
+
+void QLookupTable::q_values(const float* state, float* q_out) const {
+    interpolate(q_, resolution_, action_dim_, state, [q_out](int64_t a, float q) { q_out[a] = q; });
+}
+
+int64_t QLookupTable::select_action(const float* state) {
+    int64_t best = 0;
+    float best_q = 0.0f;
+    interpolate(q_, resolution_, action_dim_, state, [&](int64_t a, float q) {
+        if (a == 0 || q > best_q) {
+            best = a;
+            best_q = q;
+        }
+    });
+    return best;
+}
+
+LookupTableReport QLookupTable::evaluate(const ForwardFn& forward, int64_t num_samples) const {
+    torch::Tensor gyro = torch::rand({num_samples, 2}) * 2.0f - 1.0f;
+    torch::Tensor touch = torch::randint(0, 2, {num_samples, 2}, torch::kFloat32);
+    torch::Tensor states = torch::cat({gyro, touch}, 1).contiguous();
+
+    torch::Tensor q;
+    {
+        torch::NoGradGuard no_grad;
+        q = forward(states).to(torch::kCPU, torch::kFloat32).contiguous();
+    }
+
+    const float* s = states.data_ptr<float>();
+    const float* net_q = q.data_ptr<float>();
+    std::vector<float> table_q(action_dim_);
+
+    LookupTableReport report;
+    report.num_samples = num_samples;
+    int64_t mismatches = 0;
+    double error_sum = 0.0;
+
+    for (int64_t n = 0; n < num_samples; ++n) {
+        q_values(s + n * kStateDim, table_q.data());
+        const float* row = net_q + n * action_dim_;
+
+        int64_t net_best = 0;
+        int64_t table_best = 0;
+        for (int64_t a = 0; a < action_dim_; ++a) {
+            if (row[a] > row[net_best]) net_best = a;
+            if (table_q[a] > table_q[table_best]) table_best = a;
+
+            float err = std::abs(row[a] - table_q[a]);
+            report.max_q_error = std::max(report.max_q_error, err);
+            error_sum += err;
+        }
+        mismatches += (net_best != table_best) ? 1 : 0;
+    }
+
+    if (num_samples > 0) {
+        report.argmax_error = static_cast<float>(mismatches) / static_cast<float>(num_samples);
+        report.mean_q_error = static_cast<float>(error_sum / (num_samples * action_dim_));
+    }
+    return report;
+}
+
+bool QLookupTable::save(const std::string& filepath) const {
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "[QLookupTable] Error: Could not open file for writing: " << filepath << std::endl;
+        return false;
+    }
+
+    file.write(kMagic, sizeof(kMagic));
+    file.write(reinterpret_cast<const char*>(&kVersion), sizeof(kVersion));
+    file.write(reinterpret_cast<const char*>(&resolution_), sizeof(resolution_));
+    file.write(reinterpret_cast<const char*>(&action_dim_), sizeof(action_dim_));
+    file.write(reinterpret_cast<const char*>(q_.data()), q_.size() * sizeof(float));
+
+    file.close();
+    if (!file.good()) {
+        std::cerr << "[QLookupTable] Error: write failed for " << filepath << std::endl;
+        return false;
+    }
+
+    std::cout << "[QLookupTable] Table saved to: " << filepath << std::endl;
+    return true;
+}
+
+QLookupTable QLookupTable::load(const std::string& filepath) {
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("QLookupTable: could not open " + filepath);
+    }
+
+    char magic[4];
+    uint32_t version = 0;
+    QLookupTable table;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&table.resolution_), sizeof(table.resolution_));
+    file.read(reinterpret_cast<char*>(&table.action_dim_), sizeof(table.action_dim_));
+
+    if (!file || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || version != kVersion ||
+        table.resolution_ < 2 || table.resolution_ > kMaxResolution ||
+        table.action_dim_ < 1 || table.action_dim_ > kMaxActions) {
+        throw std::runtime_error("QLookupTable: invalid table file " + filepath);
+    }
+
+    // Check the size before allocating, so a bad header cannot request gigabytes
+    const int64_t expected = kHeaderSize + kTouchCases * table.resolution_ * table.resolution_ *
+                                           table.action_dim_ * static_cast<int64_t>(sizeof(float));
+    file.seekg(0, std::ios::end);
+    const int64_t actual = static_cast<int64_t>(file.tellg());
+    file.seekg(kHeaderSize, std::ios::beg);
+    if (actual != expected) {
+        throw std::runtime_error("QLookupTable: table file " + filepath + " has " +
+                                 std::to_string(actual) + " bytes, expected " +
+                                 std::to_string(expected));
+    }
+
+    table.q_.resize(kTouchCases * table.resolution_ * table.resolution_ * table.action_dim_);
+    file.read(reinterpret_cast<char*>(table.q_.data()), table.q_.size() * sizeof(float));
+    if (!file) {
+        throw std::runtime_error("QLookupTable: truncated table file " + filepath);
+    }
+
+    return table;
+}
+
+} // namespace dqn
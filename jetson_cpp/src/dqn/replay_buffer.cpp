@@ -1,6 +1,8 @@
 #include "dqn/replay_buffer.h"
 #include <stdexcept>
 #include <algorithm>
+#include <sstream>
+#include "environment/reward_functions.h"
 
 namespace dqn {
 
@@ -11,8 +13,6 @@ ReplayBuffer::ReplayBuffer(size_t capacity)
 
 void ReplayBuffer::push(const torch::Tensor& state, int64_t action, float reward,
                        const torch::Tensor& next_state, bool done) {
-    std::lock_guard<std::mutex> lock(mutex_);
-
     // Create transition
     Transition transition;
     transition.state = state.clone().detach();           // Clone to avoid aliasing
@@ -21,16 +21,38 @@ void ReplayBuffer::push(const torch::Tensor& state, int64_t action, float reward
     transition.next_state = next_state.clone().detach(); // Clone to avoid aliasing
     transition.done = done;
 
+    std::lock_guard<std::mutex> lock(mutex_);
+    push_locked(std::move(transition));
+}
+
+void ReplayBuffer::push(const torch::Tensor& state, int64_t action, float reward,
+                       const torch::Tensor& next_state, bool done,
+                       const communication::SensorRecord& sensors) {
+    Transition transition;
+    transition.state = state.clone().detach();
+    transition.action = action;
+    transition.reward = reward;
+    transition.next_state = next_state.clone().detach();
+    transition.done = done;
+    transition.sensors = sensors;
+    transition.has_sensors = true;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    push_locked(std::move(transition));
+}
+
+void ReplayBuffer::push_locked(Transition transition) {
     // Add to buffer
     buffer_.push_back(std::move(transition));
 
     // Remove oldest if over capacity (FIFO)
     if (buffer_.size() > capacity_) {
         buffer_.pop_front();
+        evicted_++;
     }
 }
 
-TransitionBatch ReplayBuffer::sample(size_t batch_size) {
+TransitionBatch ReplayBuffer::sample(size_t batch_size, int64_t target_version) {
     std::lock_guard<std::mutex> lock(mutex_);
 
     if (buffer_.size() < batch_size) {
@@ -56,6 +78,14 @@ TransitionBatch ReplayBuffer::sample(size_t batch_size) {
     std::vector<torch::Tensor> next_states;
     std::vector<float> dones;
 
+    // Both target cache slots per row; the one used depends on mirroring
+    std::vector<const Transition*> sampled;
+
+    // Output batch (cache bookkeeping filled after augmentation)
+    TransitionBatch batch;
+    batch.ids.reserve(batch_size);
+    sampled.reserve(batch_size);
+
     states.reserve(batch_size);
     actions.reserve(batch_size);
     rewards.reserve(batch_size);
@@ -69,10 +99,12 @@ TransitionBatch ReplayBuffer::sample(size_t batch_size) {
         rewards.push_back(t.reward);
         next_states.push_back(t.next_state);
         dones.push_back(t.done ? 1.0f : 0.0f);
+
+        batch.ids.push_back(evicted_ + idx);
+        sampled.push_back(&t);
     }
 
     // Convert to batched tensors
-    TransitionBatch batch;
 
     // Stack states: [batch_size, state_dim]
     batch.states = torch::stack(states);
@@ -89,9 +121,112 @@ TransitionBatch ReplayBuffer::sample(size_t batch_size) {
     // Dones: [batch_size, 1]
     batch.dones = torch::tensor(dones, torch::kFloat32).unsqueeze(1);
 
+    // Symmetry augmentation: mirror a random subset of eligible rows
+    batch.mirrored.assign(batch_size, 0);
+    if (augmentation_) {
+        torch::Tensor mask = augmentation_->sample_mask(batch.states, batch.next_states);
+        augmentation_->apply(batch.states, batch.next_states, batch.actions, mask);
+
+        auto mask_a = mask.accessor<bool, 1>();
+        for (size_t i = 0; i < batch_size; ++i) {
+            batch.mirrored[i] = mask_a[i] ? 1 : 0;
+        }
+    }
+
+    // Cached target values: [batch_size, 1]
+    std::vector<float> max_next_q(batch_size);
+    for (size_t i = 0; i < batch_size; ++i) {
+        const Transition& t = *sampled[i];
+        bool mirrored = batch.mirrored[i] != 0;
+        max_next_q[i] = mirrored ? t.target_max_q_mirror : t.target_max_q;
+        int64_t cached_version = mirrored ? t.target_version_mirror : t.target_version;
+        if (target_version < 0 || cached_version != target_version) {
+            batch.stale_rows.push_back(static_cast<int64_t>(i));
+        }
+    }
+    batch.max_next_q = torch::tensor(max_next_q, torch::kFloat32).unsqueeze(1);
+
+    return batch;
+}
+
+TransitionBatch ReplayBuffer::sample_real(size_t batch_size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (buffer_.size() < batch_size) {
+        throw std::runtime_error("ReplayBuffer: Not enough transitions to sample. "
+                                "Buffer size: " + std::to_string(buffer_.size()) +
+                                ", requested: " + std::to_string(batch_size));
+    }
+
+    std::vector<size_t> indices(buffer_.size());
+    for (size_t i = 0; i < buffer_.size(); ++i) {
+        indices[i] = i;
+    }
+    std::shuffle(indices.begin(), indices.end(), rng_);
+    indices.resize(batch_size);
+
+    std::vector<torch::Tensor> states;
+    std::vector<int64_t> actions;
+    std::vector<float> rewards;
+    std::vector<torch::Tensor> next_states;
+    std::vector<float> dones;
+    states.reserve(batch_size);
+    actions.reserve(batch_size);
+    rewards.reserve(batch_size);
+    next_states.reserve(batch_size);
+    dones.reserve(batch_size);
+
+    TransitionBatch batch;
+    batch.ids.reserve(batch_size);
+    for (size_t idx : indices) {
+        const Transition& t = buffer_[idx];
+        // A step/time limit is not a terminal state of the dynamics
+        bool truncated = t.has_sensors && t.sensors.truncated > 0.5f;
+        states.push_back(t.state);
+        actions.push_back(t.action);
+        rewards.push_back(t.reward);
+        next_states.push_back(t.next_state);
+        dones.push_back(t.done && !truncated ? 1.0f : 0.0f);
+        batch.ids.push_back(evicted_ + idx);
+    }
+
+    batch.states = torch::stack(states);
+    batch.actions = torch::tensor(actions, torch::kLong).unsqueeze(1);
+    batch.rewards = torch::tensor(rewards, torch::kFloat32).unsqueeze(1);
+    batch.next_states = torch::stack(next_states);
+    batch.dones = torch::tensor(dones, torch::kFloat32).unsqueeze(1);
+    batch.mirrored.assign(batch_size, 0);
     return batch;
 }
 
+void ReplayBuffer::set_augmentation(std::shared_ptr<const SymmetryAugmentation> augmentation) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    augmentation_ = std::move(augmentation);
+}
+
+void ReplayBuffer::update_target_cache(const TransitionBatch& batch, const torch::Tensor& values,
+                                       int64_t target_version) {
+    torch::Tensor flat = values.to(torch::kCPU, torch::kFloat32).contiguous().view({-1});
+    const float* data = flat.data_ptr<float>();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (size_t i = 0; i < batch.stale_rows.size(); ++i) {
+        uint64_t id = batch.ids[batch.stale_rows[i]];
+        if (id < evicted_ || id - evicted_ >= buffer_.size()) {
+            continue;  // Evicted since sampling
+        }
+        Transition& t = buffer_[id - evicted_];
+        if (!batch.mirrored.empty() && batch.mirrored[batch.stale_rows[i]]) {
+            t.target_max_q_mirror = data[i];
+            t.target_version_mirror = target_version;
+        } else {
+            t.target_max_q = data[i];
+            t.target_version = target_version;
+        }
+    }
+}
+
 size_t ReplayBuffer::size() const {
     std::lock_guard<std::mutex> lock(mutex_);
     return buffer_.size();
@@ -102,8 +237,215 @@ bool ReplayBuffer::can_sample(size_t batch_size) const {
     return buffer_.size() >= batch_size;
 }
 
+torch::Tensor ReplayBuffer::all_states() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (buffer_.empty()) {
+        return torch::Tensor();
+    }
+
+    std::vector<torch::Tensor> states;
+    states.reserve(buffer_.size());
+    for (const Transition& t : buffer_) {
+        states.push_back(t.state);
+    }
+    return torch::stack(states);
+}
+
+RelabelStats ReplayBuffer::relabel(const environment::RewardFunction& reward_fn) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    RelabelStats stats;
+
+    // Gather raw sensors into one SoA batch
+    environment::SensorBatch sensors;
+    std::vector<size_t> rows;
+    sensors.reserve(buffer_.size());
+    rows.reserve(buffer_.size());
+    for (size_t i = 0; i < buffer_.size(); ++i) {
+        const Transition& t = buffer_[i];
+        if (!t.has_sensors) {
+            stats.skipped++;
+            continue;
+        }
+        sensors.push_back(t.sensors, t.action);
+        rows.push_back(i);
+    }
+
+    // One sweep over the whole buffer
+    std::vector<float> rewards(rows.size());
+    std::vector<float> dones(rows.size());
+    reward_fn.compute(sensors.view(), rewards.data(), dones.data());
+
+    // Write back
+    double old_sum = 0.0;
+    double new_sum = 0.0;
+    for (size_t k = 0; k < rows.size(); ++k) {
+        Transition& t = buffer_[rows[k]];
+        bool done = dones[k] > 0.5f;
+
+        old_sum += t.reward;
+        new_sum += rewards[k];
+        stats.done_changes += (done != t.done) ? 1 : 0;
+
+        t.reward = rewards[k];
+        t.done = done;
+    }
+
+    stats.relabeled = rows.size();
+    if (!rows.empty()) {
+        stats.old_mean_reward = old_sum / rows.size();
+        stats.new_mean_reward = new_sum / rows.size();
+    }
+    return stats;
+}
+
+void ReplayData::write(torch::serialize::OutputArchive& archive) const {
+    archive.write("states", states);
+    archive.write("actions", actions);
+    archive.write("rewards", rewards);
+    archive.write("next_states", next_states);
+    archive.write("dones", dones);
+    archive.write("sensors", sensors);
+    archive.write("has_sensors", has_sensors);
+}
+
+void ReplayData::read(torch::serialize::InputArchive& archive) {
+    archive.read("states", states);
+    archive.read("actions", actions);
+    archive.read("rewards", rewards);
+    archive.read("next_states", next_states);
+    archive.read("dones", dones);
+    archive.read("sensors", sensors);
+    archive.read("has_sensors", has_sensors);
+}
+
+ReplayData ReplayBuffer::export_data() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    ReplayData data;
+    if (buffer_.empty()) {
+        return data;
+    }
+
+    const int64_t n = static_cast<int64_t>(buffer_.size());
+    std::vector<torch::Tensor> states;
+    std::vector<torch::Tensor> next_states;
+    states.reserve(n);
+    next_states.reserve(n);
+
+    data.actions = torch::empty({n}, torch::kLong);
+    data.rewards = torch::empty({n}, torch::kFloat32);
+    data.dones = torch::empty({n}, torch::kFloat32);
+    data.sensors = torch::zeros({n, 6}, torch::kFloat32);   // SensorRecord fields
+    data.has_sensors = torch::zeros({n}, torch::kFloat32);
+
+    auto actions_a = data.actions.accessor<int64_t, 1>();
+    auto rewards_a = data.rewards.accessor<float, 1>();
+    auto dones_a = data.dones.accessor<float, 1>();
+    auto sensors_a = data.sensors.accessor<float, 2>();
+    auto has_sensors_a = data.has_sensors.accessor<float, 1>();
+
+    for (int64_t i = 0; i < n; ++i) {
+        const Transition& t = buffer_[i];
+        states.push_back(t.state);
+        next_states.push_back(t.next_state);
+        actions_a[i] = t.action;
+        rewards_a[i] = t.reward;
+        dones_a[i] = t.done ? 1.0f : 0.0f;
+        if (t.has_sensors) {
+            has_sensors_a[i] = 1.0f;
+            sensors_a[i][0] = t.sensors.gyro_angle;
+            sensors_a[i][1] = t.sensors.gyro_rate;
+            sensors_a[i][2] = t.sensors.touch_front;
+            sensors_a[i][3] = t.sensors.touch_side;
+            sensors_a[i][4] = t.sensors.valid;
+            sensors_a[i][5] = t.sensors.truncated;
+        }
+    }
+
+    data.states = torch::stack(states).cpu();
+    data.next_states = torch::stack(next_states).cpu();
+    return data;
+}
+
+size_t ReplayBuffer::import_data(const ReplayData& data) {
+    if (!data.defined()) {
+        return 0;
+    }
+
+    const int64_t n = data.states.size(0);
+    torch::Tensor actions = data.actions.to(torch::kCPU, torch::kLong).contiguous();
+    torch::Tensor rewards = data.rewards.to(torch::kCPU, torch::kFloat32).contiguous();
+    torch::Tensor dones = data.dones.to(torch::kCPU, torch::kFloat32).contiguous();
+    torch::Tensor sensors = data.sensors.to(torch::kCPU, torch::kFloat32).contiguous();
+    torch::Tensor has_sensors = data.has_sensors.to(torch::kCPU, torch::kFloat32).contiguous();
+
+    auto actions_a = actions.accessor<int64_t, 1>();
+    auto rewards_a = rewards.accessor<float, 1>();
+    auto dones_a = dones.accessor<float, 1>();
+    auto sensors_a = sensors.accessor<float, 2>();
+    auto has_sensors_a = has_sensors.accessor<float, 1>();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int64_t i = 0; i < n; ++i) {
+        Transition t;
+        t.state = data.states[i].clone();
+        t.action = actions_a[i];
+        t.reward = rewards_a[i];
+        t.next_state = data.next_states[i].clone();
+        t.done = dones_a[i] > 0.5f;
+        t.has_sensors = has_sensors_a[i] > 0.5f;
+        if (t.has_sensors) {
+            t.sensors.gyro_angle = sensors_a[i][0];
+            t.sensors.gyro_rate = sensors_a[i][1];
+            t.sensors.touch_front = sensors_a[i][2];
+            t.sensors.touch_side = sensors_a[i][3];
+            t.sensors.valid = sensors_a[i][4];
+            t.sensors.truncated = sensors_a[i][5];
+        }
+        push_locked(std::move(t));
+    }
+
+    return static_cast<size_t>(n);
+}
+
+void ReplayBuffer::save(const std::string& filepath) const {
+    ReplayData data = export_data();
+    if (!data.defined()) {
+        throw std::runtime_error("ReplayBuffer: nothing to save");
+    }
+
+    torch::serialize::OutputArchive archive;
+    data.write(archive);
+    archive.save_to(filepath);
+}
+
+size_t ReplayBuffer::load(const std::string& filepath) {
+    torch::serialize::InputArchive archive;
+    archive.load_from(filepath);
+
+    ReplayData data;
+    data.read(archive);
+    return import_data(data);
+}
+
+std::string ReplayBuffer::rng_state() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ostringstream out;
+    out << rng_;
+    return out.str();
+}
+
+void ReplayBuffer::set_rng_state(const std::string& state) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::istringstream in(state);
+    in >> rng_;
+}
+
 void ReplayBuffer::clear() {
     std::lock_guard<std::mutex> lock(mutex_);
+    evicted_ += buffer_.size();  // Keep ids of outstanding batches invalid
     buffer_.clear();
 }
 
@@ -0,0 +1,246 @@
+#include "environment/arena.h"
+#include <algorithm>
+#include <cmath>
+
+namespace environment {
+
+namespace {
+
+// Liang-Barsky clip of the parametric range [t0, t1] against one slab side
+inline bool clip(float p, float q, float& t0, float& t1) {
+    if (p == 0.0f) {
+        return q >= 0.0f;
+    }
+    const float t = q / p;
+    if (p < 0.0f) {
+        t0 = std::max(t0, t);
+    } else {
+        t1 = std::min(t1, t);
+    }
+    return t0 <= t1;
+}
+
+inline bool segment_hits_obstacle(float x0, float y0, float x1, float y1, const ArenaObstacle& o) {
+    const float dx = x1 - x0;
+    const float dy = y1 - y0;
+
+    if (o.shape == ObstacleShape::kDisc) {
+        // Distance from the centre to the closest point of the segment
+        const float len_sq = dx * dx + dy * dy;
+        float t = len_sq > 0.0f ? ((o.x - x0) * dx + (o.y - y0) * dy) / len_sq : 0.0f;
+        t = std::min(1.0f, std::max(0.0f, t));
+        const float px = x0 + t * dx - o.x;
+        const float py = y0 + t * dy - o.y;
+        return px * px + py * py <= o.radius * o.radius;
+    }
+
+    float t0 = 0.0f;
+    float t1 = 1.0f;
+    return clip(-dx, x0 - (o.x - o.half_width), t0, t1) &&
+           clip(dx, (o.x + o.half_width) - x0, t0, t1) &&
+           clip(-dy, y0 - (o.y - o.half_height), t0, t1) &&
+           clip(dy, (o.y + o.half_height) - y0, t0, t1);
+}
+
+inline bool circle_hits_obstacle(float x, float y, float radius, const ArenaObstacle& o) {
+    float px;
+    float py;
+    float reach;
+    if (o.shape == ObstacleShape::kDisc) {
+        px = x - o.x;
+        py = y - o.y;
+        reach = radius + o.radius;
+    } else {
+        // Closest point of the box to the centre
+        px = x - std::min(o.x + o.half_width, std::max(o.x - o.half_width, x));
+        py = y - std::min(o.y + o.half_height, std::max(o.y - o.half_height, y));
+        reach = radius;
+    }
+    return px * px + py * py <= reach * reach;
+}
+
+inline void obstacle_bounds(const ArenaObstacle& o, float& min_x, float& min_y, float& max_x, float& max_y) {
+    const float hx = o.shape == ObstacleShape::kDisc ? o.radius : o.half_width;
+    const float hy = o.shape == ObstacleShape::kDisc ? o.radius : o.half_height;
+    min_x = o.x - hx;
+    max_x = o.x + hx;
+    min_y = o.y - hy;
+    max_y = o.y + hy;
+}
+
+} // namespace
+
+Arena::Arena(const ArenaParams& params) : params_(params) {
+    const float cell = params_.cell_size > 0.0f ? params_.cell_size : 0.25f;
+    inv_cell_ = 1.0f / cell;
+    cols_ = std::max(1, static_cast<int>(std::ceil(params_.width * inv_cell_)));
+    rows_ = std::max(1, static_cast<int>(std::ceil(params_.height * inv_cell_)));
+    build_index();
+}
+
+void Arena::generate(std::mt19937& rng) {
+    const ArenaParams& p = params_;
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_int_distribution<int> count(std::max(0, p.min_obstacles),
+                                             std::max(0, std::max(p.min_obstacles, p.max_obstacles)));
+
+    const int n = count(rng);
+    obstacles_.clear();
+    for (int i = 0; i < n; ++i) {
+        ArenaObstacle o;
+        o.x = p.width * unit(rng);
+        o.y = p.height * unit(rng);
+        if (unit(rng) < p.box_fraction) {
+            o.shape = ObstacleShape::kBox;
+            o.half_width = p.min_size + (p.max_size - p.min_size) * unit(rng);
+            o.half_height = p.min_size + (p.max_size - p.min_size) * unit(rng);
+        } else {
+            o.shape = ObstacleShape::kDisc;
+            o.radius = p.min_size + (p.max_size - p.min_size) * unit(rng);
+        }
+        obstacles_.push_back(o);
+    }
+    build_index();
+}
+
+void Arena::set_obstacles(const std::vector<ArenaObstacle>& obstacles) {
+    obstacles_.assign(obstacles.begin(), obstacles.end());
+    build_index();
+}
+
+void Arena::cell_range(float min_x, float min_y, float max_x, float max_y,
+                       int& c0, int& r0, int& c1, int& r1) const {
+    c0 = std::min(cols_ - 1, std::max(0, static_cast<int>(std::floor(min_x * inv_cell_))));
+    c1 = std::min(cols_ - 1, std::max(0, static_cast<int>(std::floor(max_x * inv_cell_))));
+    r0 = std::min(rows_ - 1, std::max(0, static_cast<int>(std::floor(min_y * inv_cell_))));
+    r1 = std::min(rows_ - 1, std::max(0, static_cast<int>(std::floor(max_y * inv_cell_))));
+}
+
+void Arena::build_index() {
+    const size_t num_cells = static_cast<size_t>(cols_) * rows_;
+    cell_start_.assign(num_cells + 1, 0);
+
+    // Count per cell, inclusive prefix sum (cell_start_[c] = end of cell c),
+    // then fill backwards so cell_start_[c] ends at the start of cell c
+    int c0, r0, c1, r1;
+    float min_x, min_y, max_x, max_y;
+    for (const ArenaObstacle& o : obstacles_) {
+        obstacle_bounds(o, min_x, min_y, max_x, max_y);
+        cell_range(min_x, min_y, max_x, max_y, c0, r0, c1, r1);
+        for (int r = r0; r <= r1; ++r) {
+            for (int c = c0; c <= c1; ++c) {
+                cell_start_[r * cols_ + c]++;
+            }
+        }
+    }
+    for (size_t c = 1; c < num_cells; ++c) {
+        cell_start_[c] += cell_start_[c - 1];
+    }
+    const uint32_t total = num_cells > 0 ? cell_start_[num_cells - 1] : 0;
+    cell_start_[num_cells] = total;
+    cell_items_.resize(total);
+
+    for (uint32_t i = 0; i < obstacles_.size(); ++i) {
+        obstacle_bounds(obstacles_[i], min_x, min_y, max_x, max_y);
+        cell_range(min_x, min_y, max_x, max_y, c0, r0, c1, r1);
+        for (int r = r0; r <= r1; ++r) {
+            for (int c = c0; c <= c1; ++c) {
+                cell_items_[--cell_start_[r * cols_ + c]] = i;
+            }
+        }
+    }
+}
+
+bool Arena::segment_hits(float x0, float y0, float x1, float y1) const {
+    // The arena is convex: a segment crosses a wall iff an endpoint is outside
+    if (std::min(x0, x1) < 0.0f || std::min(y0, y1) < 0.0f ||
+        std::max(x0, x1) > params_.width || std::max(y0, y1) > params_.height) {
+        return true;
+    }
+
+    int c0, r0, c1, r1;
+    cell_range(std::min(x0, x1), std::min(y0, y1), std::max(x0, x1), std::max(y0, y1), c0, r0, c1, r1);
+    for (int r = r0; r <= r1; ++r) {
+        for (int c = c0; c <= c1; ++c) {
+            const int cell = r * cols_ + c;
+            for (uint32_t k = cell_start_[cell]; k < cell_start_[cell + 1]; ++k) {
+                if (segment_hits_obstacle(x0, y0, x1, y1, obstacles_[cell_items_[k]])) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+bool Arena::circle_hits(float x, float y, float radius) const {
+    if (x - radius < 0.0f || y - radius < 0.0f ||
+        x + radius > params_.width || y + radius > params_.height) {
+        return true;
+    }
+
+    int c0, r0, c1, r1;
+    cell_range(x - radius, y - radius, x + radius, y + radius, c0, r0, c1, r1);
+    for (int r = r0; r <= r1; ++r) {
+        for (int c = c0; c <= c1; ++c) {
+            const int cell = r * cols_ + c;
+            for (uint32_t k = cell_start_[cell]; k < cell_start_[cell + 1]; ++k) {
+                if (circle_hits_obstacle(x, y, radius, obstacles_[cell_items_[k]])) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+bool Arena::sample_free_position(std::mt19937& rng, float clearance, float& x, float& y,
+                                 int attempts) const {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (int attempt = 0; attempt < attempts; ++attempt) {
+        x = clearance + (params_.width - 2.0f * clearance) * unit(rng);
+        y = clearance + (params_.height - 2.0f * clearance) * unit(rng);
+        if (!circle_hits(x, y, clearance)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Arena::bumper_contacts(float x, float y, float heading, const BumperGeometry& bumpers,
+                            bool& touch_front, bool& touch_side) const {
+    const float c = std::cos(heading);
+    const float s = std::sin(heading);
+
+    // Front: perpendicular to the heading, ahead of the centre
+    const float fx = x + c * bumpers.front_offset;
+    const float fy = y + s * bumpers.front_offset;
+    const float fw = bumpers.front_half_width;
+    touch_front = segment_hits(fx + s * fw, fy - c * fw, fx - s * fw, fy + c * fw);
+
+    // Side: along the heading, on the right
+    const float sx = x + s * bumpers.side_offset;
+    const float sy = y - c * bumpers.side_offset;
+    const float sl = bumpers.side_half_length;
+    touch_side = segment_hits(sx - c * sl, sy - s * sl, sx + c * sl, sy + s * sl);
+}
+
+void Arena::bumper_contacts(const PoseBatchView& poses, const BumperGeometry& bumpers,
+                            float* touch_front, float* touch_side) const {
+    for (size_t i = 0; i < poses.size; ++i) {
+        bool front = false;
+        bool side = false;
+        bumper_contacts(poses.x[i], poses.y[i], poses.heading[i], bumpers, front, side);
+        touch_front[i] = front ? 1.0f : 0.0f;
+        touch_side[i] = side ? 1.0f : 0.0f;
+    }
+}
+
+void Arena::segments_hit(const float* x0, const float* y0, const float* x1, const float* y1,
+                         size_t n, uint8_t* hits) const {
+    for (size_t i = 0; i < n; ++i) {
+        hits[i] = segment_hits(x0[i], y0[i], x1[i], y1[i]) ? 1 : 0;
+    }
+}
+
+} // namespace environment
@@ -0,0 +1,120 @@
+#include "environment/batched_environment.h"
+#include <stdexcept>
+#include <string>
+
+namespace environment {
+
+namespace {
+
+void check_buffer(const torch::Tensor& t, torch::ScalarType dtype, torch::IntArrayRef shape,
+                  const char* name) {
+    if (!t.defined() || !t.device().is_cpu() || t.scalar_type() != dtype || !t.is_contiguous() ||
+        !t.sizes().equals(shape)) {
+        throw std::invalid_argument(std::string("BatchedEnvironment: bad '") + name + "' buffer");
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// BatchedEnvironmentInterface
+// ============================================================================
+
+void BatchedEnvironmentInterface::reset_all(torch::Tensor& observations) {
+    torch::Tensor mask = torch::ones({num_envs()}, torch::kBool);
+    reset_where(mask, observations);
+}
+
+torch::Tensor BatchedEnvironmentInterface::make_observations() const {
+    return torch::zeros({num_envs(), state_dim()}, torch::kFloat32);
+}
+
+torch::Tensor BatchedEnvironmentInterface::make_scalars() const {
+    return torch::zeros({num_envs()}, torch::kFloat32);
+}
+
+void check_batch_buffers(const BatchedEnvironmentInterface& env, const torch::Tensor& actions,
+                         const torch::Tensor& observations, const torch::Tensor& rewards,
+                         const torch::Tensor& dones) {
+    const int64_t n = env.num_envs();
+    check_buffer(actions, torch::kInt64, {n}, "actions");
+    check_buffer(observations, torch::kFloat32, {n, env.state_dim()}, "observations");
+    check_buffer(rewards, torch::kFloat32, {n}, "rewards");
+    check_buffer(dones, torch::kFloat32, {n}, "dones");
+}
+
+MaskView::MaskView(const torch::Tensor& mask, int64_t num_envs) {
+    if (!mask.device().is_cpu() || !mask.is_contiguous()) {
+        throw std::invalid_argument("BatchedEnvironment: mask must be a contiguous CPU tensor");
+    }
+    if (mask.numel() != num_envs) {
+        throw std::invalid_argument("BatchedEnvironment: mask has " + std::to_string(mask.numel()) +
+                                    " elements, expected " + std::to_string(num_envs));
+    }
+    if (mask.scalar_type() == torch::kBool) {
+        bools_ = mask.data_ptr<bool>();
+    } else if (mask.scalar_type() == torch::kFloat32) {
+        floats_ = mask.data_ptr<float>();
+    } else {
+        throw std::invalid_argument("BatchedEnvironment: mask must be bool or float32");
+    }
+}
+
+// ============================================================================
+// ScalarEnvAdapter
+// ============================================================================
+
+ScalarEnvAdapter::ScalarEnvAdapter(const Factory& factory, int64_t num_envs) {
+    for (int64_t i = 0; i < num_envs; ++i) {
+        envs_.push_back(factory());
+    }
+    if (envs_.empty()) {
+        throw std::invalid_argument("ScalarEnvAdapter: at least one environment is required");
+    }
+}
+
+ScalarEnvAdapter::ScalarEnvAdapter(std::vector<std::unique_ptr<EnvironmentInterface>> envs)
+    : envs_(std::move(envs)) {
+    if (envs_.empty()) {
+        throw std::invalid_argument("ScalarEnvAdapter: at least one environment is required");
+    }
+}
+
+void ScalarEnvAdapter::reset_where(const torch::Tensor& mask, torch::Tensor& observations) {
+    MaskView selected(mask, num_envs());
+    const int64_t dim = state_dim();
+    check_buffer(observations, torch::kFloat32, {num_envs(), dim}, "observations");
+    float* obs = observations.data_ptr<float>();
+
+    for (int64_t i = 0; i < num_envs(); ++i) {
+        if (!selected[i]) {
+            continue;
+        }
+        envs_[i]->reset_into(obs + i * dim);
+    }
+}
+
+void ScalarEnvAdapter::step_batch(const torch::Tensor& actions, torch::Tensor& observations,
+                                  torch::Tensor& rewards, torch::Tensor& dones) {
+    check_batch_buffers(*this, actions, observations, rewards, dones);
+
+    const int64_t dim = state_dim();
+    const int64_t* action_ptr = actions.data_ptr<int64_t>();
+    float* obs = observations.data_ptr<float>();
+    float* reward_ptr = rewards.data_ptr<float>();
+    float* done_ptr = dones.data_ptr<float>();
+
+    for (int64_t i = 0; i < num_envs(); ++i) {
+        bool done = false;
+        envs_[i]->step_into(action_ptr[i], obs + i * dim, reward_ptr[i], done);
+        done_ptr[i] = done ? 1.0f : 0.0f;
+    }
+}
+
+void ScalarEnvAdapter::close() {
+    for (auto& env : envs_) {
+        env->close();
+    }
+}
+
+} // namespace environment
@@ -10,29 +10,44 @@ CartPoleEnv::CartPoleEnv(int max_steps)
 }
 
 torch::Tensor CartPoleEnv::reset() {
+    torch::Tensor state = torch::empty({4}, torch::kFloat32);
+    reset_into(state.data_ptr<float>());
+    return state;
+}
+
+void CartPoleEnv::reset_into(float* state) {
     std::uniform_real_distribution<float> dist(-0.05f, 0.05f);
     x_ = dist(rng_);
     x_dot_ = dist(rng_);
     theta_ = dist(rng_);
     theta_dot_ = dist(rng_);
     step_count_ = 0;
-    return get_state();
+    write_state(state);
 }
 
 StepResult CartPoleEnv::step(int64_t action) {
+    StepResult result;
+    result.next_state = torch::empty({4}, torch::kFloat32);
+    step_into(action, result.next_state.data_ptr<float>(), result.reward, result.done);
+    result.info = "sim_step=" + std::to_string(step_count_);
+    return result;
+}
+
+void CartPoleEnv::step_into(int64_t action, float* next_state, float& reward, bool& done,
+                            StepInfo* info) {
     step_count_++;
     float force = (action == 1) ? FORCE_MAG : -FORCE_MAG;
     update_physics(force);
 
-    bool done = is_terminal();
-    float reward = done ? 0.0f : 1.0f;
+    done = is_terminal();
+    reward = done ? 0.0f : 1.0f;
+    write_state(next_state);
 
-    StepResult result;
-    result.next_state = get_state();
-    result.reward = reward;
-    result.done = done;
-    result.info = "sim_step=" + std::to_string(step_count_);
-    return result;
+    if (info != nullptr) {
+        info->step = step_count_;
+        info->truncated = done && std::abs(x_) <= X_THRESHOLD && std::abs(theta_) <= THETA_THRESHOLD;
+        info->collision = false;
+    }
 }
 
 void CartPoleEnv::update_physics(float force) {
@@ -58,8 +73,11 @@ bool CartPoleEnv::is_terminal() const {
             step_count_ >= max_steps_);
 }
 
-torch::Tensor CartPoleEnv::get_state() const {
-    return torch::tensor({x_, x_dot_, theta_, theta_dot_}, torch::kFloat32);
+void CartPoleEnv::write_state(float* out) const {
+    out[0] = x_;
+    out[1] = x_dot_;
+    out[2] = theta_;
+    out[3] = theta_dot_;
 }
 
 } // namespace environment
@@ -0,0 +1,254 @@
+#include "environment/cartpole_kernels.h"
+#include <cmath>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define CARTPOLE_KERNEL_AVX2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CARTPOLE_KERNEL_NEON 1
+#endif
+
+namespace environment {
+
+namespace {
+
+using C = CartPoleConstants;
+
+constexpr float kTotalMass = C::kCartMass + C::kPoleMass;
+constexpr float kPoleMassLength = C::kPoleMass * C::kPoleLength;
+
+// Cephes sinf/cosf: reduce to [-pi/4, pi/4] by octant, then minimax polynomials
+constexpr float kFourOverPi = 1.27323954473516f;
+constexpr float kDP1 = 0.78515625f;
+constexpr float kDP2 = 2.4187564849853515625e-4f;
+constexpr float kDP3 = 3.77489497744594108e-8f;
+constexpr float kSin0 = -1.9515295891e-4f;
+constexpr float kSin1 = 8.3321608736e-3f;
+constexpr float kSin2 = -1.6666654611e-1f;
+constexpr float kCos0 = 2.443315711809948e-5f;
+constexpr float kCos1 = -1.388731625493765e-3f;
+constexpr float kCos2 = 4.166664568298827e-2f;
+
+// One lane, same algorithm as the vector kernels
+inline void step_scalar(float& x, float& x_dot, float& theta, float& theta_dot,
+                        float force, float& terminal) {
+    const float cos_theta = std::cos(theta);
+    const float sin_theta = std::sin(theta);
+
+    const float temp = (force + kPoleMassLength * theta_dot * theta_dot * sin_theta) / kTotalMass;
+    const float theta_acc = (C::kGravity * sin_theta - cos_theta * temp) /
+                            (C::kPoleLength * (4.0f / 3.0f - C::kPoleMass * cos_theta * cos_theta / kTotalMass));
+    const float x_acc = temp - kPoleMassLength * theta_acc * cos_theta / kTotalMass;
+
+    x += C::kTau * x_dot;
+    x_dot += C::kTau * x_acc;
+    theta += C::kTau * theta_dot;
+    theta_dot += C::kTau * theta_acc;
+
+    terminal = (std::abs(x) > C::kXThreshold || std::abs(theta) > C::kThetaThreshold) ? 1.0f : 0.0f;
+}
+
+#if defined(CARTPOLE_KERNEL_AVX2)
+
+inline void sincos_avx2(__m256 x, __m256& s, __m256& c) {
+    const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+    __m256 sign_sin = _mm256_and_ps(x, sign_mask);
+    x = _mm256_andnot_ps(sign_mask, x);
+
+    // Octant j, rounded up to even
+    __m256i j = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(kFourOverPi)));
+    j = _mm256_and_si256(_mm256_add_epi32(j, _mm256_set1_epi32(1)), _mm256_set1_epi32(~1));
+    const __m256 y = _mm256_cvtepi32_ps(j);
+
+    const __m256 swap_sin = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(j, _mm256_set1_epi32(4)), 29));
+    const __m256 poly_mask = _mm256_castsi256_ps(
+        _mm256_cmpeq_epi32(_mm256_and_si256(j, _mm256_set1_epi32(2)), _mm256_setzero_si256()));
+    const __m256 sign_cos = _mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_andnot_si256(_mm256_sub_epi32(j, _mm256_set1_epi32(2)), _mm256_set1_epi32(4)), 29));
+    sign_sin = _mm256_xor_ps(sign_sin, swap_sin);
+
+    // Extended-precision reduction x - y * pi/4
+    x = _mm256_fnmadd_ps(y, _mm256_set1_ps(kDP1), x);
+    x = _mm256_fnmadd_ps(y, _mm256_set1_ps(kDP2), x);
+    x = _mm256_fnmadd_ps(y, _mm256_set1_ps(kDP3), x);
+    const __m256 z = _mm256_mul_ps(x, x);
+
+    __m256 poly_cos = _mm256_fmadd_ps(_mm256_set1_ps(kCos0), z, _mm256_set1_ps(kCos1));
+    poly_cos = _mm256_fmadd_ps(poly_cos, z, _mm256_set1_ps(kCos2));
+    poly_cos = _mm256_mul_ps(_mm256_mul_ps(poly_cos, z), z);
+    poly_cos = _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z, poly_cos);
+    poly_cos = _mm256_add_ps(poly_cos, _mm256_set1_ps(1.0f));
+
+    __m256 poly_sin = _mm256_fmadd_ps(_mm256_set1_ps(kSin0), z, _mm256_set1_ps(kSin1));
+    poly_sin = _mm256_fmadd_ps(poly_sin, z, _mm256_set1_ps(kSin2));
+    poly_sin = _mm256_fmadd_ps(_mm256_mul_ps(poly_sin, z), x, x);
+
+    // Octants 1,2 (mod 4) swap the polynomials
+    s = _mm256_xor_ps(_mm256_blendv_ps(poly_cos, poly_sin, poly_mask), sign_sin);
+    c = _mm256_xor_ps(_mm256_blendv_ps(poly_sin, poly_cos, poly_mask), sign_cos);
+}
+
+int64_t step_avx2(const CartPoleSoA& state, const float* force, float* terminal) {
+    const __m256 total_mass = _mm256_set1_ps(kTotalMass);
+    const __m256 pole_mass_length = _mm256_set1_ps(kPoleMassLength);
+    const __m256 gravity = _mm256_set1_ps(C::kGravity);
+    const __m256 pole_length = _mm256_set1_ps(C::kPoleLength);
+    const __m256 four_thirds = _mm256_set1_ps(4.0f / 3.0f);
+    const __m256 pole_mass_over_total = _mm256_set1_ps(C::kPoleMass / kTotalMass);
+    const __m256 tau = _mm256_set1_ps(C::kTau);
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 x_threshold = _mm256_set1_ps(C::kXThreshold);
+    const __m256 theta_threshold = _mm256_set1_ps(C::kThetaThreshold);
+    const __m256 one = _mm256_set1_ps(1.0f);
+
+    int64_t i = 0;
+    for (; i + 8 <= state.size; i += 8) {
+        __m256 x = _mm256_loadu_ps(state.x + i);
+        __m256 x_dot = _mm256_loadu_ps(state.x_dot + i);
+        __m256 theta = _mm256_loadu_ps(state.theta + i);
+        __m256 theta_dot = _mm256_loadu_ps(state.theta_dot + i);
+        const __m256 f = _mm256_loadu_ps(force + i);
+
+        __m256 sin_theta, cos_theta;
+        sincos_avx2(theta, sin_theta, cos_theta);
+
+        const __m256 temp = _mm256_div_ps(
+            _mm256_fmadd_ps(_mm256_mul_ps(pole_mass_length, _mm256_mul_ps(theta_dot, theta_dot)), sin_theta, f),
+            total_mass);
+        const __m256 numerator = _mm256_fmsub_ps(gravity, sin_theta, _mm256_mul_ps(cos_theta, temp));
+        const __m256 denominator = _mm256_mul_ps(
+            pole_length,
+            _mm256_fnmadd_ps(pole_mass_over_total, _mm256_mul_ps(cos_theta, cos_theta), four_thirds));
+        const __m256 theta_acc = _mm256_div_ps(numerator, denominator);
+        const __m256 x_acc = _mm256_fnmadd_ps(
+            _mm256_div_ps(pole_mass_length, total_mass), _mm256_mul_ps(theta_acc, cos_theta), temp);
+
+        x = _mm256_fmadd_ps(tau, x_dot, x);
+        x_dot = _mm256_fmadd_ps(tau, x_acc, x_dot);
+        theta = _mm256_fmadd_ps(tau, theta_dot, theta);
+        theta_dot = _mm256_fmadd_ps(tau, theta_acc, theta_dot);
+
+        const __m256 out = _mm256_or_ps(
+            _mm256_cmp_ps(_mm256_and_ps(x, abs_mask), x_threshold, _CMP_GT_OQ),
+            _mm256_cmp_ps(_mm256_and_ps(theta, abs_mask), theta_threshold, _CMP_GT_OQ));
+
+        _mm256_storeu_ps(state.x + i, x);
+        _mm256_storeu_ps(state.x_dot + i, x_dot);
+        _mm256_storeu_ps(state.theta + i, theta);
+        _mm256_storeu_ps(state.theta_dot + i, theta_dot);
+        _mm256_storeu_ps(terminal + i, _mm256_and_ps(out, one));
+    }
+    return i;
+}
+
+#elif defined(CARTPOLE_KERNEL_NEON)
+
+inline void sincos_neon(float32x4_t x, float32x4_t& s, float32x4_t& c) {
+    uint32x4_t sign_sin = vandq_u32(vreinterpretq_u32_f32(x), vdupq_n_u32(0x80000000u));
+    x = vabsq_f32(x);
+
+    // Octant j, rounded up to even
+    uint32x4_t j = vcvtq_u32_f32(vmulq_n_f32(x, kFourOverPi));
+    j = vandq_u32(vaddq_u32(j, vdupq_n_u32(1)), vdupq_n_u32(~1u));
+    const float32x4_t y = vcvtq_f32_u32(j);
+
+    const uint32x4_t poly_mask = vtstq_u32(j, vdupq_n_u32(2));   // all ones where bit 1 is set
+    const uint32x4_t swap_sin = vshlq_n_u32(vandq_u32(j, vdupq_n_u32(4)), 29);
+    const uint32x4_t sign_cos = vshlq_n_u32(vandq_u32(vmvnq_u32(vsubq_u32(j, vdupq_n_u32(2))), vdupq_n_u32(4)), 29);
+    sign_sin = veorq_u32(sign_sin, swap_sin);
+
+    // Extended-precision reduction x - y * pi/4
+    x = vfmsq_f32(x, y, vdupq_n_f32(kDP1));
+    x = vfmsq_f32(x, y, vdupq_n_f32(kDP2));
+    x = vfmsq_f32(x, y, vdupq_n_f32(kDP3));
+    const float32x4_t z = vmulq_f32(x, x);
+
+    float32x4_t poly_cos = vfmaq_f32(vdupq_n_f32(kCos1), z, vdupq_n_f32(kCos0));
+    poly_cos = vfmaq_f32(vdupq_n_f32(kCos2), poly_cos, z);
+    poly_cos = vmulq_f32(vmulq_f32(poly_cos, z), z);
+    poly_cos = vfmsq_f32(poly_cos, z, vdupq_n_f32(0.5f));
+    poly_cos = vaddq_f32(poly_cos, vdupq_n_f32(1.0f));
+
+    float32x4_t poly_sin = vfmaq_f32(vdupq_n_f32(kSin1), z, vdupq_n_f32(kSin0));
+    poly_sin = vfmaq_f32(vdupq_n_f32(kSin2), poly_sin, z);
+    poly_sin = vfmaq_f32(x, vmulq_f32(poly_sin, z), x);
+
+    // Octants 1,2 (mod 4) swap the polynomials
+    s = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(vbslq_f32(poly_mask, poly_cos, poly_sin)), sign_sin));
+    c = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(vbslq_f32(poly_mask, poly_sin, poly_cos)), sign_cos));
+}
+
+int64_t step_neon(const CartPoleSoA& state, const float* force, float* terminal) {
+    const float32x4_t tau = vdupq_n_f32(C::kTau);
+    const float32x4_t x_threshold = vdupq_n_f32(C::kXThreshold);
+    const float32x4_t theta_threshold = vdupq_n_f32(C::kThetaThreshold);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+
+    int64_t i = 0;
+    for (; i + 4 <= state.size; i += 4) {
+        float32x4_t x = vld1q_f32(state.x + i);
+        float32x4_t x_dot = vld1q_f32(state.x_dot + i);
+        float32x4_t theta = vld1q_f32(state.theta + i);
+        float32x4_t theta_dot = vld1q_f32(state.theta_dot + i);
+        const float32x4_t f = vld1q_f32(force + i);
+
+        float32x4_t sin_theta, cos_theta;
+        sincos_neon(theta, sin_theta, cos_theta);
+
+        const float32x4_t temp = vdivq_f32(
+            vfmaq_f32(f, vmulq_n_f32(vmulq_f32(theta_dot, theta_dot), kPoleMassLength), sin_theta),
+            vdupq_n_f32(kTotalMass));
+        const float32x4_t numerator = vfmsq_f32(vmulq_n_f32(sin_theta, C::kGravity), cos_theta, temp);
+        const float32x4_t denominator = vmulq_n_f32(
+            vfmsq_f32(vdupq_n_f32(4.0f / 3.0f), vmulq_f32(cos_theta, cos_theta), vdupq_n_f32(C::kPoleMass / kTotalMass)),
+            C::kPoleLength);
+        const float32x4_t theta_acc = vdivq_f32(numerator, denominator);
+        const float32x4_t x_acc = vfmsq_f32(temp, vmulq_f32(theta_acc, cos_theta),
+                                            vdupq_n_f32(kPoleMassLength / kTotalMass));
+
+        x = vfmaq_f32(x, tau, x_dot);
+        x_dot = vfmaq_f32(x_dot, tau, x_acc);
+        theta = vfmaq_f32(theta, tau, theta_dot);
+        theta_dot = vfmaq_f32(theta_dot, tau, theta_acc);
+
+        const uint32x4_t out = vorrq_u32(vcagtq_f32(x, x_threshold), vcagtq_f32(theta, theta_threshold));
+
+        vst1q_f32(state.x + i, x);
+        vst1q_f32(state.x_dot + i, x_dot);
+        vst1q_f32(state.theta + i, theta);
+        vst1q_f32(state.theta_dot + i, theta_dot);
+        vst1q_f32(terminal + i, vreinterpretq_f32_u32(vandq_u32(out, vreinterpretq_u32_f32(one))));
+    }
+    return i;
+}
+
+#endif
+
+} // namespace
+
+void cartpole_step_kernel(const CartPoleSoA& state, const float* force, float* terminal) {
+    int64_t i = 0;
+#if defined(CARTPOLE_KERNEL_AVX2)
+    i = step_avx2(state, force, terminal);
+#elif defined(CARTPOLE_KERNEL_NEON)
+    i = step_neon(state, force, terminal);
+#endif
+
+    // Scalar fallback and remainder lanes
+    for (; i < state.size; ++i) {
+        step_scalar(state.x[i], state.x_dot[i], state.theta[i], state.theta_dot[i], force[i], terminal[i]);
+    }
+}
+
+const char* cartpole_kernel_isa() {
+#if defined(CARTPOLE_KERNEL_AVX2)
+    return "avx2";
+#elif defined(CARTPOLE_KERNEL_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace environment
@@ -0,0 +1,332 @@
+#include "environment/env_pool.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace environment {
+
+namespace {
+
+void check_ids(const torch::Tensor& ids, int64_t count, const char* name) {
+    if (!ids.device().is_cpu() || ids.scalar_type() != torch::kInt64 || !ids.is_contiguous() ||
+        ids.dim() != 1 || (count >= 0 && ids.size(0) != count)) {
+        throw std::invalid_argument(std::string("EnvPool: bad '") + name + "' tensor");
+    }
+}
+
+void check_output(const torch::Tensor& t, torch::IntArrayRef shape, const char* name) {
+    if (!t.device().is_cpu() || t.scalar_type() != torch::kFloat32 || !t.is_contiguous() ||
+        !t.sizes().equals(shape)) {
+        throw std::invalid_argument(std::string("EnvPool: bad '") + name + "' buffer");
+    }
+}
+
+} // namespace
+
+EnvPool::EnvPool(const ScalarEnvAdapter::Factory& factory, int64_t num_envs, int num_threads) {
+    if (num_envs <= 0) {
+        throw std::invalid_argument("EnvPool: num_envs must be positive");
+    }
+    for (int64_t i = 0; i < num_envs; ++i) {
+        envs_.push_back(factory());
+    }
+    state_dim_ = envs_.front()->state_dim();
+    action_dim_ = envs_.front()->action_dim();
+
+    action_slots_.assign(num_envs, 0);
+    observation_slots_.assign(num_envs * state_dim_, 0.0f);
+    reward_slots_.assign(num_envs, 0.0f);
+    done_slots_.assign(num_envs, 0.0f);
+    busy_.assign(num_envs, 0);
+
+    if (num_threads <= 0) {
+        num_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    num_threads = static_cast<int>(std::min<int64_t>(num_threads, num_envs));
+
+    for (int t = 0; t < num_threads; ++t) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    for (int t = 0; t < num_threads; ++t) {
+        threads_.emplace_back(&EnvPool::worker_loop, this, static_cast<size_t>(t));
+    }
+}
+
+EnvPool::~EnvPool() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stop_ = true;
+    }
+    wake_cv_.notify_all();
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+void EnvPool::close() {
+    for (auto& env : envs_) {
+        env->close();
+    }
+}
+
+// ============================================================================
+// Workers
+// ============================================================================
+
+void EnvPool::push(size_t worker, const Task& task) {
+    {
+        std::lock_guard<std::mutex> lock(workers_[worker]->mutex);
+        workers_[worker]->tasks.push_back(task);
+    }
+    queued_.fetch_add(1, std::memory_order_release);
+}
+
+bool EnvPool::pop_local(size_t index, Task& task) {
+    Worker& worker = *workers_[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) {
+        return false;
+    }
+    task = worker.tasks.front();
+    worker.tasks.pop_front();
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool EnvPool::steal(size_t index, Task& task) {
+    const size_t count = workers_.size();
+    for (size_t offset = 1; offset < count; ++offset) {
+        Worker& victim = *workers_[(index + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty()) {
+            continue;
+        }
+        // Take from the opposite end to the owner
+        task = victim.tasks.back();
+        victim.tasks.pop_back();
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        steals_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void EnvPool::worker_loop(size_t index) {
+    while (true) {
+        Task task;
+        if (pop_local(index, task) || steal(index, task)) {
+            run(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_cv_.wait(lock, [this] { return stop_ || queued_.load(std::memory_order_acquire) > 0; });
+        if (stop_ && queued_.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+
+void EnvPool::run(const Task& task) {
+    std::exception_ptr error;
+    try {
+        for (int64_t i = task.begin; i < task.end; ++i) {
+            float* obs = task.observations + i * state_dim_;
+            if (task.kind == TaskKind::kReset) {
+                if (task.mask != nullptr && !(*task.mask)[i]) {
+                    continue;
+                }
+                envs_[i]->reset_into(obs);
+                if (task.rewards != nullptr) {
+                    task.rewards[i] = 0.0f;
+                    task.dones[i] = 0.0f;
+                }
+            } else {
+                bool done = false;
+                envs_[i]->step_into(task.actions[i], obs, task.rewards[i], done);
+                task.dones[i] = done ? 1.0f : 0.0f;
+            }
+        }
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(done_mutex_);
+        if (error && !error_) {
+            error_ = error;
+        }
+        if (task.async) {
+            ready_.push_back(task.begin);
+        } else {
+            sync_remaining_--;
+        }
+    }
+    done_cv_.notify_all();
+}
+
+void EnvPool::rethrow_error() {
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(done_mutex_);
+        std::swap(error, error_);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+// ============================================================================
+// Synchronous mode
+// ============================================================================
+
+void EnvPool::run_sync(TaskKind kind, const int64_t* actions, const MaskView* mask,
+                       float* observations, float* rewards, float* dones) {
+    if (in_flight_count_ > 0) {
+        throw std::logic_error("EnvPool: synchronous call with asynchronous tasks in flight");
+    }
+
+    // Several chunks per worker so that stealing can rebalance uneven steps
+    const int64_t m = num_envs();
+    const int64_t chunk = std::max<int64_t>(1, m / (static_cast<int64_t>(workers_.size()) * 4));
+    const int64_t num_chunks = (m + chunk - 1) / chunk;
+
+    {
+        std::lock_guard<std::mutex> lock(done_mutex_);
+        sync_remaining_ = num_chunks;
+    }
+
+    for (int64_t c = 0; c < num_chunks; ++c) {
+        Task task;
+        task.kind = kind;
+        task.begin = c * chunk;
+        task.end = std::min(m, task.begin + chunk);
+        task.actions = actions;
+        task.mask = mask;
+        task.observations = observations;
+        task.rewards = rewards;
+        task.dones = dones;
+        push(static_cast<size_t>(c % static_cast<int64_t>(workers_.size())), task);
+    }
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+    }
+    wake_cv_.notify_all();
+
+    std::unique_lock<std::mutex> lock(done_mutex_);
+    done_cv_.wait(lock, [this] { return sync_remaining_ == 0; });
+    lock.unlock();
+    rethrow_error();
+}
+
+void EnvPool::step_batch(const torch::Tensor& actions, torch::Tensor& observations,
+                         torch::Tensor& rewards, torch::Tensor& dones) {
+    check_batch_buffers(*this, actions, observations, rewards, dones);
+    run_sync(TaskKind::kStep, actions.data_ptr<int64_t>(), nullptr, observations.data_ptr<float>(),
+             rewards.data_ptr<float>(), dones.data_ptr<float>());
+}
+
+void EnvPool::reset_where(const torch::Tensor& mask, torch::Tensor& observations) {
+    MaskView selected(mask, num_envs());
+    check_output(observations, {num_envs(), state_dim_}, "observations");
+    run_sync(TaskKind::kReset, nullptr, &selected, observations.data_ptr<float>(), nullptr, nullptr);
+}
+
+// ============================================================================
+// Asynchronous mode
+// ============================================================================
+
+void EnvPool::queue_async(const torch::Tensor& env_ids, const int64_t* actions, TaskKind kind) {
+    const int64_t k = env_ids.size(0);
+    const int64_t* ids = env_ids.data_ptr<int64_t>();
+
+    // Mark while validating so a duplicate id in the same call is rejected too
+    for (int64_t j = 0; j < k; ++j) {
+        if (ids[j] < 0 || ids[j] >= num_envs() || busy_[ids[j]]) {
+            for (int64_t m = 0; m < j; ++m) {
+                busy_[ids[m]] = 0;
+            }
+            throw std::invalid_argument("EnvPool: environment " + std::to_string(ids[j]) +
+                                        " is out of range, repeated or already in flight");
+        }
+        busy_[ids[j]] = 1;
+    }
+
+    for (int64_t j = 0; j < k; ++j) {
+        const int64_t i = ids[j];
+        if (actions != nullptr) {
+            action_slots_[i] = actions[j];
+        }
+
+        Task task;
+        task.kind = kind;
+        task.async = true;
+        task.begin = i;
+        task.end = i + 1;
+        task.actions = action_slots_.data();
+        task.observations = observation_slots_.data();
+        task.rewards = reward_slots_.data();
+        task.dones = done_slots_.data();
+        push(static_cast<size_t>(i % static_cast<int64_t>(workers_.size())), task);
+    }
+    in_flight_count_ += k;
+
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+    }
+    wake_cv_.notify_all();
+}
+
+void EnvPool::send(const torch::Tensor& env_ids, const torch::Tensor& actions) {
+    check_ids(env_ids, -1, "env_ids");
+    check_ids(actions, env_ids.size(0), "actions");
+    queue_async(env_ids, actions.data_ptr<int64_t>(), TaskKind::kStep);
+}
+
+void EnvPool::async_reset(const torch::Tensor& env_ids) {
+    check_ids(env_ids, -1, "env_ids");
+    queue_async(env_ids, nullptr, TaskKind::kReset);
+}
+
+int64_t EnvPool::recv(int64_t k, torch::Tensor& env_ids, torch::Tensor& observations,
+                      torch::Tensor& rewards, torch::Tensor& dones) {
+    if (k <= 0 || k > in_flight_count_) {
+        throw std::invalid_argument("EnvPool: recv(k) needs 0 < k <= in_flight()");
+    }
+    check_ids(env_ids, k, "env_ids");
+    check_output(observations, {k, state_dim_}, "observations");
+    check_output(rewards, {k}, "rewards");
+    check_output(dones, {k}, "dones");
+
+    int64_t* id_out = env_ids.data_ptr<int64_t>();
+    float* obs_out = observations.data_ptr<float>();
+    float* reward_out = rewards.data_ptr<float>();
+    float* done_out = dones.data_ptr<float>();
+
+    {
+        std::unique_lock<std::mutex> lock(done_mutex_);
+        done_cv_.wait(lock, [this, k] { return static_cast<int64_t>(ready_.size()) >= k; });
+        for (int64_t j = 0; j < k; ++j) {
+            id_out[j] = ready_.front();
+            ready_.pop_front();
+        }
+    }
+
+    // The worker published the slots before queuing the id (done_mutex_)
+    for (int64_t j = 0; j < k; ++j) {
+        const int64_t i = id_out[j];
+        std::memcpy(obs_out + j * state_dim_, observation_slots_.data() + i * state_dim_,
+                    sizeof(float) * state_dim_);
+        reward_out[j] = reward_slots_[i];
+        done_out[j] = done_slots_[i];
+        busy_[i] = 0;
+    }
+    in_flight_count_ -= k;
+
+    rethrow_error();
+    return k;
+}
+
+} // namespace environment
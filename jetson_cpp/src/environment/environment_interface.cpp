@@ -1,10 +1,69 @@
 #include "environment/environment_interface.h"
-
-// This file is intentionally minimal as EnvironmentInterface is purely abstract.
-// Concrete implementations are in derived classes (e.g., LegoRobotEnv).
+#include <cstring>
+#include <stdexcept>
 
 namespace environment {
 
-// No implementation needed for abstract interface
+std::string StepInfo::to_string() const {
+    std::string text = "step=" + std::to_string(step);
+    if (truncated) {
+        text += ", truncated";
+    }
+    if (collision) {
+        text += ", collision";
+    }
+    if (reply_lost) {
+        text += ", reply lost";
+    } else if (rtt_ms > 0.0) {
+        text += ", rtt=" + std::to_string(rtt_ms) + " ms";
+    }
+    return text;
+}
+
+void EnvironmentInterface::reset_into(float* state) {
+    torch::Tensor initial = reset().to(torch::kCPU, torch::kFloat32).contiguous();
+    std::memcpy(state, initial.data_ptr<float>(), sizeof(float) * state_dim());
+}
+
+void EnvironmentInterface::step_into(int64_t action, float* next_state, float& reward, bool& done,
+                                     StepInfo* info) {
+    StepResult result = step(action);
+    torch::Tensor state = result.next_state.to(torch::kCPU, torch::kFloat32).contiguous();
+    std::memcpy(next_state, state.data_ptr<float>(), sizeof(float) * state_dim());
+    reward = result.reward;
+    done = result.done;
+    if (info != nullptr) {
+        *info = StepInfo();
+    }
+}
+
+void EnvironmentInterface::step_async(int64_t action) {
+    begin_step(action);
+}
+
+bool EnvironmentInterface::step_poll(int /*timeout_ms*/) {
+    return step_pending_;
+}
+
+void EnvironmentInterface::step_wait(float* next_state, float& reward, bool& done, StepInfo* info) {
+    const int64_t action = end_step();
+    step_into(action, next_state, reward, done, info);
+}
+
+void EnvironmentInterface::begin_step(int64_t action) {
+    if (step_pending_) {
+        throw std::logic_error("step_async: a step is already pending");
+    }
+    step_pending_ = true;
+    pending_action_ = action;
+}
+
+int64_t EnvironmentInterface::end_step() {
+    if (!step_pending_) {
+        throw std::logic_error("step_wait: no step is pending");
+    }
+    step_pending_ = false;
+    return pending_action_;
+}
 
 } // namespace environment
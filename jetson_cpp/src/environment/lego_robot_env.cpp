@@ -1,4 +1,5 @@
 #include "environment/lego_robot_env.h"
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 #include <stdexcept>
@@ -8,10 +9,13 @@ namespace environment {
 LegoRobotEnv::LegoRobotEnv(const std::string& robot_address,
                            int max_steps_per_episode,
                            int episode_timeout_sec,
-                           const RewardParams& reward_params)
+                           const RewardParams& reward_params,
+                           utils::Clock& clock)
     : max_steps_per_episode_(max_steps_per_episode),
       episode_timeout_sec_(episode_timeout_sec),
       reward_params_(reward_params),
+      reward_fn_(reward_params),
+      clock_(&clock),
       current_step_(0) {
 
     std::cout << "[LegoRobotEnv] Initializing environment..." << std::endl;
@@ -35,28 +39,52 @@ LegoRobotEnv::~LegoRobotEnv() {
 }
 
 torch::Tensor LegoRobotEnv::reset() {
+    torch::Tensor initial_state = torch::empty({4}, torch::kFloat32);
+    reset_into(initial_state.data_ptr<float>());
+
+    std::cout << "[LegoRobotEnv] Initial state: " << initial_state << std::endl;
+
+    return initial_state;
+}
+
+void LegoRobotEnv::reset_into(float* state) {
     std::cout << "[LegoRobotEnv] Resetting environment (Episode start)" << std::endl;
 
     // Reset episode tracking
     current_step_ = 0;
-    episode_start_time_ = std::chrono::steady_clock::now();
+    episode_start_time_ = clock_->now();
 
     // Stop robot (send backward command briefly to ensure it's stopped)
     bt_manager_->send_command(communication::ACTION_BACKWARD, 10);
 
     // Wait a moment for robot to stop
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    clock_->sleep_for(std::chrono::milliseconds(100));
 
     // Get initial state
-    torch::Tensor initial_state = get_current_state();
-    previous_state_ = initial_state.clone();
+    read_state(state);
+    std::copy(state, state + 4, previous_state_.begin());
+}
 
-    std::cout << "[LegoRobotEnv] Initial state: " << initial_state << std::endl;
+StepResult LegoRobotEnv::step(int64_t action) {
+    StepInfo info;
+    StepResult result;
+    result.next_state = torch::empty({4}, torch::kFloat32);
+    step_into(action, result.next_state.data_ptr<float>(), result.reward, result.done, &info);
 
-    return initial_state;
+    result.info = "step=" + std::to_string(info.step) +
+                  ", action=" + communication::action_code_to_name(static_cast<uint8_t>(action)) +
+                  ", collision=" + (info.collision ? "true" : "false");
+    return result;
 }
 
-StepResult LegoRobotEnv::step(int64_t action) {
+void LegoRobotEnv::step_into(int64_t action, float* next_state, float& reward, bool& done,
+                             StepInfo* info) {
+    step_async(action);
+    step_wait(next_state, reward, done, info);
+}
+
+void LegoRobotEnv::step_async(int64_t action) {
+    begin_step(action);
     current_step_++;
 
     // Send action command to robot
@@ -64,46 +92,59 @@ StepResult LegoRobotEnv::step(int64_t action) {
     bool command_sent = bt_manager_->send_command(action_code, communication::DEFAULT_ACTION_DURATION_MS);
 
     if (!command_sent) {
+        end_step();
         throw std::runtime_error("Failed to send command to robot");
     }
 
+    // The sensors are read once the action has executed
+    action_done_time_ = clock_->now() +
+                        std::chrono::milliseconds(communication::DEFAULT_ACTION_DURATION_MS + 50);
+}
+
+bool LegoRobotEnv::step_poll(int timeout_ms) {
+    if (!step_pending()) {
+        return false;
+    }
+    auto now = clock_->now();
+    if (now >= action_done_time_) {
+        return true;
+    }
+    clock_->sleep_for(std::min<utils::Clock::duration>(action_done_time_ - now,
+                                                       std::chrono::milliseconds(timeout_ms)));
+    return clock_->now() >= action_done_time_;
+}
+
+void LegoRobotEnv::step_wait(float* next_state, float& reward, bool& done, StepInfo* info) {
+    const int64_t action = end_step();
+
     // Wait for action to execute
-    std::this_thread::sleep_for(std::chrono::milliseconds(communication::DEFAULT_ACTION_DURATION_MS + 50));
+    clock_->sleep_until(action_done_time_);
 
     // Read new state from sensors
-    torch::Tensor next_state;
     try {
-        next_state = get_current_state();
+        read_state(next_state);
     } catch (const std::exception& e) {
         std::cerr << "[LegoRobotEnv] Error reading sensors: " << e.what() << std::endl;
         throw;
     }
 
     // Check for collision
-    bool collision = (next_state[2].item<int>() == 1) || (next_state[3].item<int>() == 1);
+    bool collision = (next_state[2] == 1.0f) || (next_state[3] == 1.0f);
 
     // Compute reward
-    float reward = compute_reward(next_state, action, collision);
+    reward = compute_reward(next_state, action, collision);
 
     // Check if episode is done
-    bool done = is_episode_done(next_state, current_step_);
+    done = is_episode_done(next_state, current_step_);
 
-    // Create info string
-    std::string info = "step=" + std::to_string(current_step_) +
-                      ", action=" + communication::action_code_to_name(action_code) +
-                      ", collision=" + (collision ? "true" : "false");
+    if (info != nullptr) {
+        info->step = current_step_;
+        info->collision = collision;
+        info->truncated = done && !collision;
+    }
 
     // Update previous state
-    previous_state_ = next_state.clone();
-
-    // Create and return result
-    StepResult result;
-    result.next_state = next_state;
-    result.reward = reward;
-    result.done = done;
-    result.info = info;
-
-    return result;
+    std::copy(next_state, next_state + 4, previous_state_.begin());
 }
 
 void LegoRobotEnv::close() {
@@ -119,13 +160,11 @@ void LegoRobotEnv::close() {
     }
 }
 
-torch::Tensor LegoRobotEnv::get_current_state() {
+void LegoRobotEnv::read_state(float* state) {
     // Read sensor data from robot
     communication::SensorData sensor_data = bt_manager_->read_sensors();
 
-    // Create state tensor: [orientation_x, orientation_y, contact_front, contact_side]
-    torch::Tensor state = torch::zeros({4}, torch::kFloat32);
-
+    // State: [orientation_x, orientation_y, contact_front, contact_side]
     // Gyroscope readings (already normalized to -1.0 to 1.0)
     state[0] = sensor_data.gyro_x;
     state[1] = sensor_data.gyro_y;
@@ -133,55 +172,22 @@ torch::Tensor LegoRobotEnv::get_current_state() {
     // Contact sensors (binary: 0 or 1)
     state[2] = static_cast<float>(sensor_data.contact_front);
     state[3] = static_cast<float>(sensor_data.contact_side);
-
-    return state;
 }
 
-float LegoRobotEnv::compute_reward(const torch::Tensor& state, int64_t action, bool collision) {
-    float reward = 0.0f;
-
-    // Collision penalty (highest priority)
-    if (collision) {
-        reward += reward_params_.collision_penalty;
-        return reward;  // Return immediately - collision is terminal
-    }
-
-    // Action-specific rewards
-    switch (action) {
-        case communication::ACTION_FORWARD:
-            // Reward for successful forward movement (no collision)
-            reward += reward_params_.forward_success;
-            break;
-
-        case communication::ACTION_BACKWARD:
-            // Penalty for backward movement (discourage retreat)
-            reward += reward_params_.backward_penalty;
-            break;
-
-        case communication::ACTION_LEFT:
-        case communication::ACTION_RIGHT:
-            // Neutral or small reward for turning
-            reward += reward_params_.turn_reward;
-            break;
-    }
-
-    // Orientation stability bonus
-    // Reward stable orientation (low gyroscope values)
-    float orientation_magnitude = std::sqrt(
-        state[0].item<float>() * state[0].item<float>() +
-        state[1].item<float>() * state[1].item<float>()
-    );
-
-    if (orientation_magnitude < 0.3f) {
-        reward += reward_params_.orientation_bonus;
-    }
+float LegoRobotEnv::compute_reward(const float* state, int64_t action, bool collision) {
+    SensorRecord record;
+    record.gyro_angle = state[0];
+    record.gyro_rate = state[1];
+    record.touch_front = collision ? 1.0f : 0.0f;
+    record.valid = 1.0f;
 
-    return reward;
+    bool terminal = false;
+    return reward_fn_.compute_one(record, action, terminal);
 }
 
-bool LegoRobotEnv::is_episode_done(const torch::Tensor& state, int step_count) {
+bool LegoRobotEnv::is_episode_done(const float* state, int step_count) {
     // Collision detected
-    if (state[2].item<int>() == 1 || state[3].item<int>() == 1) {
+    if (state[2] == 1.0f || state[3] == 1.0f) {
         std::cout << "[LegoRobotEnv] Episode ended: Collision detected" << std::endl;
         return true;
     }
@@ -193,7 +199,7 @@ bool LegoRobotEnv::is_episode_done(const torch::Tensor& state, int step_count) {
     }
 
     // Timeout
-    auto now = std::chrono::steady_clock::now();
+    auto now = clock_->now();
     auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - episode_start_time_).count();
     if (elapsed >= episode_timeout_sec_) {
         std::cout << "[LegoRobotEnv] Episode ended: Timeout" << std::endl;
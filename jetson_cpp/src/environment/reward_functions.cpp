@@ -0,0 +1,123 @@
+#include "environment/reward_functions.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace environment {
+
+void SensorBatch::reserve(size_t n) {
+    gyro_angle_.reserve(n);
+    gyro_rate_.reserve(n);
+    touch_front_.reserve(n);
+    touch_side_.reserve(n);
+    valid_.reserve(n);
+    truncated_.reserve(n);
+    actions_.reserve(n);
+}
+
+void SensorBatch::clear() {
+    gyro_angle_.clear();
+    gyro_rate_.clear();
+    touch_front_.clear();
+    touch_side_.clear();
+    valid_.clear();
+    truncated_.clear();
+    actions_.clear();
+}
+
+void SensorBatch::push_back(const SensorRecord& record, int64_t action) {
+    gyro_angle_.push_back(record.gyro_angle);
+    gyro_rate_.push_back(record.gyro_rate);
+    touch_front_.push_back(record.touch_front);
+    touch_side_.push_back(record.touch_side);
+    valid_.push_back(record.valid);
+    truncated_.push_back(record.truncated);
+    actions_.push_back(static_cast<int32_t>(action));
+}
+
+SensorBatchView SensorBatch::view() const {
+    SensorBatchView v;
+    v.gyro_angle = gyro_angle_.data();
+    v.gyro_rate = gyro_rate_.data();
+    v.touch_front = touch_front_.data();
+    v.touch_side = touch_side_.data();
+    v.valid = valid_.data();
+    v.truncated = truncated_.data();
+    v.actions = actions_.data();
+    v.size = actions_.size();
+    return v;
+}
+
+float RewardFunction::compute_one(const SensorRecord& record, int64_t action, bool& done) const {
+    int32_t action32 = static_cast<int32_t>(action);
+
+    SensorBatchView v;
+    v.gyro_angle = &record.gyro_angle;
+    v.gyro_rate = &record.gyro_rate;
+    v.touch_front = &record.touch_front;
+    v.touch_side = &record.touch_side;
+    v.valid = &record.valid;
+    v.truncated = &record.truncated;
+    v.actions = &action32;
+    v.size = 1;
+
+    float reward = 0.0f;
+    float done_flag = 0.0f;
+    compute(v, &reward, &done_flag);
+    done = done_flag > 0.5f;
+    return reward;
+}
+
+// Both kernels are branch-free per element (selects only) so that -O2/-O3
+// vectorizes them over the SoA channels.
+
+void UDPRobotReward::compute(const SensorBatchView& batch, float* rewards, float* dones) const {
+    const UDPRewardParams p = params_;
+
+    for (size_t i = 0; i < batch.size; ++i) {
+        const float magnitude = std::fabs(batch.gyro_angle[i]);
+        const bool collision = (batch.touch_front[i] + batch.touch_side[i]) > 0.5f;
+        const bool valid = batch.valid[i] > 0.5f;
+        const int32_t action = batch.actions[i];
+
+        float r = (magnitude < p.stable_angle_deg ? p.stable_bonus : 0.0f) +
+                  (magnitude > p.tilt_angle_deg ? p.tilt_penalty : 0.0f) +
+                  (action == 1 ? p.forward_bonus : 0.0f) +
+                  (action == 0 ? p.stop_penalty : 0.0f);
+        r = collision ? p.collision_penalty : r;
+        rewards[i] = valid ? r : p.invalid_penalty;
+
+        const bool terminal = valid && (collision || magnitude > p.fall_angle_deg);
+        dones[i] = (terminal || batch.truncated[i] > 0.5f) ? 1.0f : 0.0f;
+    }
+}
+
+void LegoRobotReward::compute(const SensorBatchView& batch, float* rewards, float* dones) const {
+    const RewardParams p = params_;
+    const float stable_sq = p.stable_orientation * p.stable_orientation;
+
+    for (size_t i = 0; i < batch.size; ++i) {
+        const float x = batch.gyro_angle[i];
+        const float y = batch.gyro_rate[i];
+        const bool collision = (batch.touch_front[i] + batch.touch_side[i]) > 0.5f;
+        const int32_t action = batch.actions[i];
+
+        float r = (action == 0 ? p.forward_success : 0.0f) +
+                  (action == 1 ? p.backward_penalty : 0.0f) +
+                  ((action == 2 || action == 3) ? p.turn_reward : 0.0f) +
+                  (x * x + y * y < stable_sq ? p.orientation_bonus : 0.0f);
+        rewards[i] = collision ? p.collision_penalty : r;
+        dones[i] = (collision || batch.truncated[i] > 0.5f) ? 1.0f : 0.0f;
+    }
+}
+
+std::unique_ptr<RewardFunction> make_reward_function(const std::string& name) {
+    if (name == "udp") {
+        return std::make_unique<UDPRobotReward>();
+    }
+    if (name == "lego") {
+        return std::make_unique<LegoRobotReward>();
+    }
+    throw std::invalid_argument("Unknown reward function: " + name);
+}
+
+} // namespace environment
@@ -0,0 +1,173 @@
+#include "environment/sim_ev3_env.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace environment {
+
+namespace {
+
+constexpr float kPi = 3.14159265358979f;
+constexpr float kRadToDeg = 180.0f / kPi;
+constexpr float kDegToRad = kPi / 180.0f;
+
+// Actions shared with UDPEnvironment
+constexpr int64_t kForward = 1;
+constexpr int64_t kLeft = 2;
+constexpr int64_t kRight = 3;
+constexpr int64_t kBackward = 4;
+
+// Layouts tried before giving up on an arena the robot cannot fit in
+constexpr int kMaxLayoutAttempts = 1000;
+
+} // namespace
+
+SimEV3Env::SimEV3Env(const SimEV3Params& params, uint64_t seed, const UDPRewardParams& reward_params)
+    : params_(params), reward_fn_(reward_params), rng_(static_cast<std::mt19937::result_type>(seed)),
+      arena_(params.arena) {
+    params_.substeps = std::max(1, params_.substeps);
+}
+
+torch::Tensor SimEV3Env::reset() {
+    torch::Tensor state = torch::empty({4}, torch::kFloat32);
+    reset_into(state.data_ptr<float>());
+    return state;
+}
+
+void SimEV3Env::reset_into(float* state) {
+    generate_layout();
+    start_heading_ = heading_;
+    gyro_bias_ = 0.0f;
+    gyro_drift_ = 0.0f;
+    step_count_ = 0;
+
+    communication::SensorData sensors = read_sensors(0.0f);
+    last_record_ = make_sensor_record(sensors, false);
+    if (sensors.valid) {
+        sensors.toState(state);
+    } else {
+        std::fill(state, state + 4, 0.0f);
+    }
+}
+
+StepResult SimEV3Env::step(int64_t action) {
+    StepResult result;
+    result.next_state = torch::empty({4}, torch::kFloat32);
+    step_into(action, result.next_state.data_ptr<float>(), result.reward, result.done);
+    result.info = "sim_step=" + std::to_string(step_count_);
+    return result;
+}
+
+void SimEV3Env::step_into(int64_t action, float* next_state, float& reward, bool& done,
+                          StepInfo* info) {
+    step_count_++;
+    simulated_seconds_ += params_.step_period;
+
+    // Bias random walk, integrated by the gyro over the whole step
+    gyro_bias_ += params_.gyro_bias_walk_deg * normal_(rng_);
+    gyro_drift_ += gyro_bias_ * params_.step_period;
+
+    move(action);
+
+    // Clockwise positive: LEFT (counter-clockwise) reads negative
+    float rate_deg = 0.0f;
+    if (action == kLeft) {
+        rate_deg = -params_.turn_rate_deg;
+    } else if (action == kRight) {
+        rate_deg = params_.turn_rate_deg;
+    }
+    communication::SensorData sensors = read_sensors(rate_deg);
+
+    // Same reward and termination as the real robot
+    const bool truncated = step_count_ >= params_.max_steps;
+    last_record_ = make_sensor_record(sensors, truncated);
+    done = false;
+    reward = reward_fn_.compute_one(last_record_, action, done);
+
+    if (sensors.valid) {
+        sensors.toState(next_state);
+    } else {
+        std::fill(next_state, next_state + 4, 0.0f);
+    }
+
+    if (info != nullptr) {
+        info->step = step_count_;
+        info->truncated = truncated;
+        info->collision = sensors.valid && (sensors.touch_front == 1 || sensors.touch_side == 1);
+        info->reply_lost = !sensors.valid;   // Simulated dropout, as a lost bridge reply
+        info->rtt_ms = 0.0;
+    }
+}
+
+void SimEV3Env::generate_layout() {
+    // New layouts until the start pose is clear (quick for sane parameters)
+    const float clearance = 1.5f * params_.robot_radius;
+    int attempts = 0;
+    do {
+        if (++attempts > kMaxLayoutAttempts) {
+            throw std::runtime_error("SimEV3Env: no free start position after " +
+                                     std::to_string(kMaxLayoutAttempts) +
+                                     " layouts; arena too crowded for the robot radius");
+        }
+        arena_.generate(rng_);
+    } while (!arena_.sample_free_position(rng_, clearance, x_, y_));
+    heading_ = 2.0f * kPi * uniform_(rng_);
+}
+
+void SimEV3Env::move(int64_t action) {
+    const SimEV3Params& p = params_;
+    float speed = 0.0f;
+    float turn = 0.0f;
+    switch (action) {
+        case kForward:  speed = p.linear_speed; break;
+        case kBackward: speed = -p.linear_speed; break;
+        case kLeft:     turn = p.turn_rate_deg * kDegToRad; break;
+        case kRight:    turn = -p.turn_rate_deg * kDegToRad; break;
+        default:        break;  // STOP
+    }
+
+    const float dt = p.action_duration / static_cast<float>(p.substeps);
+    for (int s = 0; s < p.substeps; ++s) {
+        heading_ += turn * dt;
+        if (speed == 0.0f) {
+            continue;
+        }
+        const float nx = x_ + speed * std::cos(heading_) * dt;
+        const float ny = y_ + speed * std::sin(heading_) * dt;
+        if (arena_.circle_hits(nx, ny, p.robot_radius)) {
+            return;
+        }
+        x_ = nx;
+        y_ = ny;
+    }
+}
+
+communication::SensorData SimEV3Env::read_sensors(float rate_deg) {
+    communication::SensorData data;
+    if (params_.dropout_prob > 0.0f && uniform_(rng_) < params_.dropout_prob) {
+        return data;  // Lost reading (valid = false)
+    }
+
+    // Heading change since reset, clockwise positive, plus bias drift and noise
+    float angle = -(heading_ - start_heading_) * kRadToDeg + gyro_drift_ +
+                  params_.gyro_angle_noise_deg * normal_(rng_);
+    float rate = rate_deg + gyro_bias_ + params_.gyro_rate_noise_deg * normal_(rng_);
+    if (params_.gyro_quantize) {
+        angle = std::round(angle);
+        rate = std::round(rate);
+    }
+
+    bool touch_front = false;
+    bool touch_side = false;
+    arena_.bumper_contacts(x_, y_, heading_, params_.bumpers, touch_front, touch_side);
+
+    data.gyro_angle = angle;
+    data.gyro_rate = rate;
+    data.touch_front = touch_front ? 1 : 0;
+    data.touch_side = touch_side ? 1 : 0;
+    data.valid = true;
+    return data;
+}
+
+} // namespace environment
@@ -0,0 +1,140 @@
+#include "environment/vector_cartpole_env.h"
+#include <stdexcept>
+
+namespace environment {
+
+namespace {
+
+// Validated before any member is sized from it
+int64_t checked_num_envs(int64_t num_envs) {
+    if (num_envs <= 0) {
+        throw std::invalid_argument("VectorCartPoleEnv: num_envs must be positive");
+    }
+    return num_envs;
+}
+
+} // namespace
+
+VectorCartPoleEnv::VectorCartPoleEnv(int64_t num_envs, int max_steps, uint64_t seed)
+    : num_envs_(checked_num_envs(num_envs)),
+      max_steps_(max_steps),
+      rng_(static_cast<std::mt19937::result_type>(seed)),
+      reset_dist_(-0.05f, 0.05f),
+      x_(num_envs), x_dot_(num_envs), theta_(num_envs), theta_dot_(num_envs),
+      force_(num_envs), terminal_(num_envs), step_count_(num_envs, 0),
+      observations_(torch::zeros({num_envs, 4}, torch::kFloat32)),
+      final_observations_(torch::zeros({num_envs, 4}, torch::kFloat32)),
+      rewards_(torch::zeros({num_envs}, torch::kFloat32)),
+      dones_(torch::zeros({num_envs}, torch::kFloat32)) {
+    reset();
+}
+
+void VectorCartPoleEnv::reset_env(int64_t i) {
+    x_[i] = reset_dist_(rng_);
+    x_dot_[i] = reset_dist_(rng_);
+    theta_[i] = reset_dist_(rng_);
+    theta_dot_[i] = reset_dist_(rng_);
+    step_count_[i] = 0;
+}
+
+const torch::Tensor& VectorCartPoleEnv::reset() {
+    float* obs = observations_.data_ptr<float>();
+    for (int64_t i = 0; i < num_envs_; ++i) {
+        reset_env(i);
+        obs[4 * i + 0] = x_[i];
+        obs[4 * i + 1] = x_dot_[i];
+        obs[4 * i + 2] = theta_[i];
+        obs[4 * i + 3] = theta_dot_[i];
+    }
+    rewards_.zero_();
+    dones_.zero_();
+    return observations_;
+}
+
+void VectorCartPoleEnv::step(const torch::Tensor& actions) {
+    if (actions.numel() != num_envs_ || !actions.device().is_cpu()) {
+        throw std::invalid_argument("VectorCartPoleEnv: expected [num_envs] CPU actions");
+    }
+    torch::Tensor contiguous = actions.to(torch::kInt64).contiguous();
+    step(contiguous.data_ptr<int64_t>());
+}
+
+void VectorCartPoleEnv::step(const int64_t* actions) {
+    advance(actions, observations_.data_ptr<float>(), final_observations_.data_ptr<float>(),
+            rewards_.data_ptr<float>(), dones_.data_ptr<float>(), true);
+}
+
+void VectorCartPoleEnv::step_batch(const torch::Tensor& actions, torch::Tensor& observations,
+                                   torch::Tensor& rewards, torch::Tensor& dones) {
+    check_batch_buffers(*this, actions, observations, rewards, dones);
+    advance(actions.data_ptr<int64_t>(), observations.data_ptr<float>(), nullptr,
+            rewards.data_ptr<float>(), dones.data_ptr<float>(), false);
+}
+
+void VectorCartPoleEnv::reset_where(const torch::Tensor& mask, torch::Tensor& observations) {
+    MaskView selected(mask, num_envs());
+    if (observations.scalar_type() != torch::kFloat32 || !observations.is_contiguous() ||
+        observations.size(0) != num_envs_ || observations.size(1) != 4) {
+        throw std::invalid_argument("VectorCartPoleEnv: expected [num_envs, 4] float observations");
+    }
+
+    float* obs = observations.data_ptr<float>();
+    for (int64_t i = 0; i < num_envs_; ++i) {
+        if (selected[i]) {
+            reset_env(i);
+            obs[4 * i + 0] = x_[i];
+            obs[4 * i + 1] = x_dot_[i];
+            obs[4 * i + 2] = theta_[i];
+            obs[4 * i + 3] = theta_dot_[i];
+        }
+    }
+}
+
+void VectorCartPoleEnv::advance(const int64_t* actions, float* obs, float* final_obs,
+                                float* rewards, float* dones, bool auto_reset) {
+    for (int64_t i = 0; i < num_envs_; ++i) {
+        force_[i] = (actions[i] == 1) ? CartPoleConstants::kForceMag : -CartPoleConstants::kForceMag;
+    }
+
+    CartPoleSoA state;
+    state.x = x_.data();
+    state.x_dot = x_dot_.data();
+    state.theta = theta_.data();
+    state.theta_dot = theta_dot_.data();
+    state.size = num_envs_;
+    cartpole_step_kernel(state, force_.data(), terminal_.data());
+
+    for (int64_t i = 0; i < num_envs_; ++i) {
+        const int32_t steps = ++step_count_[i];
+        const bool done = terminal_[i] != 0.0f || steps >= max_steps_;
+        rewards[i] = done ? 0.0f : 1.0f;
+        dones[i] = done ? 1.0f : 0.0f;
+
+        if (done) {
+            completed_episodes_++;
+            completed_episode_steps_ += static_cast<uint64_t>(steps);
+            if (auto_reset) {
+                final_obs[4 * i + 0] = x_[i];
+                final_obs[4 * i + 1] = x_dot_[i];
+                final_obs[4 * i + 2] = theta_[i];
+                final_obs[4 * i + 3] = theta_dot_[i];
+                reset_env(i);
+            }
+        }
+
+        obs[4 * i + 0] = x_[i];
+        obs[4 * i + 1] = x_dot_[i];
+        obs[4 * i + 2] = theta_[i];
+        obs[4 * i + 3] = theta_dot_[i];
+    }
+
+    total_steps_ += static_cast<uint64_t>(num_envs_);
+}
+
+double VectorCartPoleEnv::mean_episode_length() const {
+    return completed_episodes_ > 0
+        ? static_cast<double>(completed_episode_steps_) / static_cast<double>(completed_episodes_)
+        : 0.0;
+}
+
+} // namespace environment
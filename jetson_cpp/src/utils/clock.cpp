@@ -0,0 +1,51 @@
+#include "utils/clock.h"
+#include <stdexcept>
+#include <thread>
+
+namespace utils {
+
+void Clock::sleep_until(time_point t) {
+    const time_point current = now();
+    if (t > current) {
+        sleep_for(t - current);
+    }
+}
+
+double Clock::seconds_since(time_point t) const {
+    return std::chrono::duration<double>(now() - t).count();
+}
+
+void RealClock::sleep_for(duration d) {
+    if (d > duration::zero()) {
+        std::this_thread::sleep_for(d);
+    }
+}
+
+VirtualClock::VirtualClock() : origin_(std::chrono::steady_clock::now()) {}
+
+Clock::time_point VirtualClock::now() const {
+    return origin_ + duration(offset_.load(std::memory_order_relaxed));
+}
+
+void VirtualClock::advance(duration d) {
+    if (d > duration::zero()) {
+        offset_.fetch_add(d.count(), std::memory_order_relaxed);
+    }
+}
+
+Clock& real_clock() {
+    static RealClock clock;
+    return clock;
+}
+
+std::unique_ptr<Clock> make_clock(const std::string& name) {
+    if (name == "real") {
+        return std::make_unique<RealClock>();
+    }
+    if (name == "virtual") {
+        return std::make_unique<VirtualClock>();
+    }
+    throw std::invalid_argument("Unknown clock: " + name + " (expected real or virtual)");
+}
+
+} // namespace utils
@@ -0,0 +1,159 @@
+/**
+ * @file test_arena.cpp
+ * @brief Grid-indexed collision queries against a single-cell arena that
+ *        tests every obstacle (brute force), on random layouts and queries
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "environment/arena.h"
+#include "test_util.h"
+
+using environment::Arena;
+using environment::ArenaObstacle;
+using environment::ArenaParams;
+using environment::BumperGeometry;
+using environment::ObstacleShape;
+using environment::PoseBatchView;
+
+namespace {
+
+// One cell covering the whole arena: every query visits every obstacle
+Arena make_brute_force(const ArenaParams& params) {
+    ArenaParams brute = params;
+    brute.cell_size = 100.0f;
+    return Arena(brute);
+}
+
+void test_grid_shape() {
+    ArenaParams params;
+    params.width = 2.0f;
+    params.height = 1.1f;
+    params.cell_size = 0.25f;
+    Arena arena(params);
+    CHECK(arena.grid_cols() == 8);
+    CHECK(arena.grid_rows() == 5);
+
+    Arena brute = make_brute_force(params);
+    CHECK(brute.grid_cols() == 1 && brute.grid_rows() == 1);
+}
+
+void test_fixed_layout() {
+    ArenaParams params;
+    Arena arena(params);
+
+    ArenaObstacle disc;
+    disc.shape = ObstacleShape::kDisc;
+    disc.x = 0.5f;
+    disc.y = 0.5f;
+    disc.radius = 0.1f;
+    ArenaObstacle box;
+    box.shape = ObstacleShape::kBox;
+    box.x = 1.5f;
+    box.y = 1.0f;
+    box.half_width = 0.2f;
+    box.half_height = 0.05f;
+    arena.set_obstacles({disc, box});
+
+    CHECK(arena.circle_hits(0.5f, 0.65f, 0.06f));     // Overlaps the disc
+    CHECK(!arena.circle_hits(0.5f, 0.75f, 0.1f));     // Clear of it
+    CHECK(arena.segment_hits(1.0f, 1.0f, 1.4f, 1.0f));   // Ends inside the box
+    CHECK(!arena.segment_hits(1.0f, 1.2f, 1.9f, 1.2f));  // Passes above it
+    CHECK(arena.circle_hits(0.02f, 1.0f, 0.05f));     // Wall
+    CHECK(arena.segment_hits(1.0f, 1.0f, 2.1f, 1.0f));   // Leaves the arena
+}
+
+void compare_layout(const ArenaParams& params, std::mt19937& rng, int& mismatches,
+                    int& hits) {
+    Arena grid(params);
+    grid.generate(rng);
+    Arena brute = make_brute_force(params);
+    brute.set_obstacles(grid.obstacles());
+
+    std::uniform_real_distribution<float> px(-0.1f, params.width + 0.1f);
+    std::uniform_real_distribution<float> py(-0.1f, params.height + 0.1f);
+    std::uniform_real_distribution<float> step(-0.4f, 0.4f);
+    std::uniform_real_distribution<float> radius(0.0f, 0.3f);
+    std::uniform_real_distribution<float> angle(-3.14159265f, 3.14159265f);
+
+    constexpr size_t kQueries = 500;
+    std::vector<float> x0(kQueries), y0(kQueries), x1(kQueries), y1(kQueries);
+    for (size_t i = 0; i < kQueries; ++i) {
+        x0[i] = px(rng);
+        y0[i] = py(rng);
+        x1[i] = x0[i] + step(rng);
+        y1[i] = y0[i] + step(rng);
+
+        const bool expected = brute.segment_hits(x0[i], y0[i], x1[i], y1[i]);
+        mismatches += (grid.segment_hits(x0[i], y0[i], x1[i], y1[i]) != expected) ? 1 : 0;
+        hits += expected ? 1 : 0;
+
+        const float r = radius(rng);
+        mismatches += (grid.circle_hits(x0[i], y0[i], r) != brute.circle_hits(x0[i], y0[i], r))
+                          ? 1 : 0;
+    }
+
+    // Batched segments agree with the single queries
+    std::vector<uint8_t> batch(kQueries);
+    grid.segments_hit(x0.data(), y0.data(), x1.data(), y1.data(), kQueries, batch.data());
+    for (size_t i = 0; i < kQueries; ++i) {
+        mismatches += (batch[i] != (brute.segment_hits(x0[i], y0[i], x1[i], y1[i]) ? 1 : 0))
+                          ? 1 : 0;
+    }
+
+    // Batched bumpers agree with the brute-force single-pose bumpers
+    std::vector<float> heading(kQueries);
+    for (float& h : heading) {
+        h = angle(rng);
+    }
+    BumperGeometry bumpers;
+    PoseBatchView poses;
+    poses.x = x0.data();
+    poses.y = y0.data();
+    poses.heading = heading.data();
+    poses.size = kQueries;
+    std::vector<float> front(kQueries), side(kQueries);
+    grid.bumper_contacts(poses, bumpers, front.data(), side.data());
+    for (size_t i = 0; i < kQueries; ++i) {
+        bool expected_front = false;
+        bool expected_side = false;
+        brute.bumper_contacts(x0[i], y0[i], heading[i], bumpers, expected_front, expected_side);
+        mismatches += (front[i] != (expected_front ? 1.0f : 0.0f)) ? 1 : 0;
+        mismatches += (side[i] != (expected_side ? 1.0f : 0.0f)) ? 1 : 0;
+    }
+}
+
+void test_grid_vs_brute_force() {
+    std::mt19937 rng(12345);
+    int mismatches = 0;
+    int hits = 0;
+
+    // Default layouts, then crowded layouts with obstacles spanning many cells
+    ArenaParams params;
+    for (int layout = 0; layout < 50; ++layout) {
+        compare_layout(params, rng, mismatches, hits);
+    }
+    params.min_obstacles = 20;
+    params.max_obstacles = 40;
+    params.max_size = 0.35f;
+    params.cell_size = 0.1f;
+    params.width = 3.0f;
+    for (int layout = 0; layout < 50; ++layout) {
+        compare_layout(params, rng, mismatches, hits);
+    }
+
+    CHECK(mismatches == 0);
+    CHECK(hits > 0);    // The queries actually exercised collisions
+}
+
+} // namespace
+
+int main() {
+    test_grid_shape();
+    test_fixed_layout();
+    test_grid_vs_brute_force();
+    return test::finish("arena");
+}
@@ -0,0 +1,135 @@
+/**
+ * @file test_cartpole_kernels.cpp
+ * @brief Vectorized CartPole step (AVX2 / NEON when compiled in) against a
+ *        scalar reference of CartPoleEnv::update_physics
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "environment/cartpole_kernels.h"
+#include "test_util.h"
+
+using environment::CartPoleConstants;
+using environment::CartPoleSoA;
+
+namespace {
+
+struct State {
+    float x, x_dot, theta, theta_dot;
+};
+
+// Same equations as CartPoleEnv::update_physics, with std::sin/std::cos
+State reference_step(State s, float force) {
+    using C = CartPoleConstants;
+    const float cos_theta = std::cos(s.theta);
+    const float sin_theta = std::sin(s.theta);
+    const float total_mass = C::kCartMass + C::kPoleMass;
+    const float pole_mass_length = C::kPoleMass * C::kPoleLength;
+
+    const float temp = (force + pole_mass_length * s.theta_dot * s.theta_dot * sin_theta) / total_mass;
+    const float theta_acc = (C::kGravity * sin_theta - cos_theta * temp) /
+                            (C::kPoleLength * (4.0f / 3.0f - C::kPoleMass * cos_theta * cos_theta / total_mass));
+    const float x_acc = temp - pole_mass_length * theta_acc * cos_theta / total_mass;
+
+    s.x += C::kTau * s.x_dot;
+    s.x_dot += C::kTau * x_acc;
+    s.theta += C::kTau * s.theta_dot;
+    s.theta_dot += C::kTau * theta_acc;
+    return s;
+}
+
+bool near_threshold(float value, float threshold) {
+    return std::fabs(std::fabs(value) - threshold) < 1e-4f;
+}
+
+// Sizes cover an empty batch, remainder-only batches and full vectors plus tails
+void test_against_reference(int64_t n, std::mt19937& rng, double& max_error) {
+    std::uniform_real_distribution<float> position(-2.6f, 2.6f);
+    std::uniform_real_distribution<float> velocity(-3.0f, 3.0f);
+    std::uniform_real_distribution<float> angle(-4.0f, 4.0f);     // Beyond +/-pi: range reduction
+    std::uniform_real_distribution<float> rate(-4.0f, 4.0f);
+    std::bernoulli_distribution push_right(0.5);
+
+    std::vector<float> x(n), x_dot(n), theta(n), theta_dot(n), force(n), terminal(n, -1.0f);
+    std::vector<State> expected(n);
+    for (int64_t i = 0; i < n; ++i) {
+        x[i] = position(rng);
+        x_dot[i] = velocity(rng);
+        theta[i] = (i % 2 == 0) ? angle(rng) : angle(rng) * 0.05f;  // Half near upright
+        theta_dot[i] = rate(rng);
+        force[i] = push_right(rng) ? CartPoleConstants::kForceMag : -CartPoleConstants::kForceMag;
+        expected[i] = reference_step(State{x[i], x_dot[i], theta[i], theta_dot[i]}, force[i]);
+    }
+
+    CartPoleSoA soa;
+    soa.x = x.data();
+    soa.x_dot = x_dot.data();
+    soa.theta = theta.data();
+    soa.theta_dot = theta_dot.data();
+    soa.size = n;
+    environment::cartpole_step_kernel(soa, force.data(), terminal.data());
+
+    for (int64_t i = 0; i < n; ++i) {
+        const State& e = expected[i];
+        CHECK_NEAR(x[i], e.x, 1e-5);
+        CHECK_NEAR(x_dot[i], e.x_dot, 1e-4);
+        CHECK_NEAR(theta[i], e.theta, 1e-5);
+        CHECK_NEAR(theta_dot[i], e.theta_dot, 1e-4);
+        max_error = std::max(max_error, static_cast<double>(std::fabs(theta_dot[i] - e.theta_dot)));
+
+        // Flags only compared away from the bounds, where rounding cannot flip them
+        if (!near_threshold(e.x, CartPoleConstants::kXThreshold) &&
+            !near_threshold(e.theta, CartPoleConstants::kThetaThreshold)) {
+            const bool out = std::fabs(e.x) > CartPoleConstants::kXThreshold ||
+                             std::fabs(e.theta) > CartPoleConstants::kThetaThreshold;
+            CHECK(terminal[i] == (out ? 1.0f : 0.0f));
+        }
+    }
+}
+
+void test_trajectory() {
+    // A long rollout stays on the reference trajectory (no drift from the polynomial)
+    constexpr int64_t kEnvs = 19;
+    std::vector<float> x(kEnvs, 0.0f), x_dot(kEnvs, 0.0f), theta(kEnvs), theta_dot(kEnvs, 0.0f);
+    std::vector<float> force(kEnvs), terminal(kEnvs);
+    std::vector<State> expected(kEnvs);
+    for (int64_t i = 0; i < kEnvs; ++i) {
+        theta[i] = 0.01f * static_cast<float>(i - kEnvs / 2);
+        expected[i] = State{0.0f, 0.0f, theta[i], 0.0f};
+    }
+    CartPoleSoA soa{x.data(), x_dot.data(), theta.data(), theta_dot.data(), kEnvs};
+
+    for (int step = 0; step < 50; ++step) {
+        for (int64_t i = 0; i < kEnvs; ++i) {
+            // Bang-bang controller on the reference state keeps both runs in bounds
+            force[i] = expected[i].theta + 0.1f * expected[i].theta_dot > 0.0f
+                           ? CartPoleConstants::kForceMag : -CartPoleConstants::kForceMag;
+            expected[i] = reference_step(expected[i], force[i]);
+        }
+        environment::cartpole_step_kernel(soa, force.data(), terminal.data());
+    }
+    for (int64_t i = 0; i < kEnvs; ++i) {
+        CHECK_NEAR(x[i], expected[i].x, 1e-4);
+        CHECK_NEAR(theta[i], expected[i].theta, 1e-4);
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout << "cartpole kernel ISA: " << environment::cartpole_kernel_isa() << std::endl;
+
+    std::mt19937 rng(7);
+    double max_error = 0.0;
+    for (int64_t n : {0, 1, 3, 4, 7, 8, 9, 16, 37, 1024}) {
+        test_against_reference(n, rng, max_error);
+    }
+    std::cout << "max |theta_dot| error: " << max_error << std::endl;
+
+    test_trajectory();
+    return test::finish("cartpole_kernels");
+}
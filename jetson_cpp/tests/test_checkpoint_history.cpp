@@ -0,0 +1,199 @@
+/**
+ * @file test_checkpoint_history.cpp
+ * @brief CheckpointHistory XOR (lossless) and quantized (bounded error)
+ *        delta codecs, and torn-tail recovery in read-only and read-write opens
+ */
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <torch/torch.h>
+
+#include "dqn/checkpoint_history.h"
+#include "test_util.h"
+
+using dqn::CheckpointHistory;
+using dqn::TrainingCheckpoint;
+
+namespace {
+
+std::string temp_path(const char* name) {
+    return "/tmp/dqn_test_" + std::string(name) + "_" + std::to_string(::getpid()) + ".hist";
+}
+
+uint64_t file_size(const std::string& path) {
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+}
+
+TrainingCheckpoint make_checkpoint() {
+    TrainingCheckpoint checkpoint;
+    checkpoint.q_network = {
+        {"fc1.weight", torch::randn({64, 4})},
+        {"fc1.bias", torch::randn({64})},
+        {"fc2.weight", torch::randn({2, 64})},
+        {"fc2.bias", torch::randn({2})},
+    };
+    for (const auto& entry : checkpoint.q_network) {
+        checkpoint.target_network.emplace_back(entry.first, entry.second.clone());
+    }
+    return checkpoint;
+}
+
+// One training interval: small updates to the Q network, target synced every 4 entries
+void advance(TrainingCheckpoint& checkpoint, int entry) {
+    for (auto& named : checkpoint.q_network) {
+        named.second = named.second + 0.01f * torch::randn_like(named.second);
+    }
+    if (entry % 4 == 0) {
+        for (size_t i = 0; i < checkpoint.q_network.size(); ++i) {
+            checkpoint.target_network[i].second = checkpoint.q_network[i].second.clone();
+        }
+        checkpoint.target_version++;
+    }
+    checkpoint.epsilon = 1.0f / static_cast<float>(entry + 1);
+    checkpoint.training_steps = 1000 * entry;
+    checkpoint.counters["episode"] = entry;
+}
+
+double max_abs_diff(const dqn::NamedTensors& a, const dqn::NamedTensors& b) {
+    if (a.size() != b.size()) {
+        return 1e9;
+    }
+    double worst = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].first != b[i].first || !a[i].second.sizes().equals(b[i].second.sizes())) {
+            return 1e9;
+        }
+        worst = std::max(worst, (a[i].second - b[i].second).abs().max().item<double>());
+    }
+    return worst;
+}
+
+void check_codec(CheckpointHistory::DeltaMode mode, double tolerance) {
+    const std::string path = temp_path(mode == CheckpointHistory::DeltaMode::kXor ? "xor" : "quant");
+    ::unlink(path.c_str());
+
+    CheckpointHistory::Options options;
+    options.keyframe_interval = 5;
+    options.delta_mode = mode;
+
+    std::vector<TrainingCheckpoint> written;
+    TrainingCheckpoint checkpoint = make_checkpoint();
+    {
+        CheckpointHistory history(path, options);
+        for (int entry = 0; entry < 12; ++entry) {
+            advance(checkpoint, entry);
+            CHECK(history.append(checkpoint) == static_cast<size_t>(entry));
+            written.push_back(checkpoint);   // advance() replaces tensors, never mutates them
+        }
+        CHECK(history.file_bytes() < history.raw_bytes());
+
+        std::vector<CheckpointHistory::EntryInfo> infos = history.entries();
+        CHECK(infos.size() == 12);
+        CHECK(infos[0].keyframe && infos[5].keyframe && infos[10].keyframe);
+        CHECK(!infos[1].keyframe && !infos[9].keyframe);
+    }
+
+    // Reopen from disk: every entry, not only the keyframes, comes back within the bound
+    CheckpointHistory history(path, options);
+    CHECK(history.size() == written.size());
+    for (size_t i = 0; i < written.size(); ++i) {
+        TrainingCheckpoint restored = history.restore(i);
+        CHECK(max_abs_diff(restored.q_network, written[i].q_network) <= tolerance);
+        CHECK(max_abs_diff(restored.target_network, written[i].target_network) <= tolerance);
+        CHECK(restored.epsilon == written[i].epsilon);
+        CHECK(restored.training_steps == written[i].training_steps);
+        CHECK(restored.target_version == written[i].target_version);
+        CHECK(restored.counter("episode", -1.0) == static_cast<double>(i));
+    }
+
+    bool threw = false;
+    try {
+        history.restore(written.size());
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    ::unlink(path.c_str());
+}
+
+void test_torn_tail() {
+    const std::string path = temp_path("torn");
+    ::unlink(path.c_str());
+
+    CheckpointHistory::Options options;
+    options.keyframe_interval = 5;
+    options.delta_mode = CheckpointHistory::DeltaMode::kXor;
+
+    TrainingCheckpoint checkpoint = make_checkpoint();
+    uint64_t intact_bytes = 0;
+    {
+        CheckpointHistory history(path, options);
+        for (int entry = 0; entry < 3; ++entry) {
+            advance(checkpoint, entry);
+            history.append(checkpoint);
+            if (entry == 1) {
+                intact_bytes = history.file_bytes();
+            }
+        }
+    }
+
+    // Power loss in the middle of the last record
+    const uint64_t torn_bytes = file_size(path) - 5;
+    CHECK(::truncate(path.c_str(), static_cast<off_t>(torn_bytes)) == 0);
+
+    // Read-only: the torn record is skipped and the file left alone
+    {
+        CheckpointHistory::Options inspect = options;
+        inspect.read_only = true;
+        CheckpointHistory history(path, inspect);
+        CHECK(history.size() == 2);
+        CHECK(history.restore(1).training_steps == 1000);
+        CHECK(file_size(path) == torn_bytes);
+
+        bool threw = false;
+        try {
+            history.append(checkpoint);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+
+    // Read-write: the tail is truncated and appending continues after entry 1
+    {
+        CheckpointHistory history(path, options);
+        CHECK(history.size() == 2);
+        CHECK(file_size(path) == intact_bytes);
+        CHECK(history.append(checkpoint) == 2);
+
+        TrainingCheckpoint restored = history.restore(2);
+        CHECK(max_abs_diff(restored.q_network, checkpoint.q_network) == 0.0);
+        CHECK(restored.training_steps == checkpoint.training_steps);
+    }
+    {
+        CheckpointHistory history(path, options);
+        CHECK(history.size() == 3);
+    }
+
+    ::unlink(path.c_str());
+}
+
+} // namespace
+
+int main() {
+    torch::manual_seed(0);
+    check_codec(CheckpointHistory::DeltaMode::kXor, 0.0);
+    // Updates of ~0.01 per entry: half a step of max|diff| / 127 stays well below 1e-3
+    check_codec(CheckpointHistory::DeltaMode::kQuantized, 1e-3);
+    test_torn_tail();
+    return test::finish("checkpoint_history");
+}
@@ -0,0 +1,250 @@
+/**
+ * @file test_link_impairment.cpp
+ * @brief LinkImpairment statistics (loss rate, burst length, delay
+ *        distributions, duplicates, reordering) and spec parsing
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "communication/link_impairment.h"
+#include "test_util.h"
+
+using namespace communication;
+using time_point = LinkImpairment::time_point;
+
+namespace {
+
+constexpr int kDatagrams = 200000;
+
+double delay_ms(time_point now, time_point release) {
+    return std::chrono::duration<double, std::milli>(release - now).count();
+}
+
+struct DelayStats {
+    double mean = 0.0;
+    double stddev = 0.0;
+    double min = 1e9;
+};
+
+// Arrivals one second apart, so the FIFO rule never stretches a delay
+DelayStats sample_delays(const LinkImpairmentParams& params) {
+    LinkImpairment link(params, 42);
+    time_point now{};
+    time_point release[2];
+    double sum = 0.0, sum_sq = 0.0;
+    DelayStats stats;
+    for (int i = 0; i < kDatagrams; ++i) {
+        now += std::chrono::seconds(1);
+        CHECK(link.schedule(now, release) == 1);
+        const double d = delay_ms(now, release[0]);
+        sum += d;
+        sum_sq += d * d;
+        stats.min = std::min(stats.min, d);
+    }
+    stats.mean = sum / kDatagrams;
+    stats.stddev = std::sqrt(sum_sq / kDatagrams - stats.mean * stats.mean);
+    CHECK_NEAR(link.mean_delay_ms(), stats.mean, 1e-3);
+    return stats;
+}
+
+void test_delay_distributions() {
+    LinkImpairmentParams params;
+    params.delay_ms = 20.0;
+    params.jitter_ms = 10.0;
+
+    // U(-10, 10): mean 20, sd 10 / sqrt(3)
+    params.distribution = DelayDistribution::kUniform;
+    DelayStats stats = sample_delays(params);
+    CHECK_NEAR(stats.mean, 20.0, 0.1);
+    CHECK_NEAR(stats.stddev, 10.0 / std::sqrt(3.0), 0.1);
+    CHECK(stats.min >= 10.0 - 1e-3);
+
+    // N(0, 5): clamping at zero is four sigma away
+    params.jitter_ms = 5.0;
+    params.distribution = DelayDistribution::kNormal;
+    stats = sample_delays(params);
+    CHECK_NEAR(stats.mean, 20.0, 0.1);
+    CHECK_NEAR(stats.stddev, 5.0, 0.1);
+
+    // Pareto tail with mean jitter, never below its scale
+    params.delay_ms = 0.0;
+    params.jitter_ms = 10.0;
+    params.distribution = DelayDistribution::kPareto;
+    stats = sample_delays(params);
+    CHECK_NEAR(stats.mean, 10.0, 0.3);
+    CHECK(stats.min >= 10.0 * 1.5 / 2.5 - 1e-3);
+
+    // Clamped at zero: E[max(0, U(-10, 10))] = 2.5
+    params.distribution = DelayDistribution::kUniform;
+    stats = sample_delays(params);
+    CHECK_NEAR(stats.mean, 2.5, 0.1);
+    CHECK(stats.min >= 0.0);
+}
+
+void check_loss(double loss, double burst_length) {
+    LinkImpairmentParams params;
+    params.loss = loss;
+    params.burst_length = burst_length;
+    LinkImpairment link(params, 7);
+
+    time_point now{};
+    time_point release[2];
+    uint64_t bursts = 0;
+    bool previous_lost = false;
+    for (int i = 0; i < kDatagrams; ++i) {
+        now += std::chrono::milliseconds(1);
+        const bool lost = link.schedule(now, release) == 0;
+        bursts += (lost && !previous_lost) ? 1 : 0;
+        previous_lost = lost;
+    }
+
+    CHECK(link.offered() == static_cast<uint64_t>(kDatagrams));
+    const double rate = static_cast<double>(link.dropped()) / kDatagrams;
+    CHECK_NEAR(rate, loss, 0.1 * loss);
+    CHECK(bursts > 0);
+    const double mean_burst = static_cast<double>(link.dropped()) / bursts;
+    CHECK_NEAR(mean_burst, burst_length, 0.1 * burst_length);
+}
+
+void test_loss() {
+    check_loss(0.05, 1.0);      // Independent losses
+    check_loss(0.10, 4.0);      // Bursty
+    check_loss(0.30, 2.0);
+
+    LinkImpairmentParams params;
+    LinkImpairment clean(params, 1);
+    time_point release[2];
+    for (int i = 0; i < 1000; ++i) {
+        CHECK(clean.schedule(time_point{} + std::chrono::milliseconds(i), release) == 1);
+    }
+    CHECK(clean.dropped() == 0);
+}
+
+void test_fifo_and_reorder() {
+    // Jitter much larger than the arrival spacing still keeps FIFO order
+    LinkImpairmentParams params;
+    params.delay_ms = 5.0;
+    params.jitter_ms = 20.0;
+    params.distribution = DelayDistribution::kPareto;
+    LinkImpairment fifo(params, 3);
+
+    time_point now{};
+    time_point release[2];
+    time_point last{};
+    uint64_t overtaken = 0;
+    for (int i = 0; i < kDatagrams; ++i) {
+        now += std::chrono::milliseconds(1);
+        fifo.schedule(now, release);
+        CHECK(release[0] >= now);
+        overtaken += (release[0] < last) ? 1 : 0;
+        last = release[0];
+    }
+    CHECK(overtaken == 0);
+    CHECK(fifo.reordered() == 0);
+
+    // Held-back datagrams are overtaken by the following ones
+    params.jitter_ms = 0.0;
+    params.reorder = 0.1;
+    params.reorder_ms = 30.0;
+    LinkImpairment shuffled(params, 4);
+    now = time_point{};
+    last = time_point{};
+    overtaken = 0;
+    for (int i = 0; i < kDatagrams; ++i) {
+        now += std::chrono::milliseconds(1);
+        shuffled.schedule(now, release);
+        overtaken += (release[0] < last) ? 1 : 0;
+        last = release[0];
+    }
+    CHECK_NEAR(static_cast<double>(shuffled.reordered()) / kDatagrams, 0.1, 0.01);
+    CHECK(overtaken > 0);
+}
+
+void test_duplicates() {
+    LinkImpairmentParams params;
+    params.duplicate = 0.05;
+    params.delay_ms = 10.0;
+    LinkImpairment link(params, 5);
+
+    time_point now{};
+    time_point release[2];
+    uint64_t copies = 0;
+    for (int i = 0; i < kDatagrams; ++i) {
+        now += std::chrono::milliseconds(1);
+        const int n = link.schedule(now, release);
+        copies += static_cast<uint64_t>(n);
+        if (n == 2) {
+            CHECK(release[1] >= release[0]);
+        }
+    }
+    CHECK(copies == static_cast<uint64_t>(kDatagrams) + link.duplicated());
+    CHECK_NEAR(static_cast<double>(link.duplicated()) / kDatagrams, 0.05, 0.005);
+}
+
+void test_seeded() {
+    LinkImpairmentParams params;
+    params.loss = 0.2;
+    params.jitter_ms = 10.0;
+    LinkImpairment a(params, 99);
+    LinkImpairment b(params, 99);
+    time_point ra[2], rb[2];
+    bool same = true;
+    for (int i = 0; i < 1000; ++i) {
+        const time_point now = time_point{} + std::chrono::milliseconds(i);
+        const int na = a.schedule(now, ra);
+        const int nb = b.schedule(now, rb);
+        same = same && na == nb && (na == 0 || ra[0] == rb[0]);
+    }
+    CHECK(same);
+}
+
+bool parse_throws(const std::string& spec) {
+    try {
+        parse_link_impairment(spec);
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+void test_parse() {
+    LinkImpairmentParams params =
+        parse_link_impairment("delay=20,jitter=10,dist=pareto,loss=0.05,burst=3,dup=0.01,"
+                              "reorder=0.02,reorder_ms=30");
+    CHECK(params.delay_ms == 20.0);
+    CHECK(params.jitter_ms == 10.0);
+    CHECK(params.distribution == DelayDistribution::kPareto);
+    CHECK(params.loss == 0.05);
+    CHECK(params.burst_length == 3.0);
+    CHECK(params.duplicate == 0.01);
+    CHECK(params.reorder == 0.02);
+    CHECK(params.reorder_ms == 30.0);
+
+    params = parse_link_impairment("");
+    CHECK(params.loss == 0.0 && params.delay_ms == 0.0);
+
+    CHECK(parse_throws("latency=5"));
+    CHECK(parse_throws("loss=1.5"));
+    CHECK(parse_throws("burst=0.5"));
+    CHECK(parse_throws("delay=-1"));
+    CHECK(parse_throws("delay=abc"));
+    CHECK(parse_throws("delay"));
+    CHECK(parse_throws("dist=gamma"));
+}
+
+} // namespace
+
+int main() {
+    test_delay_distributions();
+    test_loss();
+    test_fifo_and_reorder();
+    test_duplicates();
+    test_seeded();
+    test_parse();
+    return test::finish("link_impairment");
+}
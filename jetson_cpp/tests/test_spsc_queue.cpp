@@ -0,0 +1,81 @@
+/**
+ * @file test_spsc_queue.cpp
+ * @brief SpscQueue: capacity rounding, full/empty edges, wrap-around and
+ *        FIFO order under a concurrent producer and consumer
+ */
+
+#include <cstdint>
+#include <thread>
+
+#include "communication/spsc_queue.h"
+#include "test_util.h"
+
+using communication::SpscQueue;
+
+namespace {
+
+void test_single_thread() {
+    SpscQueue<int> queue(5);
+    CHECK(queue.capacity() == 8);   // Rounded up to a power of two
+    CHECK(queue.empty());
+
+    int value = -1;
+    CHECK(!queue.try_pop(value));
+
+    for (int i = 0; i < 8; ++i) {
+        CHECK(queue.try_push(i));
+    }
+    CHECK(!queue.try_push(8));      // Full
+
+    // Interleave pops and pushes so the indices wrap many times
+    for (int i = 0; i < 1000; ++i) {
+        CHECK(queue.try_pop(value));
+        CHECK(value == i);
+        CHECK(queue.try_push(i + 8));
+    }
+    for (int i = 1000; i < 1008; ++i) {
+        CHECK(queue.try_pop(value));
+        CHECK(value == i);
+    }
+    CHECK(!queue.try_pop(value));
+    CHECK(queue.empty());
+}
+
+void test_two_threads() {
+    constexpr uint64_t kItems = 1000000;
+    SpscQueue<uint64_t> queue(64);
+
+    std::thread producer([&]() {
+        for (uint64_t i = 1; i <= kItems; ++i) {
+            while (!queue.try_push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    // Every item arrives exactly once and in order
+    uint64_t expected = 1;
+    uint64_t out_of_order = 0;
+    while (expected <= kItems) {
+        uint64_t value = 0;
+        if (!queue.try_pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        out_of_order += (value != expected) ? 1 : 0;
+        expected = value + 1;
+    }
+    producer.join();
+
+    CHECK(out_of_order == 0);
+    CHECK(expected == kItems + 1);
+    CHECK(queue.empty());
+}
+
+} // namespace
+
+int main() {
+    test_single_thread();
+    test_two_threads();
+    return test::finish("spsc_queue");
+}
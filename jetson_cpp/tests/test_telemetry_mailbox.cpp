@@ -0,0 +1,176 @@
+/**
+ * @file test_telemetry_mailbox.cpp
+ * @brief Seqlock consistency under a concurrent writer, and TelemetryMailbox
+ *        ordering, history and restart handling
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "communication/seqlock.h"
+#include "communication/telemetry_mailbox.h"
+#include "test_util.h"
+
+using namespace communication;
+
+namespace {
+
+// Every field derived from one counter, so a torn copy is detectable
+struct Payload {
+    uint64_t a;
+    uint64_t b;
+    uint64_t c;
+    double d;
+};
+
+Payload make_payload(uint64_t n) {
+    return Payload{n, ~n, n * 3, static_cast<double>(n)};
+}
+
+bool consistent(const Payload& p) {
+    return p.b == ~p.a && p.c == p.a * 3 && p.d == static_cast<double>(p.a);
+}
+
+void test_seqlock() {
+    Seqlock<Payload> lock;
+    CHECK(lock.load().a == 0);      // Zero-initialized before the first store
+
+    lock.store(make_payload(5));
+    Payload p;
+    CHECK(lock.try_load(p));
+    CHECK(p.a == 5 && consistent(p));
+
+    std::atomic<bool> stop{false};
+    std::thread writer([&]() {
+        for (uint64_t n = 1; !stop.load(std::memory_order_relaxed); ++n) {
+            lock.store(make_payload(n));
+        }
+    });
+
+    uint64_t torn = 0;
+    uint64_t backwards = 0;
+    uint64_t last = 0;
+    for (int i = 0; i < 200000; ++i) {
+        Payload value = lock.load();
+        torn += consistent(value) ? 0 : 1;
+        backwards += (value.a < last) ? 1 : 0;
+        last = value.a;
+    }
+    stop = true;
+    writer.join();
+
+    CHECK(torn == 0);
+    CHECK(backwards == 0);          // Single writer: values never go back in time
+}
+
+SensorData make_sensors(float angle) {
+    SensorData sensors;
+    sensors.gyro_angle = angle;
+    sensors.gyro_rate = 0.0f;
+    sensors.touch_front = 0;
+    sensors.touch_side = 0;
+    sensors.valid = true;
+    return sensors;
+}
+
+WireTag make_frame(uint32_t sequence, uint64_t time_us) {
+    WireTag frame;
+    frame.sequence = sequence;
+    frame.timestamp_us = time_us;
+    return frame;
+}
+
+void test_mailbox_ordering() {
+    const auto now = std::chrono::steady_clock::now();
+    TelemetryMailbox mailbox;
+    TelemetrySample sample;
+    CHECK(!mailbox.latest(sample));
+
+    CHECK(mailbox.publish(make_sensors(1.0f), make_frame(10, 1000), now));
+    CHECK(mailbox.publish(make_sensors(2.0f), make_frame(11, 2000), now));
+
+    // Late and duplicate frames are dropped
+    CHECK(!mailbox.publish(make_sensors(0.5f), make_frame(9, 900), now));
+    CHECK(!mailbox.publish(make_sensors(2.0f), make_frame(11, 2000), now));
+    CHECK(mailbox.reordered() == 2);
+
+    CHECK(mailbox.latest(sample));
+    CHECK(sample.frame == 11);
+    CHECK(sample.sensors.gyro_angle == 2.0f);
+    CHECK(sample.index == 2);
+
+    // Counter back with a newer bridge clock: bridge restarted, accepted
+    CHECK(mailbox.publish(make_sensors(3.0f), make_frame(1, 3000), now));
+    CHECK(mailbox.latest(sample));
+    CHECK(sample.frame == 1);
+    CHECK(mailbox.published() == 3);
+
+    // Counter wrap-around is a forward step
+    CHECK(mailbox.publish(make_sensors(4.0f), make_frame(0xFFFFFFFFu, 4000), now));
+    CHECK(mailbox.publish(make_sensors(5.0f), make_frame(0, 5000), now));
+}
+
+void test_mailbox_history() {
+    const auto now = std::chrono::steady_clock::now();
+    TelemetryMailbox mailbox;
+    const uint32_t total = TelemetryMailbox::kHistory + 8;
+    for (uint32_t i = 1; i <= total; ++i) {
+        mailbox.publish(make_sensors(static_cast<float>(i)), make_frame(i, i * 100), now);
+    }
+
+    TelemetrySample window[TelemetryMailbox::kHistory + 4];
+    size_t n = mailbox.history(window, 4);
+    CHECK(n == 4);
+    for (size_t k = 0; k < n; ++k) {
+        CHECK(window[k].frame == total - k);    // Newest first
+    }
+
+    // Never more than the ring holds
+    n = mailbox.history(window, TelemetryMailbox::kHistory + 4);
+    CHECK(n == TelemetryMailbox::kHistory);
+    CHECK(window[n - 1].frame == total - TelemetryMailbox::kHistory + 1);
+}
+
+void test_mailbox_concurrent() {
+    TelemetryMailbox mailbox;
+    std::atomic<bool> stop{false};
+    std::thread writer([&]() {
+        const auto now = std::chrono::steady_clock::now();
+        for (uint32_t i = 1; !stop.load(std::memory_order_relaxed); ++i) {
+            mailbox.publish(make_sensors(static_cast<float>(i)), make_frame(i, i), now);
+        }
+    });
+
+    uint64_t bad = 0;
+    uint32_t last = 0;
+    TelemetrySample window[8];
+    for (int i = 0; i < 100000; ++i) {
+        TelemetrySample sample;
+        if (mailbox.latest(sample)) {
+            // Fields of one frame stay together and never go back
+            bad += (sample.sensors.gyro_angle != static_cast<float>(sample.frame) &&
+                    sample.frame < (1u << 24)) ? 1 : 0;
+            bad += (sample.frame < last) ? 1 : 0;
+            last = sample.frame;
+        }
+        size_t n = mailbox.history(window, 8);
+        for (size_t k = 1; k < n; ++k) {
+            bad += (window[k].index + 1 != window[k - 1].index) ? 1 : 0;
+        }
+    }
+    stop = true;
+    writer.join();
+    CHECK(bad == 0);
+}
+
+} // namespace
+
+int main() {
+    test_seqlock();
+    test_mailbox_ordering();
+    test_mailbox_history();
+    test_mailbox_concurrent();
+    return test::finish("telemetry_mailbox");
+}
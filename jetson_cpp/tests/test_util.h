@@ -0,0 +1,53 @@
+#ifndef TESTS_TEST_UTIL_H
+#define TESTS_TEST_UTIL_H
+
+#include <cmath>
+#include <iostream>
+
+/**
+ * @file test_util.h
+ * @brief Minimal check macros for the ctest executables (no framework needed)
+ *
+ * A failed CHECK prints the location and keeps going; main() returns
+ * test::finish(), which is non-zero when any check failed.
+ */
+
+namespace test {
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline int finish(const char* name) {
+    if (failures() == 0) {
+        std::cout << "[PASS] " << name << std::endl;
+        return 0;
+    }
+    std::cerr << "[FAIL] " << name << ": " << failures() << " check(s) failed" << std::endl;
+    return 1;
+}
+
+} // namespace test
+
+#define CHECK(cond)                                                                 \
+    do {                                                                            \
+        if (!(cond)) {                                                              \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") failed" \
+                      << std::endl;                                                 \
+            ++test::failures();                                                     \
+        }                                                                           \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tol)                                                        \
+    do {                                                                             \
+        const double check_a_ = (a);                                                 \
+        const double check_b_ = (b);                                                 \
+        if (!(std::fabs(check_a_ - check_b_) <= (tol))) {                            \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK_NEAR(" #a ", " #b   \
+                      << ") failed: " << check_a_ << " vs " << check_b_ << std::endl; \
+            ++test::failures();                                                      \
+        }                                                                            \
+    } while (0)
+
+#endif // TESTS_TEST_UTIL_H
@@ -0,0 +1,230 @@
+/**
+ * @file test_wire_protocol.cpp
+ * @brief Round trips of every datagram type in csv, csv-tagged and binary,
+ *        and rejection of corrupted binary packets (Fletcher-16)
+ */
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "communication/wire_protocol.h"
+#include "test_util.h"
+
+using namespace communication;
+
+namespace {
+
+const WireFormat kFormats[] = {WireFormat::kCsv, WireFormat::kCsvTagged, WireFormat::kBinary};
+
+SensorData make_sensors(float angle, float rate, int front, int side) {
+    SensorData sensors;
+    sensors.gyro_angle = angle;
+    sensors.gyro_rate = rate;
+    sensors.touch_front = front;
+    sensors.touch_side = side;
+    sensors.valid = true;
+    return sensors;
+}
+
+void test_checksum() {
+    // Reference values of the Fletcher-16 definition
+    CHECK(wire_checksum(reinterpret_cast<const uint8_t*>("abcde"), 5) == 0xC8F0);
+    CHECK(wire_checksum(reinterpret_cast<const uint8_t*>("abcdef"), 6) == 0x2057);
+    CHECK(wire_checksum(reinterpret_cast<const uint8_t*>("abcdefgh"), 8) == 0x0627);
+
+    // Block-wise reduction agrees with the per-byte definition on long inputs
+    uint8_t data[1000];
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = static_cast<uint8_t>(255 - i % 7);
+    }
+    uint32_t a = 0, b = 0;
+    for (uint8_t byte : data) {
+        a = (a + byte) % 255;
+        b = (b + a) % 255;
+    }
+    CHECK(wire_checksum(data, sizeof(data)) == ((b << 8) | a));
+}
+
+void test_action_round_trip() {
+    WireTag tag;
+    tag.sequence = 4242;
+    tag.timestamp_us = 1234567890123ULL;
+
+    for (WireFormat format : kFormats) {
+        for (int action : {0, 3, 255}) {
+            char buffer[kMaxWirePacketSize];
+            size_t size = encode_action(action, format, buffer, sizeof(buffer), tag);
+            CHECK(size > 0);
+
+            int decoded = -1;
+            WireFormat detected;
+            WireTag decoded_tag;
+            CHECK(decode_action(buffer, size, decoded, &detected, &decoded_tag));
+            CHECK(decoded == action);
+            CHECK(detected == format);
+            if (format == WireFormat::kCsv) {
+                CHECK(decoded_tag.sequence == 0);   // Plain CSV never carries a tag
+            } else {
+                CHECK(decoded_tag.sequence == tag.sequence);
+                CHECK(decoded_tag.timestamp_us == tag.timestamp_us);
+            }
+        }
+    }
+
+    // The original bridge protocol is exactly the bare number
+    char buffer[kMaxWirePacketSize];
+    size_t size = encode_action(4, WireFormat::kCsv, buffer, sizeof(buffer), tag);
+    CHECK(std::string(buffer, size) == "4");
+
+    // Too small a buffer is reported, not overrun
+    CHECK(encode_action(1, WireFormat::kBinary, buffer, kActionPacketSize - 1, tag) == 0);
+}
+
+void test_sensor_round_trip() {
+    WireTag tag;
+    tag.sequence = 7;
+    tag.timestamp_us = 99;
+
+    const SensorData cases[] = {
+        make_sensors(12.5f, -3.25f, 1, 0),
+        make_sensors(-179.75f, 0.0f, 0, 1),
+        make_sensors(0.5f, 720.0f, -1, -1),
+    };
+    for (WireFormat format : kFormats) {
+        for (const SensorData& sensors : cases) {
+            char buffer[kMaxWirePacketSize];
+            size_t size = encode_sensors(sensors, format, buffer, sizeof(buffer), tag);
+            CHECK(size > 0);
+
+            SensorData decoded;
+            WireFormat detected;
+            WireTag decoded_tag;
+            CHECK(decode_sensors(buffer, size, decoded, &detected, &decoded_tag));
+            CHECK(decoded.valid);
+            CHECK(detected == format);
+            // CSV keeps two decimals; these values are exact in both encodings
+            CHECK(decoded.gyro_angle == sensors.gyro_angle);
+            CHECK(decoded.gyro_rate == sensors.gyro_rate);
+            CHECK(decoded.touch_front == sensors.touch_front);
+            CHECK(decoded.touch_side == sensors.touch_side);
+            CHECK(decoded_tag.sequence == (format == WireFormat::kCsv ? 0u : tag.sequence));
+        }
+    }
+
+    // Malformed CSV readings
+    SensorData decoded;
+    const char* bad[] = {"", "1.0,2.0,0", "1.0,2.0,0,2", "nan,0,0,0", "1,2,0,0,5", "1,2,0,0 x"};
+    for (const char* text : bad) {
+        CHECK(!decode_sensors(text, std::strlen(text), decoded));
+        CHECK(!decoded.valid);
+    }
+}
+
+void test_subscribe_and_telemetry() {
+    for (WireFormat format : kFormats) {
+        char buffer[kMaxWirePacketSize];
+        size_t size = encode_subscribe(50, format, buffer, sizeof(buffer));
+        int rate = -1;
+        CHECK(size > 0);
+        CHECK(decode_subscribe(buffer, size, rate));
+        CHECK(rate == 50);
+
+        // A subscription is never mistaken for an action
+        int action = -1;
+        CHECK(!decode_action(buffer, size, action));
+
+        WireTag frame;
+        frame.sequence = 123456;
+        frame.timestamp_us = 5000000;
+        SensorData sensors = make_sensors(-45.25f, 10.5f, 0, 1);
+        size = encode_telemetry(sensors, format, buffer, sizeof(buffer), frame);
+        CHECK(size > 0);
+        CHECK(is_telemetry(buffer, size));
+
+        SensorData decoded;
+        WireTag decoded_frame;
+        CHECK(decode_telemetry(buffer, size, decoded, nullptr, &decoded_frame));
+        CHECK(decoded.gyro_angle == sensors.gyro_angle);
+        CHECK(decoded.touch_side == 1);
+        CHECK(decoded_frame.sequence == frame.sequence);
+        CHECK(decoded_frame.timestamp_us == frame.timestamp_us);
+
+        // Telemetry is not a reply, and a reply is not telemetry
+        CHECK(!decode_sensors(buffer, size, decoded));
+        size = encode_sensors(sensors, format, buffer, sizeof(buffer), frame);
+        CHECK(!is_telemetry(buffer, size));
+    }
+}
+
+void test_binary_rejection() {
+    WireTag tag;
+    tag.sequence = 31337;
+    tag.timestamp_us = 0x0102030405060708ULL;
+
+    char action_packet[kActionPacketSize];
+    CHECK(encode_action(2, WireFormat::kBinary, action_packet, sizeof(action_packet), tag) ==
+          kActionPacketSize);
+    char sensor_packet[kSensorPacketSize];
+    CHECK(encode_sensors(make_sensors(1.0f, 2.0f, 1, 1), WireFormat::kBinary, sensor_packet,
+                         sizeof(sensor_packet), tag) == kSensorPacketSize);
+
+    // Any single flipped bit, in the body or in the checksum, is rejected
+    for (size_t byte = 0; byte < kActionPacketSize; ++byte) {
+        for (int bit = 0; bit < 8; ++bit) {
+            char copy[kActionPacketSize];
+            std::memcpy(copy, action_packet, sizeof(copy));
+            copy[byte] ^= static_cast<char>(1 << bit);
+            int action = -1;
+            CHECK(!decode_action(copy, sizeof(copy), action));
+        }
+    }
+    for (size_t byte = 0; byte < kSensorPacketSize; ++byte) {
+        char copy[kSensorPacketSize];
+        std::memcpy(copy, sensor_packet, sizeof(copy));
+        copy[byte] ^= 0x10;
+        SensorData sensors;
+        CHECK(!decode_sensors(copy, sizeof(copy), sensors));
+        CHECK(!sensors.valid);
+    }
+
+    // Wrong size
+    int action = -1;
+    CHECK(!decode_action(action_packet, kActionPacketSize - 1, action));
+    SensorData sensors;
+    CHECK(!decode_sensors(sensor_packet, kSensorPacketSize - 1, sensors));
+
+    // Version 1 packets are rejected even with a valid checksum
+    char v1[kActionPacketSize];
+    std::memcpy(v1, action_packet, sizeof(v1));
+    v1[1] = 1;
+    uint16_t checksum = wire_checksum(reinterpret_cast<const uint8_t*>(v1), kActionPacketSize - 2);
+    v1[16] = static_cast<char>(checksum & 0xff);
+    v1[17] = static_cast<char>(checksum >> 8);
+    CHECK(!decode_action(v1, sizeof(v1), action));
+}
+
+void test_format_names() {
+    for (WireFormat format : kFormats) {
+        CHECK(parse_wire_format(wire_format_name(format)) == format);
+    }
+    bool threw = false;
+    try {
+        parse_wire_format("json");
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+} // namespace
+
+int main() {
+    test_checksum();
+    test_action_round_trip();
+    test_sensor_round_trip();
+    test_subscribe_and_telemetry();
+    test_binary_rejection();
+    test_format_names();
+    return test::finish("wire_protocol");
+}
@@ -13,11 +13,27 @@ PROTOCOLO:
   3. Bridge lee sensores del EV3
   4. Bridge responde: "SENSORS:gyro_angle,gyro_rate,touch_front,touch_side"
 
+  Formato binario opcional (jetson_cpp/include/communication/wire_protocol.h):
+  paquetes little-endian con magic 0xEB, versión, tipo y checksum Fletcher-16.
+  Se detecta por el primer byte y se responde en el mismo formato.
+
+  Cada acción puede llevar "N,secuencia,timestamp_us" (o esos campos en el
+  paquete binario); la respuesta los devuelve tal cual para que el Jetson
+  descarte respuestas tardías.
+
+  TELEMETRÍA (opcional):
+  El Jetson puede suscribirse con "S,hz" (o el paquete binario tipo 3) y el
+  bridge le empuja frames de sensores a ese ritmo, sin esperar acciones:
+  "T,gyro_angle,gyro_rate,touch_front,touch_side,frame,timestamp_us" (o
+  paquete binario tipo 4). La suscripción caduca si no se renueva en 3 s;
+  "S,0" la cancela.
+
 SEGURIDAD:
   - Si no recibe del Jetson por >0.5s → envía STOP al EV3
   - Logging de todas las acciones y sensores
 """
 import socket
+import struct
 import time
 import threading
 from datetime import datetime
@@ -31,6 +47,67 @@ from config import UDP_PORT, TIMEOUT_SECONDS, SPEED_FORWARD, SPEED_TURN
 
 from ev3_controller import EV3Controller
 
+# Protocolo binario (ver wire_protocol.h)
+WIRE_MAGIC = 0xEB
+WIRE_VERSION = 2
+WIRE_TYPE_ACTION = 1
+WIRE_TYPE_SENSORS = 2
+WIRE_TYPE_SUBSCRIBE = 3
+WIRE_TYPE_TELEMETRY = 4
+
+# Telemetría empujada: ritmo máximo (lecturas USB del EV3) y caducidad
+MAX_TELEMETRY_HZ = 100
+TELEMETRY_SUBSCRIPTION_TIMEOUT = 3.0
+
+
+def wire_checksum(data):
+    """Fletcher-16"""
+    a = b = 0
+    for byte in data:
+        a = (a + byte) % 255
+        b = (b + a) % 255
+    return (b << 8) | a
+
+
+def decode_action(data):
+    """Devuelve (acción, binario, (secuencia, timestamp_us)) o lanza ValueError"""
+    if data and data[0] == WIRE_MAGIC:
+        if (len(data) != 18 or data[1] != WIRE_VERSION or data[2] != WIRE_TYPE_ACTION or
+                struct.unpack('<H', data[16:18])[0] != wire_checksum(data[:16])):
+            raise ValueError(f"paquete binario inválido: {data.hex()}")
+        return data[3], True, struct.unpack('<IQ', data[4:16])
+    fields = data.decode('utf-8').strip().split(',')
+    if len(fields) == 3:
+        return int(fields[0]), False, (int(fields[1]), int(fields[2]))
+    if len(fields) != 1:
+        raise ValueError(f"acción inválida: {data!r}")
+    return int(fields[0]), False, (0, 0)
+
+
+def decode_subscribe(data):
+    """Devuelve (hz, binario) si el datagrama es una suscripción, None si no"""
+    if data and data[0] == WIRE_MAGIC:
+        if (len(data) == 18 and data[1] == WIRE_VERSION and data[2] == WIRE_TYPE_SUBSCRIBE and
+                struct.unpack('<H', data[16:18])[0] == wire_checksum(data[:16])):
+            return struct.unpack('<I', data[4:8])[0], True
+        return None
+    if data.startswith(b'S,'):
+        return int(data[2:].decode('utf-8').strip()), False
+    return None
+
+
+def encode_sensors_binary(sensor_data, tag, wire_type=WIRE_TYPE_SENSORS):
+    flags = 0
+    for bit, key in ((0, 'touch_front'), (1, 'touch_side')):
+        value = sensor_data[key]
+        if value is None or value < 0:
+            flags |= 1 << (bit + 2)
+        elif value:
+            flags |= 1 << bit
+    packet = struct.pack('<BBBBIQff', WIRE_MAGIC, WIRE_VERSION, wire_type, flags,
+                         tag[0], tag[1], sensor_data['gyro_angle'], sensor_data['gyro_rate'])
+    return packet + struct.pack('<H', wire_checksum(packet))
+
 
 class Bridge:
     """Puente Jetson ↔ EV3"""
@@ -43,6 +120,13 @@ class Bridge:
         self.last_action = 0
         self.last_received_time = time.time()
         self.running = False
+        self.binary = False  # Formato de la última acción recibida
+        self.tag = (0, 0)    # (secuencia, timestamp_us) de la última acción, para el eco
+
+        # Telemetría: un suscriptor (dirección, hz, binario, caducidad)
+        self.subscriber = None
+        self.telemetry_frame = 0
+        self.ev3_lock = threading.Lock()  # Acciones y telemetría comparten el EV3
 
         # Log
         self.log_file = f"bridge_log_{datetime.now().strftime('%Y%m%d_%H%M%S')}.txt"
@@ -74,12 +158,16 @@ class Bridge:
         """Recibe acción del Jetson (bloqueante con timeout)"""
         try:
             data, addr = self.sock.recvfrom(1024)
-            action = int(data.decode('utf-8').strip())
+            subscription = decode_subscribe(data)
+            if subscription is not None:
+                self.subscribe(addr, *subscription)
+                return None, None
+            action, self.binary, self.tag = decode_action(data)
             self.last_received_time = time.time()
             return action, addr
         except socket.timeout:
             return None, None
-        except ValueError as e:
+        except (ValueError, UnicodeDecodeError) as e:
             self.log(f"ERROR: Dato inválido recibido: {e}")
             return None, None
 
@@ -94,7 +182,9 @@ class Bridge:
         Returns:
             sensor_data: dict con valores de sensores (o None si no hay client_addr)
         """
-        if self.ev3.execute_action(action):
+        with self.ev3_lock:
+            executed = self.ev3.execute_action(action)
+        if executed:
             self.last_action = action
             action_name = ["STOP", "FORWARD", "TURN_LEFT", "TURN_RIGHT", "BACKWARD"][action]
             self.log(f"[OK] Accion {action} ({action_name}) ejecutada")
@@ -103,7 +193,8 @@ class Bridge:
             return None
 
         # Leer sensores después de ejecutar acción
-        sensor_data = self.ev3.read_sensors()
+        with self.ev3_lock:
+            sensor_data = self.ev3.read_sensors()
 
         # Si hay client_addr, enviar sensores de vuelta
         if client_addr is not None:
@@ -117,15 +208,71 @@ class Bridge:
 
         Formato: "gyro_angle,gyro_rate,touch_front,touch_side"
         Ejemplo: "12.5,-3.2,0,1"
+        (o paquete binario si la acción llegó en binario)
         """
         try:
-            # Formato CSV simple
-            msg = f"{sensor_data['gyro_angle']:.2f},{sensor_data['gyro_rate']:.2f},{sensor_data['touch_front']},{sensor_data['touch_side']}"
-            self.sock.sendto(msg.encode('utf-8'), client_addr)
+            if self.binary:
+                msg = encode_sensors_binary(sensor_data, self.tag)
+                self.sock.sendto(msg, client_addr)
+                msg = msg.hex()
+            else:
+                # Formato CSV simple (+ eco de secuencia y timestamp si la acción los traía)
+                msg = f"{sensor_data['gyro_angle']:.2f},{sensor_data['gyro_rate']:.2f},{sensor_data['touch_front']},{sensor_data['touch_side']}"
+                if self.tag[0] != 0:
+                    msg += f",{self.tag[0]},{self.tag[1]}"
+                self.sock.sendto(msg.encode('utf-8'), client_addr)
             self.log(f"-> Sensores enviados a {client_addr[0]}:{client_addr[1]}: {msg}")
         except Exception as e:
             self.log(f"[ERROR] Enviando sensores: {e}")
 
+    def subscribe(self, addr, hz, binary):
+        """Alta, renovación o baja de la telemetría empujada"""
+        hz = min(hz, MAX_TELEMETRY_HZ)
+        if hz == 0:
+            if self.subscriber is not None:
+                self.log(f"Telemetría cancelada por {addr[0]}:{addr[1]}")
+            self.subscriber = None
+            return
+        if self.subscriber is None or self.subscriber[0] != addr or self.subscriber[1] != hz:
+            self.log(f"Telemetría a {hz} Hz para {addr[0]}:{addr[1]}")
+        self.subscriber = (addr, hz, binary, time.time() + TELEMETRY_SUBSCRIPTION_TIMEOUT)
+
+    def telemetry(self):
+        """Thread que empuja frames de sensores al suscriptor a ritmo fijo"""
+        next_frame = time.time()
+        while self.running:
+            subscriber = self.subscriber
+            now = time.time()
+            if subscriber is None or now > subscriber[3]:
+                self.subscriber = None
+                time.sleep(0.05)
+                next_frame = time.time()
+                continue
+
+            addr, hz, binary, _ = subscriber
+            try:
+                with self.ev3_lock:
+                    sensor_data = self.ev3.read_sensors()
+                self.telemetry_frame = (self.telemetry_frame + 1) & 0xFFFFFFFF
+                frame = (self.telemetry_frame, int(time.time() * 1e6))
+                if binary:
+                    msg = encode_sensors_binary(sensor_data, frame, WIRE_TYPE_TELEMETRY)
+                else:
+                    msg = (f"T,{sensor_data['gyro_angle']:.2f},{sensor_data['gyro_rate']:.2f},"
+                           f"{sensor_data['touch_front']},{sensor_data['touch_side']},"
+                           f"{frame[0]},{frame[1]}").encode('utf-8')
+                self.sock.sendto(msg, addr)
+            except Exception as e:
+                self.log(f"[ERROR] Enviando telemetría: {e}")
+
+            # Ritmo fijo; si la lectura se retrasa no se envían ráfagas
+            next_frame += 1.0 / hz
+            delay = next_frame - time.time()
+            if delay > 0:
+                time.sleep(delay)
+            else:
+                next_frame = time.time()
+
     def watchdog(self):
         """Thread que monitorea timeout y envía STOP si no recibe"""
         while self.running:
@@ -145,6 +292,8 @@ class Bridge:
         # Iniciar watchdog en thread separado
         watchdog_thread = threading.Thread(target=self.watchdog, daemon=True)
         watchdog_thread.start()
+        telemetry_thread = threading.Thread(target=self.telemetry, daemon=True)
+        telemetry_thread.start()
 
         self.log("Bridge operativo. Esperando acciones del Jetson...")
         self.log("Modo: BIDIRECCIONAL (acciones + sensores)")
@@ -168,7 +317,8 @@ class Bridge:
         """Limpieza al cerrar"""
         self.running = False
         self.log("Enviando STOP final al EV3...")
-        self.ev3.execute_action(0)
+        with self.ev3_lock:
+            self.ev3.execute_action(0)
         time.sleep(0.5)
         self.ev3.cleanup()
         self.sock.close()